@@ -0,0 +1,208 @@
+#include "BarAggregator.h"
+
+namespace {
+	const int IntervalCount = static_cast<int>(BarInterval::Count);
+	const qint64 IntervalMSecs[IntervalCount] = { 1000, 5000, 60000, 300000 };
+
+	// Two minutes of seconds, ten of 5 s bars, four hours of minutes, a day of 5 minutes
+	const int DefaultCapacity[IntervalCount] = { 120, 120, 240, 288 };
+
+	inline void openBar(Bar& bar, qint64 startTime, double price, double volume)
+	{
+		bar.startTime = startTime;
+		bar.open = price;
+		bar.high = price;
+		bar.low = price;
+		bar.close = price;
+		bar.volume = volume;
+		bar.notional = price * volume;
+		bar.trades = 1;
+	}
+
+	inline void updateBar(Bar& bar, double price, double volume)
+	{
+		if (price > bar.high) {
+			bar.high = price;
+		}
+		if (price < bar.low) {
+			bar.low = price;
+		}
+		bar.close = price;
+		bar.volume += volume;
+		bar.notional += price * volume;
+		bar.trades++;
+	}
+}
+
+BarAggregator::BarAggregator()
+	: m_lateTrades(0)
+{
+	for (int i = 0; i < IntervalCount; ++i) {
+		m_capacity[i] = DefaultCapacity[i];
+	}
+}
+
+BarAggregator::~BarAggregator()
+{
+	clear();
+}
+
+void BarAggregator::setCapacity(BarInterval interval, int bars)
+{
+	m_capacity[static_cast<int>(interval)] = qMax(1, bars);
+}
+
+int BarAggregator::addTrade(SymbolId id, qint64 timestamp, double price, double volume, ClosedBar* closed)
+{
+	SymbolBars* symbol = symbolBars(id);
+	if (!symbol) {
+		symbol = allocate(id);
+		if (!symbol) {
+			return 0;
+		}
+	}
+
+	int closedMask = 0;
+	int closedCount = 0;
+	bool late = false;
+	for (int i = 0; i < IntervalCount; ++i) {
+		Series& series = symbol->series[i];
+		const qint64 startTime = timestamp - timestamp % IntervalMSecs[i];
+
+		if (series.count == 0) {
+			openBar(series.bars[0], startTime, price, volume);
+			series.count = 1;
+			continue;
+		}
+
+		Bar& current = series.bars[series.head];
+		if (startTime <= current.startTime) {
+			late = late || startTime < current.startTime;
+			updateBar(current, price, volume);
+			continue;
+		}
+
+		if (closed) {
+			ClosedBar& entry = closed[closedCount++];
+			entry.symbolId = id;
+			entry.interval = static_cast<BarInterval>(i);
+			entry.bar = current;
+		}
+		closedMask |= 1 << i;
+
+		series.head = series.head + 1 == series.capacity ? 0 : series.head + 1;
+		if (series.count < series.capacity) {
+			series.count++;
+		}
+		openBar(series.bars[series.head], startTime, price, volume);
+	}
+
+	if (late) {
+		m_lateTrades++;
+	}
+	return closedMask;
+}
+
+void BarAggregator::removeSymbol(SymbolId id)
+{
+	if (SymbolBars* symbol = symbolBars(id)) {
+		delete symbol;
+		m_symbols[id] = nullptr;
+	}
+}
+
+void BarAggregator::clear()
+{
+	qDeleteAll(m_symbols);
+	m_symbols.clear();
+	m_lateTrades = 0;
+}
+
+int BarAggregator::barCount(SymbolId id, BarInterval interval) const
+{
+	SymbolBars* symbol = symbolBars(id);
+	return symbol ? symbol->series[static_cast<int>(interval)].count : 0;
+}
+
+bool BarAggregator::bar(SymbolId id, BarInterval interval, int ago, Bar& out) const
+{
+	SymbolBars* symbol = symbolBars(id);
+	if (!symbol) {
+		return false;
+	}
+	const Series& series = symbol->series[static_cast<int>(interval)];
+	if (ago < 0 || ago >= series.count) {
+		return false;
+	}
+	int index = series.head - ago;
+	if (index < 0) {
+		index += series.capacity;
+	}
+	out = series.bars[index];
+	return true;
+}
+
+QVector<Bar> BarAggregator::bars(SymbolId id, BarInterval interval, int maxBars) const
+{
+	QVector<Bar> result;
+	SymbolBars* symbol = symbolBars(id);
+	if (!symbol) {
+		return result;
+	}
+
+	const Series& series = symbol->series[static_cast<int>(interval)];
+	const int count = qMin(maxBars, series.count);
+	result.reserve(count);
+	int index = series.head - (count - 1);
+	if (index < 0) {
+		index += series.capacity;
+	}
+	for (int i = 0; i < count; ++i) {
+		result.append(series.bars[index]);
+		index = index + 1 == series.capacity ? 0 : index + 1;
+	}
+	return result;
+}
+
+qint64 BarAggregator::intervalMSecs(BarInterval interval)
+{
+	return IntervalMSecs[static_cast<int>(interval)];
+}
+
+QString BarAggregator::intervalName(BarInterval interval)
+{
+	switch (interval) {
+	case BarInterval::OneSecond: return "1s";
+	case BarInterval::FiveSeconds: return "5s";
+	case BarInterval::OneMinute: return "1m";
+	case BarInterval::FiveMinutes: return "5m";
+	default: return "?";
+	}
+}
+
+BarAggregator::SymbolBars* BarAggregator::symbolBars(SymbolId id) const
+{
+	if (id == InvalidSymbolId || id >= static_cast<SymbolId>(m_symbols.size())) {
+		return nullptr;
+	}
+	return m_symbols[id];
+}
+
+BarAggregator::SymbolBars* BarAggregator::allocate(SymbolId id)
+{
+	if (id == InvalidSymbolId) {
+		return nullptr;
+	}
+	ensureSymbolCapacity(m_symbols, id, static_cast<SymbolBars*>(nullptr));
+
+	SymbolBars* symbol = new SymbolBars;
+	for (int i = 0; i < IntervalCount; ++i) {
+		Series& series = symbol->series[i];
+		series.capacity = m_capacity[i];
+		series.bars.reset(new Bar[series.capacity]);
+		series.head = 0;
+		series.count = 0;
+	}
+	m_symbols[id] = symbol;
+	return symbol;
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <QVector>
+#include <QString>
+#include <memory>
+#include "SymbolTable.h"
+
+enum class BarInterval {
+	OneSecond,
+	FiveSeconds,
+	OneMinute,
+	FiveMinutes,
+	Count
+};
+
+// One OHLCV bar. startTime is milliseconds since the epoch, aligned to the
+// interval; notional accumulates price * volume for the VWAP.
+struct Bar {
+	qint64 startTime;
+	double open;
+	double high;
+	double low;
+	double close;
+	double volume;
+	double notional;
+	quint32 trades;
+
+	double vwap() const { return volume > 0.0 ? notional / volume : close; }
+};
+
+// A bar that a trade in the following interval has just closed
+struct ClosedBar {
+	SymbolId symbolId;
+	BarInterval interval;
+	Bar bar;
+};
+
+// Incremental OHLCV + VWAP bars for every interval, per symbol, built from
+// the trade stream in constant time per trade. Each symbol's bars for an
+// interval live in a fixed-capacity ring, allocated on its first trade;
+// once full the oldest bar is overwritten.
+//
+// A bar is closed by the first trade that falls in a later interval, so a
+// symbol that stops trading keeps its last bar open and intervals without
+// trades produce no bar. Trades stamped before the open bar are late and
+// are folded into it.
+//
+// Consumer-thread only.
+class BarAggregator {
+public:
+	BarAggregator();
+	~BarAggregator();
+
+	// Takes effect for symbols whose rings are allocated afterwards
+	void setCapacity(BarInterval interval, int bars);
+	int capacity(BarInterval interval) const { return m_capacity[static_cast<int>(interval)]; }
+
+	// timestamp in ms since the epoch; returns the bars this trade closed
+	// as a mask of 1 << BarInterval
+	int addTrade(SymbolId id, qint64 timestamp, double price, double volume, ClosedBar* closed = nullptr);
+
+	void removeSymbol(SymbolId id);  // Frees its bars
+	void clear();
+
+	// Bars held, including the open one
+	int barCount(SymbolId id, BarInterval interval) const;
+
+	// ago 0 is the open bar, 1 the last closed one, and so on; false if not held
+	bool bar(SymbolId id, BarInterval interval, int ago, Bar& out) const;
+
+	// Up to maxBars of the most recent bars, oldest first, open bar last
+	QVector<Bar> bars(SymbolId id, BarInterval interval, int maxBars) const;
+
+	quint64 lateTrades() const { return m_lateTrades; }
+
+	static qint64 intervalMSecs(BarInterval interval);
+	static QString intervalName(BarInterval interval);
+
+private:
+	struct Series {
+		std::unique_ptr<Bar[]> bars;
+		int capacity;
+		int head;   // Index of the open bar
+		int count;  // Bars held, 0 until the first trade
+	};
+
+	struct SymbolBars {
+		Series series[static_cast<int>(BarInterval::Count)];
+	};
+
+	SymbolBars* symbolBars(SymbolId id) const;
+	SymbolBars* allocate(SymbolId id);
+
+private:
+	QVector<SymbolBars*> m_symbols;  // Indexed by SymbolId, nullptr until the first trade
+	int m_capacity[static_cast<int>(BarInterval::Count)];
+	quint64 m_lateTrades;
+};
@@ -0,0 +1,169 @@
+#include "BinaryFeedProtocol.h"
+#include <QtEndian>
+#include <cstring>
+
+BinaryFeedReader::BinaryFeedReader(const char* data, int length)
+	: m_pos(data)
+	, m_end(data + length)
+	, m_sequence(0)
+	, m_sendTime(0)
+	, m_recordCount(0)
+	, m_recordsRead(0)
+	, m_valid(false)
+	, m_error(false)
+{
+	if (length < BinaryFeed::HeaderSize) {
+		return;
+	}
+	if (qFromLittleEndian<quint32>(data) != BinaryFeed::Magic ||
+		static_cast<quint8>(data[4]) != BinaryFeed::Version) {
+		return;
+	}
+
+	const int headerSize = static_cast<quint8>(data[5]);
+	if (headerSize < BinaryFeed::HeaderSize || headerSize > length) {
+		return;
+	}
+
+	m_recordCount = qFromLittleEndian<quint16>(data + 6);
+	m_sequence = qFromLittleEndian<quint64>(data + 8);
+	m_sendTime = qFromLittleEndian<qint64>(data + 16);
+	m_pos = data + headerSize;
+	m_valid = true;
+}
+
+BinaryFeedReader::BinaryFeedReader(const QByteArray& message)
+	: BinaryFeedReader(message.constData(), static_cast<int>(message.size()))
+{
+}
+
+bool BinaryFeedReader::next(BinaryFeedRecord& record)
+{
+	while (m_valid && !m_error && m_recordsRead < m_recordCount) {
+		if (m_end - m_pos < BinaryFeed::RecordPrefixSize) {
+			m_error = true;
+			return false;
+		}
+
+		const char* p = m_pos;
+		const int size = static_cast<quint8>(p[1]);
+		if (size < BinaryFeed::RecordPrefixSize || size > m_end - p) {
+			m_error = true;
+			return false;
+		}
+		m_pos += size;
+		m_recordsRead++;
+
+		const BinaryFeedRecordType type = static_cast<BinaryFeedRecordType>(static_cast<quint8>(p[0]));
+		int expectedSize = 0;
+		switch (type) {
+		case BinaryFeedRecordType::Trade: expectedSize = BinaryFeed::TradeRecordSize; break;
+		case BinaryFeedRecordType::Quote: expectedSize = BinaryFeed::QuoteRecordSize; break;
+		default: continue;  // Newer record type - skip it by size
+		}
+		if (size < expectedSize) {
+			m_error = true;
+			return false;
+		}
+
+		const char* symbol = p + BinaryFeed::RecordPrefixSize;
+		int symbolLength = 0;
+		while (symbolLength < BinaryFeed::SymbolSize && symbol[symbolLength] != '\0') {
+			symbolLength++;
+		}
+
+		if (symbolLength == 0) {
+			m_error = true;
+			return false;
+		}
+
+		record.type = type;
+		record.symbol = symbol;
+		record.symbolLength = symbolLength;
+		record.price = qFromLittleEndian<double>(p + 24);
+		record.volume = qFromLittleEndian<double>(p + 32);
+		if (type == BinaryFeedRecordType::Trade) {
+			record.askPrice = 0.0;
+			record.askVolume = 0.0;
+			record.exchangeTime = qFromLittleEndian<qint64>(p + 40);
+		}
+		else {
+			record.askPrice = qFromLittleEndian<double>(p + 40);
+			record.askVolume = qFromLittleEndian<double>(p + 48);
+			record.exchangeTime = qFromLittleEndian<qint64>(p + 56);
+		}
+		return true;
+	}
+	return false;
+}
+
+BinaryFeedWriter::BinaryFeedWriter(QByteArray* buffer)
+	: m_buffer(buffer)
+	, m_recordCount(0)
+{
+}
+
+void BinaryFeedWriter::begin(quint64 sequence, qint64 sendTime)
+{
+	// resize() keeps the capacity, so a reused buffer stops allocating once warm
+	m_buffer->resize(BinaryFeed::HeaderSize);
+	char* p = m_buffer->data();
+	qToLittleEndian<quint32>(BinaryFeed::Magic, p);
+	p[4] = static_cast<char>(BinaryFeed::Version);
+	p[5] = static_cast<char>(BinaryFeed::HeaderSize);
+	qToLittleEndian<quint16>(0, p + 6);
+	qToLittleEndian<quint64>(sequence, p + 8);
+	qToLittleEndian<qint64>(sendTime, p + 16);
+	m_recordCount = 0;
+}
+
+bool BinaryFeedWriter::addTrade(const QByteArray& symbol, double price, double volume, qint64 exchangeTime)
+{
+	char* p = appendRecord(BinaryFeedRecordType::Trade, BinaryFeed::TradeRecordSize, symbol);
+	if (!p) {
+		return false;
+	}
+	qToLittleEndian<double>(price, p + 24);
+	qToLittleEndian<double>(volume, p + 32);
+	qToLittleEndian<qint64>(exchangeTime, p + 40);
+	return true;
+}
+
+bool BinaryFeedWriter::addQuote(const QByteArray& symbol, double bidPrice, double bidVolume,
+	double askPrice, double askVolume, qint64 exchangeTime)
+{
+	char* p = appendRecord(BinaryFeedRecordType::Quote, BinaryFeed::QuoteRecordSize, symbol);
+	if (!p) {
+		return false;
+	}
+	qToLittleEndian<double>(bidPrice, p + 24);
+	qToLittleEndian<double>(bidVolume, p + 32);
+	qToLittleEndian<double>(askPrice, p + 40);
+	qToLittleEndian<double>(askVolume, p + 48);
+	qToLittleEndian<qint64>(exchangeTime, p + 56);
+	return true;
+}
+
+void BinaryFeedWriter::finish()
+{
+	qToLittleEndian<quint16>(static_cast<quint16>(m_recordCount), m_buffer->data() + 6);
+}
+
+char* BinaryFeedWriter::appendRecord(BinaryFeedRecordType type, int size, const QByteArray& symbol)
+{
+	if (m_recordCount >= BinaryFeed::MaxRecordsPerBatch ||
+		symbol.isEmpty() || symbol.size() > BinaryFeed::SymbolSize) {
+		return nullptr;
+	}
+
+	const int offset = static_cast<int>(m_buffer->size());
+	m_buffer->resize(offset + size);
+	char* p = m_buffer->data() + offset;
+	std::memset(p, 0, size);
+	p[0] = static_cast<char>(type);
+	p[1] = static_cast<char>(size);
+	std::memcpy(p + BinaryFeed::RecordPrefixSize, symbol.constData(), symbol.size());
+
+	m_recordCount++;
+	return p;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <QtGlobal>
+#include <QByteArray>
+
+// Internal binary market data protocol. One WebSocket binary message carries
+// one batch: a fixed header followed by fixed-layout records. Every field is
+// little-endian and read in place, so decoding never copies the payload.
+//
+// Batch header (24 bytes)
+//   0  u32  magic "LTMD"
+//   4  u8   version
+//   5  u8   header size in bytes (readers skip anything past what they know)
+//   6  u16  record count
+//   8  u64  batch sequence number, +1 per batch
+//   16 i64  send time, ms since epoch
+//
+// Every record starts with an 8-byte prefix and a 16-byte symbol
+//   0  u8   record type
+//   1  u8   record size in bytes (unknown types are skipped by size)
+//   2  u16  flags (reserved, 0)
+//   4  u32  reserved
+//   8  char symbol[16], NUL padded
+//
+// Trade record (48 bytes): 24 f64 price, 32 f64 volume, 40 i64 exchange time (ms)
+// Quote record (64 bytes): 24 f64 bid, 32 f64 bid size, 40 f64 ask, 48 f64 ask size,
+//                          56 i64 exchange time (ms)
+namespace BinaryFeed {
+	const quint32 Magic = 0x444D544Cu;  // "LTMD" as little-endian bytes
+	const quint8 Version = 1;
+	const int HeaderSize = 24;
+	const int RecordPrefixSize = 8;
+	const int SymbolSize = 16;
+	const int TradeRecordSize = 48;
+	const int QuoteRecordSize = 64;
+	const int MaxRecordsPerBatch = 0xFFFF;
+}
+
+enum class BinaryFeedRecordType : quint8 {
+	Trade = 1,
+	Quote = 2
+};
+
+// Decoded view of one record. The symbol points into the message buffer and
+// is only valid while that buffer is alive.
+struct BinaryFeedRecord {
+	BinaryFeedRecordType type;
+	const char* symbol;
+	int symbolLength;
+	double price;      // Trade price, or bid for quotes
+	double volume;     // Trade size, or bid size for quotes
+	double askPrice;   // Quotes only
+	double askVolume;  // Quotes only
+	qint64 exchangeTime;
+};
+
+// Walks a batch in place; the caller pulls records one at a time with next()
+class BinaryFeedReader {
+public:
+	BinaryFeedReader(const char* data, int length);
+	explicit BinaryFeedReader(const QByteArray& message);
+
+	bool isValid() const { return m_valid; }
+	quint64 sequence() const { return m_sequence; }
+	qint64 sendTime() const { return m_sendTime; }
+	int recordCount() const { return m_recordCount; }
+
+	// Returns false at the end of the batch or on a truncated record
+	bool next(BinaryFeedRecord& record);
+	bool hasError() const { return m_error; }
+
+private:
+	const char* m_pos;
+	const char* m_end;
+	quint64 m_sequence;
+	qint64 m_sendTime;
+	int m_recordCount;
+	int m_recordsRead;
+	bool m_valid;
+	bool m_error;
+};
+
+// Builds a batch into a caller-owned buffer that is reused between batches
+class BinaryFeedWriter {
+public:
+	explicit BinaryFeedWriter(QByteArray* buffer);
+
+	void begin(quint64 sequence, qint64 sendTime);
+	bool addTrade(const QByteArray& symbol, double price, double volume, qint64 exchangeTime);
+	bool addQuote(const QByteArray& symbol, double bidPrice, double bidVolume,
+		double askPrice, double askVolume, qint64 exchangeTime);
+	void finish();
+
+	int recordCount() const { return m_recordCount; }
+
+private:
+	char* appendRecord(BinaryFeedRecordType type, int size, const QByteArray& symbol);
+
+private:
+	QByteArray* m_buffer;
+	int m_recordCount;
+};
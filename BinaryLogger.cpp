@@ -0,0 +1,218 @@
+#include "BinaryLogger.h"
+#include "Order.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+
+struct LogEventInfo {
+	LogCategory category;
+	LogLevel level;
+};
+
+// Indexed by LogEventId
+const LogEventInfo eventInfo[] = {
+	{ LogCategory::Trade, LogLevel::Debug },  // FeedTrade
+	{ LogCategory::Order, LogLevel::Info },   // OrderSubmitted
+	{ LogCategory::Order, LogLevel::Info },   // OrderModified
+	{ LogCategory::Fill, LogLevel::Info },    // OrderFilled
+	{ LogCategory::Fill, LogLevel::Info },    // OrderPartiallyFilled
+};
+
+static_assert(sizeof(eventInfo) / sizeof(eventInfo[0]) == static_cast<int>(LogEventId::Count),
+	"eventInfo must describe every LogEventId");
+
+thread_local void* t_threadLog = nullptr;
+
+QString tagToString(const LogArg& arg)
+{
+	int length = 0;
+	while (length < 8 && arg.text[length] != '\0') {
+		length++;
+	}
+	return QString::fromLatin1(arg.text, length);
+}
+
+}
+
+LogArg logTag(const QString& text)
+{
+	LogArg arg;
+	arg.i = 0;
+	const int length = qMin(8, static_cast<int>(text.size()));
+	for (int i = 0; i < length; ++i) {
+		arg.text[i] = text[i].toLatin1();
+	}
+	return arg;
+}
+
+BinaryLogger& BinaryLogger::instance()
+{
+	static BinaryLogger logger;
+	return logger;
+}
+
+BinaryLogger::BinaryLogger()
+{
+	// Order flow is logged by default; per-trade logging must be opted into
+	m_categoryLevels[static_cast<int>(LogCategory::Trade)].store(static_cast<quint8>(LogLevel::Off));
+	m_categoryLevels[static_cast<int>(LogCategory::Order)].store(static_cast<quint8>(LogLevel::Info));
+	m_categoryLevels[static_cast<int>(LogCategory::Fill)].store(static_cast<quint8>(LogLevel::Info));
+	refreshEnabledEvents();
+}
+
+void BinaryLogger::log(LogEventId id, std::initializer_list<LogArg> args)
+{
+	BinaryLogger& logger = instance();
+	if (!logger.m_eventEnabled[static_cast<int>(id)].load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	LogEvent event;
+	event.timestamp = MonotonicClock::now();
+	event.id = id;
+	event.argCount = 0;
+	for (const LogArg& arg : args) {
+		if (event.argCount == sizeof(event.args) / sizeof(event.args[0])) {
+			break;
+		}
+		event.args[event.argCount++] = arg;
+	}
+
+	ThreadLog* log = logger.threadLog();
+	if (!log->ring.tryPush(event)) {
+		log->dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void BinaryLogger::setCategoryLevel(LogCategory category, LogLevel level)
+{
+	m_categoryLevels[static_cast<int>(category)].store(static_cast<quint8>(level), std::memory_order_relaxed);
+	refreshEnabledEvents();
+}
+
+LogLevel BinaryLogger::categoryLevel(LogCategory category) const
+{
+	return static_cast<LogLevel>(m_categoryLevels[static_cast<int>(category)].load(std::memory_order_relaxed));
+}
+
+QStringList BinaryLogger::takeFormatted(int maxEvents)
+{
+	QVector<ThreadLog*> threads;
+	{
+		QMutexLocker locker(&m_threadsMutex);
+		threads = m_threads;
+	}
+
+	m_pending.clear();
+	LogEvent event;
+	for (ThreadLog* log : threads) {
+		while (m_pending.size() < maxEvents && log->ring.tryPop(event)) {
+			m_pending.append(event);
+		}
+	}
+
+	// Rings are ordered per thread only; merge them by timestamp
+	std::stable_sort(m_pending.begin(), m_pending.end(),
+		[](const LogEvent& a, const LogEvent& b) { return a.timestamp < b.timestamp; });
+
+	QStringList lines;
+	lines.reserve(m_pending.size());
+	for (const LogEvent& pending : m_pending) {
+		lines.append(format(pending));
+	}
+	return lines;
+}
+
+quint64 BinaryLogger::droppedEvents() const
+{
+	QMutexLocker locker(&m_threadsMutex);
+	quint64 total = 0;
+	for (ThreadLog* log : m_threads) {
+		total += log->dropped.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+QString BinaryLogger::categoryToString(LogCategory category)
+{
+	switch (category) {
+	case LogCategory::Trade: return "TRADE";
+	case LogCategory::Order: return "ORDER";
+	case LogCategory::Fill: return "FILL";
+	default: return "UNKNOWN";
+	}
+}
+
+BinaryLogger::ThreadLog* BinaryLogger::threadLog()
+{
+	if (!t_threadLog) {
+		// First event from this thread: allocate and register its ring. Rings
+		// are kept for the life of the process so the reader never races a free.
+		ThreadLog* log = new ThreadLog();
+		QMutexLocker locker(&m_threadsMutex);
+		m_threads.append(log);
+		t_threadLog = log;
+	}
+	return static_cast<ThreadLog*>(t_threadLog);
+}
+
+void BinaryLogger::refreshEnabledEvents()
+{
+	for (int i = 0; i < static_cast<int>(LogEventId::Count); ++i) {
+		const LogEventInfo& info = eventInfo[i];
+		LogLevel level = categoryLevel(info.category);
+		bool enabled = level != LogLevel::Off &&
+			static_cast<quint8>(info.level) <= static_cast<quint8>(level);
+		m_eventEnabled[i].store(enabled, std::memory_order_relaxed);
+	}
+}
+
+QString BinaryLogger::format(const LogEvent& event) const
+{
+	// Wall-clock conversion only happens here, never on the logging thread
+	QString time = MonotonicClock::toDateTime(event.timestamp).toString("hh:mm:ss.zzz");
+	const LogArg* a = event.args;
+
+	QString text;
+	switch (event.id) {
+	case LogEventId::FeedTrade:
+		text = QString("[FEED] Trade: %1 @ $%2 (Vol: %3)")
+			.arg(SymbolTable::instance().symbol(static_cast<SymbolId>(a[0].i)))
+			.arg(a[1].d, 0, 'f', 2)
+			.arg(a[2].d);
+		break;
+	case LogEventId::OrderSubmitted:
+		text = QString("[ORDER] Submitted %1 %2 %3 @ %4 - ID: %5")
+			.arg(Order::sideToString(static_cast<OrderSide>(a[0].i)))
+			.arg(a[1].d)
+			.arg(SymbolTable::instance().symbol(static_cast<SymbolId>(a[2].i)))
+			.arg(a[3].d)
+			.arg(tagToString(a[4]));
+		break;
+	case LogEventId::OrderModified:
+		text = QString("[ORDER] Modified %1 - New price: %2")
+			.arg(tagToString(a[0]))
+			.arg(a[1].d);
+		break;
+	case LogEventId::OrderFilled:
+		text = QString("[FILL] Order %1 fully filled: %2 @ %3")
+			.arg(tagToString(a[0]))
+			.arg(a[1].d)
+			.arg(a[2].d);
+		break;
+	case LogEventId::OrderPartiallyFilled:
+		text = QString("[FILL] Order %1 partially filled: %2 @ %3 (%4/%5)")
+			.arg(tagToString(a[0]))
+			.arg(a[1].d)
+			.arg(a[2].d)
+			.arg(a[3].d)
+			.arg(a[4].d);
+		break;
+	default:
+		text = QString("[LOG] Unknown event %1").arg(static_cast<int>(event.id));
+		break;
+	}
+
+	return QString("[%1] %2").arg(time, text);
+}
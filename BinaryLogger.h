@@ -0,0 +1,99 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMutex>
+#include <atomic>
+#include <initializer_list>
+#include "SpscRing.h"
+#include "SymbolTable.h"
+#include "MonotonicClock.h"
+
+enum class LogCategory : quint8 {
+	Trade,    // Every market data trade
+	Order,    // Order lifecycle
+	Fill,     // Executions
+	Count
+};
+
+enum class LogLevel : quint8 {
+	Off,
+	Error,
+	Info,
+	Debug
+};
+
+enum class LogEventId : quint16 {
+	FeedTrade,             // symbol, price, volume
+	OrderSubmitted,        // side, quantity, symbol, price, order tag
+	OrderModified,         // order tag, price
+	OrderFilled,           // order tag, quantity, price
+	OrderPartiallyFilled,  // order tag, quantity, price, filled, total
+	Count
+};
+
+// Fixed-size argument slot; the event ID decides how each slot is read
+union LogArg {
+	qint64 i;
+	double d;
+	char text[8];
+};
+
+inline LogArg logInt(qint64 value) { LogArg arg; arg.i = value; return arg; }
+inline LogArg logReal(double value) { LogArg arg; arg.d = value; return arg; }
+inline LogArg logSymbol(SymbolId id) { LogArg arg; arg.i = id; return arg; }
+LogArg logTag(const QString& text);  // First 8 Latin-1 characters, e.g. an order ID prefix
+
+struct LogEvent {
+	qint64 timestamp;  // MonotonicClock ns
+	LogEventId id;
+	quint8 argCount;
+	LogArg args[5];
+};
+
+// Lock-free structured logger for hot paths. Each thread records fixed-size
+// binary events into its own SPSC ring; nothing is formatted until a reader
+// calls takeFormatted() (the System Log panel does so on a timer).
+class BinaryLogger {
+public:
+	static BinaryLogger& instance();
+
+	static bool isEnabled(LogEventId id)
+	{
+		return instance().m_eventEnabled[static_cast<int>(id)].load(std::memory_order_relaxed);
+	}
+
+	static void log(LogEventId id, std::initializer_list<LogArg> args);
+
+	void setCategoryLevel(LogCategory category, LogLevel level);
+	LogLevel categoryLevel(LogCategory category) const;
+
+	// Drains every thread's ring, merges by time and formats the result
+	QStringList takeFormatted(int maxEvents = 2048);
+	quint64 droppedEvents() const;
+
+	static QString categoryToString(LogCategory category);
+
+private:
+	struct ThreadLog {
+		ThreadLog() : ring(8192), dropped(0) {}
+		SpscRing<LogEvent> ring;
+		std::atomic<quint64> dropped;
+	};
+
+	BinaryLogger();
+	BinaryLogger(const BinaryLogger&) = delete;
+	BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+	ThreadLog* threadLog();
+	void refreshEnabledEvents();
+	QString format(const LogEvent& event) const;
+
+private:
+	std::atomic<bool> m_eventEnabled[static_cast<int>(LogEventId::Count)];
+	std::atomic<quint8> m_categoryLevels[static_cast<int>(LogCategory::Count)];
+
+	mutable QMutex m_threadsMutex;  // Only taken when a thread logs for the first time
+	QVector<ThreadLog*> m_threads;
+	QVector<LogEvent> m_pending;  // Reader-side merge buffer
+};
@@ -0,0 +1,229 @@
+#include "FeedArbiter.h"
+#include "MonotonicClock.h"
+#include <cstring>
+
+FeedArbiter::FeedArbiter(qint64 windowNanos)
+	: m_enabled(false)
+	, m_windowNanos(windowNanos)
+	, m_overflows(0)
+{
+}
+
+FeedArbiter::~FeedArbiter()
+{
+	qDeleteAll(m_windows);
+}
+
+void FeedArbiter::setArbitrationEnabled(bool enabled)
+{
+	if (m_enabled == enabled) {
+		return;
+	}
+	m_enabled = enabled;
+
+	// Windows from an earlier arbitrated period would match stale ticks
+	qDeleteAll(m_windows);
+	m_windows.clear();
+}
+
+bool FeedArbiter::accept(const FeedTick& tick)
+{
+	SourceCounters& source = counters(tick.sourceId);
+	source.received++;
+	if (tick.exchangeTime > 0) {
+		source.latency.record(MonotonicClock::toWallNanos(tick.receiveTime) - tick.exchangeTime * 1000000);
+	}
+
+	if (!m_enabled) {
+		source.accepted++;
+		source.firstArrivals++;
+		return true;
+	}
+
+	SymbolWindow* symbolWindow = window(tick.symbolId);
+	symbolWindow->seenSources |= 1u << tick.sourceId;
+	expire(*symbolWindow, tick.receiveTime);
+
+	const quint64 print = fingerprint(tick);
+	const quint64 mask = static_cast<quint64>(symbolWindow->entries.size()) - 1;
+	QHash<quint64, quint64>::const_iterator found = symbolWindow->index.constFind(print);
+	Entry* entry = found != symbolWindow->index.constEnd()
+		? &symbolWindow->entries[static_cast<qsizetype>(found.value() & mask)] : nullptr;
+	if (entry && tick.receiveTime - entry->firstReceiveTime > m_windowNanos) {
+		// Aged out behind a younger head; close it now and start afresh
+		settle(*symbolWindow, *entry);
+		entry->accepted = 0;
+		entry = nullptr;
+	}
+
+	if (entry) {
+		if (++entry->copies[tick.sourceId] > entry->accepted) {
+			// More copies from this source than anyone delivered: a new event
+			entry->accepted++;
+			source.accepted++;
+			source.firstArrivals++;
+			return true;
+		}
+
+		source.duplicates++;
+		if (tick.receiveTime < entry->firstReceiveTime) {
+			// Drained after the winner but received before it; credit the race correctly
+			SourceCounters& previous = counters(entry->firstSource);
+			previous.firstArrivals--;
+			previous.lag.record(entry->firstReceiveTime - tick.receiveTime);
+			source.firstArrivals++;
+			entry->firstSource = tick.sourceId;
+			entry->firstReceiveTime = tick.receiveTime;
+		}
+		else {
+			source.lag.record(tick.receiveTime - entry->firstReceiveTime);
+		}
+		return false;
+	}
+
+	// First copy, into a new entry at the tail
+	if (symbolWindow->tail - symbolWindow->head == static_cast<quint64>(symbolWindow->entries.size())) {
+		if (symbolWindow->entries.size() < MaxWindowEntries) {
+			grow(*symbolWindow);
+		}
+		else {
+			// Only an entry some source still owes a copy of is lost information
+			m_overflows += evictOldest(*symbolWindow) ? 1 : 0;
+		}
+	}
+	const quint64 sequence = symbolWindow->tail++;
+	Entry& slot = symbolWindow->entries[static_cast<qsizetype>(sequence & (static_cast<quint64>(symbolWindow->entries.size()) - 1))];
+	symbolWindow->index.insert(print, sequence);
+	std::memset(slot.copies, 0, sizeof(slot.copies));
+	slot.fingerprint = print;
+	slot.firstReceiveTime = tick.receiveTime;
+	slot.accepted = 1;
+	slot.firstSource = tick.sourceId;
+	slot.copies[tick.sourceId] = 1;
+
+	source.accepted++;
+	source.firstArrivals++;
+	return true;
+}
+
+bool FeedArbiter::settle(const SymbolWindow& window, const Entry& entry)
+{
+	// Anything a source that carries this symbol never delivered counts as lost on that source
+	bool incomplete = false;
+	for (int s = 0; s < MaxFeedSources; ++s) {
+		if ((window.seenSources & (1u << s)) && entry.copies[s] < entry.accepted) {
+			counters(static_cast<FeedSourceId>(s)).missed += entry.accepted - entry.copies[s];
+			incomplete = true;
+		}
+	}
+	return incomplete;
+}
+
+void FeedArbiter::expire(SymbolWindow& window, qint64 now)
+{
+	const quint64 mask = static_cast<quint64>(window.entries.size()) - 1;
+	while (window.head != window.tail &&
+		now - window.entries[static_cast<qsizetype>(window.head & mask)].firstReceiveTime > m_windowNanos) {
+		evictOldest(window);
+	}
+}
+
+bool FeedArbiter::evictOldest(SymbolWindow& window)
+{
+	const quint64 sequence = window.head++;
+	const Entry& entry = window.entries[static_cast<qsizetype>(sequence & (static_cast<quint64>(window.entries.size()) - 1))];
+	if (entry.accepted == 0) {
+		return false;  // Already settled when a newer copy replaced it
+	}
+	const bool incomplete = settle(window, entry);
+
+	QHash<quint64, quint64>::iterator it = window.index.find(entry.fingerprint);
+	if (it != window.index.end() && it.value() == sequence) {
+		window.index.erase(it);
+	}
+	return incomplete;
+}
+
+void FeedArbiter::grow(SymbolWindow& window)
+{
+	// Sequence numbers stay valid; each live entry moves to its slot in the larger ring
+	QVector<Entry> entries(window.entries.size() * 2);
+	const quint64 oldMask = static_cast<quint64>(window.entries.size()) - 1;
+	const quint64 newMask = static_cast<quint64>(entries.size()) - 1;
+	for (quint64 sequence = window.head; sequence != window.tail; ++sequence) {
+		entries[static_cast<qsizetype>(sequence & newMask)] = window.entries[static_cast<qsizetype>(sequence & oldMask)];
+	}
+	window.entries.swap(entries);
+}
+
+FeedSourceStats FeedArbiter::sourceStats(FeedSourceId source) const
+{
+	FeedSourceStats stats = {};
+	if (source >= MaxFeedSources || !m_sources[source]) {
+		return stats;
+	}
+
+	const SourceCounters& counters = *m_sources[source];
+	stats.received = counters.received;
+	stats.accepted = counters.accepted;
+	stats.duplicates = counters.duplicates;
+	stats.missed = counters.missed;
+	stats.firstArrivals = counters.firstArrivals;
+	stats.latency = counters.latency.snapshot();
+	stats.lag = counters.lag.snapshot();
+	return stats;
+}
+
+void FeedArbiter::resetSource(FeedSourceId source)
+{
+	if (source < MaxFeedSources) {
+		m_sources[source].reset();
+	}
+}
+
+FeedArbiter::SourceCounters& FeedArbiter::counters(FeedSourceId source)
+{
+	std::unique_ptr<SourceCounters>& counters = m_sources[source % MaxFeedSources];
+	if (!counters) {
+		counters.reset(new SourceCounters());
+	}
+	return *counters;
+}
+
+FeedArbiter::SymbolWindow* FeedArbiter::window(SymbolId id)
+{
+	ensureSymbolCapacity(m_windows, id, static_cast<SymbolWindow*>(nullptr));
+	SymbolWindow*& symbolWindow = m_windows[id];
+	if (!symbolWindow) {
+		symbolWindow = new SymbolWindow();
+		symbolWindow->entries.resize(InitialWindowEntries);
+	}
+	return symbolWindow;
+}
+
+quint64 FeedArbiter::fingerprint(const FeedTick& tick)
+{
+	// splitmix64 finaliser over the fields every copy of a tick shares
+	auto mix = [](quint64 h, quint64 v) {
+		h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+		h ^= h >> 30;
+		h *= 0xBF58476D1CE4E5B9ull;
+		h ^= h >> 27;
+		h *= 0x94D049BB133111EBull;
+		return h ^ (h >> 31);
+	};
+	auto bits = [](double d) {
+		quint64 v;
+		std::memcpy(&v, &d, sizeof(v));
+		return v;
+	};
+
+	quint64 h = mix(static_cast<quint64>(tick.type), static_cast<quint64>(tick.exchangeTime));
+	h = mix(h, bits(tick.price));
+	h = mix(h, bits(tick.volume));
+	if (tick.type == FeedTickType::Quote) {
+		h = mix(h, bits(tick.askPrice));
+		h = mix(h, bits(tick.askVolume));
+	}
+	return h;
+}
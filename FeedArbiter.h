@@ -0,0 +1,96 @@
+#pragma once
+#include <QVector>
+#include <QHash>
+#include <memory>
+#include "FeedTick.h"
+#include "LatencyHistogram.h"
+
+struct FeedSourceStats {
+	quint64 received;        // Ticks seen from this source
+	quint64 accepted;        // Passed downstream
+	quint64 duplicates;      // Suppressed; another source already delivered the tick
+	quint64 missed;          // Delivered by another source but never by this one
+	quint64 firstArrivals;   // Times this source had the earliest receive time
+	LatencySnapshot latency; // Exchange timestamp to receive
+	LatencySnapshot lag;     // How far behind the first arrival this source's duplicates came
+};
+
+// A/B line arbitration across feed sources. The same tick arriving from
+// several sources - identified by symbol, type, exchange time, prices and
+// sizes - is passed on once, from whichever source delivers it first; later
+// copies are suppressed. Identical ticks within one source are distinct
+// events, so copies are counted per source rather than simply remembered.
+//
+// Each symbol remembers every distinct tick first received within the
+// window, however many that is. The ring of entries doubles as traffic
+// needs, and entries leave it by age. Only a symbol that exceeds
+// MaxWindowEntries within one window loses entries early; those some source
+// had not yet delivered are counted as overflows.
+//
+// Consumer-thread only. With arbitration disabled every tick is accepted
+// and only the per-source statistics are kept.
+class FeedArbiter {
+public:
+	static const int InitialWindowEntries = 16;  // Per symbol; a power of two
+	static const int MaxWindowEntries = 1 << 16;
+
+	explicit FeedArbiter(qint64 windowNanos = 2000000000);
+	~FeedArbiter();
+
+	void setArbitrationEnabled(bool enabled);
+	bool isArbitrationEnabled() const { return m_enabled; }
+
+	// true if the tick should be applied, false if it is a duplicate
+	bool accept(const FeedTick& tick);
+
+	FeedSourceStats sourceStats(FeedSourceId source) const;
+	void resetSource(FeedSourceId source);
+
+	// Entries pushed out of a full window before they aged out while a source
+	// still owed a copy; a late copy of one of those is not recognised as a
+	// duplicate
+	quint64 windowOverflows() const { return m_overflows; }
+
+private:
+	struct Entry {
+		quint64 fingerprint;
+		qint64 firstReceiveTime;
+		quint32 accepted;  // Copies passed downstream; 0 once settled
+		FeedSourceId firstSource;
+		quint16 copies[MaxFeedSources];
+	};
+
+	// Entries are addressed by a running sequence number; [head, tail) are live
+	struct SymbolWindow {
+		QVector<Entry> entries;         // Ring, power-of-two size
+		QHash<quint64, quint64> index;  // Fingerprint to the sequence of its newest entry
+		quint64 head = 0;
+		quint64 tail = 0;
+		quint32 seenSources = 0;        // Sources that have ever delivered this symbol
+	};
+
+	struct SourceCounters {
+		quint64 received = 0;
+		quint64 accepted = 0;
+		quint64 duplicates = 0;
+		quint64 missed = 0;
+		quint64 firstArrivals = 0;
+		LatencyHistogram latency;
+		LatencyHistogram lag;
+	};
+
+	SourceCounters& counters(FeedSourceId source);
+	SymbolWindow* window(SymbolId id);
+	bool settle(const SymbolWindow& window, const Entry& entry);  // true if a source missed it
+	void expire(SymbolWindow& window, qint64 now);
+	bool evictOldest(SymbolWindow& window);
+	static void grow(SymbolWindow& window);
+	static quint64 fingerprint(const FeedTick& tick);
+
+private:
+	bool m_enabled;
+	qint64 m_windowNanos;
+	quint64 m_overflows;
+	QVector<SymbolWindow*> m_windows;  // Indexed by SymbolId, created on first arbitrated tick
+	std::unique_ptr<SourceCounters> m_sources[MaxFeedSources];
+};
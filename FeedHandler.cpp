@@ -0,0 +1,379 @@
+#include "FeedHandler.h"
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include "LatencyMonitor.h"
+
+FeedHandler::FeedHandler(SpscRing<FeedTick>* ring, FeedSourceId sourceId, QObject* parent)
+	: QObject(parent)
+	, m_transport(nullptr)
+	, m_transportKind(WebSocketTransportKind::Qt)
+	, m_heartbeatTimer(new QTimer(this))
+	, m_ring(ring)
+	, m_journal(nullptr)
+	, m_sourceId(sourceId)
+	, m_wakePending(false)
+	, m_framesReceived(0)
+	, m_ticksEnqueued(0)
+	, m_ticksDropped(0)
+	, m_sequenceGaps(0)
+	, m_highWaterMark(0)
+	, m_lastMessageTime(0)
+	, m_expectedSequence(0)
+	, m_frameReceiveTime(0)
+{
+	m_heartbeatTimer->setInterval(30000);  // Heartbeat every 30 seconds
+	connect(m_heartbeatTimer, &QTimer::timeout, this, [this]() {
+		if (m_transport && m_transport->isValid()) {
+			// Finnhub WebSocket ping
+			m_transport->sendTextMessage("{\"type\":\"ping\"}");
+		}
+		});
+}
+
+void FeedHandler::open(const QUrl& url)
+{
+	WebSocketTransportKind kind = m_transportKind;
+	if (kind == WebSocketTransportKind::IoUring && url.scheme() == "wss") {
+		emit logMessage("[FEED] io_uring transport has no TLS - using Qt WebSocket for wss://");
+		kind = WebSocketTransportKind::Qt;
+	}
+	else if (!WebSocketTransport::isAvailable(kind)) {
+		emit logMessage(QString("[FEED] %1 transport not available here - using Qt WebSocket")
+			.arg(WebSocketTransport::kindName(kind)));
+		kind = WebSocketTransportKind::Qt;
+	}
+
+	if (!m_transport || m_transport->kind() != kind) {
+		setTransport(WebSocketTransport::create(kind, this));
+	}
+	m_transport->open(url);
+}
+
+void FeedHandler::close()
+{
+	m_heartbeatTimer->stop();
+	if (m_transport) {
+		m_transport->close();
+	}
+}
+
+void FeedHandler::setTransportKind(WebSocketTransportKind kind)
+{
+	m_transportKind = kind;
+}
+
+void FeedHandler::setTransport(WebSocketTransport* transport)
+{
+	if (m_transport) {
+		// The old socket goes quietly; its session was already closed or replaced
+		disconnect(m_transport, nullptr, this, nullptr);
+		m_transport->close();
+		m_transport->deleteLater();
+	}
+	m_transport = transport;
+
+	connect(m_transport, &WebSocketTransport::connected, this, &FeedHandler::onConnected);
+	connect(m_transport, &WebSocketTransport::disconnected, this, &FeedHandler::onDisconnected);
+	connect(m_transport, &WebSocketTransport::errorOccurred, this, &FeedHandler::errorOccurred);
+	connect(m_transport, &WebSocketTransport::textMessageReceived,
+		this, &FeedHandler::onTextMessageReceived);
+	connect(m_transport, &WebSocketTransport::textFrameReceived,
+		this, &FeedHandler::onTextFrameReceived, Qt::DirectConnection);
+	connect(m_transport, &WebSocketTransport::binaryMessageReceived,
+		this, &FeedHandler::onBinaryMessageReceived, Qt::DirectConnection);
+}
+
+QString FeedHandler::subscriptionMessage(const QString& type, const QString& symbol)
+{
+	QJsonObject msg;
+	msg["type"] = type;
+	msg["symbol"] = symbol;
+	return QString::fromUtf8(QJsonDocument(msg).toJson(QJsonDocument::Compact));
+}
+
+void FeedHandler::sendTextMessage(const QString& message)
+{
+	if (m_transport && m_transport->isValid()) {
+		m_transport->sendTextMessage(message);
+	}
+}
+
+void FeedHandler::sendTextMessages(const QStringList& messages)
+{
+	if (m_transport && m_transport->isValid()) {
+		m_transport->sendTextMessages(messages);
+	}
+}
+
+void FeedHandler::addSymbol(const QByteArray& symbol, SymbolId id)
+{
+	m_symbolIds.insert(symbol, id);
+}
+
+void FeedHandler::setJournal(FeedJournal* journal)
+{
+	m_journal = journal;
+}
+
+void FeedHandler::onConnected()
+{
+	m_expectedSequence = 0;  // A new session restarts the batch sequence
+	m_lastMessageTime.store(MonotonicClock::now(), std::memory_order_relaxed);  // Silence is measured from here
+	m_heartbeatTimer->start();
+	emit connected();
+}
+
+void FeedHandler::onDisconnected()
+{
+	m_heartbeatTimer->stop();
+	emit disconnected();
+}
+
+void FeedHandler::onTextMessageReceived(const QString& message)
+{
+	m_frameReceiveTime = MonotonicClock::now();
+	m_framesReceived.fetch_add(1, std::memory_order_relaxed);
+	m_lastMessageTime.store(m_frameReceiveTime, std::memory_order_relaxed);
+
+	// Finnhub frames are plain ASCII, so narrow them into the reusable buffer
+	// instead of allocating a new QByteArray with toUtf8() for every message.
+	const int length = message.size();
+	m_frameBuffer.resize(length);
+	const QChar* src = message.constData();
+	char* dst = m_frameBuffer.data();
+	bool ascii = true;
+	for (int i = 0; i < length; ++i) {
+		const char16_t c = src[i].unicode();
+		if (c > 0x7F) {
+			ascii = false;
+			break;
+		}
+		dst[i] = static_cast<char>(c);
+	}
+
+	if (m_journal) {
+		// Tick files persist across runs, so they carry wall-clock receive times
+		const qint64 wallNanos = MonotonicClock::toWallNanos(m_frameReceiveTime);
+		if (ascii) {
+			m_journal->append(wallNanos, TickFilePayload::Text, m_frameBuffer.constData(), length);
+		}
+		else {
+			QByteArray utf8 = message.toUtf8();
+			m_journal->append(wallNanos, TickFilePayload::Text, utf8.constData(), static_cast<int>(utf8.size()));
+		}
+	}
+
+	if (!ascii || !processTradeFrame(m_frameBuffer)) {
+		// Unknown message types and non-ASCII payloads take the generic JSON path
+		processJsonMessage(message);
+	}
+
+	wakeConsumer();
+}
+
+void FeedHandler::onTextFrameReceived(const QByteArray& frame)
+{
+	// Straight from the transport's receive buffer: no QString round trip
+	m_frameReceiveTime = MonotonicClock::now();
+	m_framesReceived.fetch_add(1, std::memory_order_relaxed);
+	m_lastMessageTime.store(m_frameReceiveTime, std::memory_order_relaxed);
+
+	if (m_journal) {
+		m_journal->append(MonotonicClock::toWallNanos(m_frameReceiveTime), TickFilePayload::Text, frame.constData(), static_cast<int>(frame.size()));
+	}
+
+	if (!processTradeFrame(frame)) {
+		processJsonMessage(QString::fromUtf8(frame));
+	}
+
+	wakeConsumer();
+}
+
+void FeedHandler::onBinaryMessageReceived(const QByteArray& message)
+{
+	m_frameReceiveTime = MonotonicClock::now();
+	m_framesReceived.fetch_add(1, std::memory_order_relaxed);
+	m_lastMessageTime.store(m_frameReceiveTime, std::memory_order_relaxed);
+
+	if (m_journal) {
+		m_journal->append(MonotonicClock::toWallNanos(m_frameReceiveTime), TickFilePayload::Binary, message.constData(), static_cast<int>(message.size()));
+	}
+
+	processBinaryBatch(message);
+	wakeConsumer();
+}
+
+bool FeedHandler::processTradeFrame(const QByteArray& frame)
+{
+	FinnhubTradeParser parser(frame);
+
+	switch (parser.messageType()) {
+	case FinnhubMessageType::Ping:
+		return true;
+	case FinnhubMessageType::Trade:
+		break;
+	default:
+		return false;
+	}
+
+	FinnhubTrade trade;
+	while (parser.nextTrade(trade)) {
+		enqueueTrade(trade.symbol, trade.symbolLength, trade.price, trade.volume, trade.timestamp);
+	}
+
+	if (parser.hasError()) {
+		// Trades before the bad record are already queued, so do not replay
+		// the frame through the JSON path.
+		emit logMessage("[FEED] Malformed trade frame - remaining trades dropped");
+	}
+
+	return true;
+}
+
+void FeedHandler::processBinaryBatch(const QByteArray& message)
+{
+	BinaryFeedReader reader(message);
+	if (!reader.isValid()) {
+		emit logMessage(QString("[FEED] Dropped binary frame with bad header (%1 bytes)").arg(message.size()));
+		return;
+	}
+
+	if (m_expectedSequence != 0 && reader.sequence() != m_expectedSequence) {
+		m_sequenceGaps.fetch_add(1, std::memory_order_relaxed);
+		emit logMessage(QString("[FEED] Binary sequence gap: expected %1, got %2")
+			.arg(m_expectedSequence).arg(reader.sequence()));
+	}
+	m_expectedSequence = reader.sequence() + 1;
+
+	BinaryFeedRecord record;
+	while (reader.next(record)) {
+		if (record.type == BinaryFeedRecordType::Trade) {
+			enqueueTrade(record.symbol, record.symbolLength, record.price, record.volume, record.exchangeTime);
+		}
+		else {
+			enqueueQuote(record);
+		}
+	}
+
+	if (reader.hasError()) {
+		emit logMessage("[FEED] Truncated binary batch - remaining records dropped");
+	}
+}
+
+void FeedHandler::processJsonMessage(const QString& message)
+{
+	QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+	if (doc.isNull() || !doc.isObject()) {
+		return;
+	}
+
+	QJsonObject obj = doc.object();
+	QString type = obj["type"].toString();
+
+	// Handle Finnhub WebSocket response format
+	if (type == "ping") {
+		return;
+	}
+	else if (type == "trade") {
+		// Finnhub sends trade data in "data" array
+		QJsonArray dataArray = obj["data"].toArray();
+
+		for (const QJsonValue& val : dataArray) {
+			QJsonObject trade = val.toObject();
+
+			QByteArray symbol = trade["s"].toString().toUtf8();  // Symbol
+			double price = trade["p"].toDouble();    // Price
+			double volume = trade["v"].toDouble();   // Volume
+			qint64 timestamp = trade["t"].toVariant().toLongLong();  // Timestamp
+
+			enqueueTrade(symbol.constData(), static_cast<int>(symbol.size()), price, volume, timestamp);
+		}
+	}
+	else {
+		// Log unknown message types for debugging
+		emit logMessage(QString("[FEED] Unknown message type: %1").arg(type));
+	}
+}
+
+void FeedHandler::enqueueTrade(const char* symbol, int symbolLength, double price,
+	double volume, qint64 timestamp)
+{
+	SymbolId id = lookupSymbol(symbol, symbolLength);
+	if (id == InvalidSymbolId) {
+		return;  // Not subscribed
+	}
+
+	FeedTick tick;
+	tick.symbolId = id;
+	tick.type = FeedTickType::Trade;
+	tick.sourceId = m_sourceId;
+	tick.price = price;
+	tick.volume = volume;
+	tick.askPrice = 0.0;
+	tick.askVolume = 0.0;
+	tick.exchangeTime = timestamp;
+	tick.receiveTime = m_frameReceiveTime;
+	tick.parsedTime = MonotonicClock::now();
+	pushTick(tick);
+}
+
+void FeedHandler::enqueueQuote(const BinaryFeedRecord& quote)
+{
+	SymbolId id = lookupSymbol(quote.symbol, quote.symbolLength);
+	if (id == InvalidSymbolId) {
+		return;
+	}
+
+	FeedTick tick;
+	tick.symbolId = id;
+	tick.type = FeedTickType::Quote;
+	tick.sourceId = m_sourceId;
+	tick.price = quote.price;
+	tick.volume = quote.volume;
+	tick.askPrice = quote.askPrice;
+	tick.askVolume = quote.askVolume;
+	tick.exchangeTime = quote.exchangeTime;
+	tick.receiveTime = m_frameReceiveTime;
+	tick.parsedTime = MonotonicClock::now();
+	pushTick(tick);
+}
+
+SymbolId FeedHandler::lookupSymbol(const char* symbol, int symbolLength) const
+{
+	// fromRawData wraps the frame bytes without copying them
+	auto it = m_symbolIds.constFind(QByteArray::fromRawData(symbol, symbolLength));
+	return it == m_symbolIds.constEnd() ? InvalidSymbolId : it.value();
+}
+
+void FeedHandler::pushTick(const FeedTick& tick)
+{
+	if (!m_ring->tryPush(tick)) {
+		// GUI thread is behind - drop rather than block ingestion
+		m_ticksDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	m_ticksEnqueued.fetch_add(1, std::memory_order_relaxed);
+
+	LatencyMonitor::record(LatencyStage::ReceiveToParsed, tick.parsedTime - tick.receiveTime);
+	if (tick.exchangeTime > 0) {
+		LatencyMonitor::record(LatencyStage::ExchangeToReceive,
+			MonotonicClock::toWallNanos(tick.receiveTime) - tick.exchangeTime * 1000000);
+	}
+
+	const int depth = m_ring->size();
+	if (depth > m_highWaterMark.load(std::memory_order_relaxed)) {
+		m_highWaterMark.store(depth, std::memory_order_relaxed);
+	}
+}
+
+void FeedHandler::wakeConsumer()
+{
+	if (m_ring->isEmpty()) {
+		return;
+	}
+	if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+		emit ticksAvailable();
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <QObject>
+#include <QTimer>
+#include <QUrl>
+#include <QStringList>
+#include <QHash>
+#include <atomic>
+#include "WebSocketTransport.h"
+#include "SpscRing.h"
+#include "FinnhubTradeParser.h"
+#include "BinaryFeedProtocol.h"
+#include "FeedJournal.h"
+#include "SymbolTable.h"
+#include "MonotonicClock.h"
+#include "FeedTick.h"
+
+struct FeedQueueStats {
+	int depth;
+	int capacity;
+	int highWaterMark;
+	quint64 framesReceived;
+	quint64 ticksEnqueued;
+	quint64 ticksDropped;
+};
+
+// Lives on the MarketDataFeed worker thread. Owns the WebSocket transport,
+// decodes frames and pushes FeedTicks into the ring the GUI thread drains.
+class FeedHandler : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit FeedHandler(SpscRing<FeedTick>* ring, FeedSourceId sourceId = PrimaryFeedSource, QObject* parent = nullptr);
+
+	// Thread-safe statistics
+	quint64 framesReceived() const { return m_framesReceived.load(std::memory_order_relaxed); }
+	quint64 ticksEnqueued() const { return m_ticksEnqueued.load(std::memory_order_relaxed); }
+	quint64 ticksDropped() const { return m_ticksDropped.load(std::memory_order_relaxed); }
+	quint64 sequenceGaps() const { return m_sequenceGaps.load(std::memory_order_relaxed); }
+	int highWaterMark() const { return m_highWaterMark.load(std::memory_order_relaxed); }
+	qint64 lastMessageTime() const { return m_lastMessageTime.load(std::memory_order_relaxed); }  // MonotonicClock ns of the last frame or connect
+
+	// Called by the consumer before it drains, so pushes made during the
+	// drain raise a fresh ticksAvailable()
+	void acknowledgeTicks() { m_wakePending.store(false, std::memory_order_release); }
+
+	// Finnhub's {"type":type,"symbol":symbol} frame; the feed takes one symbol per frame
+	static QString subscriptionMessage(const QString& type, const QString& symbol);
+
+	WebSocketTransportKind transportKind() const { return m_transportKind; }
+
+public slots:
+	void open(const QUrl& url);
+	void close();
+	void sendTextMessage(const QString& message);
+	void sendTextMessages(const QStringList& messages);  // One hop for a batch of frames
+	void addSymbol(const QByteArray& symbol, SymbolId id);
+	void setJournal(FeedJournal* journal);  // nullptr stops capture
+	void setTransportKind(WebSocketTransportKind kind);  // Applies from the next open()
+
+signals:
+	void connected();
+	void disconnected();
+	void errorOccurred(const QString& error);
+	void ticksAvailable();
+	void logMessage(const QString& message);
+
+private slots:
+	void onConnected();
+	void onDisconnected();
+	void onTextMessageReceived(const QString& message);
+	void onTextFrameReceived(const QByteArray& frame);
+	void onBinaryMessageReceived(const QByteArray& message);
+
+private:
+	bool processTradeFrame(const QByteArray& frame);
+	void processJsonMessage(const QString& message);
+	void processBinaryBatch(const QByteArray& message);
+	void enqueueTrade(const char* symbol, int symbolLength, double price, double volume, qint64 timestamp);
+	void enqueueQuote(const BinaryFeedRecord& quote);
+	SymbolId lookupSymbol(const char* symbol, int symbolLength) const;
+	void pushTick(const FeedTick& tick);
+	void wakeConsumer();
+	void setTransport(WebSocketTransport* transport);
+
+private:
+	WebSocketTransport* m_transport;  // Created by open() for the preferred kind
+	WebSocketTransportKind m_transportKind;
+	QTimer* m_heartbeatTimer;
+	SpscRing<FeedTick>* m_ring;
+	QByteArray m_frameBuffer;  // Reused across frames to avoid per-message allocation
+	QHash<QByteArray, SymbolId> m_symbolIds;  // Feed-thread copy, so lookups take no lock
+	FeedJournal* m_journal;  // Not owned; only touched on the feed thread
+	FeedSourceId m_sourceId;
+
+	std::atomic<bool> m_wakePending;
+	std::atomic<quint64> m_framesReceived;
+	std::atomic<quint64> m_ticksEnqueued;
+	std::atomic<quint64> m_ticksDropped;
+	std::atomic<quint64> m_sequenceGaps;
+	std::atomic<int> m_highWaterMark;
+	std::atomic<qint64> m_lastMessageTime;
+	quint64 m_expectedSequence;  // Next binary batch sequence; 0 until the first batch
+	qint64 m_frameReceiveTime;   // Stamped once per frame, shared by all of its ticks
+};
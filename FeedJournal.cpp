@@ -0,0 +1,229 @@
+#include "FeedJournal.h"
+#include <QDir>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <cstring>
+
+FeedJournal::FeedJournal(const QString& directory, QObject* parent)
+	: QObject(parent)
+	, m_directory(directory)
+	, m_segmentSize(256LL * 1024 * 1024)
+	, m_rotationSeconds(15 * 60)
+	, m_mask(0)
+	, m_writePos(0)
+	, m_readPos(0)
+	, m_writer(nullptr)
+	, m_stopping(false)
+	, m_segmentUsed(0)
+	, m_segmentOpenedMs(0)
+	, m_segmentIndex(0)
+	, m_framesWritten(0)
+	, m_framesDropped(0)
+	, m_bytesWritten(0)
+{
+	setRingSize(32 * 1024 * 1024);
+}
+
+FeedJournal::~FeedJournal()
+{
+	stop();
+}
+
+void FeedJournal::setRingSize(int bytes)
+{
+	if (m_writer) {
+		return;
+	}
+
+	quint64 size = 4096;
+	while (size < static_cast<quint64>(bytes)) {
+		size <<= 1;
+	}
+	m_ring.assign(size, 0);
+	m_mask = size - 1;
+}
+
+bool FeedJournal::start()
+{
+	if (m_writer) {
+		return true;
+	}
+
+	if (!QDir().mkpath(m_directory)) {
+		emit logMessage(QString("[JOURNAL] Cannot create %1").arg(m_directory));
+		return false;
+	}
+
+	m_writePos.store(0, std::memory_order_relaxed);
+	m_readPos.store(0, std::memory_order_relaxed);
+	m_stopping.store(false, std::memory_order_relaxed);
+
+	m_writer = QThread::create([this]() { writerLoop(); });
+	m_writer->setObjectName("FeedJournal");
+	m_writer->start(QThread::LowPriority);
+
+	emit logMessage(QString("[JOURNAL] Capturing raw frames to %1").arg(m_directory));
+	return true;
+}
+
+void FeedJournal::stop()
+{
+	if (!m_writer) {
+		return;
+	}
+
+	m_stopping.store(true, std::memory_order_release);
+	m_writer->wait();
+	delete m_writer;
+	m_writer = nullptr;
+
+	emit logMessage(QString("[JOURNAL] Stopped: %1 frames (%2 MB) written, %3 dropped")
+		.arg(framesWritten())
+		.arg(bytesWritten() / (1024.0 * 1024.0), 0, 'f', 1)
+		.arg(framesDropped()));
+}
+
+bool FeedJournal::append(qint64 receiveTimeNs, TickFilePayload kind, const char* data, int length)
+{
+	const quint64 recordSize = TickFile::RecordHeaderSize + static_cast<quint64>(length);
+	const quint64 write = m_writePos.load(std::memory_order_relaxed);
+	const quint64 read = m_readPos.load(std::memory_order_acquire);
+
+	if (recordSize > m_ring.size() - (write - read)) {
+		// Writer is behind (slow disk) - losing capture beats stalling the feed
+		m_framesDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	char header[TickFile::RecordHeaderSize];
+	TickFile::writeRecordHeader(header, receiveTimeNs, static_cast<quint32>(length), static_cast<quint8>(kind));
+	copyIn(write, header, TickFile::RecordHeaderSize);
+	copyIn(write + TickFile::RecordHeaderSize, data, length);
+
+	m_writePos.store(write + recordSize, std::memory_order_release);
+	return true;
+}
+
+QString FeedJournal::currentSegment() const
+{
+	QMutexLocker locker(&m_segmentMutex);
+	return m_segmentName;
+}
+
+void FeedJournal::writerLoop()
+{
+	if (!openSegment()) {
+		return;
+	}
+
+	for (;;) {
+		const quint64 read = m_readPos.load(std::memory_order_relaxed);
+		const quint64 write = m_writePos.load(std::memory_order_acquire);
+
+		if (read == write) {
+			// The feed stops appending before stop() is called, so empty means done
+			if (m_stopping.load(std::memory_order_acquire)) {
+				break;
+			}
+			m_segment.flush();
+			if (QDateTime::currentMSecsSinceEpoch() - m_segmentOpenedMs >= m_rotationSeconds * 1000LL &&
+				m_segmentUsed > TickFile::FileHeaderSize) {
+				closeSegment();
+				if (!openSegment()) {
+					return;
+				}
+			}
+			QThread::msleep(2);
+			continue;
+		}
+
+		char header[TickFile::RecordHeaderSize];
+		copyOut(read, header, TickFile::RecordHeaderSize);
+		const quint32 length = qFromLittleEndian<quint32>(header + 8);
+		const qint64 recordSize = TickFile::RecordHeaderSize + static_cast<qint64>(length);
+
+		const bool full = m_segmentUsed + recordSize > m_segmentSize && m_segmentUsed > TickFile::FileHeaderSize;
+		const bool expired = QDateTime::currentMSecsSinceEpoch() - m_segmentOpenedMs >= m_rotationSeconds * 1000LL;
+		if (full || expired) {
+			closeSegment();
+			if (!openSegment()) {
+				return;
+			}
+		}
+
+		if (m_scratch.size() < static_cast<size_t>(recordSize)) {
+			m_scratch.resize(recordSize);
+		}
+		copyOut(read, m_scratch.data(), static_cast<int>(recordSize));
+		m_readPos.store(read + recordSize, std::memory_order_release);
+
+		if (m_segment.write(m_scratch.data(), recordSize) != recordSize) {
+			emit logMessage(QString("[JOURNAL] Write to %1 failed: %2")
+				.arg(m_segment.fileName(), m_segment.errorString()));
+			closeSegment();
+			return;
+		}
+		m_segmentUsed += recordSize;
+		m_framesWritten.fetch_add(1, std::memory_order_relaxed);
+		m_bytesWritten.fetch_add(recordSize, std::memory_order_relaxed);
+	}
+
+	closeSegment();
+}
+
+bool FeedJournal::openSegment()
+{
+	const QDateTime now = QDateTime::currentDateTime();
+	QString name = QDir(m_directory).filePath(QString("feed-%1-%2.ltf")
+		.arg(now.toString("yyyyMMdd-hhmmss"))
+		.arg(m_segmentIndex++, 4, 10, QChar('0')));
+
+	m_segment.setFileName(name);
+	if (!m_segment.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+		emit logMessage(QString("[JOURNAL] Cannot open %1: %2").arg(name, m_segment.errorString()));
+		return false;
+	}
+
+	// Reserve the whole segment up front so appends never grow the file;
+	// the zeroed tail reads as end-of-file until it is written.
+	m_segment.resize(m_segmentSize);
+
+	char header[TickFile::FileHeaderSize];
+	TickFile::writeFileHeader(header, now.toMSecsSinceEpoch() * 1000000);
+	m_segment.write(header, sizeof(header));
+	m_segmentUsed = TickFile::FileHeaderSize;
+	m_segmentOpenedMs = now.toMSecsSinceEpoch();
+
+	QMutexLocker locker(&m_segmentMutex);
+	m_segmentName = name;
+	return true;
+}
+
+void FeedJournal::closeSegment()
+{
+	if (!m_segment.isOpen()) {
+		return;
+	}
+
+	// Give back the unused part of the preallocation
+	m_segment.flush();
+	m_segment.resize(m_segmentUsed);
+	m_segment.close();
+}
+
+void FeedJournal::copyIn(quint64 position, const char* data, int length)
+{
+	const quint64 offset = position & m_mask;
+	const quint64 first = qMin<quint64>(length, m_ring.size() - offset);
+	std::memcpy(m_ring.data() + offset, data, first);
+	std::memcpy(m_ring.data(), data + first, length - first);
+}
+
+void FeedJournal::copyOut(quint64 position, char* data, int length) const
+{
+	const quint64 offset = position & m_mask;
+	const quint64 first = qMin<quint64>(length, m_ring.size() - offset);
+	std::memcpy(data, m_ring.data() + offset, first);
+	std::memcpy(data + first, m_ring.data(), length - first);
+}
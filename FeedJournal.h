@@ -0,0 +1,78 @@
+#pragma once
+#include <QObject>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QString>
+#include <atomic>
+#include <vector>
+#include "TickFile.h"
+
+// Append-only capture of every raw frame the feed receives. The feed thread
+// copies frames into a byte ring and never waits; a background writer
+// drains the ring into preallocated segment files in TickFile format, so a
+// segment can be replayed directly by ReplayFeed.
+class FeedJournal : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit FeedJournal(const QString& directory, QObject* parent = nullptr);
+	~FeedJournal();
+
+	// Configuration - set before start()
+	void setSegmentSize(qint64 bytes) { m_segmentSize = bytes; }          // Default 256 MB
+	void setRotationInterval(int seconds) { m_rotationSeconds = seconds; } // Default 15 min
+	void setRingSize(int bytes);                                          // Default 32 MB
+
+	bool start();
+	void stop();  // Drains what is buffered, then closes the segment
+	bool isRunning() const { return m_writer != nullptr; }
+
+	// Producer side - one thread only. Returns false (and counts a drop)
+	// when the ring is full.
+	bool append(qint64 receiveTimeNs, TickFilePayload kind, const char* data, int length);
+
+	// Thread-safe statistics
+	quint64 framesWritten() const { return m_framesWritten.load(std::memory_order_relaxed); }
+	quint64 framesDropped() const { return m_framesDropped.load(std::memory_order_relaxed); }
+	quint64 bytesWritten() const { return m_bytesWritten.load(std::memory_order_relaxed); }
+	QString currentSegment() const;
+
+signals:
+	void logMessage(const QString& message);
+
+private:
+	void writerLoop();
+	bool openSegment();
+	void closeSegment();
+	void copyIn(quint64 position, const char* data, int length);
+	void copyOut(quint64 position, char* data, int length) const;
+
+private:
+	QString m_directory;
+	qint64 m_segmentSize;
+	int m_rotationSeconds;
+
+	// Byte ring; positions are running byte counts, masked on access
+	std::vector<char> m_ring;
+	quint64 m_mask;
+	alignas(64) std::atomic<quint64> m_writePos;
+	alignas(64) std::atomic<quint64> m_readPos;
+
+	QThread* m_writer;
+	std::atomic<bool> m_stopping;
+
+	// Writer thread state
+	QFile m_segment;
+	qint64 m_segmentUsed;
+	qint64 m_segmentOpenedMs;
+	int m_segmentIndex;
+	std::vector<char> m_scratch;
+	mutable QMutex m_segmentMutex;  // Guards m_segmentName
+	QString m_segmentName;
+
+	std::atomic<quint64> m_framesWritten;
+	std::atomic<quint64> m_framesDropped;
+	std::atomic<quint64> m_bytesWritten;
+};
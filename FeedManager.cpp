@@ -0,0 +1,392 @@
+#include "FeedManager.h"
+#include <QFileInfo>
+
+FeedManager::FeedManager(QThread* ioThread, QObject* parent)
+	: QObject(parent)
+	, m_ioThread(ioThread)
+	, m_transportKind(WebSocketTransportKind::Qt)
+	, m_discoveringSources(0)
+{
+}
+
+FeedManager::~FeedManager()
+{
+	removeAllSessions();
+}
+
+FeedSourceId FeedManager::addWebSocketSession(const QString& name, const QUrl& url)
+{
+	Session* session = createSession(name, FeedSessionKind::WebSocket, url.toDisplayString(QUrl::RemoveQuery));
+	if (!session) {
+		return InvalidFeedSource;
+	}
+
+	session->ring.reset(new SpscRing<FeedTick>(65536));
+	FeedHandler* handler = new FeedHandler(session->ring.get(), session->sourceId);
+	handler->setTransportKind(m_transportKind);
+	handler->moveToThread(m_ioThread);
+	session->handler = handler;
+
+	const FeedSourceId sourceId = session->sourceId;
+	connect(handler, &FeedHandler::ticksAvailable, this, &FeedManager::ticksAvailable);
+	connect(handler, &FeedHandler::logMessage, this, &FeedManager::logMessage);
+	connect(handler, &FeedHandler::connected, this, [this, sourceId, handler]() {
+		Session* session = findSession(sourceId);
+		if (!session) {
+			return;
+		}
+		session->connected = true;
+		QStringList messages;
+		messages.reserve(m_symbols.size());
+		for (auto it = m_symbols.constBegin(); it != m_symbols.constEnd(); ++it) {
+			messages.append(FeedHandler::subscriptionMessage("subscribe", it.key()));
+		}
+		QMetaObject::invokeMethod(handler, [handler, messages]() {
+			handler->sendTextMessages(messages);
+			}, Qt::QueuedConnection);
+		emit logMessage(QString("[FEEDMGR] %1 connected, %2 symbols subscribed")
+			.arg(session->name).arg(m_symbols.size()));
+		emit sessionsChanged();
+		});
+	connect(handler, &FeedHandler::disconnected, this, [this, sourceId]() {
+		if (Session* session = findSession(sourceId)) {
+			session->connected = false;
+			emit logMessage(QString("[FEEDMGR] %1 disconnected").arg(session->name));
+			emit sessionsChanged();
+		}
+		});
+	connect(handler, &FeedHandler::errorOccurred, this, [this, sourceId](const QString& error) {
+		if (Session* session = findSession(sourceId)) {
+			emit logMessage(QString("[FEEDMGR] %1 error: %2").arg(session->name, error));
+		}
+		});
+
+	// Queued in order, so the symbol map is complete before the first frame
+	for (auto it = m_symbols.constBegin(); it != m_symbols.constEnd(); ++it) {
+		QByteArray utf8 = it.key().toUtf8();
+		SymbolId id = it.value();
+		QMetaObject::invokeMethod(handler, [handler, utf8, id]() {
+			handler->addSymbol(utf8, id);
+			}, Qt::QueuedConnection);
+	}
+	QMetaObject::invokeMethod(handler, [handler, url]() {
+		handler->open(url);
+		}, Qt::QueuedConnection);
+
+	emit sessionAdded(sourceId);
+	rebuildRings();
+	emit logMessage(QString("[FEEDMGR] Session %1 (source %2) connecting to %3")
+		.arg(session->name).arg(sourceId).arg(session->target));
+	emit sessionsChanged();
+	return sourceId;
+}
+
+FeedSourceId FeedManager::addReplaySession(const QString& name, const QString& path, double speed)
+{
+	Session* session = createSession(name, FeedSessionKind::Replay, QFileInfo(path).fileName());
+	if (!session) {
+		return InvalidFeedSource;
+	}
+
+	session->ring.reset(new SpscRing<FeedTick>(65536));
+	ReplayFeed* replay = new ReplayFeed(session->ring.get(), session->sourceId);
+	replay->moveToThread(m_ioThread);
+	session->replay = replay;
+
+	const FeedSourceId sourceId = session->sourceId;
+	connect(replay, &ReplayFeed::ticksAvailable, this, &FeedManager::ticksAvailable);
+	connect(replay, &ReplayFeed::logMessage, this, &FeedManager::logMessage);
+	connect(replay, &ReplayFeed::started, this, [this, sourceId](const QStringList& symbols) {
+		if (Session* session = findSession(sourceId)) {
+			session->connected = true;
+			emit symbolsDiscovered(symbols);
+			emit sessionsChanged();
+		}
+		});
+	connect(replay, &ReplayFeed::finished, this, [this, sourceId](const QString& summary) {
+		if (Session* session = findSession(sourceId)) {
+			session->connected = false;
+			emit logMessage(QString("[FEEDMGR] %1: %2").arg(session->name, summary));
+			emit sessionsChanged();
+		}
+		});
+
+	QMetaObject::invokeMethod(replay, [replay, path, speed]() {
+		replay->start(path, speed);
+		}, Qt::QueuedConnection);
+
+	emit sessionAdded(sourceId);
+	rebuildRings();
+	emit sessionsChanged();
+	return sourceId;
+}
+
+FeedSourceId FeedManager::addSyntheticSession(const QString& name, SyntheticGeneratorConfig config)
+{
+	Session* session = createSession(name, FeedSessionKind::Synthetic,
+		QString("%1 symbols").arg(config.symbols.size()));
+	if (!session) {
+		return InvalidFeedSource;
+	}
+
+	QStringList symbols;
+	for (const SyntheticSymbolConfig& symbol : config.symbols) {
+		symbols.append(symbol.symbol);
+	}
+	emit symbolsDiscovered(symbols);
+
+	session->generator = new SyntheticMarketGenerator(this);
+	connect(session->generator, &SyntheticMarketGenerator::ticksAvailable, this, &FeedManager::ticksAvailable);
+	config.sourceId = session->sourceId;
+	session->generator->start(config);
+	session->connected = true;
+
+	emit sessionAdded(session->sourceId);
+	rebuildRings();
+	emit logMessage(QString("[FEEDMGR] Session %1 (source %2) generating %3 symbols")
+		.arg(session->name).arg(session->sourceId).arg(symbols.size()));
+	emit sessionsChanged();
+	return session->sourceId;
+}
+
+FeedSourceId FeedManager::addMulticastSession(const QString& name, const MulticastFeedConfig& config)
+{
+	Session* session = createSession(name, FeedSessionKind::Multicast, QString("%1:%2").arg(config.group).arg(config.port));
+	if (!session) {
+		return InvalidFeedSource;
+	}
+
+	session->ring.reset(new SpscRing<FeedTick>(65536));
+	MulticastFeedHandler* multicast = new MulticastFeedHandler(session->ring.get(), session->sourceId, this);
+	session->multicast = multicast;
+	connect(multicast, &MulticastFeedHandler::ticksAvailable, this, &FeedManager::ticksAvailable);
+	connect(multicast, &MulticastFeedHandler::symbolsDiscovered, this, &FeedManager::symbolsDiscovered);
+	connect(multicast, &MulticastFeedHandler::logMessage, this, &FeedManager::logMessage);
+
+	const FeedSourceId sourceId = session->sourceId;
+	emit sessionAdded(sourceId);
+	rebuildRings();  // Before the receive thread can push
+	if (!multicast->start(config)) {
+		removeSession(sourceId);
+		return InvalidFeedSource;
+	}
+	session->connected = true;
+	emit logMessage(QString("[FEEDMGR] Session %1 (source %2) receiving %3")
+		.arg(session->name).arg(sourceId).arg(session->target));
+	emit sessionsChanged();
+	return sourceId;
+}
+
+void FeedManager::removeSession(FeedSourceId sourceId)
+{
+	for (int i = 0; i < m_sessions.size(); ++i) {
+		std::shared_ptr<Session> session = m_sessions[i];
+		if (session->sourceId != sourceId) {
+			continue;
+		}
+
+		// Stop the producer before its ring goes away
+		if (session->handler) {
+			QMetaObject::invokeMethod(session->handler, &FeedHandler::close, Qt::BlockingQueuedConnection);
+			session->handler->deleteLater();
+		}
+		if (session->replay) {
+			session->replay->requestStop();
+			QMetaObject::invokeMethod(session->replay, &ReplayFeed::cancel, Qt::BlockingQueuedConnection);
+			session->replay->deleteLater();
+		}
+		if (session->generator) {
+			session->generator->stop();
+			delete session->generator;
+		}
+		if (session->multicast) {
+			session->multicast->stop();
+			delete session->multicast;
+		}
+
+		m_sessions.remove(i);
+		rebuildRings();
+		emit logMessage(QString("[FEEDMGR] Session %1 removed").arg(session->name));
+		emit sessionsChanged();
+		return;
+	}
+}
+
+void FeedManager::removeAllSessions()
+{
+	while (!m_sessions.isEmpty()) {
+		removeSession(m_sessions.constLast()->sourceId);
+	}
+}
+
+QVector<FeedSessionInfo> FeedManager::sessions() const
+{
+	QVector<FeedSessionInfo> result;
+	result.reserve(m_sessions.size());
+	for (const std::shared_ptr<Session>& session : m_sessions) {
+		FeedSessionInfo info;
+		info.sourceId = session->sourceId;
+		info.name = session->name;
+		info.kind = session->kind;
+		info.target = session->target;
+		info.connected = session->connected;
+		info.framesReceived = 0;
+		info.ticksDropped = 0;
+		info.sequenceGaps = 0;
+		if (session->handler) {
+			info.framesReceived = session->handler->framesReceived();
+			info.ticksDropped = session->handler->ticksDropped();
+			info.sequenceGaps = session->handler->sequenceGaps();
+		}
+		else if (session->replay) {
+			info.framesReceived = session->replay->stats().ticksReplayed;
+		}
+		else if (session->generator) {
+			info.framesReceived = session->generator->eventsGenerated();
+		}
+		else if (session->multicast) {
+			const MulticastFeedStats stats = session->multicast->stats();
+			info.framesReceived = stats.packets;
+			info.ticksDropped = stats.ticksDropped;
+			info.sequenceGaps = stats.sequence.gaps;
+		}
+		result.append(info);
+	}
+	return result;
+}
+
+QString FeedManager::sessionName(FeedSourceId sourceId) const
+{
+	Session* session = findSession(sourceId);
+	return session ? session->name : QString();
+}
+
+void FeedManager::setTransportKind(WebSocketTransportKind kind)
+{
+	m_transportKind = kind;
+	for (const std::shared_ptr<Session>& session : m_sessions) {
+		if (FeedHandler* handler = session->handler) {
+			QMetaObject::invokeMethod(handler, [handler, kind]() {
+				handler->setTransportKind(kind);
+				}, Qt::QueuedConnection);
+		}
+	}
+}
+
+void FeedManager::addSymbol(const QString& symbol, SymbolId id)
+{
+	if (m_symbols.contains(symbol)) {
+		return;
+	}
+	m_symbols.insert(symbol, id);
+
+	QByteArray utf8 = symbol.toUtf8();
+	for (const std::shared_ptr<Session>& session : m_sessions) {
+		FeedHandler* handler = session->handler;
+		if (!handler) {
+			continue;
+		}
+		QMetaObject::invokeMethod(handler, [handler, utf8, id]() {
+			handler->addSymbol(utf8, id);
+			}, Qt::QueuedConnection);
+		if (session->connected) {
+			sendSubscription(handler, "subscribe", symbol);
+		}
+	}
+}
+
+void FeedManager::removeSymbol(const QString& symbol)
+{
+	if (!m_symbols.remove(symbol)) {
+		return;
+	}
+	for (const std::shared_ptr<Session>& session : m_sessions) {
+		if (session->handler && session->connected) {
+			sendSubscription(session->handler, "unsubscribe", symbol);
+		}
+	}
+}
+
+void FeedManager::acknowledgeTicks()
+{
+	for (const std::shared_ptr<Session>& session : m_sessions) {
+		if (session->handler) {
+			session->handler->acknowledgeTicks();
+		}
+		else if (session->replay) {
+			session->replay->acknowledgeTicks();
+		}
+		else if (session->generator) {
+			session->generator->acknowledgeTicks();
+		}
+		else if (session->multicast) {
+			session->multicast->acknowledgeTicks();
+		}
+	}
+}
+
+FeedManager::Session* FeedManager::createSession(const QString& name, FeedSessionKind kind, const QString& target)
+{
+	// Lowest free source ID above the built-in sources
+	FeedSourceId sourceId = InvalidFeedSource;
+	for (int id = FirstSessionSource; id < MaxFeedSources && sourceId == InvalidFeedSource; ++id) {
+		if (!findSession(static_cast<FeedSourceId>(id))) {
+			sourceId = static_cast<FeedSourceId>(id);
+		}
+	}
+	if (sourceId == InvalidFeedSource) {
+		emit logMessage(QString("[FEEDMGR] Cannot add %1: all %2 session slots in use")
+			.arg(name).arg(MaxFeedSources - FirstSessionSource));
+		return nullptr;
+	}
+
+	std::shared_ptr<Session> session = std::make_shared<Session>();
+	session->sourceId = sourceId;
+	session->name = name.isEmpty() ? QString("Session %1").arg(sourceId) : name;
+	session->kind = kind;
+	session->target = target;
+	session->connected = false;
+	session->handler = nullptr;
+	session->replay = nullptr;
+	session->generator = nullptr;
+	session->multicast = nullptr;
+	m_sessions.append(session);
+	return session.get();
+}
+
+FeedManager::Session* FeedManager::findSession(FeedSourceId sourceId) const
+{
+	for (const std::shared_ptr<Session>& session : m_sessions) {
+		if (session->sourceId == sourceId) {
+			return session.get();
+		}
+	}
+	return nullptr;
+}
+
+void FeedManager::sendSubscription(FeedHandler* handler, const QString& type, const QString& symbol)
+{
+	QString message = FeedHandler::subscriptionMessage(type, symbol);
+	QMetaObject::invokeMethod(handler, [handler, message]() {
+		handler->sendTextMessage(message);
+		}, Qt::QueuedConnection);
+}
+
+void FeedManager::rebuildRings()
+{
+	m_rings.clear();
+	m_discoveringSources = 0;
+	for (const std::shared_ptr<Session>& session : m_sessions) {
+		if (session->multicast) {
+			m_discoveringSources |= 1u << session->sourceId;
+		}
+		if (session->ring) {
+			m_rings.append(session->ring.get());
+		}
+		else if (session->generator) {
+			for (int i = 0; i < session->generator->ringCount(); ++i) {
+				m_rings.append(session->generator->ring(i));
+			}
+		}
+	}
+}
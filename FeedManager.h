@@ -0,0 +1,107 @@
+#pragma once
+#include <QObject>
+#include <QThread>
+#include <QUrl>
+#include <QHash>
+#include <QStringList>
+#include <memory>
+#include "FeedHandler.h"
+#include "ReplayFeed.h"
+#include "SyntheticMarketGenerator.h"
+#include "MulticastFeedHandler.h"
+
+enum class FeedSessionKind {
+	WebSocket,  // Finnhub JSON or local binary
+	Replay,
+	Synthetic,
+	Multicast   // Binary batches over UDP, one per datagram
+};
+
+struct FeedSessionInfo {
+	FeedSourceId sourceId;
+	QString name;
+	FeedSessionKind kind;
+	QString target;          // URL, file path or symbol count
+	bool connected;
+	quint64 framesReceived;  // Frames, replayed ticks or generated events
+	quint64 ticksDropped;    // Ring overflow
+	quint64 sequenceGaps;    // Binary batch sequence gaps
+};
+
+// Runs additional market data sessions next to MarketDataFeed's primary
+// source. Every session stamps its own FeedSourceId on the ticks it
+// produces and fills its own ring, so each ring keeps a single producer;
+// WebSocket and replay sessions share the feed I/O thread. Arbitration
+// between sessions happens on the consumer side (see FeedArbiter).
+class FeedManager : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit FeedManager(QThread* ioThread, QObject* parent = nullptr);
+	~FeedManager();
+
+	// Return the new session's source ID, or InvalidFeedSource if all are in use
+	FeedSourceId addWebSocketSession(const QString& name, const QUrl& url);
+	FeedSourceId addReplaySession(const QString& name, const QString& path, double speed);
+	FeedSourceId addSyntheticSession(const QString& name, SyntheticGeneratorConfig config);
+	FeedSourceId addMulticastSession(const QString& name, const MulticastFeedConfig& config);
+	void removeSession(FeedSourceId sourceId);
+	void removeAllSessions();  // Must run while the I/O thread is still up
+
+	bool isEmpty() const { return m_sessions.isEmpty(); }
+	QVector<FeedSessionInfo> sessions() const;
+	QString sessionName(FeedSourceId sourceId) const;
+
+	// Socket backend for WebSocket sessions; applies from each session's next connect
+	void setTransportKind(WebSocketTransportKind kind);
+	WebSocketTransportKind transportKind() const { return m_transportKind; }
+
+	// Symbols WebSocket sessions subscribe to and decode
+	void addSymbol(const QString& symbol, SymbolId id);
+	void removeSymbol(const QString& symbol);
+
+	// Consumer side (GUI thread)
+	int ringCount() const { return static_cast<int>(m_rings.size()); }
+	SpscRing<FeedTick>* ring(int index) const { return m_rings[index]; }
+	void acknowledgeTicks();
+
+	// Sources, as a bit per FeedSourceId, whose symbols are read off the wire
+	// rather than subscribed; their ticks can name a symbol before
+	// symbolsDiscovered() announces it
+	quint32 discoveringSources() const { return m_discoveringSources; }
+
+signals:
+	void ticksAvailable();
+	void sessionAdded(FeedSourceId sourceId);
+	void sessionsChanged();
+	void symbolsDiscovered(const QStringList& symbols);  // Replay, synthetic and multicast sessions
+	void logMessage(const QString& message);
+
+private:
+	struct Session {
+		FeedSourceId sourceId;
+		QString name;
+		FeedSessionKind kind;
+		QString target;
+		bool connected;
+		std::unique_ptr<SpscRing<FeedTick>> ring;  // WebSocket and replay; generators own theirs
+		FeedHandler* handler;
+		ReplayFeed* replay;
+		SyntheticMarketGenerator* generator;
+		MulticastFeedHandler* multicast;  // Runs its own receive thread
+	};
+
+	Session* createSession(const QString& name, FeedSessionKind kind, const QString& target);
+	Session* findSession(FeedSourceId sourceId) const;
+	void sendSubscription(FeedHandler* handler, const QString& type, const QString& symbol);
+	void rebuildRings();
+
+private:
+	QThread* m_ioThread;
+	QVector<std::shared_ptr<Session>> m_sessions;
+	QVector<SpscRing<FeedTick>*> m_rings;  // Flattened over all sessions, for draining
+	QHash<QString, SymbolId> m_symbols;
+	WebSocketTransportKind m_transportKind;
+	quint32 m_discoveringSources;
+};
@@ -0,0 +1,128 @@
+#include "FeedRecovery.h"
+#include "MonotonicClock.h"
+#include <QRandomGenerator>
+
+FeedRecovery::FeedRecovery(QObject* parent)
+	: QObject(parent)
+	, m_state(RecoveryState::Idle)
+	, m_enteredAt(MonotonicClock::now())
+	, m_outageStart(0)
+	, m_attempt(0)
+	, m_initialBackoff(500)
+	, m_maxBackoff(60000)
+	, m_retryTimer(new QTimer(this))
+{
+	m_retryTimer->setSingleShot(true);
+	connect(m_retryTimer, &QTimer::timeout, this, [this]() {
+		if (m_state != RecoveryState::Backoff) {
+			return;
+		}
+		m_attempt++;
+		transition(RecoveryState::Connecting, QString("attempt %1").arg(m_attempt));
+		emit reconnectDue();
+		});
+}
+
+void FeedRecovery::setBackoff(int initialMs, int maxMs)
+{
+	m_initialBackoff = qMax(1, initialMs);
+	m_maxBackoff = qMax(m_initialBackoff, maxMs);
+}
+
+void FeedRecovery::start()
+{
+	m_retryTimer->stop();
+	m_outageStart = 0;
+	m_attempt = 0;
+	transition(RecoveryState::Connecting);
+}
+
+void FeedRecovery::stop()
+{
+	m_retryTimer->stop();
+	m_outageStart = 0;
+	m_attempt = 0;
+	transition(RecoveryState::Idle);
+}
+
+void FeedRecovery::onConnected()
+{
+	if (m_state != RecoveryState::Connecting) {
+		return;
+	}
+	transition(RecoveryState::Resubscribing);
+}
+
+void FeedRecovery::onResubscribed()
+{
+	if (m_state != RecoveryState::Resubscribing) {
+		return;
+	}
+	transition(RecoveryState::Live);
+
+	if (m_outageStart != 0) {
+		const qint64 blind = MonotonicClock::now() - m_outageStart;
+		const int attempts = m_attempt;
+		m_outageStart = 0;
+		m_attempt = 0;
+		emit outageEnded(blind, attempts);
+	}
+}
+
+void FeedRecovery::onLinkLost(const QString& reason)
+{
+	// Errors are usually followed by a disconnect; only the first one counts
+	if (m_state == RecoveryState::Idle || m_state == RecoveryState::Backoff) {
+		return;
+	}
+
+	if (m_outageStart == 0) {
+		m_outageStart = MonotonicClock::now();
+	}
+
+	const int delay = backoffDelay();
+	m_retryTimer->start(delay);
+	transition(RecoveryState::Backoff, QString("%1; retry in %2 ms").arg(reason).arg(delay));
+}
+
+int FeedRecovery::backoffDelay() const
+{
+	// Exponential in the attempt count, with jitter so many clients do not retry in lockstep
+	const int shift = qMin(m_attempt, 16);
+	const qint64 base = qMin<qint64>(m_maxBackoff, static_cast<qint64>(m_initialBackoff) << shift);
+	return static_cast<int>(base + QRandomGenerator::global()->bounded(static_cast<int>(base / 2) + 1));
+}
+
+void FeedRecovery::transition(RecoveryState state, const QString& detail)
+{
+	const qint64 now = MonotonicClock::now();
+	const RecoveryState previous = m_state;
+	const qint64 elapsed = now - m_enteredAt;
+	m_state = state;
+	m_enteredAt = now;
+
+	if (previous == state && detail.isEmpty()) {
+		return;
+	}
+
+	QString message = QString("[RECOVERY] %1 -> %2 after %3 ms")
+		.arg(stateToString(previous), stateToString(state))
+		.arg(elapsed / 1000000);
+	if (!detail.isEmpty()) {
+		message += QString(" (%1)").arg(detail);
+	}
+	emit logMessage(message);
+	emit stateChanged(state, previous, elapsed);
+}
+
+QString FeedRecovery::stateToString(RecoveryState state)
+{
+	switch (state) {
+	case RecoveryState::Idle: return "Idle";
+	case RecoveryState::Connecting: return "Connecting";
+	case RecoveryState::Resubscribing: return "Resubscribing";
+	case RecoveryState::Live: return "Live";
+	case RecoveryState::Backoff: return "Backoff";
+	default: return "Unknown";
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <QObject>
+#include <QTimer>
+#include <QString>
+
+enum class RecoveryState {
+	Idle,          // Not trying to be connected
+	Connecting,    // Socket open in progress
+	Resubscribing, // Connected, subscriptions going out in batches
+	Live,
+	Backoff        // Link lost, waiting for the next attempt
+};
+
+// Reconnect state machine for the primary feed. Owns the backoff timer and
+// times every transition; MarketDataFeed performs the actions (opening the
+// socket, resubscribing, refreshing snapshots) and reports back.
+class FeedRecovery : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit FeedRecovery(QObject* parent = nullptr);
+
+	// First retry after initialMs, doubling up to maxMs, plus up to 50% jitter
+	void setBackoff(int initialMs, int maxMs);
+
+	RecoveryState state() const { return m_state; }
+	int attempt() const { return m_attempt; }
+	bool inOutage() const { return m_outageStart != 0; }
+	qint64 outageStart() const { return m_outageStart; }  // MonotonicClock ns, 0 when not in an outage
+	int nextAttemptInMs() const { return m_retryTimer->remainingTime(); }
+
+	void start();
+	void stop();
+	void onConnected();
+	void onResubscribed();
+	void onLinkLost(const QString& reason);
+
+	static QString stateToString(RecoveryState state);
+
+signals:
+	void reconnectDue();
+	void stateChanged(RecoveryState state, RecoveryState previous, qint64 nanosInPrevious);
+	void outageEnded(qint64 blindNanos, int attempts);
+	void logMessage(const QString& message);
+
+private:
+	void transition(RecoveryState state, const QString& detail = QString());
+	int backoffDelay() const;
+
+private:
+	RecoveryState m_state;
+	qint64 m_enteredAt;    // MonotonicClock ns the current state began
+	qint64 m_outageStart;  // When the link was lost
+	int m_attempt;         // Reconnect attempts in the current outage
+	int m_initialBackoff;
+	int m_maxBackoff;
+	QTimer* m_retryTimer;
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <QtGlobal>
+#include "SymbolTable.h"
+
+// Which session produced a tick. The first few are MarketDataFeed's
+// built-in sources; FeedManager hands out the rest.
+typedef quint8 FeedSourceId;
+const FeedSourceId PrimaryFeedSource = 0;    // MarketDataFeed's WebSocket (Finnhub or local binary)
+const FeedSourceId ReplayFeedSource = 1;     // MarketDataFeed's tick file replay
+const FeedSourceId SyntheticFeedSource = 2;  // Simulation mode and load tests
+const FeedSourceId FirstSessionSource = 3;
+const FeedSourceId InvalidFeedSource = 0xFF;
+const int MaxFeedSources = 16;
+
+enum class FeedTickType : quint8 {
+	Trade,
+	Quote
+};
+
+// Normalized trade/quote record. Every source - WebSocket JSON or binary, UDP multicast,
+// replay, synthetic - decodes into this before handing ticks to the GUI thread.
+struct FeedTick {
+	SymbolId symbolId;
+	FeedTickType type;
+	FeedSourceId sourceId;
+	double price;         // Trade price, or bid for quotes
+	double volume;        // Trade size, or bid size for quotes
+	double askPrice;      // Quotes only
+	double askVolume;     // Quotes only
+	qint64 exchangeTime;  // ms since epoch, as sent by the exchange
+	qint64 receiveTime;   // MonotonicClock ns when the frame reached this process
+	qint64 parsedTime;    // MonotonicClock ns when the tick was decoded
+};
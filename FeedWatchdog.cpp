@@ -0,0 +1,214 @@
+#include "FeedWatchdog.h"
+#include "MonotonicClock.h"
+
+namespace {
+	const qint64 RateIntervalNanos = 1000000000;
+	const int WarmupIntervals = 30;       // Non-empty seconds before a baseline is trusted
+	const double BaselineAlpha = 0.02;    // Roughly a minute of memory
+	const double AlertRatio = 0.25;       // Alert below a quarter of the baseline...
+	const int AlertAfterIntervals = 5;    // ...for this many seconds running
+	const double RecoverRatio = 0.5;
+	const double MinAlertBaseline = 5.0;  // Sparser sources are too bursty to judge by rate
+}
+
+FeedWatchdog::FeedWatchdog(qint64 tickNanos)
+	: m_tickNanos(qMax<qint64>(1, tickNanos))
+	, m_staleAfter(30000000000LL)
+	, m_wheel(WheelSlots)
+	, m_cursor(0)
+	, m_wheelTime(MonotonicClock::now())
+	, m_staleCount(0)
+	, m_rateWindowStart(m_wheelTime)
+{
+}
+
+void FeedWatchdog::setStaleAfter(qint64 nanos)
+{
+	// Symbols already scheduled pick the new threshold up when their slot comes round
+	m_staleAfter = qMax(m_tickNanos, nanos);
+}
+
+void FeedWatchdog::track(SymbolId id, qint64 now)
+{
+	if (id == InvalidSymbolId) {
+		return;
+	}
+	SymbolState empty = { 0, 0 };
+	ensureSymbolCapacity(m_symbols, id, empty);
+
+	SymbolState& state = m_symbols[id];
+	state.flags |= Tracked;
+	state.lastUpdate = now;
+	if (!(state.flags & Armed)) {
+		rearm(id, now);
+	}
+}
+
+void FeedWatchdog::untrack(SymbolId id)
+{
+	if (id == InvalidSymbolId || id >= static_cast<SymbolId>(m_symbols.size())) {
+		return;
+	}
+
+	// Any wheel entry is dropped when its slot comes round
+	SymbolState& state = m_symbols[id];
+	if (state.flags & Stale) {
+		m_staleCount--;
+	}
+	state.flags &= ~(Tracked | Stale);
+}
+
+bool FeedWatchdog::isStale(SymbolId id) const
+{
+	return id != InvalidSymbolId && id < static_cast<SymbolId>(m_symbols.size())
+		&& (m_symbols[id].flags & Stale);
+}
+
+void FeedWatchdog::rearm(SymbolId id, qint64 now)
+{
+	SymbolState& state = m_symbols[id];
+	if (state.flags & Stale) {
+		state.flags &= ~Stale;
+		m_staleCount--;
+		m_recovered.append(id);
+	}
+	state.flags |= Armed;
+	schedule(id, now + m_staleAfter);
+}
+
+void FeedWatchdog::schedule(SymbolId id, qint64 deadline)
+{
+	// Round up so a symbol is never checked before its deadline; ones beyond
+	// the wheel's horizon go in the farthest slot and are rescheduled from there
+	qint64 ticksAhead = (deadline - m_wheelTime + m_tickNanos - 1) / m_tickNanos;
+	ticksAhead = qBound<qint64>(1, ticksAhead, WheelSlots - 1);
+	m_wheel[(m_cursor + static_cast<int>(ticksAhead)) & (WheelSlots - 1)].append(id);
+}
+
+void FeedWatchdog::advance(qint64 now, WatchdogEvents& events)
+{
+	int steps = 0;
+	while (m_wheelTime + m_tickNanos <= now) {
+		if (steps == WheelSlots) {
+			// Stalled for longer than a full turn; every slot has been visited
+			m_wheelTime = now - (now - m_wheelTime) % m_tickNanos;
+			break;
+		}
+		m_wheelTime += m_tickNanos;
+		m_cursor = (m_cursor + 1) & (WheelSlots - 1);
+		expireSlot(m_cursor, now, events);
+		steps++;
+	}
+
+	if (!m_recovered.isEmpty()) {
+		// A symbol can go stale and recover within one advance; report the final state only
+		for (SymbolId id : m_recovered) {
+			if (!(m_symbols[id].flags & Stale)) {
+				events.recovered.append(id);
+			}
+		}
+		m_recovered.clear();
+	}
+
+	if (now - m_rateWindowStart >= RateIntervalNanos) {
+		updateRates(now, events);
+	}
+}
+
+void FeedWatchdog::expireSlot(int slot, qint64 now, WatchdogEvents& events)
+{
+	m_expiring.swap(m_wheel[slot]);
+	for (SymbolId id : m_expiring) {
+		SymbolState& state = m_symbols[id];
+		if (!(state.flags & Tracked)) {
+			state.flags &= ~Armed;
+			continue;
+		}
+
+		const qint64 deadline = state.lastUpdate + m_staleAfter;
+		if (deadline > now) {
+			schedule(id, deadline);
+			continue;
+		}
+
+		state.flags = (state.flags & ~Armed) | Stale;
+		m_staleCount++;
+		events.stale.append(id);
+	}
+	m_expiring.clear();
+}
+
+void FeedWatchdog::updateRates(qint64 now, WatchdogEvents& events)
+{
+	const double seconds = (now - m_rateWindowStart) / 1e9;
+	m_rateWindowStart = now;
+
+	for (int i = 0; i < MaxFeedSources; ++i) {
+		SourceRate& source = m_sources[i];
+		source.rate = (source.count - source.lastCount) / seconds;
+		source.lastCount = source.count;
+
+		if (source.samples < WarmupIntervals) {
+			// Idle sources never build a baseline, so they never alert
+			if (source.rate > 0.0) {
+				source.baseline = source.samples == 0 ? source.rate
+					: source.baseline + (source.rate - source.baseline) / (source.samples + 1);
+				source.samples++;
+			}
+			continue;
+		}
+
+		if (source.alerting) {
+			if (source.rate >= source.baseline * RecoverRatio) {
+				source.alerting = false;
+				source.lowIntervals = 0;
+				events.rateRecoveries.append(static_cast<FeedSourceId>(i));
+			}
+			continue;
+		}
+
+		// The baseline only learns from healthy intervals, so a slow decline still alerts
+		const bool low = source.rate < source.baseline * AlertRatio;
+		if (!low) {
+			source.baseline += BaselineAlpha * (source.rate - source.baseline);
+			source.lowIntervals = 0;
+			continue;
+		}
+		source.lowIntervals++;
+		if (source.lowIntervals >= AlertAfterIntervals && source.baseline >= MinAlertBaseline) {
+			source.alerting = true;
+			events.rateAlerts.append(static_cast<FeedSourceId>(i));
+		}
+	}
+}
+
+FeedRateStatus FeedWatchdog::rateStatus(FeedSourceId source) const
+{
+	FeedRateStatus status = { 0.0, 0.0, false };
+	if (source < MaxFeedSources) {
+		const SourceRate& rate = m_sources[source];
+		status.rate = rate.rate;
+		status.baseline = rate.samples >= WarmupIntervals ? rate.baseline : 0.0;
+		status.alerting = rate.alerting;
+	}
+	return status;
+}
+
+double FeedWatchdog::totalRate() const
+{
+	double total = 0.0;
+	for (const SourceRate& source : m_sources) {
+		total += source.rate;
+	}
+	return total;
+}
+
+void FeedWatchdog::resetSource(FeedSourceId source)
+{
+	if (source < MaxFeedSources) {
+		const quint64 count = m_sources[source].count;
+		m_sources[source] = SourceRate();
+		m_sources[source].count = count;
+		m_sources[source].lastCount = count;
+	}
+}
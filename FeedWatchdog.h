@@ -0,0 +1,106 @@
+#pragma once
+#include <QVector>
+#include "FeedTick.h"
+
+// Message rate of one source against what it normally delivers
+struct FeedRateStatus {
+	double rate;      // Messages per second over the last interval
+	double baseline;  // Learned normal rate, 0 until warmed up
+	bool alerting;
+};
+
+// What changed during one advance()
+struct WatchdogEvents {
+	QVector<SymbolId> stale;      // No update for the stale threshold
+	QVector<SymbolId> recovered;  // Updated again after being stale
+	QVector<FeedSourceId> rateAlerts;
+	QVector<FeedSourceId> rateRecoveries;
+};
+
+// Per-symbol staleness and per-source message rate watchdog.
+//
+// Each tracked symbol sits in one slot of a timer wheel, due when it would
+// go stale if nothing arrived. onTick() only records the time; a symbol
+// whose slot comes round is rescheduled from its last update, or flagged
+// stale if there was none. The cost per advance() is the number of
+// symbols due in the slots passed, not the number tracked.
+//
+// Consumer-thread only.
+class FeedWatchdog {
+public:
+	static const int WheelSlots = 256;  // Power of two
+
+	explicit FeedWatchdog(qint64 tickNanos = 250000000);
+
+	void setStaleAfter(qint64 nanos);
+	qint64 staleAfter() const { return m_staleAfter; }
+
+	void track(SymbolId id, qint64 now);  // Grace period starts now
+	void untrack(SymbolId id);
+	bool isStale(SymbolId id) const;
+	int staleCount() const { return m_staleCount; }
+
+	inline void onTick(SymbolId id, FeedSourceId source, qint64 receiveTime);
+
+	// Expire the wheel up to now and, once a second, update the rates
+	void advance(qint64 now, WatchdogEvents& events);
+
+	FeedRateStatus rateStatus(FeedSourceId source) const;
+	double totalRate() const;
+	void resetSource(FeedSourceId source);  // Forget the baseline, e.g. when a session is replaced
+
+private:
+	enum SymbolFlags : quint8 {
+		Tracked = 1,
+		Armed = 2,  // Present in a wheel slot
+		Stale = 4
+	};
+
+	struct SymbolState {
+		qint64 lastUpdate;
+		quint8 flags;
+	};
+
+	struct SourceRate {
+		quint64 count = 0;
+		quint64 lastCount = 0;
+		double rate = 0.0;
+		double baseline = 0.0;
+		int samples = 0;       // Non-empty intervals learned, for warm-up
+		int lowIntervals = 0;  // Consecutive intervals below the alert ratio
+		bool alerting = false;
+	};
+
+	void rearm(SymbolId id, qint64 now);
+	void schedule(SymbolId id, qint64 deadline);
+	void expireSlot(int slot, qint64 now, WatchdogEvents& events);
+	void updateRates(qint64 now, WatchdogEvents& events);
+
+private:
+	qint64 m_tickNanos;
+	qint64 m_staleAfter;
+	QVector<SymbolState> m_symbols;  // Indexed by SymbolId
+	QVector<QVector<SymbolId>> m_wheel;
+	QVector<SymbolId> m_expiring;    // Reused while a slot is processed
+	QVector<SymbolId> m_recovered;   // Since the last advance()
+	int m_cursor;
+	qint64 m_wheelTime;              // Time the cursor slot stands for
+	int m_staleCount;
+
+	SourceRate m_sources[MaxFeedSources];
+	qint64 m_rateWindowStart;
+};
+
+inline void FeedWatchdog::onTick(SymbolId id, FeedSourceId source, qint64 receiveTime)
+{
+	m_sources[source].count++;
+	if (id >= static_cast<SymbolId>(m_symbols.size())) {
+		return;
+	}
+
+	SymbolState& state = m_symbols[id];
+	state.lastUpdate = receiveTime;
+	if ((state.flags & (Tracked | Armed)) == Tracked) {
+		rearm(id, receiveTime);  // Was stale; its wheel entry has already expired
+	}
+}
@@ -0,0 +1,325 @@
+#include "FinnhubTradeParser.h"
+#include <charconv>
+#include <cstring>
+
+FinnhubTradeParser::FinnhubTradeParser(const char* data, int length)
+	: m_end(data + length)
+	, m_pos(data)
+	, m_dataBegin(nullptr)
+	, m_dataStarted(false)
+	, m_error(false)
+	, m_type(FinnhubMessageType::Malformed)
+{
+	scanEnvelope();
+}
+
+FinnhubTradeParser::FinnhubTradeParser(const QByteArray& frame)
+	: FinnhubTradeParser(frame.constData(), static_cast<int>(frame.size()))
+{
+}
+
+void FinnhubTradeParser::scanEnvelope()
+{
+	skipWhitespace();
+	if (!consume('{')) {
+		return;
+	}
+
+	bool typeSeen = false;
+	FinnhubMessageType type = FinnhubMessageType::Unknown;
+
+	skipWhitespace();
+	if (consume('}')) {
+		m_type = FinnhubMessageType::Unknown;
+		return;
+	}
+
+	while (m_pos < m_end) {
+		const char* key = nullptr;
+		int keyLength = 0;
+		if (!parseString(key, keyLength)) {
+			return;
+		}
+		skipWhitespace();
+		if (!consume(':')) {
+			return;
+		}
+		skipWhitespace();
+
+		if (keyLength == 4 && std::memcmp(key, "type", 4) == 0) {
+			const char* value = nullptr;
+			int valueLength = 0;
+			if (!parseString(value, valueLength)) {
+				return;
+			}
+			typeSeen = true;
+			if (valueLength == 5 && std::memcmp(value, "trade", 5) == 0) {
+				type = FinnhubMessageType::Trade;
+			}
+			else if (valueLength == 4 && std::memcmp(value, "ping", 4) == 0) {
+				type = FinnhubMessageType::Ping;
+			}
+		}
+		else if (keyLength == 4 && std::memcmp(key, "data", 4) == 0) {
+			if (m_pos >= m_end || *m_pos != '[') {
+				return;
+			}
+			m_dataBegin = m_pos + 1;
+
+			// Type already known: the trades can be read straight from here
+			// without walking the array twice.
+			if (typeSeen) {
+				m_type = type;
+				m_pos = m_dataBegin;
+				return;
+			}
+			if (!skipContainer()) {
+				return;
+			}
+		}
+		else if (!skipValue()) {
+			return;
+		}
+
+		skipWhitespace();
+		if (consume(',')) {
+			skipWhitespace();
+			continue;
+		}
+		if (consume('}')) {
+			break;
+		}
+		return;
+	}
+
+	if (!typeSeen) {
+		m_type = FinnhubMessageType::Unknown;
+		return;
+	}
+
+	m_type = type;
+	if (m_type == FinnhubMessageType::Trade) {
+		if (!m_dataBegin) {
+			m_type = FinnhubMessageType::Malformed;
+			return;
+		}
+		m_pos = m_dataBegin;
+	}
+}
+
+bool FinnhubTradeParser::nextTrade(FinnhubTrade& trade)
+{
+	if (m_type != FinnhubMessageType::Trade || m_error) {
+		return false;
+	}
+
+	skipWhitespace();
+	if (m_pos >= m_end) {
+		m_error = true;
+		return false;
+	}
+	if (*m_pos == ']') {
+		return false;
+	}
+	if (m_dataStarted && !consume(',')) {
+		m_error = true;
+		return false;
+	}
+	m_dataStarted = true;
+
+	skipWhitespace();
+	if (!parseTradeObject(trade)) {
+		m_error = true;
+		return false;
+	}
+	return true;
+}
+
+bool FinnhubTradeParser::parseTradeObject(FinnhubTrade& trade)
+{
+	trade.symbol = nullptr;
+	trade.symbolLength = 0;
+	trade.price = 0.0;
+	trade.volume = 0.0;
+	trade.timestamp = 0;
+
+	if (!consume('{')) {
+		return false;
+	}
+	skipWhitespace();
+	if (consume('}')) {
+		return false;
+	}
+
+	while (m_pos < m_end) {
+		const char* key = nullptr;
+		int keyLength = 0;
+		if (!parseString(key, keyLength)) {
+			return false;
+		}
+		skipWhitespace();
+		if (!consume(':')) {
+			return false;
+		}
+		skipWhitespace();
+
+		bool ok = true;
+		if (keyLength == 1) {
+			switch (key[0]) {
+			case 's': ok = parseString(trade.symbol, trade.symbolLength); break;
+			case 'p': ok = parseNumber(trade.price); break;
+			case 'v': ok = parseNumber(trade.volume); break;
+			case 't': ok = parseInteger(trade.timestamp); break;
+			default: ok = skipValue(); break;
+			}
+		}
+		else {
+			ok = skipValue();
+		}
+		if (!ok) {
+			return false;
+		}
+
+		skipWhitespace();
+		if (consume(',')) {
+			skipWhitespace();
+			continue;
+		}
+		if (consume('}')) {
+			return trade.symbol != nullptr && trade.symbolLength > 0;
+		}
+		return false;
+	}
+	return false;
+}
+
+void FinnhubTradeParser::skipWhitespace()
+{
+	while (m_pos < m_end &&
+		(*m_pos == ' ' || *m_pos == '\n' || *m_pos == '\r' || *m_pos == '\t')) {
+		++m_pos;
+	}
+}
+
+bool FinnhubTradeParser::consume(char c)
+{
+	if (m_pos < m_end && *m_pos == c) {
+		++m_pos;
+		return true;
+	}
+	return false;
+}
+
+bool FinnhubTradeParser::parseString(const char*& begin, int& length)
+{
+	if (!consume('"')) {
+		return false;
+	}
+
+	begin = m_pos;
+	while (m_pos < m_end) {
+		if (*m_pos == '\\') {
+			if (m_end - m_pos < 2) {
+				return false;
+			}
+			m_pos += 2;
+			continue;
+		}
+		if (*m_pos == '"') {
+			length = static_cast<int>(m_pos - begin);
+			++m_pos;
+			return true;
+		}
+		++m_pos;
+	}
+	return false;
+}
+
+bool FinnhubTradeParser::parseNumber(double& value)
+{
+	if (m_pos < m_end && *m_pos == 'n') {
+		// null price/volume - treat as zero
+		value = 0.0;
+		return skipValue();
+	}
+
+	std::from_chars_result result = std::from_chars(m_pos, m_end, value);
+	if (result.ec != std::errc()) {
+		return false;
+	}
+	m_pos = result.ptr;
+	return true;
+}
+
+bool FinnhubTradeParser::parseInteger(qint64& value)
+{
+	std::from_chars_result result = std::from_chars(m_pos, m_end, value);
+	if (result.ec != std::errc()) {
+		return false;
+	}
+	m_pos = result.ptr;
+
+	// Tolerate a fractional part on the timestamp and drop it
+	if (m_pos < m_end && (*m_pos == '.' || *m_pos == 'e' || *m_pos == 'E')) {
+		return skipValue();
+	}
+	return true;
+}
+
+bool FinnhubTradeParser::skipValue()
+{
+	if (m_pos >= m_end) {
+		return false;
+	}
+
+	switch (*m_pos) {
+	case '"': {
+		const char* begin = nullptr;
+		int length = 0;
+		return parseString(begin, length);
+	}
+	case '{':
+		return skipContainer();
+	case '[':
+		return skipContainer();
+	default:
+		// Number or literal (true/false/null)
+		while (m_pos < m_end && *m_pos != ',' && *m_pos != '}' && *m_pos != ']' &&
+			*m_pos != ' ' && *m_pos != '\n' && *m_pos != '\r' && *m_pos != '\t') {
+			++m_pos;
+		}
+		return true;
+	}
+}
+
+bool FinnhubTradeParser::skipContainer()
+{
+	if (m_pos >= m_end || (*m_pos != '{' && *m_pos != '[')) {
+		return false;
+	}
+	++m_pos;
+
+	int depth = 1;
+	while (m_pos < m_end) {
+		char c = *m_pos;
+		if (c == '"') {
+			const char* begin = nullptr;
+			int length = 0;
+			if (!parseString(begin, length)) {
+				return false;
+			}
+			continue;
+		}
+		if (c == '{' || c == '[') {
+			++depth;
+		}
+		else if (c == '}' || c == ']') {
+			if (--depth == 0) {
+				++m_pos;
+				return true;
+			}
+		}
+		++m_pos;
+	}
+	return false;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <QtGlobal>
+#include <QByteArray>
+
+// One trade from a Finnhub "trade" frame. The symbol points into the frame
+// buffer and is only valid while that buffer is alive.
+struct FinnhubTrade {
+	const char* symbol;
+	int symbolLength;
+	double price;
+	double volume;
+	qint64 timestamp;  // Exchange time, ms since epoch
+};
+
+enum class FinnhubMessageType {
+	Trade,
+	Ping,
+	Unknown,
+	Malformed
+};
+
+// Single-pass parser for Finnhub WebSocket frames of the shape
+// {"type":"trade","data":[{"s":..,"p":..,"v":..,"t":..,"c":..},...]}.
+// Works directly on the UTF-8 bytes and never allocates; the caller pulls
+// trades one at a time with nextTrade().
+class FinnhubTradeParser {
+public:
+	FinnhubTradeParser(const char* data, int length);
+	explicit FinnhubTradeParser(const QByteArray& frame);
+
+	FinnhubMessageType messageType() const { return m_type; }
+
+	// Returns false when the data array is exhausted or a trade is malformed
+	bool nextTrade(FinnhubTrade& trade);
+	bool hasError() const { return m_error; }
+
+private:
+	void scanEnvelope();
+	bool parseTradeObject(FinnhubTrade& trade);
+
+	void skipWhitespace();
+	bool consume(char c);
+	bool parseString(const char*& begin, int& length);
+	bool parseNumber(double& value);
+	bool parseInteger(qint64& value);
+	bool skipValue();
+	bool skipContainer();
+
+private:
+	const char* m_end;
+	const char* m_pos;
+	const char* m_dataBegin;  // First byte after '[' of the "data" array
+	bool m_dataStarted;
+	bool m_error;
+	FinnhubMessageType m_type;
+};
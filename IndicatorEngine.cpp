@@ -0,0 +1,391 @@
+#include "IndicatorEngine.h"
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INDICATOR_ENGINE_SSE2
+#endif
+
+namespace {
+	inline double emaAlpha(int period)
+	{
+		return 2.0 / (period + 1.0);
+	}
+
+	inline double wilderAlpha(int period)
+	{
+		return 1.0 / period;
+	}
+
+	// Everything the per-symbol update needs for one lane
+	struct UpdateWeights {
+		double ema;
+		double fast;
+		double slow;
+		double signal;
+		double rsi;
+		double atr;
+	};
+
+	inline UpdateWeights weights(const IndicatorConfig& config)
+	{
+		UpdateWeights w;
+		w.ema = emaAlpha(config.emaPeriod);
+		w.fast = emaAlpha(config.macdFast);
+		w.slow = emaAlpha(config.macdSlow);
+		w.signal = emaAlpha(config.macdSignal);
+		w.rsi = wilderAlpha(config.rsiPeriod);
+		w.atr = wilderAlpha(config.atrPeriod);
+		return w;
+	}
+
+	// Scalar form of the SIMD pass, for the last odd slot and non-SSE2 builds
+	inline void updateScalar(int i, const UpdateWeights& w, const double* pending, const double* close,
+		const double* high, const double* low, double* bars, double* lastClose, double* ema,
+		double* emaFast, double* emaSlow, double* macdSignal, double* avgGain, double* avgLoss, double* atr)
+	{
+		if (pending[i] != 1.0) {
+			return;
+		}
+		const double c = close[i];
+		const double n = bars[i] + 1.0;
+		const double inv = 1.0 / n;
+		const double previous = bars[i] > 0.0 ? lastClose[i] : c;
+
+		ema[i] += qMax(w.ema, inv) * (c - ema[i]);
+		emaFast[i] += qMax(w.fast, inv) * (c - emaFast[i]);
+		emaSlow[i] += qMax(w.slow, inv) * (c - emaSlow[i]);
+		macdSignal[i] += qMax(w.signal, inv) * ((emaFast[i] - emaSlow[i]) - macdSignal[i]);
+
+		// RSI averages changes, of which the first bar has none
+		if (n > 1.0) {
+			const double k = qMax(w.rsi, 1.0 / (n - 1.0));
+			const double change = c - previous;
+			avgGain[i] += k * (qMax(change, 0.0) - avgGain[i]);
+			avgLoss[i] += k * (qMax(-change, 0.0) - avgLoss[i]);
+		}
+
+		const double range = qMax(high[i] - low[i], qMax(std::fabs(high[i] - previous), std::fabs(low[i] - previous)));
+		atr[i] += qMax(w.atr, inv) * (range - atr[i]);
+
+		lastClose[i] = c;
+		bars[i] = n;
+	}
+}
+
+IndicatorEngine::IndicatorEngine()
+	: m_interval(BarInterval::OneMinute)
+	, m_pendingCount(0)
+{
+}
+
+void IndicatorEngine::setConfig(const IndicatorConfig& config)
+{
+	m_config = config;
+	m_config.emaPeriod = qMax(1, m_config.emaPeriod);
+	m_config.smaPeriod = qMax(1, m_config.smaPeriod);
+	m_config.rsiPeriod = qMax(1, m_config.rsiPeriod);
+	m_config.macdFast = qMax(1, m_config.macdFast);
+	m_config.macdSlow = qMax(m_config.macdFast, m_config.macdSlow);
+	m_config.macdSignal = qMax(1, m_config.macdSignal);
+	m_config.atrPeriod = qMax(1, m_config.atrPeriod);
+	clear();
+}
+
+void IndicatorEngine::setInterval(BarInterval interval)
+{
+	if (interval != m_interval) {
+		m_interval = interval;
+		clear();
+	}
+}
+
+void IndicatorEngine::addBar(SymbolId id, const Bar& bar)
+{
+	if (id == InvalidSymbolId) {
+		return;
+	}
+	ensureCapacity(id);
+	if (m_pending[id] == 1.0) {
+		// A second bar before update(), e.g. fast replay or a drain backlog:
+		// apply the staged one for this symbol alone so no bar is skipped
+		applyStaged(static_cast<int>(id));
+	}
+	else {
+		m_pending[id] = 1.0;
+		m_pendingCount++;
+	}
+	m_close[id] = bar.close;
+	m_high[id] = bar.high;
+	m_low[id] = bar.low;
+}
+
+int IndicatorEngine::update()
+{
+	if (m_pendingCount == 0) {
+		return 0;
+	}
+	const int updated = m_pendingCount;
+
+	// The window ring is indexed per symbol, so it is updated on its own first
+	updateWindows();
+
+	const UpdateWeights w = weights(m_config);
+
+	const int count = static_cast<int>(m_bars.size());
+	double* pending = m_pending.data();
+	const double* close = m_close.constData();
+	const double* high = m_high.constData();
+	const double* low = m_low.constData();
+	double* bars = m_bars.data();
+	double* lastClose = m_lastClose.data();
+	double* ema = m_ema.data();
+	double* emaFast = m_emaFast.data();
+	double* emaSlow = m_emaSlow.data();
+	double* macdSignal = m_macdSignal.data();
+	double* avgGain = m_avgGain.data();
+	double* avgLoss = m_avgLoss.data();
+	double* atr = m_atr.data();
+
+	int i = 0;
+#ifdef INDICATOR_ENGINE_SSE2
+	const __m128d one = _mm_set1_pd(1.0);
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d signMask = _mm_set1_pd(-0.0);
+	const __m128d wEma = _mm_set1_pd(w.ema);
+	const __m128d wFast = _mm_set1_pd(w.fast);
+	const __m128d wSlow = _mm_set1_pd(w.slow);
+	const __m128d wSignal = _mm_set1_pd(w.signal);
+	const __m128d wRsi = _mm_set1_pd(w.rsi);
+	const __m128d wAtr = _mm_set1_pd(w.atr);
+
+	// Lanes without a staged bar compute garbage that the mask discards
+	for (; i + 2 <= count; i += 2) {
+		const __m128d take = _mm_cmpeq_pd(_mm_loadu_pd(pending + i), one);
+		if (_mm_movemask_pd(take) == 0) {
+			continue;
+		}
+
+		const __m128d c = _mm_loadu_pd(close + i);
+		const __m128d h = _mm_loadu_pd(high + i);
+		const __m128d l = _mm_loadu_pd(low + i);
+		const __m128d oldBars = _mm_loadu_pd(bars + i);
+		const __m128d n = _mm_add_pd(oldBars, one);
+		const __m128d inv = _mm_div_pd(one, n);
+		const __m128d hasPrevious = _mm_cmpgt_pd(oldBars, zero);
+		const __m128d oldLast = _mm_loadu_pd(lastClose + i);
+		const __m128d previous = _mm_or_pd(_mm_and_pd(hasPrevious, oldLast), _mm_andnot_pd(hasPrevious, c));
+
+#define INDICATOR_STEP(array, weight, input) \
+		{ \
+			const __m128d old = _mm_loadu_pd(array + i); \
+			const __m128d k = _mm_max_pd(weight, inv); \
+			const __m128d updated = _mm_add_pd(old, _mm_mul_pd(k, _mm_sub_pd(input, old))); \
+			_mm_storeu_pd(array + i, _mm_or_pd(_mm_and_pd(take, updated), _mm_andnot_pd(take, old))); \
+		}
+
+		INDICATOR_STEP(ema, wEma, c)
+		INDICATOR_STEP(emaFast, wFast, c)
+		INDICATOR_STEP(emaSlow, wSlow, c)
+		const __m128d macd = _mm_sub_pd(_mm_loadu_pd(emaFast + i), _mm_loadu_pd(emaSlow + i));
+		INDICATOR_STEP(macdSignal, wSignal, macd)
+
+		const __m128d range = _mm_max_pd(_mm_sub_pd(h, l),
+			_mm_max_pd(_mm_andnot_pd(signMask, _mm_sub_pd(h, previous)), _mm_andnot_pd(signMask, _mm_sub_pd(l, previous))));
+		INDICATOR_STEP(atr, wAtr, range)
+#undef INDICATOR_STEP
+
+		// RSI: only lanes that already had a bar have a change to average
+		{
+			const __m128d takeChange = _mm_and_pd(take, hasPrevious);
+			const __m128d k = _mm_max_pd(wRsi, _mm_div_pd(one, _mm_max_pd(oldBars, one)));
+			const __m128d change = _mm_sub_pd(c, previous);
+			const __m128d oldGain = _mm_loadu_pd(avgGain + i);
+			const __m128d oldLoss = _mm_loadu_pd(avgLoss + i);
+			const __m128d gain = _mm_add_pd(oldGain, _mm_mul_pd(k, _mm_sub_pd(_mm_max_pd(change, zero), oldGain)));
+			const __m128d loss = _mm_add_pd(oldLoss, _mm_mul_pd(k, _mm_sub_pd(_mm_max_pd(_mm_sub_pd(zero, change), zero), oldLoss)));
+			_mm_storeu_pd(avgGain + i, _mm_or_pd(_mm_and_pd(takeChange, gain), _mm_andnot_pd(takeChange, oldGain)));
+			_mm_storeu_pd(avgLoss + i, _mm_or_pd(_mm_and_pd(takeChange, loss), _mm_andnot_pd(takeChange, oldLoss)));
+		}
+
+		_mm_storeu_pd(lastClose + i, _mm_or_pd(_mm_and_pd(take, c), _mm_andnot_pd(take, oldLast)));
+		_mm_storeu_pd(bars + i, _mm_or_pd(_mm_and_pd(take, n), _mm_andnot_pd(take, oldBars)));
+		_mm_storeu_pd(pending + i, zero);
+	}
+#endif
+	for (; i < count; ++i) {
+		updateScalar(i, w, pending, close, high, low, bars, lastClose, ema, emaFast, emaSlow, macdSignal, avgGain, avgLoss, atr);
+		pending[i] = 0.0;
+	}
+
+	m_pendingCount = 0;
+	return updated;
+}
+
+void IndicatorEngine::updateWindows()
+{
+	const int count = static_cast<int>(m_bars.size());
+	for (int i = 0; i < count; ++i) {
+		if (m_pending[i] == 1.0) {
+			updateWindow(i);
+		}
+	}
+}
+
+void IndicatorEngine::updateWindow(int slot)
+{
+	const int period = m_config.smaPeriod;
+	const qint64 held = static_cast<qint64>(m_bars[slot]);
+	const int position = static_cast<int>(held % period);
+	double* window = m_window.data() + static_cast<qsizetype>(slot) * period;
+	const double c = m_close[slot];
+	const double oldest = held >= period ? window[position] : 0.0;
+	window[position] = c;
+
+	if (position == period - 1) {
+		// Once per full window, recompute so rounding in the running sums cannot build up
+		double sum = 0.0;
+		double squares = 0.0;
+		for (int k = 0; k < period; ++k) {
+			sum += window[k];
+			squares += window[k] * window[k];
+		}
+		m_sum[slot] = sum;
+		m_sumSquares[slot] = squares;
+	}
+	else {
+		m_sum[slot] += c - oldest;
+		m_sumSquares[slot] += c * c - oldest * oldest;
+	}
+}
+
+void IndicatorEngine::applyStaged(int slot)
+{
+	// The window update reads the bar count, so it goes first as in update()
+	updateWindow(slot);
+	updateScalar(slot, weights(m_config), m_pending.constData(), m_close.constData(), m_high.constData(),
+		m_low.constData(), m_bars.data(), m_lastClose.data(), m_ema.data(), m_emaFast.data(), m_emaSlow.data(),
+		m_macdSignal.data(), m_avgGain.data(), m_avgLoss.data(), m_atr.data());
+}
+
+void IndicatorEngine::removeSymbol(SymbolId id)
+{
+	if (id == InvalidSymbolId || id >= static_cast<SymbolId>(m_bars.size())) {
+		return;
+	}
+	if (m_pending[id] == 1.0) {
+		m_pendingCount--;
+	}
+	resetSlot(static_cast<int>(id));
+}
+
+void IndicatorEngine::clear()
+{
+	m_pending.clear();
+	m_close.clear();
+	m_high.clear();
+	m_low.clear();
+	m_bars.clear();
+	m_lastClose.clear();
+	m_ema.clear();
+	m_emaFast.clear();
+	m_emaSlow.clear();
+	m_macdSignal.clear();
+	m_avgGain.clear();
+	m_avgLoss.clear();
+	m_atr.clear();
+	m_window.clear();
+	m_sum.clear();
+	m_sumSquares.clear();
+	m_pendingCount = 0;
+}
+
+bool IndicatorEngine::values(SymbolId id, IndicatorValues& out) const
+{
+	if (id == InvalidSymbolId || id >= static_cast<SymbolId>(m_bars.size()) || m_bars[id] < 1.0) {
+		return false;
+	}
+
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	const int bars = static_cast<int>(m_bars[id]);
+	out.bars = bars;
+	out.ema = bars >= m_config.emaPeriod ? m_ema[id] : nan;
+
+	if (bars >= m_config.smaPeriod) {
+		const double mean = m_sum[id] / m_config.smaPeriod;
+		const double variance = qMax(0.0, m_sumSquares[id] / m_config.smaPeriod - mean * mean);
+		const double width = m_config.bollingerWidth * std::sqrt(variance);
+		out.sma = mean;
+		out.bollingerUpper = mean + width;
+		out.bollingerLower = mean - width;
+	}
+	else {
+		out.sma = nan;
+		out.bollingerUpper = nan;
+		out.bollingerLower = nan;
+	}
+
+	if (bars > m_config.rsiPeriod) {
+		const double gain = m_avgGain[id];
+		const double loss = m_avgLoss[id];
+		out.rsi = gain + loss > 0.0 ? 100.0 * gain / (gain + loss) : 50.0;
+	}
+	else {
+		out.rsi = nan;
+	}
+
+	const double macd = m_emaFast[id] - m_emaSlow[id];
+	out.macd = bars >= m_config.macdSlow ? macd : nan;
+	const bool signalReady = bars >= m_config.macdSlow + m_config.macdSignal - 1;
+	out.macdSignal = signalReady ? m_macdSignal[id] : nan;
+	out.macdHistogram = signalReady ? macd - m_macdSignal[id] : nan;
+	out.atr = bars >= m_config.atrPeriod ? m_atr[id] : nan;
+	return true;
+}
+
+void IndicatorEngine::ensureCapacity(SymbolId id)
+{
+	if (static_cast<qsizetype>(id) < m_bars.size()) {
+		return;
+	}
+
+	// Even length, so the SIMD pass never needs a tail
+	const qsizetype size = (static_cast<qsizetype>(id) + 2) & ~qsizetype(1);
+	m_pending.resize(size, 0.0);
+	m_close.resize(size, 0.0);
+	m_high.resize(size, 0.0);
+	m_low.resize(size, 0.0);
+	m_bars.resize(size, 0.0);
+	m_lastClose.resize(size, 0.0);
+	m_ema.resize(size, 0.0);
+	m_emaFast.resize(size, 0.0);
+	m_emaSlow.resize(size, 0.0);
+	m_macdSignal.resize(size, 0.0);
+	m_avgGain.resize(size, 0.0);
+	m_avgLoss.resize(size, 0.0);
+	m_atr.resize(size, 0.0);
+	m_window.resize(size * m_config.smaPeriod, 0.0);
+	m_sum.resize(size, 0.0);
+	m_sumSquares.resize(size, 0.0);
+}
+
+void IndicatorEngine::resetSlot(int slot)
+{
+	m_pending[slot] = 0.0;
+	m_bars[slot] = 0.0;
+	m_lastClose[slot] = 0.0;
+	m_ema[slot] = 0.0;
+	m_emaFast[slot] = 0.0;
+	m_emaSlow[slot] = 0.0;
+	m_macdSignal[slot] = 0.0;
+	m_avgGain[slot] = 0.0;
+	m_avgLoss[slot] = 0.0;
+	m_atr[slot] = 0.0;
+	m_sum[slot] = 0.0;
+	m_sumSquares[slot] = 0.0;
+	double* window = m_window.data() + static_cast<qsizetype>(slot) * m_config.smaPeriod;
+	for (int k = 0; k < m_config.smaPeriod; ++k) {
+		window[k] = 0.0;
+	}
+}
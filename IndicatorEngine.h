@@ -0,0 +1,101 @@
+#pragma once
+#include <QVector>
+#include "SymbolTable.h"
+#include "BarAggregator.h"
+
+struct IndicatorConfig {
+	int emaPeriod = 20;
+	int smaPeriod = 20;          // Also the Bollinger window
+	double bollingerWidth = 2.0; // Standard deviations
+	int rsiPeriod = 14;
+	int macdFast = 12;
+	int macdSlow = 26;
+	int macdSignal = 9;
+	int atrPeriod = 14;
+};
+
+// One symbol's indicators as of its last closed bar. Each value is NaN
+// until enough bars have closed for it.
+struct IndicatorValues {
+	int bars = 0;
+	double ema = 0.0;
+	double sma = 0.0;
+	double bollingerUpper = 0.0;
+	double bollingerLower = 0.0;
+	double rsi = 0.0;
+	double macd = 0.0;
+	double macdSignal = 0.0;
+	double macdHistogram = 0.0;
+	double atr = 0.0;
+};
+
+// EMA, SMA, Bollinger bands, RSI, MACD and ATR for every symbol, updated
+// in constant time per closed bar of one interval.
+//
+// State is kept structure-of-arrays, one array per quantity indexed by
+// SymbolId. Closed bars are staged by addBar() and applied by update() in a
+// single pass over all symbols, two at a time with SSE2, so a bar boundary
+// across thousands of symbols stays in cache. EMAs and Wilder averages use
+// max(alpha, 1 / bars) as their weight, which makes the first bars a
+// simple average and needs no separate warm-up path.
+//
+// Consumer-thread only; the feed's consumer is the GUI thread, so widgets
+// read values directly.
+class IndicatorEngine {
+public:
+	IndicatorEngine();
+
+	// Clears all state
+	void setConfig(const IndicatorConfig& config);
+	const IndicatorConfig& config() const { return m_config; }
+	void setInterval(BarInterval interval);
+	BarInterval interval() const { return m_interval; }
+
+	// Stages a closed bar. A symbol that already has one staged applies it
+	// first on its own, so several bars per batch are all counted.
+	void addBar(SymbolId id, const Bar& bar);
+	bool hasPending() const { return m_pendingCount > 0; }
+
+	// Applies every staged bar; returns how many symbols changed
+	int update();
+
+	void removeSymbol(SymbolId id);
+	void clear();
+
+	// False if the symbol has no closed bars
+	bool values(SymbolId id, IndicatorValues& out) const;
+
+private:
+	void ensureCapacity(SymbolId id);
+	void resetSlot(int slot);
+	void updateWindows();
+	void updateWindow(int slot);
+	void applyStaged(int slot);
+
+private:
+	IndicatorConfig m_config;
+	BarInterval m_interval;
+
+	// Staged bars; m_pending is 1.0 for a symbol with a bar waiting
+	QVector<double> m_pending;
+	QVector<double> m_close;
+	QVector<double> m_high;
+	QVector<double> m_low;
+	int m_pendingCount;
+
+	// Per-symbol state, all the same length (a multiple of two)
+	QVector<double> m_bars;
+	QVector<double> m_lastClose;
+	QVector<double> m_ema;
+	QVector<double> m_emaFast;
+	QVector<double> m_emaSlow;
+	QVector<double> m_macdSignal;
+	QVector<double> m_avgGain;
+	QVector<double> m_avgLoss;
+	QVector<double> m_atr;
+
+	// SMA and Bollinger: the last smaPeriod closes per symbol, with running sums
+	QVector<double> m_window;  // smaPeriod entries per symbol
+	QVector<double> m_sum;
+	QVector<double> m_sumSquares;
+};
@@ -0,0 +1,206 @@
+#include "IoUring.h"
+
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+int ioUringSetup(unsigned entries, io_uring_params* params)
+{
+	return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+	return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned count)
+{
+	return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+}
+
+IoUring::IoUring()
+	: m_fd(-1)
+	, m_lastError(0)
+	, m_sqRing(MAP_FAILED)
+	, m_sqRingSize(0)
+	, m_sqes(nullptr)
+	, m_sqesSize(0)
+	, m_sqHead(nullptr)
+	, m_sqTail(nullptr)
+	, m_sqMask(0)
+	, m_sqEntries(0)
+	, m_sqeTail(0)
+	, m_submitted(0)
+	, m_cqRing(MAP_FAILED)
+	, m_cqRingSize(0)
+	, m_cqHead(nullptr)
+	, m_cqTail(nullptr)
+	, m_cqMask(0)
+	, m_cqes(nullptr)
+	, m_enterCalls(0)
+{
+}
+
+IoUring::~IoUring()
+{
+	release();
+}
+
+bool IoUring::setup(unsigned entries)
+{
+	release();
+
+	io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	m_fd = ioUringSetup(entries, &params);
+	if (m_fd < 0) {
+		m_lastError = errno;
+		return false;
+	}
+
+	m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+	if (singleMap) {
+		m_sqRingSize = m_cqRingSize = qMax(m_sqRingSize, m_cqRingSize);
+	}
+
+	m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+	if (m_sqRing == MAP_FAILED) {
+		m_lastError = errno;
+		release();
+		return false;
+	}
+	if (singleMap) {
+		m_cqRing = m_sqRing;
+	}
+	else {
+		m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+		if (m_cqRing == MAP_FAILED) {
+			m_lastError = errno;
+			release();
+			return false;
+		}
+	}
+
+	m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	void* sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+	if (sqes == MAP_FAILED) {
+		m_lastError = errno;
+		release();
+		return false;
+	}
+	m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+	char* sq = static_cast<char*>(m_sqRing);
+	m_sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+	m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+	m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+	m_sqEntries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+
+	// SQEs are always used in ring order, so the index array is the identity
+	unsigned* array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+	for (unsigned i = 0; i < m_sqEntries; ++i) {
+		array[i] = i;
+	}
+	m_sqeTail = m_submitted = *m_sqTail;
+
+	char* cq = static_cast<char*>(m_cqRing);
+	m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+	m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+	m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+	m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+	return true;
+}
+
+io_uring_sqe* IoUring::nextSqe()
+{
+	const unsigned head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+	if (m_sqeTail - head >= m_sqEntries) {
+		return nullptr;
+	}
+	io_uring_sqe* sqe = &m_sqes[m_sqeTail & m_sqMask];
+	std::memset(sqe, 0, sizeof(*sqe));
+	m_sqeTail++;
+	return sqe;
+}
+
+int IoUring::submit(unsigned waitFor)
+{
+	const unsigned toSubmit = m_sqeTail - m_submitted;
+	if (toSubmit == 0 && waitFor == 0) {
+		return 0;
+	}
+
+	// The SQE contents must be visible before the kernel sees the new tail
+	__atomic_store_n(m_sqTail, m_sqeTail, __ATOMIC_RELEASE);
+	m_submitted = m_sqeTail;
+
+	int result;
+	do {
+		result = ioUringEnter(m_fd, toSubmit, waitFor, waitFor > 0 ? IORING_ENTER_GETEVENTS : 0);
+	} while (result < 0 && errno == EINTR);
+	m_enterCalls++;
+	if (result < 0) {
+		m_lastError = errno;
+		return -1;
+	}
+	return result;
+}
+
+bool IoUring::registerBuffers(const iovec* buffers, unsigned count)
+{
+	if (ioUringRegister(m_fd, IORING_REGISTER_BUFFERS, buffers, count) < 0) {
+		m_lastError = errno;
+		return false;
+	}
+	return true;
+}
+
+bool IoUring::registerEventFd(int eventFd)
+{
+	if (ioUringRegister(m_fd, IORING_REGISTER_EVENTFD, &eventFd, 1) < 0) {
+		m_lastError = errno;
+		return false;
+	}
+	return true;
+}
+
+bool IoUring::isSupported()
+{
+	static const bool supported = []() {
+		IoUring ring;
+		return ring.setup(2);
+	}();
+	return supported;
+}
+
+void IoUring::release()
+{
+	if (m_sqes) {
+		munmap(m_sqes, m_sqesSize);
+		m_sqes = nullptr;
+	}
+	if (m_cqRing != MAP_FAILED && m_cqRing != m_sqRing) {
+		munmap(m_cqRing, m_cqRingSize);
+	}
+	m_cqRing = MAP_FAILED;
+	if (m_sqRing != MAP_FAILED) {
+		munmap(m_sqRing, m_sqRingSize);
+		m_sqRing = MAP_FAILED;
+	}
+	if (m_fd >= 0) {
+		::close(m_fd);
+		m_fd = -1;
+	}
+}
+
+#endif
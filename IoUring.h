@@ -0,0 +1,93 @@
+#pragma once
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+// Minimal io_uring instance over the raw system calls, so the build needs
+// kernel headers but not liburing. One thread owns an instance: SQEs are
+// taken with nextSqe(), go to the kernel together with submit(), and
+// completions are consumed with reap().
+class IoUring {
+public:
+	IoUring();
+	~IoUring();
+
+	IoUring(const IoUring&) = delete;
+	IoUring& operator=(const IoUring&) = delete;
+
+	// entries is rounded up to a power of two by the kernel
+	bool setup(unsigned entries);
+	bool isValid() const { return m_fd >= 0; }
+	int lastError() const { return m_lastError; }  // errno of the last failure
+
+	// Zeroed SQE, or nullptr if every entry is waiting to be submitted
+	io_uring_sqe* nextSqe();
+	unsigned pending() const { return m_sqeTail - m_submitted; }
+
+	// One io_uring_enter for every SQE taken since the last call, optionally
+	// waiting for completions. Returns the number submitted, or -1.
+	int submit(unsigned waitFor = 0);
+	quint64 enterCalls() const { return m_enterCalls; }
+
+	// Calls handler(userData, result, flags) for each completion; returns the count
+	template<typename Handler>
+	int reap(Handler handler);
+
+	// Fixed buffers, addressed by index from READ_FIXED / WRITE_FIXED
+	bool registerBuffers(const iovec* buffers, unsigned count);
+	// Signalled for every completion, so a poller can sleep on it
+	bool registerEventFd(int eventFd);
+
+	// True if the running kernel lets this process create a ring
+	static bool isSupported();
+
+private:
+	void release();
+
+private:
+	int m_fd;
+	int m_lastError;
+
+	// Submission queue
+	void* m_sqRing;
+	size_t m_sqRingSize;
+	io_uring_sqe* m_sqes;
+	size_t m_sqesSize;
+	unsigned* m_sqHead;
+	unsigned* m_sqTail;
+	unsigned m_sqMask;
+	unsigned m_sqEntries;
+	unsigned m_sqeTail;    // SQEs handed out
+	unsigned m_submitted;  // SQEs published to the kernel
+
+	// Completion queue; shares m_sqRing when the kernel supports one mapping
+	void* m_cqRing;
+	size_t m_cqRingSize;
+	unsigned* m_cqHead;
+	unsigned* m_cqTail;
+	unsigned m_cqMask;
+	io_uring_cqe* m_cqes;
+
+	quint64 m_enterCalls;
+};
+
+template<typename Handler>
+int IoUring::reap(Handler handler)
+{
+	unsigned head = *m_cqHead;
+	const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+	int count = 0;
+	while (head != tail) {
+		const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+		handler(cqe.user_data, cqe.res, cqe.flags);
+		head++;
+		count++;
+	}
+	// Hands the slots back to the kernel once the entries are read
+	__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+	return count;
+}
+
+#endif
@@ -0,0 +1,166 @@
+#include "LatencyDiagnosticsWidget.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+
+LatencyDiagnosticsWidget::LatencyDiagnosticsWidget(MarketDataFeed* feed, QWidget* parent)
+	: QWidget(parent)
+	, m_feed(feed)
+	, m_refreshTimer(new QTimer(this))
+{
+	setupUI();
+	connect(m_refreshTimer, &QTimer::timeout, this, &LatencyDiagnosticsWidget::refresh);
+}
+
+void LatencyDiagnosticsWidget::setupUI()
+{
+	setWindowTitle("Market Data Latency");
+
+	QVBoxLayout* mainLayout = new QVBoxLayout(this);
+
+	m_countersLabel = new QLabel(this);
+
+	const int stageCount = static_cast<int>(LatencyStage::Count);
+	m_stageTable = new QTableWidget(stageCount, 8, this);
+	QStringList headers = {
+		"Samples", "Min", "p50", "p90", "p99", "p99.9", "Max", "Negative"
+	};
+	m_stageTable->setHorizontalHeaderLabels(headers);
+	QStringList stages;
+	for (int i = 0; i < stageCount; ++i) {
+		stages.append(LatencyMonitor::stageName(static_cast<LatencyStage>(i)));
+	}
+	m_stageTable->setVerticalHeaderLabels(stages);
+	m_stageTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	m_stageTable->setSelectionMode(QAbstractItemView::NoSelection);
+	m_stageTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+	m_resetButton = new QPushButton("Reset", this);
+	connect(m_resetButton, &QPushButton::clicked, this, &LatencyDiagnosticsWidget::onResetClicked);
+
+	QHBoxLayout* toolbarLayout = new QHBoxLayout();
+	toolbarLayout->addWidget(m_countersLabel);
+	toolbarLayout->addStretch();
+	toolbarLayout->addWidget(m_resetButton);
+
+	m_sourceTable = new QTableWidget(0, 11, this);
+	QStringList sourceHeaders = {
+		"Source", "Received", "Accepted", "Duplicates", "First", "Missed",
+		"Gaps", "Drops", "Latency p50/p99", "Lag p99", "Rate / Baseline"
+	};
+	m_sourceTable->setHorizontalHeaderLabels(sourceHeaders);
+	m_sourceTable->verticalHeader()->setVisible(false);
+	m_sourceTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	m_sourceTable->setSelectionMode(QAbstractItemView::NoSelection);
+	m_sourceTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+	mainLayout->addLayout(toolbarLayout);
+	mainLayout->addWidget(m_stageTable);
+	mainLayout->addWidget(new QLabel(
+		"Exchange -> Receive uses the exchange's millisecond timestamp; "
+		"negative samples mean its clock is ahead of ours.", this));
+	mainLayout->addWidget(new QLabel("Sources - duplicates are suppressed copies, "
+		"missed are ticks another source delivered and this one never did", this));
+	mainLayout->addWidget(m_sourceTable);
+
+	resize(900, 420);
+}
+
+void LatencyDiagnosticsWidget::showEvent(QShowEvent* event)
+{
+	QWidget::showEvent(event);
+	refresh();
+	m_refreshTimer->start(500);
+}
+
+void LatencyDiagnosticsWidget::hideEvent(QHideEvent* event)
+{
+	QWidget::hideEvent(event);
+	m_refreshTimer->stop();
+}
+
+void LatencyDiagnosticsWidget::refresh()
+{
+	FeedQueueStats stats = m_feed->queueStats();
+	m_countersLabel->setText(QString("Frames: %1 | Ticks enqueued: %2 | Processed: %3 | Dropped: %4 | %5 msg/s | Stale symbols: %6 | Arbiter overflows: %7")
+		.arg(stats.framesReceived)
+		.arg(stats.ticksEnqueued)
+		.arg(m_feed->messagesProcessed())
+		.arg(stats.ticksDropped)
+		.arg(m_feed->messageRate(), 0, 'f', 0)
+		.arg(m_feed->staleSymbolCount())
+		.arg(m_feed->arbiterOverflows()));
+
+	const LatencyMonitor& monitor = LatencyMonitor::instance();
+	for (int row = 0; row < static_cast<int>(LatencyStage::Count); ++row) {
+		LatencySnapshot snapshot = monitor.snapshot(static_cast<LatencyStage>(row));
+		const bool empty = snapshot.count() == 0;
+		QStringList cells = {
+			QString::number(snapshot.count()),
+			empty ? "-" : LatencyMonitor::formatNanos(snapshot.min()),
+			empty ? "-" : LatencyMonitor::formatNanos(snapshot.percentile(50.0)),
+			empty ? "-" : LatencyMonitor::formatNanos(snapshot.percentile(90.0)),
+			empty ? "-" : LatencyMonitor::formatNanos(snapshot.percentile(99.0)),
+			empty ? "-" : LatencyMonitor::formatNanos(snapshot.percentile(99.9)),
+			empty ? "-" : LatencyMonitor::formatNanos(snapshot.max()),
+			QString::number(snapshot.negative)
+		};
+		for (int column = 0; column < cells.size(); ++column) {
+			QTableWidgetItem* item = m_stageTable->item(row, column);
+			if (!item) {
+				item = new QTableWidgetItem();
+				item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+				m_stageTable->setItem(row, column, item);
+			}
+			item->setText(cells[column]);
+		}
+	}
+
+	refreshSources();
+}
+
+void LatencyDiagnosticsWidget::refreshSources()
+{
+	QVector<FeedSourceSummary> sources = m_feed->sourceSummaries();
+	m_sourceTable->setRowCount(static_cast<int>(sources.size()));
+
+	for (int row = 0; row < sources.size(); ++row) {
+		const FeedSourceSummary& source = sources[row];
+		const FeedSourceStats& stats = source.stats;
+		QString latency = stats.latency.count() == 0 ? QString("-")
+			: QString("%1 / %2")
+			.arg(LatencyMonitor::formatNanos(stats.latency.percentile(50.0)))
+			.arg(LatencyMonitor::formatNanos(stats.latency.percentile(99.0)));
+		QStringList cells = {
+			QString("%1 (%2)").arg(source.name).arg(source.sourceId),
+			QString::number(stats.received),
+			QString::number(stats.accepted),
+			QString::number(stats.duplicates),
+			QString::number(stats.firstArrivals),
+			QString::number(stats.missed),
+			QString::number(source.sequenceGaps),
+			QString::number(source.ticksDropped),
+			latency,
+			stats.lag.count() == 0 ? QString("-") : LatencyMonitor::formatNanos(stats.lag.percentile(99.0)),
+			QString("%1 / %2%3")
+				.arg(source.rate.rate, 0, 'f', 0)
+				.arg(source.rate.baseline > 0.0 ? QString::number(source.rate.baseline, 'f', 0) : QString("learning"))
+				.arg(source.rate.alerting ? " LOW" : "")
+		};
+		for (int column = 0; column < cells.size(); ++column) {
+			QTableWidgetItem* item = m_sourceTable->item(row, column);
+			if (!item) {
+				item = new QTableWidgetItem();
+				item->setTextAlignment(column == 0 ? Qt::AlignLeft | Qt::AlignVCenter : Qt::AlignRight | Qt::AlignVCenter);
+				m_sourceTable->setItem(row, column, item);
+			}
+			item->setText(cells[column]);
+		}
+	}
+}
+
+void LatencyDiagnosticsWidget::onResetClicked()
+{
+	LatencyMonitor::instance().reset();
+	refresh();
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <QWidget>
+#include <QTableWidget>
+#include <QPushButton>
+#include <QLabel>
+#include <QTimer>
+#include "MarketDataFeed.h"
+#include "LatencyMonitor.h"
+
+// Live view of the per-stage pipeline latency histograms, the feed's
+// message counters and per-source arbitration figures. Only refreshes
+// while visible.
+class LatencyDiagnosticsWidget : public QWidget
+{
+	Q_OBJECT
+
+public:
+	explicit LatencyDiagnosticsWidget(MarketDataFeed* feed, QWidget* parent = nullptr);
+
+protected:
+	void showEvent(QShowEvent* event) override;
+	void hideEvent(QHideEvent* event) override;
+
+private slots:
+	void refresh();
+	void onResetClicked();
+
+private:
+	void setupUI();
+	void refreshSources();
+
+private:
+	MarketDataFeed* m_feed;
+	QLabel* m_countersLabel;
+	QTableWidget* m_stageTable;
+	QTableWidget* m_sourceTable;
+	QPushButton* m_resetButton;
+	QTimer* m_refreshTimer;
+};
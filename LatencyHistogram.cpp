@@ -0,0 +1,129 @@
+#include "LatencyHistogram.h"
+#include <QtAlgorithms>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+	: m_negative(0)
+{
+	for (std::atomic<quint64>& count : m_counts) {
+		count.store(0, std::memory_order_relaxed);
+	}
+}
+
+int LatencyHistogram::bucketIndex(qint64 nanos)
+{
+	const quint64 value = static_cast<quint64>(nanos);
+	if (value < static_cast<quint64>(SubBucketCount)) {
+		return static_cast<int>(value);
+	}
+
+	// Shift so the value keeps SubBucketBits significant bits; the top one
+	// is always set, leaving SubBucketHalf distinct sub-buckets per exponent
+	const int msb = 63 - static_cast<int>(qCountLeadingZeroBits(value));
+	const int exponent = msb - (SubBucketBits - 1);
+	if (exponent > MaxExponent) {
+		return BucketCount - 1;
+	}
+	const int subBucket = static_cast<int>(value >> exponent) - SubBucketHalf;
+	return SubBucketCount + (exponent - 1) * SubBucketHalf + subBucket;
+}
+
+qint64 LatencyHistogram::bucketHighestValue(int index)
+{
+	if (index < SubBucketCount) {
+		return index;
+	}
+	const int offset = index - SubBucketCount;
+	const int exponent = offset / SubBucketHalf + 1;
+	const qint64 subBucket = offset % SubBucketHalf + SubBucketHalf;
+	return ((subBucket + 1) << exponent) - 1;
+}
+
+void LatencyHistogram::reset()
+{
+	for (std::atomic<quint64>& count : m_counts) {
+		count.store(0, std::memory_order_relaxed);
+	}
+	m_negative.store(0, std::memory_order_relaxed);
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const
+{
+	LatencySnapshot snapshot;
+	snapshot.counts.resize(BucketCount);
+	quint64* counts = snapshot.counts.data();
+	for (int i = 0; i < BucketCount; ++i) {
+		counts[i] = m_counts[i].load(std::memory_order_relaxed);
+		snapshot.total += counts[i];
+	}
+	snapshot.negative = m_negative.load(std::memory_order_relaxed);
+	return snapshot;
+}
+
+qint64 LatencySnapshot::percentile(double percent) const
+{
+	if (total == 0) {
+		return 0;
+	}
+
+	const double clamped = qBound(0.0, percent, 100.0);
+	quint64 target = static_cast<quint64>(std::ceil(clamped / 100.0 * static_cast<double>(total)));
+	target = qMax<quint64>(target, 1);
+
+	quint64 seen = 0;
+	for (int i = 0; i < counts.size(); ++i) {
+		seen += counts[i];
+		if (seen >= target) {
+			return LatencyHistogram::bucketHighestValue(i);
+		}
+	}
+	return max();
+}
+
+qint64 LatencySnapshot::min() const
+{
+	for (int i = 0; i < counts.size(); ++i) {
+		if (counts[i] != 0) {
+			return LatencyHistogram::bucketHighestValue(i);
+		}
+	}
+	return 0;
+}
+
+qint64 LatencySnapshot::max() const
+{
+	for (int i = static_cast<int>(counts.size()) - 1; i >= 0; --i) {
+		if (counts[i] != 0) {
+			return LatencyHistogram::bucketHighestValue(i);
+		}
+	}
+	return 0;
+}
+
+double LatencySnapshot::mean() const
+{
+	if (total == 0) {
+		return 0.0;
+	}
+	double sum = 0.0;
+	for (int i = 0; i < counts.size(); ++i) {
+		if (counts[i] != 0) {
+			sum += static_cast<double>(counts[i]) * LatencyHistogram::bucketHighestValue(i);
+		}
+	}
+	return sum / static_cast<double>(total);
+}
+
+LatencySnapshot LatencySnapshot::since(const LatencySnapshot& earlier) const
+{
+	LatencySnapshot delta;
+	delta.counts.resize(counts.size());
+	for (int i = 0; i < counts.size(); ++i) {
+		// A reset in between makes the earlier count larger; treat it as a restart
+		const quint64 before = i < earlier.counts.size() ? earlier.counts[i] : 0;
+		delta.counts[i] = counts[i] >= before ? counts[i] - before : counts[i];
+		delta.total += delta.counts[i];
+	}
+	delta.negative = negative >= earlier.negative ? negative - earlier.negative : negative;
+	return delta;
+}
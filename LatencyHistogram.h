@@ -0,0 +1,58 @@
+#pragma once
+#include <QtGlobal>
+#include <QVector>
+#include <atomic>
+
+// Plain copy of a histogram's counts, taken off the recording path. Two
+// snapshots of the same histogram can be subtracted for interval figures.
+struct LatencySnapshot {
+	QVector<quint64> counts;
+	quint64 total = 0;
+	quint64 negative = 0;  // Samples below zero, e.g. exchange clock ahead of ours
+
+	quint64 count() const { return total; }
+	qint64 percentile(double percent) const;  // Highest value equivalent to the bucket
+	qint64 min() const;
+	qint64 max() const;
+	double mean() const;
+	LatencySnapshot since(const LatencySnapshot& earlier) const;
+};
+
+// Log-linear histogram of nanosecond values in the style of HdrHistogram:
+// values below 128 are exact, larger ones land in one of 64 linear
+// sub-buckets per power of two, so reported values are within ~1.6%.
+// Recording is a bucket index computation and one relaxed atomic add,
+// safe from any thread; no allocation after construction.
+class LatencyHistogram {
+public:
+	static constexpr int SubBucketBits = 7;
+	static constexpr int SubBucketCount = 1 << SubBucketBits;
+	static constexpr int SubBucketHalf = SubBucketCount / 2;
+	static constexpr int MaxExponent = 40;  // Tracks values up to 2^47 ns (about 39 hours)
+	static constexpr int BucketCount = SubBucketCount + MaxExponent * SubBucketHalf;
+
+	LatencyHistogram();
+	LatencyHistogram(const LatencyHistogram&) = delete;
+	LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+	void record(qint64 nanos)
+	{
+		if (nanos < 0) {
+			m_negative.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		m_counts[bucketIndex(nanos)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Not atomic with respect to concurrent record() calls; a sample
+	// recorded during a reset may survive it
+	void reset();
+	LatencySnapshot snapshot() const;
+
+	static int bucketIndex(qint64 nanos);
+	static qint64 bucketHighestValue(int index);
+
+private:
+	std::atomic<quint64> m_counts[BucketCount];
+	std::atomic<quint64> m_negative;
+};
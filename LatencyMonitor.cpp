@@ -0,0 +1,74 @@
+#include "LatencyMonitor.h"
+#include <QStringList>
+
+LatencyMonitor& LatencyMonitor::instance()
+{
+	static LatencyMonitor monitor;
+	return monitor;
+}
+
+LatencySnapshot LatencyMonitor::snapshot(LatencyStage stage) const
+{
+	return m_histograms[static_cast<int>(stage)].snapshot();
+}
+
+void LatencyMonitor::reset()
+{
+	for (int i = 0; i < static_cast<int>(LatencyStage::Count); ++i) {
+		m_histograms[i].reset();
+		m_lastReported[i] = LatencySnapshot();
+	}
+}
+
+QString LatencyMonitor::takeIntervalReport()
+{
+	QStringList lines;
+	for (int i = 0; i < static_cast<int>(LatencyStage::Count); ++i) {
+		LatencySnapshot current = m_histograms[i].snapshot();
+		LatencySnapshot interval = current.since(m_lastReported[i]);
+		m_lastReported[i] = current;
+		if (interval.count() == 0) {
+			continue;
+		}
+		lines.append(QString("[LATENCY] %1: %2")
+			.arg(stageName(static_cast<LatencyStage>(i)), -20)
+			.arg(formatSummary(interval)));
+	}
+	return lines.join('\n');
+}
+
+QString LatencyMonitor::stageName(LatencyStage stage)
+{
+	switch (stage) {
+	case LatencyStage::ExchangeToReceive: return "Exchange -> Receive";
+	case LatencyStage::ReceiveToParsed: return "Receive -> Parsed";
+	case LatencyStage::ParsedToModel: return "Parsed -> Model";
+	case LatencyStage::ModelToPaint: return "Model -> Paint";
+	default: return "Unknown";
+	}
+}
+
+QString LatencyMonitor::formatNanos(qint64 nanos)
+{
+	if (nanos < 10000) {
+		return QString("%1 ns").arg(nanos);
+	}
+	if (nanos < 10000000) {
+		return QString("%1 us").arg(nanos / 1000.0, 0, 'f', 1);
+	}
+	return QString("%1 ms").arg(nanos / 1000000.0, 0, 'f', 1);
+}
+
+QString LatencyMonitor::formatSummary(const LatencySnapshot& snapshot)
+{
+	QString summary = QString("n=%1 p50=%2 p99=%3 p99.9=%4 max=%5")
+		.arg(snapshot.count())
+		.arg(formatNanos(snapshot.percentile(50.0)))
+		.arg(formatNanos(snapshot.percentile(99.0)))
+		.arg(formatNanos(snapshot.percentile(99.9)))
+		.arg(formatNanos(snapshot.max()));
+	if (snapshot.negative != 0) {
+		summary += QString(" negative=%1").arg(snapshot.negative);
+	}
+	return summary;
+}
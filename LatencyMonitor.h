@@ -0,0 +1,43 @@
+#pragma once
+#include <QString>
+#include "LatencyHistogram.h"
+
+// Market data pipeline stages, in tick order
+enum class LatencyStage : quint8 {
+	ExchangeToReceive,  // Exchange timestamp to frame arrival (ms resolution, clock skew applies)
+	ReceiveToParsed,    // Frame arrival to tick pushed onto the feed ring
+	ParsedToModel,      // Ring push to MarketData updated on the GUI thread
+	ModelToPaint,       // MarketData updated to the price table repainting it
+	Count
+};
+
+// Process-wide per-stage latency histograms. Producers call record() on
+// their hot paths; the GUI reads snapshots for the diagnostics panel and
+// the periodic dump.
+class LatencyMonitor {
+public:
+	static LatencyMonitor& instance();
+
+	static void record(LatencyStage stage, qint64 nanos)
+	{
+		instance().m_histograms[static_cast<int>(stage)].record(nanos);
+	}
+
+	LatencySnapshot snapshot(LatencyStage stage) const;
+	void reset();
+
+	// Text report of everything recorded since the previous call (GUI thread only)
+	QString takeIntervalReport();
+
+	static QString stageName(LatencyStage stage);
+	static QString formatNanos(qint64 nanos);
+	static QString formatSummary(const LatencySnapshot& snapshot);
+
+private:
+	LatencyMonitor() = default;
+	LatencyMonitor(const LatencyMonitor&) = delete;
+	LatencyMonitor& operator=(const LatencyMonitor&) = delete;
+
+	LatencyHistogram m_histograms[static_cast<int>(LatencyStage::Count)];
+	LatencySnapshot m_lastReported[static_cast<int>(LatencyStage::Count)];
+};
@@ -0,0 +1,216 @@
+#include "LocalFeedPublisher.h"
+#include <QWebSocketServer>
+#include <QWebSocket>
+#include <QHostAddress>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+LocalFeedPublisher::LocalFeedPublisher(QObject* parent)
+	: QObject(parent)
+	, m_server(new QWebSocketServer("LightningTrade Local Feed", QWebSocketServer::NonSecureMode, this))
+	, m_publishTimer(new QTimer(this))
+	, m_random(0x4C54u)
+	, m_recordRate(10000)
+	, m_recordsPerBatch(64)
+	, m_quoteRatio(0.5)
+	, m_sequence(0)
+	, m_recordsSent(0)
+	, m_recordsScheduled(0)
+{
+	connect(m_server, &QWebSocketServer::newConnection, this, &LocalFeedPublisher::onNewConnection);
+
+	// 1 ms ticks; each tick sends whatever the rate says is due, so the
+	// configured rate holds even when the timer fires late.
+	m_publishTimer->setInterval(1);
+	m_publishTimer->setTimerType(Qt::PreciseTimer);
+	connect(m_publishTimer, &QTimer::timeout, this, &LocalFeedPublisher::publish);
+}
+
+LocalFeedPublisher::~LocalFeedPublisher()
+{
+	stop();
+}
+
+bool LocalFeedPublisher::start(quint16 port)
+{
+	if (m_server->isListening()) {
+		return true;
+	}
+
+	if (!m_server->listen(QHostAddress::LocalHost, port)) {
+		emit logMessage(QString("[PUBLISHER] Failed to listen on port %1: %2")
+			.arg(port).arg(m_server->errorString()));
+		return false;
+	}
+
+	m_sequence = 0;
+	m_recordsSent = 0;
+	m_recordsScheduled = 0;
+	m_clock.start();
+	m_publishTimer->start();
+
+	emit logMessage(QString("[PUBLISHER] Binary feed listening on %1 (%2 records/sec, %3 per batch)")
+		.arg(url().toString()).arg(m_recordRate).arg(m_recordsPerBatch));
+	return true;
+}
+
+void LocalFeedPublisher::stop()
+{
+	if (!m_server->isListening()) {
+		return;
+	}
+
+	m_publishTimer->stop();
+	for (QWebSocket* client : m_clients) {
+		client->close();
+		client->deleteLater();
+	}
+	m_clients.clear();
+	m_server->close();
+
+	emit logMessage(QString("[PUBLISHER] Stopped after %1 records in %2 batches")
+		.arg(m_recordsSent).arg(m_sequence));
+}
+
+bool LocalFeedPublisher::isRunning() const
+{
+	return m_server->isListening();
+}
+
+QUrl LocalFeedPublisher::url() const
+{
+	return QUrl(QString("ws://127.0.0.1:%1").arg(m_server->serverPort()));
+}
+
+void LocalFeedPublisher::setRecordRate(int recordsPerSecond)
+{
+	m_recordRate = qMax(1, recordsPerSecond);
+
+	// Restart pacing so a rate change does not send a catch-up burst
+	m_recordsScheduled = 0;
+	m_clock.restart();
+}
+
+void LocalFeedPublisher::setRecordsPerBatch(int records)
+{
+	m_recordsPerBatch = qBound(1, records, BinaryFeed::MaxRecordsPerBatch);
+}
+
+void LocalFeedPublisher::setQuoteRatio(double ratio)
+{
+	m_quoteRatio = qBound(0.0, ratio, 1.0);
+}
+
+void LocalFeedPublisher::onNewConnection()
+{
+	while (m_server->hasPendingConnections()) {
+		QWebSocket* client = m_server->nextPendingConnection();
+		connect(client, &QWebSocket::textMessageReceived, this, &LocalFeedPublisher::onClientTextMessage);
+		connect(client, &QWebSocket::disconnected, this, &LocalFeedPublisher::onClientDisconnected);
+		m_clients.append(client);
+
+		emit logMessage(QString("[PUBLISHER] Client connected from %1:%2")
+			.arg(client->peerAddress().toString()).arg(client->peerPort()));
+	}
+}
+
+void LocalFeedPublisher::onClientDisconnected()
+{
+	QWebSocket* client = qobject_cast<QWebSocket*>(sender());
+	if (!client) {
+		return;
+	}
+	m_clients.removeAll(client);
+	client->deleteLater();
+	emit logMessage("[PUBLISHER] Client disconnected");
+}
+
+void LocalFeedPublisher::onClientTextMessage(const QString& message)
+{
+	// Control messages are rare, so plain QJsonDocument is fine here
+	QJsonObject msg = QJsonDocument::fromJson(message.toUtf8()).object();
+	QString type = msg["type"].toString();
+	QByteArray symbol = msg["symbol"].toString().toUtf8();
+
+	if (symbol.isEmpty() || symbol.size() > BinaryFeed::SymbolSize) {
+		return;
+	}
+
+	int index = symbolIndex(symbol);
+	if (type == "subscribe" && index < 0) {
+		m_symbols.append(symbol);
+		m_prices.append(50.0 + m_random.bounded(450.0));
+	}
+	else if (type == "unsubscribe" && index >= 0) {
+		m_symbols.removeAt(index);
+		m_prices.remove(index);
+	}
+}
+
+void LocalFeedPublisher::publish()
+{
+	if (m_clients.isEmpty() || m_symbols.isEmpty()) {
+		// Nobody to send to - do not build up a backlog
+		m_recordsScheduled = 0;
+		m_clock.restart();
+		return;
+	}
+
+	const quint64 due = static_cast<quint64>(m_clock.nsecsElapsed() / 1000) * m_recordRate / 1000000;
+	if (due <= m_recordsScheduled) {
+		return;
+	}
+
+	// Cap a single catch-up so a stalled event loop cannot flood the clients
+	quint64 remaining = qMin<quint64>(due - m_recordsScheduled, static_cast<quint64>(m_recordsPerBatch) * 64);
+	m_recordsScheduled = due;
+
+	const qint64 now = QDateTime::currentMSecsSinceEpoch();
+	BinaryFeedWriter writer(&m_batch);
+
+	while (remaining > 0) {
+		const int count = static_cast<int>(qMin<quint64>(remaining, m_recordsPerBatch));
+		writer.begin(++m_sequence, now);
+		for (int i = 0; i < count; ++i) {
+			writeRecord(writer, now);
+		}
+		writer.finish();
+
+		for (QWebSocket* client : m_clients) {
+			client->sendBinaryMessage(m_batch);
+		}
+
+		m_recordsSent += count;
+		remaining -= count;
+	}
+}
+
+int LocalFeedPublisher::symbolIndex(const QByteArray& symbol) const
+{
+	for (int i = 0; i < m_symbols.size(); ++i) {
+		if (m_symbols[i] == symbol) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void LocalFeedPublisher::writeRecord(BinaryFeedWriter& writer, qint64 now)
+{
+	const int index = m_random.bounded(static_cast<int>(m_symbols.size()));
+	double& price = m_prices[index];
+
+	// Small random walk, never below a cent
+	price = qMax(0.01, price * (1.0 + (m_random.generateDouble() - 0.5) * 0.002));
+
+	if (m_random.generateDouble() < m_quoteRatio) {
+		const double halfSpread = qMax(0.005, price * 0.0002);
+		writer.addQuote(m_symbols[index],
+			price - halfSpread, 100.0 * (1 + m_random.bounded(20)),
+			price + halfSpread, 100.0 * (1 + m_random.bounded(20)), now);
+	}
+	else {
+		writer.addTrade(m_symbols[index], price, 1 + m_random.bounded(500), now);
+	}
+}
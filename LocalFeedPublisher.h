@@ -0,0 +1,71 @@
+#pragma once
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QList>
+#include <QVector>
+#include <QUrl>
+#include <QRandomGenerator>
+#include "BinaryFeedProtocol.h"
+
+class QWebSocketServer;
+class QWebSocket;
+
+// Local stand-in for an internal binary feed. Listens on a loopback
+// WebSocket port, accepts Finnhub-style subscribe/unsubscribe text messages
+// and streams random-walk trades and quotes for the subscribed symbols as
+// binary batches at a fixed record rate.
+class LocalFeedPublisher : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit LocalFeedPublisher(QObject* parent = nullptr);
+	~LocalFeedPublisher();
+
+	bool start(quint16 port = 8765);
+	void stop();
+	bool isRunning() const;
+	QUrl url() const;
+
+	// Configuration - may be changed while running
+	void setRecordRate(int recordsPerSecond);
+	void setRecordsPerBatch(int records);
+	void setQuoteRatio(double ratio);  // Fraction of records sent as quotes
+	int recordRate() const { return m_recordRate; }
+
+	quint64 recordsSent() const { return m_recordsSent; }
+	quint64 batchesSent() const { return m_sequence; }
+
+signals:
+	void logMessage(const QString& message);
+
+private slots:
+	void onNewConnection();
+	void onClientDisconnected();
+	void onClientTextMessage(const QString& message);
+	void publish();
+
+private:
+	int symbolIndex(const QByteArray& symbol) const;
+	void writeRecord(BinaryFeedWriter& writer, qint64 now);
+
+private:
+	QWebSocketServer* m_server;
+	QList<QWebSocket*> m_clients;
+	QTimer* m_publishTimer;
+	QElapsedTimer m_clock;
+	QRandomGenerator m_random;
+
+	// Per-symbol random walk, indexed in subscription order
+	QList<QByteArray> m_symbols;
+	QVector<double> m_prices;
+
+	QByteArray m_batch;  // Reused for every batch
+	int m_recordRate;
+	int m_recordsPerBatch;
+	double m_quoteRatio;
+	quint64 m_sequence;
+	quint64 m_recordsSent;
+	quint64 m_recordsScheduled;  // Records the pacing clock has released so far
+};
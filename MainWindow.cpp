@@ -4,6 +4,7 @@
 #include <QMenuBar>
 #include <QHeaderView>
 #include <QDateTime>
+#include <QTimeZone>
 #include <QNetworkRequest>
 #include <QUrl>
 #include <QDesktopServices>
@@ -11,8 +12,17 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QSignalBlocker>
+#include <QFileInfo>
+#include <QLineEdit>
 #include <algorithm>
 #include "StockTickerWidget.h"
+#include "MarketDataBenchmark.h"
+#include "BinaryLogger.h"
+#include "LatencyMonitor.h"
+#include "TickAnalytics.h"
 
 MainWindow::MainWindow(QWidget* parent)
 	: QMainWindow(parent)
@@ -20,8 +30,16 @@ MainWindow::MainWindow(QWidget* parent)
 	, m_networkManager(new QNetworkAccessManager(this))
 	, m_refreshTimer(new QTimer(this))
 	, m_clockTimer(new QTimer(this))
+	, m_logFlushTimer(new QTimer(this))
+	, m_latencyDumpTimer(new QTimer(this))
 	, m_orderManager(new OrderManager(this))
 	, m_marketDataFeed(new MarketDataFeed(this))
+	, m_localPublisher(nullptr)
+	, m_multicastPublisher(nullptr)
+	, m_multicastPublisherAction(nullptr)
+	, m_lastSyntheticEvents(0)
+	, m_positionsChanged(false)
+	, m_latencyPanel(nullptr)
 	, m_authManager(new AuthManager(this))
 	, m_userAccount(new UserAccount("trader001", "John Doe", "john@example.com"))
 	, m_stockTicker(nullptr)
@@ -54,7 +72,10 @@ MainWindow::MainWindow(QWidget* parent)
 	connect(m_refreshTimer, &QTimer::timeout, this, &MainWindow::refreshMarketData);
 	connect(m_clockTimer, &QTimer::timeout, this, [this]() {
 		m_clockLabel->setText(QDateTime::currentDateTime().toString("hh:mm:ss AP"));
+		updateFeedStats();
 		});
+	connect(m_logFlushTimer, &QTimer::timeout, this, &MainWindow::flushBinaryLog);
+	connect(m_latencyDumpTimer, &QTimer::timeout, this, &MainWindow::dumpLatencyReport);
 
 	// Connect OMS signals
 	connect(m_orderEntryWidget, &OrderEntryWidget::orderRequested,
@@ -70,14 +91,19 @@ MainWindow::MainWindow(QWidget* parent)
 		this, &MainWindow::onOrderManagerLog);
 
 	// Connect market data feed signals
-	connect(m_marketDataFeed, &MarketDataFeed::marketDataUpdated,
-		this, &MainWindow::onMarketDataUpdated);
+	m_marketDataFeed->bus().subscribeAll(UpdateEvents, this);
 	connect(m_marketDataFeed, &MarketDataFeed::logMessage,
 		this, &MainWindow::onOrderManagerLog);
+	connect(m_marketDataFeed, &MarketDataFeed::snapshotProgress, this, [this](int completed, int total) {
+		m_statusLabel->setText(completed < total
+			? QString("Loading snapshots %1/%2...").arg(completed).arg(total)
+			: QString("Snapshots loaded (%1)").arg(total));
+		});
 
 	// Start timers
 	m_refreshTimer->start(60000); // Refresh news every minute
 	m_clockTimer->start(1000);    // Update clock every second
+	m_logFlushTimer->start(250);  // Format queued binary log events
 
 	// Auto-start market data feed
 	QStringList defaultSymbols = { "AAPL", "MSFT", "GOOGL", "TSLA", "AMZN", "NVDA", "META", "SPY", "QQQ" };
@@ -94,6 +120,19 @@ MainWindow::~MainWindow()
 {
 }
 
+bool MainWindow::eventFilter(QObject* watched, QEvent* event)
+{
+	// Measured when the viewport paint is dispatched, i.e. up to the start of the repaint
+	if (event->type() == QEvent::Paint && watched == m_priceTable->viewport() && !m_unpaintedUpdates.isEmpty()) {
+		const qint64 now = MonotonicClock::now();
+		for (qint64 processTime : m_unpaintedUpdates) {
+			LatencyMonitor::record(LatencyStage::ModelToPaint, now - processTime);
+		}
+		m_unpaintedUpdates.clear();
+	}
+	return QMainWindow::eventFilter(watched, event);
+}
+
 void MainWindow::setupMenuBar()
 {
 	// File Menu
@@ -117,6 +156,136 @@ void MainWindow::setupMenuBar()
 		m_tradingTabs->setCurrentIndex(1);
 		});
 
+	// Tools Menu
+	QMenu* toolsMenu = menuBar()->addMenu("T&ools");
+	toolsMenu->addAction("Benchmark Trade &Parsers...", this, &MainWindow::runTradeParserBenchmark);
+	toolsMenu->addAction("Benchmark &Order Book", this, [this]() {
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		QString report = MarketDataBenchmark::benchmarkOrderBook();
+		QApplication::restoreOverrideCursor();
+		onOrderManagerLog(report);
+		});
+	toolsMenu->addAction("Benchmark Market Data B&us", this, [this]() {
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		QString report = MarketDataBenchmark::benchmarkBus();
+		QApplication::restoreOverrideCursor();
+		onOrderManagerLog(report);
+		});
+	toolsMenu->addAction("Stress Test Market Data &Snapshots", this, [this]() {
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		QString report = MarketDataBenchmark::stressSnapshots();
+		QApplication::restoreOverrideCursor();
+		onOrderManagerLog(report);
+		});
+	toolsMenu->addAction("Check &Indicators", this, [this]() {
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		QString report = MarketDataBenchmark::checkIndicators();
+		QApplication::restoreOverrideCursor();
+		onOrderManagerLog(report);
+		});
+	toolsMenu->addAction("Check B&ars", this, [this]() {
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		QString report = MarketDataBenchmark::checkBars();
+		QApplication::restoreOverrideCursor();
+		onOrderManagerLog(report);
+		});
+	toolsMenu->addAction("Chec&k Snapshot Loader", this, [this]() {
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		QString report = MarketDataBenchmark::checkSnapshotLoader();
+		QApplication::restoreOverrideCursor();
+		onOrderManagerLog(report);
+		});
+	toolsMenu->addAction("Check Se&quence Tracker", this, [this]() {
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		QString report = MarketDataBenchmark::checkSequenceTracker();
+		QApplication::restoreOverrideCursor();
+		onOrderManagerLog(report);
+		});
+	toolsMenu->addSeparator();
+	QAction* tradeLogAction = toolsMenu->addAction("Log Every &Trade");
+	tradeLogAction->setCheckable(true);
+	tradeLogAction->setChecked(BinaryLogger::instance().categoryLevel(LogCategory::Trade) != LogLevel::Off);
+	connect(tradeLogAction, &QAction::toggled, this, &MainWindow::setTradeLoggingEnabled);
+	toolsMenu->addSeparator();
+	toolsMenu->addAction("&Replay Tick File...", this, &MainWindow::startTickReplay);
+	toolsMenu->addAction("Stop Re&play", this, [this]() {
+		m_marketDataFeed->stopReplay();
+		});
+	toolsMenu->addAction("&Generate Tick File...", this, &MainWindow::generateTickFile);
+	toolsMenu->addSeparator();
+	toolsMenu->addAction("Synthetic &Load Test...", this, &MainWindow::startLoadTest);
+	toolsMenu->addAction("Stop Load Tes&t", this, [this]() {
+		m_marketDataFeed->stopLoadTest();
+		});
+	QAction* journalAction = toolsMenu->addAction("Capture Feed to &Journal");
+	journalAction->setCheckable(true);
+	connect(journalAction, &QAction::toggled, this, [this, journalAction](bool enabled) {
+		setFeedJournalEnabled(enabled);
+		if (enabled && !m_marketDataFeed->journal()) {
+			QSignalBlocker blocker(journalAction);
+			journalAction->setChecked(false);
+		}
+		});
+	QAction* historyAction = toolsMenu->addAction("Record Tick &History...");
+	historyAction->setCheckable(true);
+	connect(historyAction, &QAction::toggled, this, [this, historyAction](bool enabled) {
+		setTickHistoryEnabled(enabled);
+		if (enabled && !m_marketDataFeed->tickStore()) {
+			QSignalBlocker blocker(historyAction);
+			historyAction->setChecked(false);
+		}
+		});
+	toolsMenu->addAction("&Query Tick History...", this, &MainWindow::queryTickHistory);
+	QAction* localFeedAction = toolsMenu->addAction("Local &Binary Feed");
+	localFeedAction->setCheckable(true);
+	connect(localFeedAction, &QAction::toggled, this, [this, localFeedAction](bool enabled) {
+		setLocalBinaryFeedEnabled(enabled);
+		if (enabled && !(m_localPublisher && m_localPublisher->isRunning())) {
+			QSignalBlocker blocker(localFeedAction);
+			localFeedAction->setChecked(false);
+		}
+		});
+	m_multicastPublisherAction = toolsMenu->addAction("&Multicast Publisher...");
+	m_multicastPublisherAction->setCheckable(true);
+	connect(m_multicastPublisherAction, &QAction::toggled, this, [this](bool enabled) {
+		setMulticastPublisherEnabled(enabled);
+		if (enabled && !(m_multicastPublisher && m_multicastPublisher->isRunning())) {
+			QSignalBlocker blocker(m_multicastPublisherAction);
+			m_multicastPublisherAction->setChecked(false);
+		}
+		});
+	toolsMenu->addSeparator();
+	toolsMenu->addAction("Add Feed &Session...", this, &MainWindow::addFeedSession);
+	toolsMenu->addAction("Remove All Feed Sessions", this, [this]() {
+		m_marketDataFeed->feedManager()->removeAllSessions();
+		});
+	QAction* uringAction = toolsMenu->addAction("Use io_&uring Transport");
+	uringAction->setCheckable(true);
+	uringAction->setChecked(m_marketDataFeed->transportKind() == WebSocketTransportKind::IoUring);
+	uringAction->setEnabled(WebSocketTransport::isAvailable(WebSocketTransportKind::IoUring));
+	connect(uringAction, &QAction::toggled, this, [this](bool enabled) {
+		m_marketDataFeed->setTransportKind(enabled ? WebSocketTransportKind::IoUring : WebSocketTransportKind::Qt);
+		});
+	toolsMenu->addAction("Benchmark WebSocket Trans&ports", this, [this]() {
+		QApplication::setOverrideCursor(Qt::WaitCursor);
+		QString report = MarketDataBenchmark::compareTransports();
+		QApplication::restoreOverrideCursor();
+		onOrderManagerLog(report);
+		});
+	toolsMenu->addSeparator();
+	toolsMenu->addAction("Latency &Diagnostics", this, &MainWindow::showLatencyDiagnostics);
+	QAction* latencyDumpAction = toolsMenu->addAction("Dump Latency to Log (10 s)");
+	latencyDumpAction->setCheckable(true);
+	connect(latencyDumpAction, &QAction::toggled, this, [this](bool enabled) {
+		if (enabled) {
+			LatencyMonitor::instance().takeIntervalReport();  // Start the first interval now
+			m_latencyDumpTimer->start(10000);
+		}
+		else {
+			m_latencyDumpTimer->stop();
+		}
+		});
+
 	// Help Menu
 	QMenu* helpMenu = menuBar()->addMenu("&Help");
 	helpMenu->addAction("&About", this, &MainWindow::showAbout);
@@ -176,6 +345,7 @@ void MainWindow::setupMarketDataArea()
 	m_priceTable->horizontalHeader()->setStretchLastSection(true);
 	m_priceTable->setAlternatingRowColors(true);
 	m_priceTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+	m_priceTable->viewport()->installEventFilter(this);  // Model -> Paint latency
 
 	layout->addWidget(m_refreshButton, 0, Qt::AlignLeft);
 	layout->addWidget(m_priceTable);
@@ -241,13 +411,64 @@ void MainWindow::setupStatusBar()
 {
 	m_statusLabel = new QLabel("Ready", this);
 	m_orderStatsLabel = new QLabel("Orders: 0 Active | 0 Total", this);
+	m_feedStatsLabel = new QLabel("Feed queue: 0 | Drops: 0", this);
 	m_clockLabel = new QLabel(QDateTime::currentDateTime().toString("hh:mm:ss AP"), this);
 
 	statusBar()->addWidget(m_statusLabel);
 	statusBar()->addWidget(m_orderStatsLabel, 1);
+	statusBar()->addPermanentWidget(m_feedStatsLabel);
 	statusBar()->addPermanentWidget(m_clockLabel);
 }
 
+void MainWindow::updateFeedStats()
+{
+	FeedQueueStats stats = m_marketDataFeed->queueStats();
+	m_feedStatsLabel->setText(QString("Feed queue: %1 (peak %2/%3) | Drops: %4")
+		.arg(stats.depth)
+		.arg(stats.highWaterMark)
+		.arg(stats.capacity)
+		.arg(stats.ticksDropped));
+
+	if (m_marketDataFeed->isReplaying()) {
+		ReplayStats replay = m_marketDataFeed->replayStats();
+		m_feedStatsLabel->setText(m_feedStatsLabel->text() +
+			QString(" | Replay %1%: %2 ticks/s, lag %3 ms (max %4)")
+			.arg(replay.progress * 100.0, 0, 'f', 0)
+			.arg(replay.ticksPerSecond, 0, 'f', 0)
+			.arg(replay.lagMs)
+			.arg(replay.maxLagMs));
+	}
+
+	if (m_marketDataFeed->isLoadTesting()) {
+		quint64 events = m_marketDataFeed->syntheticEventsGenerated();
+		quint64 rate = events >= m_lastSyntheticEvents ? events - m_lastSyntheticEvents : events;
+		m_lastSyntheticEvents = events;
+		m_feedStatsLabel->setText(m_feedStatsLabel->text() +
+			QString(" | Synthetic: %1 events/s").arg(rate));
+	}
+	else {
+		m_lastSyntheticEvents = 0;
+	}
+
+	if (const FeedJournal* journal = m_marketDataFeed->journal()) {
+		m_feedStatsLabel->setText(m_feedStatsLabel->text() +
+			QString(" | Journal: %1 MB, %2 lost")
+			.arg(journal->bytesWritten() / (1024.0 * 1024.0), 0, 'f', 1)
+			.arg(journal->framesDropped()));
+	}
+
+	if (const TickStore* store = m_marketDataFeed->tickStore()) {
+		m_feedStatsLabel->setText(m_feedStatsLabel->text() +
+			QString(" | History: %1 trades, %2x, %3 lost")
+			.arg(store->ticksWritten())
+			.arg(store->compressionRatio(), 0, 'f', 1)
+			.arg(store->ticksDropped()));
+	}
+
+	// Highlight backpressure as soon as anything has been dropped
+	m_feedStatsLabel->setStyleSheet(stats.ticksDropped > 0 ? QString("QLabel { color: #ff6464; }") : QString());
+}
+
 void MainWindow::handleOrderRequest(const QString& symbol, OrderSide side,
 	OrderType type, double quantity, double price)
 {
@@ -323,36 +544,65 @@ void MainWindow::onOrderManagerLog(const QString& message)
 
 void MainWindow::onMarketDataUpdated(const QString& symbol, MarketData* data)
 {
-	if (!data) return;
+	if (updatePriceRow(symbol, data)) {
+		m_accountWidget->updatePositions();
+	}
+}
 
-	// Find or create row for this symbol
-	int row = -1;
-	for (int i = 0; i < m_priceTable->rowCount(); ++i) {
-		QTableWidgetItem* item = m_priceTable->item(i, 0);
-		if (item && item->text() == symbol) {
-			row = i;
-			break;
-		}
+void MainWindow::onMarketDataUpdate(const MarketDataUpdate& update)
+{
+	if (!update.data) {
+		return;
+	}
+	if (updatePriceRow(update.data->symbol(), update.data)) {
+		m_positionsChanged = true;
+	}
+	m_unpaintedUpdates.append(update.data->processTime());
+}
+
+void MainWindow::onMarketDataBatchEnd()
+{
+	// Nothing repaints while the table is hidden or minimised; keep the backlog bounded
+	if (m_unpaintedUpdates.size() > 8192) {
+		m_unpaintedUpdates.clear();
+	}
+
+	// Refresh the positions table once per batch, not once per symbol
+	if (m_positionsChanged) {
+		m_positionsChanged = false;
+		m_accountWidget->updatePositions();
 	}
+}
+
+bool MainWindow::updatePriceRow(const QString& symbol, MarketData* data)
+{
+	if (!data) return false;
+	const MarketDataSnapshot snapshot = data->snapshot();
+
+	// Find or create row for this symbol
+	SymbolId id = snapshot.symbolId;
+	ensureSymbolCapacity(m_priceRowBySymbol, id, -1);
+	int row = m_priceRowBySymbol[id];
 
 	// Create new row if not found
 	if (row < 0) {
 		row = m_priceTable->rowCount();
 		m_priceTable->insertRow(row);
 		m_priceTable->setItem(row, 0, new QTableWidgetItem(symbol));
+		m_priceRowBySymbol[id] = row;
 	}
 
 	// Update price
-	double price = data->lastPrice();
+	double price = snapshot.lastPrice;
 	QTableWidgetItem* priceItem = new QTableWidgetItem(QString("$%1").arg(price, 0, 'f', 2));
 
 	// Update change
-	double change = data->changeAmount();
+	double change = snapshot.changeAmount();
 	QString changeStr = QString("%1%2").arg(change >= 0 ? "+" : "").arg(change, 0, 'f', 2);
 	QTableWidgetItem* changeItem = new QTableWidgetItem(changeStr);
 
 	// Update change %
-	double changePercent = data->changePercent();
+	double changePercent = snapshot.changePercent();
 	QString percentStr = QString("%1%2%").arg(changePercent >= 0 ? "+" : "").arg(changePercent, 0, 'f', 2);
 	QTableWidgetItem* percentItem = new QTableWidgetItem(percentStr);
 
@@ -377,7 +627,7 @@ void MainWindow::onMarketDataUpdated(const QString& symbol, MarketData* data)
 	m_priceTable->setItem(row, 3, percentItem);
 
 	// Update volume
-	double volume = data->totalVolume();
+	double volume = snapshot.totalVolume;
 	QString volumeStr;
 	if (volume >= 1000000) {
 		volumeStr = QString("%1M").arg(volume / 1000000.0, 0, 'f', 2);
@@ -391,10 +641,11 @@ void MainWindow::onMarketDataUpdated(const QString& symbol, MarketData* data)
 	m_priceTable->setItem(row, 4, new QTableWidgetItem(volumeStr));
 
 	// Update account position prices
-	if (m_userAccount->hasPosition(symbol)) {
-		m_userAccount->updatePositionPrice(symbol, data->lastPrice());
-		m_accountWidget->updatePositions();
+	if (m_userAccount->hasPosition(id)) {
+		m_userAccount->updatePositionPrice(id, snapshot.lastPrice);
+		return true;
 	}
+	return false;
 }
 
 void MainWindow::refreshOrderBlotter()
@@ -582,6 +833,321 @@ void MainWindow::showAbout()
 		"</ul>");
 }
 
+void MainWindow::runTradeParserBenchmark()
+{
+	QString path = QFileDialog::getOpenFileName(this, "Select Recorded Feed Corpus",
+		QString(), "Feed captures (*.txt *.jsonl);;All files (*)");
+
+	QList<QByteArray> corpus;
+	if (!path.isEmpty()) {
+		corpus = MarketDataBenchmark::loadCorpus(path);
+		onOrderManagerLog(QString("[BENCH] Loaded %1 frames from %2").arg(corpus.size()).arg(path));
+	}
+	else {
+		corpus = MarketDataBenchmark::generateTradeCorpus(5000, 8);
+		onOrderManagerLog("[BENCH] No corpus selected - using generated trade frames");
+	}
+
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	QString report = MarketDataBenchmark::compareTradeParsers(corpus);
+	QApplication::restoreOverrideCursor();
+
+	onOrderManagerLog(report);
+}
+
+void MainWindow::flushBinaryLog()
+{
+	QStringList lines = BinaryLogger::instance().takeFormatted();
+	for (const QString& line : lines) {
+		m_orderBlotter->append(line);
+	}
+}
+
+void MainWindow::setTradeLoggingEnabled(bool enabled)
+{
+	BinaryLogger::instance().setCategoryLevel(LogCategory::Trade, enabled ? LogLevel::Debug : LogLevel::Off);
+	onOrderManagerLog(QString("[LOG] Per-trade logging %1").arg(enabled ? "enabled" : "disabled"));
+}
+
+void MainWindow::startTickReplay()
+{
+	QString path = QFileDialog::getOpenFileName(this, "Select Tick File",
+		QString(), "Tick files (*.ltf);;All files (*)");
+	if (path.isEmpty()) {
+		return;
+	}
+
+	QStringList speeds = { "1x", "10x", "100x", "Max" };
+	bool ok = false;
+	QString choice = QInputDialog::getItem(this, "Replay Speed", "Replay speed:", speeds, 0, false, &ok);
+	if (!ok) {
+		return;
+	}
+
+	double speed = choice == "Max" ? 0.0 : choice.chopped(1).toDouble();
+	m_marketDataFeed->startReplay(path, speed);
+}
+
+void MainWindow::generateTickFile()
+{
+	QString path = QFileDialog::getSaveFileName(this, "Save Tick File",
+		"replay.ltf", "Tick files (*.ltf)");
+	if (path.isEmpty()) {
+		return;
+	}
+
+	// 200k frames of 8 trades, 1 ms apart: a bit over three minutes at 1x
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	QList<QByteArray> frames = MarketDataBenchmark::generateTradeCorpus(200000, 8);
+	bool ok = MarketDataBenchmark::writeTickFile(path, frames, 1000);
+	QApplication::restoreOverrideCursor();
+
+	onOrderManagerLog(ok
+		? QString("[REPLAY] Wrote %1 frames to %2").arg(frames.size()).arg(path)
+		: QString("[REPLAY] Failed to write %1").arg(path));
+}
+
+void MainWindow::startLoadTest()
+{
+	bool ok = false;
+	int symbols = QInputDialog::getInt(this, "Synthetic Load Test", "Symbols:",
+		10000, 1, 200000, 1000, &ok);
+	if (!ok) {
+		return;
+	}
+
+	int rate = QInputDialog::getInt(this, "Synthetic Load Test", "Events per second (0 = unbounded):",
+		1000000, 0, 100000000, 100000, &ok);
+	if (!ok) {
+		return;
+	}
+
+	int threads = qMax(1, QThread::idealThreadCount() / 2);
+	m_lastSyntheticEvents = 0;
+	m_marketDataFeed->startLoadTest(symbols, rate, threads, 42);
+}
+
+void MainWindow::addFeedSession()
+{
+	// Point a WebSocket session at the same endpoint as the primary feed for A/B lines
+	QStringList kinds = { "WebSocket", "Tick File Replay", "UDP Multicast", "Synthetic" };
+	bool ok = false;
+	QString kind = QInputDialog::getItem(this, "Add Feed Session", "Source:", kinds, 0, false, &ok);
+	if (!ok) {
+		return;
+	}
+
+	FeedManager* manager = m_marketDataFeed->feedManager();
+	if (kind == "WebSocket") {
+		QString url = QInputDialog::getText(this, "Add Feed Session", "WebSocket URL:",
+			QLineEdit::Normal, m_marketDataFeed->webSocketUrl(), &ok);
+		if (ok && !url.isEmpty()) {
+			m_marketDataFeed->addWebSocketSession(QString("WS %1").arg(QUrl(url).host()), url);
+		}
+	}
+	else if (kind == "Tick File Replay") {
+		QString path = QFileDialog::getOpenFileName(this, "Select Tick File",
+			QString(), "Tick files (*.ltf);;All files (*)");
+		if (!path.isEmpty()) {
+			manager->addReplaySession(QFileInfo(path).completeBaseName(), path, 1.0);
+		}
+	}
+	else if (kind == "UDP Multicast") {
+		MulticastFeedConfig config = MulticastFeedHandler::defaultConfig();
+		QString target = QInputDialog::getText(this, "Add Feed Session", "Group:port:",
+			QLineEdit::Normal, QString("%1:%2").arg(config.group).arg(config.port), &ok);
+		if (!ok || target.isEmpty()) {
+			return;
+		}
+		// Loopback by default, to pair with Tools > Multicast Publisher
+		QString interfaceAddress = QInputDialog::getText(this, "Add Feed Session", "Interface address (empty = default):",
+			QLineEdit::Normal, "127.0.0.1", &ok);
+		if (!ok) {
+			return;
+		}
+		config.group = target.section(':', 0, 0);
+		config.port = static_cast<quint16>(target.section(':', 1, 1).toUInt());
+		config.interfaceAddress = interfaceAddress.trimmed();
+		manager->addMulticastSession(QString("MCAST %1").arg(target), config);
+	}
+	else {
+		int seed = QInputDialog::getInt(this, "Add Feed Session", "Seed:", 1, 0, 1000000, 1, &ok);
+		if (!ok) {
+			return;
+		}
+		SyntheticGeneratorConfig config;
+		config.seed = static_cast<quint64>(seed);
+		config.sourceId = InvalidFeedSource;  // Assigned by the manager
+		config.threads = 1;
+		config.eventsPerSecond = 1000;
+		config.secondsPerEvent = 0.001;
+		for (const QString& symbol : m_marketDataFeed->getSubscribedSymbols()) {
+			config.symbols.append(SyntheticMarketGenerator::defaultSymbolConfig(symbol));
+		}
+		manager->addSyntheticSession(QString("Synthetic %1").arg(seed), config);
+	}
+}
+
+void MainWindow::setFeedJournalEnabled(bool enabled)
+{
+	if (!enabled) {
+		m_marketDataFeed->stopJournal();
+		return;
+	}
+
+	QString directory = QFileDialog::getExistingDirectory(this, "Select Journal Directory");
+	if (!directory.isEmpty()) {
+		m_marketDataFeed->startJournal(directory);
+	}
+}
+
+void MainWindow::setTickHistoryEnabled(bool enabled)
+{
+	if (!enabled) {
+		m_marketDataFeed->stopTickStore();
+		return;
+	}
+
+	QString directory = QFileDialog::getExistingDirectory(this, "Select Tick History Directory");
+	if (!directory.isEmpty()) {
+		m_marketDataFeed->startTickStore(directory);
+	}
+}
+
+void MainWindow::queryTickHistory()
+{
+	QString directory;
+	if (const TickStore* store = m_marketDataFeed->tickStore()) {
+		directory = store->directory();
+	}
+	else {
+		directory = QFileDialog::getExistingDirectory(this, "Select Tick History Directory");
+		if (directory.isEmpty()) {
+			return;
+		}
+	}
+
+	bool ok = false;
+	QString symbols = QInputDialog::getText(this, "Query Tick History",
+		"Symbols (comma-separated):", QLineEdit::Normal, QString(), &ok);
+	if (!ok || symbols.trimmed().isEmpty()) {
+		return;
+	}
+	int days = QInputDialog::getInt(this, "Query Tick History", "Days, ending today (UTC):", 30, 1, 3660, 1, &ok);
+	if (!ok) {
+		return;
+	}
+
+	const QDate today = QDateTime::currentDateTimeUtc().date();
+	TickQuery query;
+	query.root = directory;
+	query.symbols = symbols.toUpper().remove(' ').split(',', Qt::SkipEmptyParts);
+	query.fromNs = QDateTime(today.addDays(1 - days), QTime(0, 0), QTimeZone::UTC).toMSecsSinceEpoch() * 1000000;
+	query.toNs = QDateTime(today.addDays(1), QTime(0, 0), QTimeZone::UTC).toMSecsSinceEpoch() * 1000000 - 1;
+
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	const TickQueryReport report = TickAnalytics::run(query);
+	QApplication::restoreOverrideCursor();
+
+	onOrderManagerLog(TickAnalytics::formatReport(query, report));
+}
+
+void MainWindow::setLocalBinaryFeedEnabled(bool enabled)
+{
+	if (!enabled) {
+		if (m_localPublisher && m_localPublisher->isRunning()) {
+			m_localPublisher->stop();
+			m_marketDataFeed->connectToEndpoint(m_liveFeedUrl);
+		}
+		return;
+	}
+
+	bool ok = false;
+	int rate = QInputDialog::getInt(this, "Local Binary Feed", "Records per second:",
+		10000, 1, 5000000, 1000, &ok);
+	if (!ok) {
+		return;
+	}
+
+	if (!m_localPublisher) {
+		m_localPublisher = new LocalFeedPublisher(this);
+		connect(m_localPublisher, &LocalFeedPublisher::logMessage,
+			this, &MainWindow::onOrderManagerLog);
+	}
+	m_localPublisher->setRecordRate(rate);
+	if (!m_localPublisher->start()) {
+		return;
+	}
+
+	m_liveFeedUrl = m_marketDataFeed->webSocketUrl();
+	m_marketDataFeed->connectToEndpoint(m_localPublisher->url().toString());
+}
+
+void MainWindow::setMulticastPublisherEnabled(bool enabled)
+{
+	if (!enabled) {
+		if (m_multicastPublisher) {
+			m_multicastPublisher->stop();  // The summary arrives through finished()
+		}
+		return;
+	}
+
+	QString path = QFileDialog::getOpenFileName(this, "Select Capture to Publish",
+		QString(), "Tick files (*.ltf);;All files (*)");
+	if (path.isEmpty()) {
+		return;
+	}
+	MulticastPublisherConfig config = MulticastPublisher::defaultConfig();
+	bool ok = false;
+	config.packetsPerSecond = QInputDialog::getInt(this, "Multicast Publisher", "Packets per second (0 = max):",
+		config.packetsPerSecond, 0, 10000000, 1000, &ok);
+	if (!ok) {
+		return;
+	}
+	config.loops = QInputDialog::getInt(this, "Multicast Publisher", "Passes over the capture (0 = until stopped):",
+		config.loops, 0, 1000000, 1, &ok);
+	if (!ok) {
+		return;
+	}
+	const double lossPercent = QInputDialog::getDouble(this, "Multicast Publisher", "Simulated packet loss (%):",
+		0.0, 0.0, 50.0, 2, &ok);
+	if (!ok) {
+		return;
+	}
+	config.lossRatio = lossPercent / 100.0;
+
+	if (!m_multicastPublisher) {
+		m_multicastPublisher = new MulticastPublisher(this);
+		connect(m_multicastPublisher, &MulticastPublisher::logMessage,
+			this, &MainWindow::onOrderManagerLog);
+		connect(m_multicastPublisher, &MulticastPublisher::finished, this, [this](const QString& summary) {
+			onOrderManagerLog(summary);
+			QSignalBlocker blocker(m_multicastPublisherAction);
+			m_multicastPublisherAction->setChecked(false);
+			});
+	}
+	m_multicastPublisher->start(path, config);
+}
+
+void MainWindow::showLatencyDiagnostics()
+{
+	if (!m_latencyPanel) {
+		m_latencyPanel = new LatencyDiagnosticsWidget(m_marketDataFeed, this);
+		m_latencyPanel->setWindowFlag(Qt::Window);
+	}
+	m_latencyPanel->show();
+	m_latencyPanel->raise();
+	m_latencyPanel->activateWindow();
+}
+
+void MainWindow::dumpLatencyReport()
+{
+	QString report = LatencyMonitor::instance().takeIntervalReport();
+	if (!report.isEmpty()) {
+		onOrderManagerLog(report);
+	}
+}
+
 void MainWindow::onAccountDeposit(double amount)
 {
 	m_orderBlotter->append(QString("[%1] Account deposit: $%2")
@@ -844,10 +1410,11 @@ void MainWindow::onTickerSymbolClicked(const QString& symbol)
 			QString("No data available for %1").arg(symbol));
 		return;
 	}
+	const MarketDataSnapshot snapshot = data->snapshot();
 
 	// Create detailed info with HTML formatting
-	QString changeColor = data->changeAmount() >= 0 ? "#00c800" : "#ff6464";
-	QString changeSymbol = data->changeAmount() >= 0 ? "▲" : "▼";
+	QString changeColor = snapshot.changeAmount() >= 0 ? "#00c800" : "#ff6464";
+	QString changeSymbol = snapshot.changeAmount() >= 0 ? "▲" : "▼";
 
 	QString info = QString(
 		"<div style='font-family: Arial;'>"
@@ -881,17 +1448,17 @@ void MainWindow::onTickerSymbolClicked(const QString& symbol)
 		"</div>"
 	)
 		.arg(symbol)
-		.arg(data->lastPrice(), 0, 'f', 2)
-		.arg(data->changeAmount() >= 0 ? "+" : "")
-		.arg(data->changeAmount(), 0, 'f', 2)
-		.arg(data->changePercent() >= 0 ? "+" : "")
-		.arg(data->changePercent(), 0, 'f', 2)
+		.arg(snapshot.lastPrice, 0, 'f', 2)
+		.arg(snapshot.changeAmount() >= 0 ? "+" : "")
+		.arg(snapshot.changeAmount(), 0, 'f', 2)
+		.arg(snapshot.changePercent() >= 0 ? "+" : "")
+		.arg(snapshot.changePercent(), 0, 'f', 2)
 		.arg(changeColor)
 		.arg(changeSymbol)
-		.arg(data->openPrice(), 0, 'f', 2)
-		.arg(data->highPrice(), 0, 'f', 2)
-		.arg(data->lowPrice(), 0, 'f', 2)
-		.arg(data->totalVolume(), 0, 'f', 0);
+		.arg(snapshot.openPrice, 0, 'f', 2)
+		.arg(snapshot.highPrice, 0, 'f', 2)
+		.arg(snapshot.lowPrice, 0, 'f', 2)
+		.arg(snapshot.totalVolume, 0, 'f', 0);
 
 	QMessageBox msgBox(this);
 	msgBox.setWindowTitle(QString("%1 - Market Data").arg(symbol));
@@ -914,14 +1481,14 @@ void MainWindow::onTickerSymbolClicked(const QString& symbol)
 		m_orderBlotter->append(QString("[%1] Ready to place buy order for %2 at $%3")
 			.arg(QDateTime::currentDateTime().toString("hh:mm:ss"))
 			.arg(symbol)
-			.arg(data->lastPrice(), 0, 'f', 2));
+			.arg(snapshot.lastPrice, 0, 'f', 2));
 	}
 	else if (msgBox.clickedButton() == sellButton) {
 		m_tradingTabs->setCurrentIndex(0);  // Switch to Order Entry
 		m_orderBlotter->append(QString("[%1] Ready to place sell order for %2 at $%3")
 			.arg(QDateTime::currentDateTime().toString("hh:mm:ss"))
 			.arg(symbol)
-			.arg(data->lastPrice(), 0, 'f', 2));
+			.arg(snapshot.lastPrice, 0, 'f', 2));
 	}
 	else if (msgBox.clickedButton() == chartButton) {
 		// Open Yahoo Finance chart
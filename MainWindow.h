@@ -20,8 +20,11 @@
 #include "AccountWidget.h"
 #include "LoginDialog.h"
 #include "StockTickerWidget.h"
+#include "LocalFeedPublisher.h"
+#include "MulticastPublisher.h"
+#include "LatencyDiagnosticsWidget.h"
 
-class MainWindow : public QMainWindow
+class MainWindow : public QMainWindow, public MarketDataSubscriber
 {
 	Q_OBJECT
 
@@ -29,6 +32,13 @@ public:
 	explicit MainWindow(QWidget* parent = nullptr);
 	~MainWindow();
 
+	// MarketDataSubscriber - the price table shows every symbol
+	void onMarketDataUpdate(const MarketDataUpdate& update) override;
+	void onMarketDataBatchEnd() override;
+
+protected:
+	bool eventFilter(QObject* watched, QEvent* event) override;
+
 private slots:
 	// Order management slots
 	void handleOrderRequest(const QString& symbol, OrderSide side,
@@ -45,6 +55,20 @@ private slots:
 	void refreshOrderBlotter();
 	void refreshMarketData();
 	void showAbout();
+	void runTradeParserBenchmark();
+	void flushBinaryLog();
+	void setTradeLoggingEnabled(bool enabled);
+	void setLocalBinaryFeedEnabled(bool enabled);
+	void setMulticastPublisherEnabled(bool enabled);
+	void startTickReplay();
+	void generateTickFile();
+	void setFeedJournalEnabled(bool enabled);
+	void setTickHistoryEnabled(bool enabled);
+	void queryTickHistory();
+	void startLoadTest();
+	void addFeedSession();
+	void showLatencyDiagnostics();
+	void dumpLatencyReport();
 
 	// News slots
 	void onNewsReplyFinished();
@@ -70,6 +94,8 @@ private:
 	void setupTradingArea();
 	void setupStatusBar();
 	void setupStockTicker();
+	void updateFeedStats();
+	bool updatePriceRow(const QString& symbol, MarketData* data);
 
 	void loadMarketNews();
 	void loadMarketPrices();
@@ -87,6 +113,7 @@ private:
 	// Market data area
 	QGroupBox* m_marketDataGroup;
 	QTableWidget* m_priceTable;
+	QVector<int> m_priceRowBySymbol;  // Indexed by SymbolId, -1 if no row yet
 	QPushButton* m_refreshButton;
 
 	// News area
@@ -106,6 +133,7 @@ private:
 	// Status bar
 	QLabel* m_statusLabel;
 	QLabel* m_orderStatsLabel;
+	QLabel* m_feedStatsLabel;
 	QLabel* m_clockLabel;
 
 	// Network
@@ -114,12 +142,22 @@ private:
 	// Timers
 	QTimer* m_refreshTimer;
 	QTimer* m_clockTimer;
+	QTimer* m_logFlushTimer;
+	QTimer* m_latencyDumpTimer;
 
 	// Order management
 	OrderManager* m_orderManager;
 
 	// Market data feed
 	MarketDataFeed* m_marketDataFeed;
+	LocalFeedPublisher* m_localPublisher;
+	MulticastPublisher* m_multicastPublisher;
+	QAction* m_multicastPublisherAction;  // Unchecked when a run ends on its own
+	QString m_liveFeedUrl;  // Restored when the local binary feed is switched off
+	quint64 m_lastSyntheticEvents;  // For the per-second load test rate
+	QVector<qint64> m_unpaintedUpdates;  // MarketData process times awaiting a price table repaint
+	bool m_positionsChanged;  // A price row for a held symbol moved this batch
+	LatencyDiagnosticsWidget* m_latencyPanel;
 
 	// Authentication
 	AuthManager* m_authManager;
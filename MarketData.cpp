@@ -1,8 +1,11 @@
 #include "MarketData.h"
 
 MarketData::MarketData()
-	: m_type(MarketDataType::Trade)
-	, m_timestamp(QDateTime::currentDateTime())
+	: m_symbolId(InvalidSymbolId)
+	, m_type(MarketDataType::Trade)
+	, m_exchangeTime(0)
+	, m_receiveTime(MonotonicClock::now())
+	, m_processTime(m_receiveTime)
 	, m_lastPrice(0.0)
 	, m_bidPrice(0.0)
 	, m_askPrice(0.0)
@@ -15,12 +18,16 @@ MarketData::MarketData()
 	, m_askVolume(0.0)
 	, m_totalVolume(0.0)
 {
+	publish();
 }
 
 MarketData::MarketData(const QString& symbol, MarketDataType type)
 	: m_symbol(symbol)
+	, m_symbolId(SymbolTable::instance().intern(symbol))
 	, m_type(type)
-	, m_timestamp(QDateTime::currentDateTime())
+	, m_exchangeTime(0)
+	, m_receiveTime(MonotonicClock::now())
+	, m_processTime(m_receiveTime)
 	, m_lastPrice(0.0)
 	, m_bidPrice(0.0)
 	, m_askPrice(0.0)
@@ -33,6 +40,14 @@ MarketData::MarketData(const QString& symbol, MarketDataType type)
 	, m_askVolume(0.0)
 	, m_totalVolume(0.0)
 {
+	publish();
+}
+
+void MarketData::setSymbol(const QString& symbol)
+{
+	m_symbol = symbol;
+	m_symbolId = SymbolTable::instance().intern(symbol);
+	publish();
 }
 
 double MarketData::changePercent() const
@@ -41,12 +56,14 @@ double MarketData::changePercent() const
 	return ((m_lastPrice - m_openPrice) / m_openPrice) * 100.0;
 }
 
-void MarketData::updateTrade(double price, double volume)
+void MarketData::updateTrade(double price, double volume, qint64 exchangeTime, qint64 receiveTime)
 {
 	m_lastPrice = price;
 	m_lastVolume = volume;
 	m_totalVolume += volume;
-	m_timestamp = QDateTime::currentDateTime();
+	m_exchangeTime = exchangeTime;
+	m_processTime = MonotonicClock::now();
+	m_receiveTime = receiveTime != 0 ? receiveTime : m_processTime;
 
 	// Update high/low
 	if (m_highPrice == 0.0 || price > m_highPrice) {
@@ -60,15 +77,41 @@ void MarketData::updateTrade(double price, double volume)
 	if (m_openPrice == 0.0) {
 		m_openPrice = price;
 	}
+	publish();
 }
 
-void MarketData::updateQuote(double bidPrice, double bidVolume, double askPrice, double askVolume)
+void MarketData::updateQuote(double bidPrice, double bidVolume, double askPrice, double askVolume,
+	qint64 exchangeTime, qint64 receiveTime)
 {
 	m_bidPrice = bidPrice;
 	m_bidVolume = bidVolume;
 	m_askPrice = askPrice;
 	m_askVolume = askVolume;
-	m_timestamp = QDateTime::currentDateTime();
+	m_exchangeTime = exchangeTime;
+	m_processTime = MonotonicClock::now();
+	m_receiveTime = receiveTime != 0 ? receiveTime : m_processTime;
+	publish();
+}
+
+void MarketData::publish()
+{
+	MarketDataSnapshot snapshot;
+	snapshot.symbolId = m_symbolId;
+	snapshot.exchangeTime = m_exchangeTime;
+	snapshot.receiveTime = m_receiveTime;
+	snapshot.processTime = m_processTime;
+	snapshot.lastPrice = m_lastPrice;
+	snapshot.bidPrice = m_bidPrice;
+	snapshot.askPrice = m_askPrice;
+	snapshot.openPrice = m_openPrice;
+	snapshot.highPrice = m_highPrice;
+	snapshot.lowPrice = m_lowPrice;
+	snapshot.closePrice = m_closePrice;
+	snapshot.lastVolume = m_lastVolume;
+	snapshot.bidVolume = m_bidVolume;
+	snapshot.askVolume = m_askVolume;
+	snapshot.totalVolume = m_totalVolume;
+	m_published.store(snapshot);
 }
 
 bool MarketData::isValid() const
@@ -1,6 +1,9 @@
 #pragma once
 #include <QString>
 #include <QDateTime>
+#include "SymbolTable.h"
+#include "MonotonicClock.h"
+#include "SeqLock.h"
 
 enum class MarketDataType {
 	Trade,
@@ -9,15 +12,57 @@ enum class MarketDataType {
 	Summary
 };
 
+// A consistent copy of one symbol's state, safe to take from any thread
+struct MarketDataSnapshot {
+	SymbolId symbolId;
+	qint64 exchangeTime;
+	qint64 receiveTime;
+	qint64 processTime;
+	double lastPrice;
+	double bidPrice;
+	double askPrice;
+	double openPrice;
+	double highPrice;
+	double lowPrice;
+	double closePrice;
+	double lastVolume;
+	double bidVolume;
+	double askVolume;
+	double totalVolume;
+
+	QDateTime timestamp() const { return MonotonicClock::toDateTime(processTime); }  // Display only
+	double midPrice() const { return (bidPrice + askPrice) / 2.0; }
+	double spread() const { return askPrice - bidPrice; }
+	double changeAmount() const { return lastPrice - openPrice; }
+	double changePercent() const { return openPrice > 0.0 ? (lastPrice - openPrice) / openPrice * 100.0 : 0.0; }
+};
+
+// The feed's consumer thread owns a MarketData and is the only one that may
+// call the setters and update methods, or read through the plain getters.
+// Every change is also published through a seqlock, and snapshot() gives
+// any other thread a consistent copy without locking.
 class MarketData {
 public:
 	MarketData();
 	MarketData(const QString& symbol, MarketDataType type);
 
-	// Getters
+	// Any thread: all fields as of one update
+	MarketDataSnapshot snapshot() const { return m_published.load(); }
+	int snapshot(MarketDataSnapshot& out) const { return m_published.load(out); }  // Returns the retries
+	quint32 snapshotVersion() const { return m_published.version(); }
+
+	// Getters - owning thread only
 	QString symbol() const { return m_symbol; }
+	SymbolId symbolId() const { return m_symbolId; }
 	MarketDataType type() const { return m_type; }
-	QDateTime timestamp() const { return m_timestamp; }
+	QDateTime timestamp() const { return MonotonicClock::toDateTime(m_processTime); }  // Display only
+
+	// Tick timing: exchange time is ms since epoch as sent by the venue (0 if
+	// unknown); receive and process times are MonotonicClock ns
+	qint64 exchangeTime() const { return m_exchangeTime; }
+	qint64 receiveTime() const { return m_receiveTime; }
+	qint64 processTime() const { return m_processTime; }
+	qint64 feedLatencyNanos() const { return m_processTime - m_receiveTime; }
 
 	// Price data
 	double lastPrice() const { return m_lastPrice; }
@@ -41,26 +86,27 @@ public:
 	double changeAmount() const { return m_lastPrice - m_openPrice; }
 
 	// Setters
-	void setSymbol(const QString& symbol) { m_symbol = symbol; }
+	void setSymbol(const QString& symbol);
 	void setType(MarketDataType type) { m_type = type; }
-	void setTimestamp(const QDateTime& timestamp) { m_timestamp = timestamp; }
 
-	void setLastPrice(double price) { m_lastPrice = price; }
-	void setBidPrice(double price) { m_bidPrice = price; }
-	void setAskPrice(double price) { m_askPrice = price; }
-	void setOpenPrice(double price) { m_openPrice = price; }
-	void setHighPrice(double price) { m_highPrice = price; }
-	void setLowPrice(double price) { m_lowPrice = price; }
-	void setClosePrice(double price) { m_closePrice = price; }
+	void setLastPrice(double price) { m_lastPrice = price; publish(); }
+	void setBidPrice(double price) { m_bidPrice = price; publish(); }
+	void setAskPrice(double price) { m_askPrice = price; publish(); }
+	void setOpenPrice(double price) { m_openPrice = price; publish(); }
+	void setHighPrice(double price) { m_highPrice = price; publish(); }
+	void setLowPrice(double price) { m_lowPrice = price; publish(); }
+	void setClosePrice(double price) { m_closePrice = price; publish(); }
 
-	void setLastVolume(double volume) { m_lastVolume = volume; }
-	void setBidVolume(double volume) { m_bidVolume = volume; }
-	void setAskVolume(double volume) { m_askVolume = volume; }
-	void setTotalVolume(double volume) { m_totalVolume = volume; }
+	void setLastVolume(double volume) { m_lastVolume = volume; publish(); }
+	void setBidVolume(double volume) { m_bidVolume = volume; publish(); }
+	void setAskVolume(double volume) { m_askVolume = volume; publish(); }
+	void setTotalVolume(double volume) { m_totalVolume = volume; publish(); }
 
 	// Update methods
-	void updateTrade(double price, double volume);
-	void updateQuote(double bidPrice, double bidVolume, double askPrice, double askVolume);
+	// receiveTime 0 = stamped now, i.e. the update did not come off the wire
+	void updateTrade(double price, double volume, qint64 exchangeTime = 0, qint64 receiveTime = 0);
+	void updateQuote(double bidPrice, double bidVolume, double askPrice, double askVolume,
+		qint64 exchangeTime = 0, qint64 receiveTime = 0);
 
 	// Validation
 	bool isValid() const;
@@ -68,10 +114,16 @@ public:
 	// String conversion
 	static QString typeToString(MarketDataType type);
 
+private:
+	void publish();
+
 private:
 	QString m_symbol;
+	SymbolId m_symbolId;
 	MarketDataType m_type;
-	QDateTime m_timestamp;
+	qint64 m_exchangeTime;
+	qint64 m_receiveTime;
+	qint64 m_processTime;
 
 	// Price data
 	double m_lastPrice;
@@ -87,4 +139,6 @@ private:
 	double m_bidVolume;
 	double m_askVolume;
 	double m_totalVolume;
+
+	SeqLock<MarketDataSnapshot> m_published;
 };
\ No newline at end of file
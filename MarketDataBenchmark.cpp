@@ -0,0 +1,1372 @@
+#include "MarketDataBenchmark.h"
+#include "FinnhubTradeParser.h"
+#include "MarketData.h"
+#include "TickFile.h"
+#include "OrderBook.h"
+#include "LatencyHistogram.h"
+#include "LatencyMonitor.h"
+#include "MonotonicClock.h"
+#include "WebSocketTransport.h"
+#include "IndicatorEngine.h"
+#include "BarAggregator.h"
+#include "MarketDataBus.h"
+#include "SnapshotLoader.h"
+#include "SnapshotStandIn.h"
+#include "PacketSequenceTracker.h"
+#include "MulticastFeedHandler.h"
+#include "MulticastPublisher.h"
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QEventLoop>
+#include <QTimer>
+#include <QWebSocketServer>
+#include <QWebSocket>
+#include <QHostAddress>
+#include <QNetworkAccessManager>
+#include <QTemporaryDir>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+QList<QByteArray> MarketDataBenchmark::loadCorpus(const QString& path)
+{
+	QList<QByteArray> corpus;
+
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return corpus;
+	}
+
+	while (!file.atEnd()) {
+		QByteArray line = file.readLine().trimmed();
+		if (!line.isEmpty()) {
+			corpus.append(line);
+		}
+	}
+	return corpus;
+}
+
+QList<QByteArray> MarketDataBenchmark::generateTradeCorpus(int frames, int tradesPerFrame)
+{
+	static const char* symbols[] = {
+		"AAPL", "MSFT", "GOOGL", "TSLA", "AMZN", "NVDA", "META", "SPY", "QQQ"
+	};
+	const int symbolCount = sizeof(symbols) / sizeof(symbols[0]);
+
+	QRandomGenerator rng(42);
+	QList<QByteArray> corpus;
+	corpus.reserve(frames);
+
+	qint64 timestamp = 1700000000000;
+	for (int f = 0; f < frames; ++f) {
+		QByteArray frame = "{\"data\":[";
+		for (int t = 0; t < tradesPerFrame; ++t) {
+			if (t > 0) frame += ',';
+			frame += QString("{\"c\":[\"1\",\"12\"],\"p\":%1,\"s\":\"%2\",\"t\":%3,\"v\":%4}")
+				.arg(100.0 + rng.bounded(50000) / 100.0, 0, 'f', 2)
+				.arg(QLatin1String(symbols[rng.bounded(symbolCount)]))
+				.arg(timestamp++)
+				.arg(rng.bounded(1000) + 1)
+				.toUtf8();
+		}
+		frame += "],\"type\":\"trade\"}";
+		corpus.append(frame);
+	}
+	return corpus;
+}
+
+bool MarketDataBenchmark::writeTickFile(const QString& path, const QList<QByteArray>& frames, int frameIntervalUs)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		return false;
+	}
+
+	const qint64 start = QDateTime::currentMSecsSinceEpoch() * 1000000;
+	char header[TickFile::FileHeaderSize];
+	TickFile::writeFileHeader(header, start);
+	file.write(header, sizeof(header));
+
+	qint64 receiveTime = start;
+	for (const QByteArray& frame : frames) {
+		char recordHeader[TickFile::RecordHeaderSize];
+		TickFile::writeRecordHeader(recordHeader, receiveTime, static_cast<quint32>(frame.size()),
+			static_cast<quint8>(TickFilePayload::Text));
+		file.write(recordHeader, sizeof(recordHeader));
+		file.write(frame);
+		receiveTime += static_cast<qint64>(frameIntervalUs) * 1000;
+	}
+	return file.error() == QFileDevice::NoError;
+}
+
+QString MarketDataBenchmark::compareTradeParsers(const QList<QByteArray>& corpus, int iterations)
+{
+	if (corpus.isEmpty()) {
+		return "[BENCH] Trade parser benchmark skipped - empty corpus";
+	}
+
+	// QWebSocket hands us QStrings, so both paths start from the same input
+	QStringList frames;
+	frames.reserve(corpus.size());
+	for (const QByteArray& frame : corpus) {
+		frames.append(QString::fromUtf8(frame));
+	}
+
+	// Collect the symbol universe up front so neither path pays for inserts
+	QMap<QString, MarketData*> legacyBook;
+	QHash<QByteArray, MarketData*> fastBook;
+	for (const QByteArray& frame : corpus) {
+		FinnhubTradeParser parser(frame);
+		FinnhubTrade trade;
+		while (parser.nextTrade(trade)) {
+			QByteArray key(trade.symbol, trade.symbolLength);
+			if (!fastBook.contains(key)) {
+				QString symbol = QString::fromUtf8(key);
+				legacyBook[symbol] = new MarketData(symbol, MarketDataType::Trade);
+				fastBook[key] = new MarketData(symbol, MarketDataType::Trade);
+			}
+		}
+	}
+
+	qint64 legacyTrades = 0;
+	double legacyChecksum = 0.0;
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < iterations; ++i) {
+		for (const QString& message : frames) {
+			QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+			if (doc.isNull() || !doc.isObject()) {
+				continue;
+			}
+			QJsonObject obj = doc.object();
+			if (obj["type"].toString() != "trade") {
+				continue;
+			}
+			QJsonArray dataArray = obj["data"].toArray();
+			for (const QJsonValue& val : dataArray) {
+				QJsonObject trade = val.toObject();
+				QString symbol = trade["s"].toString();
+				double price = trade["p"].toDouble();
+				double volume = trade["v"].toDouble();
+				qint64 timestamp = trade["t"].toVariant().toLongLong();
+				Q_UNUSED(timestamp);
+
+				if (!legacyBook.contains(symbol)) {
+					continue;
+				}
+				legacyBook[symbol]->updateTrade(price, volume);
+				legacyChecksum += price;
+				legacyTrades++;
+			}
+		}
+	}
+	qint64 legacyNs = timer.nsecsElapsed();
+
+	qint64 fastTrades = 0;
+	double fastChecksum = 0.0;
+	QByteArray buffer;
+	timer.restart();
+	for (int i = 0; i < iterations; ++i) {
+		for (const QString& message : frames) {
+			const int length = message.size();
+			buffer.resize(length);
+			const QChar* src = message.constData();
+			char* dst = buffer.data();
+			for (int c = 0; c < length; ++c) {
+				dst[c] = static_cast<char>(src[c].unicode());
+			}
+
+			FinnhubTradeParser parser(buffer);
+			FinnhubTrade trade;
+			while (parser.nextTrade(trade)) {
+				auto it = fastBook.constFind(QByteArray::fromRawData(trade.symbol, trade.symbolLength));
+				if (it == fastBook.constEnd()) {
+					continue;
+				}
+				it.value()->updateTrade(trade.price, trade.volume);
+				fastChecksum += trade.price;
+				fastTrades++;
+			}
+		}
+	}
+	qint64 fastNs = timer.nsecsElapsed();
+
+	qDeleteAll(legacyBook);
+	qDeleteAll(fastBook);
+
+	const qint64 totalFrames = static_cast<qint64>(frames.size()) * iterations;
+	const bool match = legacyTrades == fastTrades && qFuzzyCompare(legacyChecksum + 1.0, fastChecksum + 1.0);
+
+	return QString("[BENCH] Trade parsers over %1 frames x %2 (%3 trades): "
+		"QJsonDocument %4 ns/frame, FinnhubTradeParser %5 ns/frame, speedup %6x%7")
+		.arg(frames.size())
+		.arg(iterations)
+		.arg(fastTrades)
+		.arg(legacyNs / static_cast<double>(totalFrames), 0, 'f', 0)
+		.arg(fastNs / static_cast<double>(totalFrames), 0, 'f', 0)
+		.arg(fastNs > 0 ? legacyNs / static_cast<double>(fastNs) : 0.0, 0, 'f', 1)
+		.arg(match ? "" : " - RESULT MISMATCH");
+}
+
+QString MarketDataBenchmark::benchmarkOrderBook(const QList<int>& depths, int updates)
+{
+	struct BookUpdate {
+		BookSide side;
+		int distance;   // Levels from the best price
+		bool churn;     // Delete and re-add instead of modify
+		double size;
+	};
+
+	QStringList results;
+	for (int depth : depths) {
+		// Pre-generate the stream so RNG cost stays out of the timing. Real
+		// feeds hit the top levels hardest, so distance is roughly geometric.
+		QRandomGenerator rng(7);
+		QVector<BookUpdate> stream;
+		stream.reserve(updates);
+		for (int i = 0; i < updates; ++i) {
+			BookUpdate update;
+			update.side = rng.bounded(2) ? BookSide::Bid : BookSide::Ask;
+			int distance = 0;
+			while (distance < depth - 1 && rng.bounded(4) != 0) {
+				distance++;
+			}
+			update.distance = distance;
+			update.churn = rng.bounded(10) < 3;
+			update.size = 100.0 * (1 + rng.bounded(50));
+			stream.append(update);
+		}
+
+		OrderBook book(InvalidSymbolId, 0.01);
+		const qint64 bestBid = 10000;
+		const qint64 bestAsk = 10001;
+		for (int level = 0; level < depth; ++level) {
+			book.addLevel(BookSide::Bid, book.toPrice(bestBid - level), 100.0);
+			book.addLevel(BookSide::Ask, book.toPrice(bestAsk + level), 100.0);
+		}
+
+		double checksum = 0.0;
+		QElapsedTimer timer;
+		timer.start();
+		for (int i = 0; i < updates; ++i) {
+			const BookUpdate& update = stream[i];
+			const double price = update.side == BookSide::Bid
+				? book.toPrice(bestBid - update.distance)
+				: book.toPrice(bestAsk + update.distance);
+
+			if (update.churn) {
+				book.deleteLevel(update.side, price);
+				book.addLevel(update.side, price, update.size);
+			}
+			else {
+				book.modifyLevel(update.side, price, update.size);
+			}
+
+			if (i % 10 == 0) {
+				BookSideView top = book.top(update.side, 5);
+				for (int level = 0; level < top.count; ++level) {
+					checksum += top[level].size;
+				}
+			}
+		}
+		const qint64 elapsedNs = timer.nsecsElapsed();
+
+		const bool intact = book.depth(BookSide::Bid) == depth && book.depth(BookSide::Ask) == depth;
+		results.append(QString("%1 levels %2 ns/update (%3 M/s)%4")
+			.arg(depth)
+			.arg(elapsedNs / static_cast<double>(updates), 0, 'f', 1)
+			.arg(updates * 1000.0 / qMax<qint64>(1, elapsedNs), 0, 'f', 1)
+			.arg(intact && checksum > 0.0 ? "" : " - BOOK CORRUPTED"));
+	}
+
+	return QString("[BENCH] Order book, %1 updates per depth: %2")
+		.arg(updates)
+		.arg(results.join("; "));
+}
+
+namespace {
+	// Counts what it is delivered; shown is its own symbol filter for the
+	// broadcast comparison
+	class BusBenchmarkSubscriber : public MarketDataSubscriber {
+	public:
+		explicit BusBenchmarkSubscriber(int symbols)
+			: shown(symbols, false)
+		{
+		}
+
+		void onMarketDataUpdate(const MarketDataUpdate& update) override
+		{
+			updates++;
+			volume += update.volume;
+		}
+		void onMarketDataBatchEnd() override { batches++; }
+
+		QVector<bool> shown;
+		quint64 updates = 0;
+		quint64 batches = 0;
+		double volume = 0.0;
+	};
+}
+
+QString MarketDataBenchmark::benchmarkBus(int symbols, int subscribers, int symbolsPerSubscriber, int updates)
+{
+	const int batchSize = 500;
+
+	// The first subscriber takes every symbol, like the price table; the
+	// others follow their own random symbols, like watchlists and tickers
+	QRandomGenerator random(1303);
+	MarketDataBus bus;
+	QVector<BusBenchmarkSubscriber*> subscriberList;
+	for (int k = 0; k < subscribers; ++k) {
+		BusBenchmarkSubscriber* subscriber = new BusBenchmarkSubscriber(symbols);
+		if (k == 0) {
+			subscriber->shown.fill(true);
+			bus.subscribeAll(UpdateEvents, subscriber);
+		}
+		else {
+			for (int s = 0; s < symbolsPerSubscriber; ++s) {
+				const int id = random.bounded(symbols);
+				subscriber->shown[id] = true;
+				bus.subscribe(static_cast<SymbolId>(id), UpdateEvents, subscriber);
+			}
+		}
+		subscriberList.append(subscriber);
+	}
+
+	// Pre-generated so RNG cost stays out of the timing
+	QVector<SymbolId> stream;
+	stream.reserve(updates);
+	QVector<quint64> expected(subscribers, 0);
+	quint64 expectedTotal = 0;
+	for (int i = 0; i < updates; ++i) {
+		const SymbolId id = static_cast<SymbolId>(random.bounded(symbols));
+		stream.append(id);
+		for (int k = 0; k < subscribers; ++k) {
+			if (subscriberList[k]->shown[id]) {
+				expected[k]++;
+				expectedTotal++;
+			}
+		}
+	}
+
+	MarketDataUpdate update = {};
+	update.volume = 1.0;
+	update.tradeCount = 1;
+
+	// As the feed publishes: wants() first, endBatch() after each batch
+	QElapsedTimer timer;
+	timer.start();
+	for (int i = 0; i < updates; ++i) {
+		update.symbolId = stream[i];
+		if (bus.wants(update.symbolId, UpdateEvents)) {
+			bus.publishUpdate(update);
+		}
+		if ((i + 1) % batchSize == 0) {
+			bus.endBatch();
+		}
+	}
+	bus.endBatch();
+	const qint64 busNs = timer.nsecsElapsed();
+
+	bool delivered = bus.deliveries() == expectedTotal;
+	for (int k = 0; k < subscribers; ++k) {
+		delivered = delivered && subscriberList[k]->updates == expected[k] && subscriberList[k]->batches > 0;
+		subscriberList[k]->updates = 0;
+	}
+
+	// The alternative the bus replaces: every subscriber hears every update
+	// and drops the symbols it does not show
+	timer.restart();
+	for (int i = 0; i < updates; ++i) {
+		update.symbolId = stream[i];
+		for (BusBenchmarkSubscriber* subscriber : subscriberList) {
+			if (subscriber->shown[update.symbolId]) {
+				subscriber->onMarketDataUpdate(update);
+			}
+		}
+	}
+	const qint64 broadcastNs = timer.nsecsElapsed();
+
+	for (int k = 0; k < subscribers; ++k) {
+		delivered = delivered && subscriberList[k]->updates == expected[k];
+	}
+	qDeleteAll(subscriberList);
+
+	return QString("[BENCH] Market data bus, %1 symbols, %2 subscribers (one wildcard, %3 symbols each for the rest), %4 updates: "
+		"%5 ns/update for %6 deliveries per update; broadcast and filter in each subscriber %7 ns/update%8")
+		.arg(symbols)
+		.arg(subscribers)
+		.arg(symbolsPerSubscriber)
+		.arg(updates)
+		.arg(busNs / static_cast<double>(updates), 0, 'f', 1)
+		.arg(expectedTotal / static_cast<double>(updates), 0, 'f', 2)
+		.arg(broadcastNs / static_cast<double>(updates), 0, 'f', 1)
+		.arg(delivered ? "" : " - DELIVERY MISMATCH");
+}
+
+QString MarketDataBenchmark::stressSnapshots(int readers, int milliseconds)
+{
+	// Update k sets every field from k alone: quotes on even k, trades on odd
+	// k with volume 1, so a snapshot mixing two updates breaks an identity
+	MarketData data;
+	std::atomic<bool> stop(false);
+	std::atomic<quint64> updates(0);
+
+	struct ReaderStats {
+		quint64 reads = 0;
+		quint64 retries = 0;
+		quint64 torn = 0;
+		quint64 backwards = 0;
+	};
+	QVector<ReaderStats> stats(readers);
+
+	QThread* writer = QThread::create([&]() {
+		quint64 k = 0;
+		while (!stop.load(std::memory_order_relaxed)) {
+			for (int i = 0; i < 1024; ++i) {
+				++k;
+				const double value = static_cast<double>(k);
+				if (k % 2 == 0) {
+					data.updateQuote(value, 2.0 * value, value + 1.0, 3.0 * value, static_cast<qint64>(k), static_cast<qint64>(k));
+				}
+				else {
+					data.updateTrade(value, 1.0, static_cast<qint64>(k), static_cast<qint64>(k));
+				}
+			}
+		}
+		updates.store(k, std::memory_order_relaxed);
+		});
+
+	QList<QThread*> readerThreads;
+	for (int r = 0; r < readers; ++r) {
+		ReaderStats* out = &stats[r];
+		readerThreads.append(QThread::create([&data, &stop, out]() {
+			qint64 lastSeen = 0;
+			while (!stop.load(std::memory_order_relaxed)) {
+				MarketDataSnapshot s;
+				out->retries += data.snapshot(s);
+				out->reads++;
+
+				bool consistent = true;
+				if (s.bidPrice > 0.0) {
+					consistent = consistent && s.bidVolume == 2.0 * s.bidPrice
+						&& s.askPrice == s.bidPrice + 1.0 && s.askVolume == 3.0 * s.bidPrice;
+				}
+				if (s.totalVolume > 0.0) {
+					consistent = consistent && s.lastPrice == 2.0 * s.totalVolume - 1.0
+						&& s.highPrice == s.lastPrice && s.lowPrice == 1.0 && s.lastVolume == 1.0;
+				}
+				const qint64 latest = static_cast<qint64>(qMax(s.bidPrice, s.lastPrice));
+				consistent = consistent && s.exchangeTime == latest && s.receiveTime == latest;
+				if (!consistent) {
+					out->torn++;
+				}
+				if (s.exchangeTime < lastSeen) {
+					out->backwards++;
+				}
+				lastSeen = s.exchangeTime;
+			}
+			}));
+	}
+
+	writer->start();
+	for (QThread* thread : readerThreads) {
+		thread->start();
+	}
+	QThread::msleep(static_cast<unsigned long>(milliseconds));
+	stop.store(true, std::memory_order_relaxed);
+	writer->wait();
+	delete writer;
+	for (QThread* thread : readerThreads) {
+		thread->wait();
+		delete thread;
+	}
+
+	ReaderStats total;
+	for (const ReaderStats& reader : stats) {
+		total.reads += reader.reads;
+		total.retries += reader.retries;
+		total.torn += reader.torn;
+		total.backwards += reader.backwards;
+	}
+
+	const double seconds = milliseconds / 1000.0;
+	return QString("[BENCH] Snapshot stress: %1 M updates/s, %2 readers %3 M reads/s, %4 retries, %5 torn, %6 out of order%7")
+		.arg(updates.load() / seconds / 1e6, 0, 'f', 1)
+		.arg(readers)
+		.arg(total.reads / seconds / 1e6, 0, 'f', 1)
+		.arg(total.retries)
+		.arg(total.torn)
+		.arg(total.backwards)
+		.arg(total.torn == 0 && total.backwards == 0 ? "" : " - TORN READS");
+}
+
+namespace {
+	// Textbook definitions over the whole history, using the engine's
+	// max(alpha, 1 / n) warm-up weights
+	IndicatorValues referenceIndicators(const IndicatorConfig& config, const QVector<Bar>& history)
+	{
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+		const int n = history.size();
+		IndicatorValues out;
+		out.bars = n;
+
+		auto ema = [&](const QVector<double>& input, int period) {
+			double value = 0.0;
+			for (int k = 0; k < input.size(); ++k) {
+				value += qMax(2.0 / (period + 1.0), 1.0 / (k + 1.0)) * (input[k] - value);
+			}
+			return value;
+		};
+		auto wilder = [&](const QVector<double>& input, int period) {
+			double value = 0.0;
+			for (int k = 0; k < input.size(); ++k) {
+				value += qMax(1.0 / period, 1.0 / (k + 1.0)) * (input[k] - value);
+			}
+			return value;
+		};
+
+		QVector<double> closes;
+		QVector<double> ranges;
+		QVector<double> gains;
+		QVector<double> losses;
+		for (int k = 0; k < n; ++k) {
+			const Bar& bar = history[k];
+			const double previous = k > 0 ? history[k - 1].close : bar.close;
+			closes.append(bar.close);
+			ranges.append(qMax(bar.high - bar.low, qMax(std::fabs(bar.high - previous), std::fabs(bar.low - previous))));
+			if (k > 0) {
+				gains.append(qMax(bar.close - previous, 0.0));
+				losses.append(qMax(previous - bar.close, 0.0));
+			}
+		}
+
+		out.ema = n >= config.emaPeriod ? ema(closes, config.emaPeriod) : nan;
+		if (n >= config.smaPeriod) {
+			double sum = 0.0;
+			for (int k = n - config.smaPeriod; k < n; ++k) {
+				sum += closes[k];
+			}
+			const double mean = sum / config.smaPeriod;
+			double variance = 0.0;
+			for (int k = n - config.smaPeriod; k < n; ++k) {
+				variance += (closes[k] - mean) * (closes[k] - mean);
+			}
+			const double width = config.bollingerWidth * std::sqrt(variance / config.smaPeriod);
+			out.sma = mean;
+			out.bollingerUpper = mean + width;
+			out.bollingerLower = mean - width;
+		}
+		else {
+			out.sma = out.bollingerUpper = out.bollingerLower = nan;
+		}
+
+		if (n > config.rsiPeriod) {
+			const double gain = wilder(gains, config.rsiPeriod);
+			const double loss = wilder(losses, config.rsiPeriod);
+			out.rsi = gain + loss > 0.0 ? 100.0 * gain / (gain + loss) : 50.0;
+		}
+		else {
+			out.rsi = nan;
+		}
+
+		QVector<double> macdLine;
+		QVector<double> prefix;
+		for (int k = 0; k < n; ++k) {
+			prefix.append(closes[k]);
+			macdLine.append(ema(prefix, config.macdFast) - ema(prefix, config.macdSlow));
+		}
+		const double macd = n > 0 ? macdLine.last() : 0.0;
+		const double signal = ema(macdLine, config.macdSignal);
+		const bool signalReady = n >= config.macdSlow + config.macdSignal - 1;
+		out.macd = n >= config.macdSlow ? macd : nan;
+		out.macdSignal = signalReady ? signal : nan;
+		out.macdHistogram = signalReady ? macd - signal : nan;
+		out.atr = n >= config.atrPeriod ? wilder(ranges, config.atrPeriod) : nan;
+		return out;
+	}
+
+	// Relative difference, or infinity if only one side is NaN
+	double indicatorError(double value, double expected)
+	{
+		if (std::isnan(value) || std::isnan(expected)) {
+			return std::isnan(value) == std::isnan(expected) ? 0.0 : std::numeric_limits<double>::infinity();
+		}
+		return std::fabs(value - expected) / qMax(1.0, std::fabs(expected));
+	}
+}
+
+QString MarketDataBenchmark::checkIndicators(int symbols, int batches)
+{
+	const IndicatorConfig config;
+	IndicatorEngine engine;
+	engine.setConfig(config);
+
+	QRandomGenerator random(20250101);
+	QVector<QVector<Bar>> history(symbols);
+	QVector<double> price(symbols, 100.0);
+	qint64 bars = 0;
+	qint64 multiBarBatches = 0;
+	qint64 mismatches = 0;
+	double worst = 0.0;
+
+	for (int batch = 0; batch < batches; ++batch) {
+		for (int s = 0; s < symbols; ++s) {
+			const int count = random.bounded(5);
+			multiBarBatches += count > 1 ? 1 : 0;
+			for (int k = 0; k < count; ++k) {
+				Bar bar = {};
+				bar.open = price[s];
+				bar.close = qMax(1.0, price[s] + (random.generateDouble() - 0.5) * 2.0);
+				bar.high = qMax(bar.open, bar.close) + random.generateDouble();
+				bar.low = qMin(bar.open, bar.close) - random.generateDouble();
+				price[s] = bar.close;
+				history[s].append(bar);
+				engine.addBar(static_cast<SymbolId>(s), bar);
+				bars++;
+			}
+		}
+		engine.update();
+
+		for (int s = 0; s < symbols; ++s) {
+			IndicatorValues actual;
+			if (!engine.values(static_cast<SymbolId>(s), actual)) {
+				mismatches += history[s].isEmpty() ? 0 : 1;
+				continue;
+			}
+			const IndicatorValues expected = referenceIndicators(config, history[s]);
+			const double error = qMax(qMax(qMax(indicatorError(actual.ema, expected.ema), indicatorError(actual.sma, expected.sma)),
+				qMax(indicatorError(actual.bollingerUpper, expected.bollingerUpper), indicatorError(actual.bollingerLower, expected.bollingerLower))),
+				qMax(qMax(indicatorError(actual.rsi, expected.rsi), indicatorError(actual.macd, expected.macd)),
+				qMax(qMax(indicatorError(actual.macdSignal, expected.macdSignal), indicatorError(actual.macdHistogram, expected.macdHistogram)),
+				indicatorError(actual.atr, expected.atr))));
+			worst = qMax(worst, error);
+			if (actual.bars != expected.bars || error > 1e-9) {
+				mismatches++;
+			}
+		}
+	}
+
+	return QString("[BENCH] Indicator check: %1 bars over %2 symbols, %3 times several bars for one symbol in a batch, max relative error %4, %5 mismatches%6")
+		.arg(bars)
+		.arg(symbols)
+		.arg(multiBarBatches)
+		.arg(worst, 0, 'g', 3)
+		.arg(mismatches)
+		.arg(mismatches == 0 ? "" : " - FAILED");
+}
+
+namespace {
+	struct BarTrade {
+		qint64 timestamp;
+		double price;
+		double volume;
+	};
+
+	// Buckets the trades by interval in arrival order, where a trade stamped
+	// at or before the open bucket joins it, then builds each bar from its
+	// own trade list
+	QVector<Bar> referenceBars(const QVector<BarTrade>& trades, qint64 intervalMSecs)
+	{
+		QVector<QVector<int>> buckets;
+		QVector<qint64> starts;
+		for (int k = 0; k < trades.size(); ++k) {
+			const qint64 start = trades[k].timestamp - trades[k].timestamp % intervalMSecs;
+			if (starts.isEmpty() || start > starts.last()) {
+				starts.append(start);
+				buckets.append(QVector<int>());
+			}
+			buckets.last().append(k);
+		}
+
+		QVector<Bar> bars;
+		for (int b = 0; b < buckets.size(); ++b) {
+			Bar bar = {};
+			bar.startTime = starts[b];
+			bar.open = trades[buckets[b].first()].price;
+			bar.close = trades[buckets[b].last()].price;
+			bar.high = bar.open;
+			bar.low = bar.open;
+			for (int k : buckets[b]) {
+				bar.high = qMax(bar.high, trades[k].price);
+				bar.low = qMin(bar.low, trades[k].price);
+				bar.volume += trades[k].volume;
+				bar.notional += trades[k].price * trades[k].volume;
+			}
+			bar.trades = static_cast<quint32>(buckets[b].size());
+			bars.append(bar);
+		}
+		return bars;
+	}
+
+	bool sameBar(const Bar& actual, const Bar& expected)
+	{
+		auto close = [](double value, double reference) {
+			return std::fabs(value - reference) <= 1e-12 * qMax(1.0, std::fabs(reference));
+		};
+		return actual.startTime == expected.startTime && actual.open == expected.open
+			&& actual.high == expected.high && actual.low == expected.low && actual.close == expected.close
+			&& actual.trades == expected.trades && close(actual.volume, expected.volume)
+			&& close(actual.notional, expected.notional) && close(actual.vwap(), expected.vwap());
+	}
+}
+
+QString MarketDataBenchmark::checkBars(int symbols, int tradesPerSymbol)
+{
+	const int intervals = static_cast<int>(BarInterval::Count);
+
+	// Seconds apart on average with a jump of up to ten minutes every 500
+	// trades, so one trade closes several intervals at once and every ring
+	// wraps within the run. One trade in 100 is stamped up to 4 s back and
+	// one in 2000 up to 7 minutes back.
+	QRandomGenerator random(20250317);
+	QVector<QVector<BarTrade>> history(symbols);
+	QVector<qint64> latest(symbols, Q_INT64_C(1735689600000));
+	QVector<double> price(symbols, 100.0);
+	QVector<SymbolId> stream;
+	stream.reserve(symbols * tradesPerSymbol);
+	quint64 expectedLate = 0;
+	for (int t = 0; t < symbols * tradesPerSymbol; ++t) {
+		const int s = random.bounded(symbols);
+		BarTrade trade;
+		const int roll = history[s].isEmpty() ? 1000 : random.bounded(2000);
+		if (roll == 0) {
+			trade.timestamp = latest[s] - random.bounded(420000);
+		}
+		else if (roll < 20) {
+			trade.timestamp = latest[s] - random.bounded(4000);
+		}
+		else {
+			latest[s] += roll < 24 ? random.bounded(600000) : random.bounded(3000);
+			trade.timestamp = latest[s];
+		}
+		// Buckets nest, so a trade late for any interval is late for 1 s
+		if (trade.timestamp - trade.timestamp % 1000 < latest[s] - latest[s] % 1000) {
+			expectedLate++;
+		}
+		price[s] = qMax(1.0, price[s] + (random.generateDouble() - 0.5) * 0.1);
+		trade.price = price[s];
+		trade.volume = 1 + random.bounded(500);
+		history[s].append(trade);
+		stream.append(static_cast<SymbolId>(s));
+	}
+
+	BarAggregator aggregator;
+	QVector<QVector<Bar>> closedBars(symbols * intervals);
+	QVector<int> position(symbols, 0);
+	ClosedBar closed[static_cast<int>(BarInterval::Count)];
+	qint64 multiClose = 0;
+	qint64 mismatches = 0;
+	for (SymbolId id : stream) {
+		const BarTrade& trade = history[id][position[id]++];
+		const int mask = aggregator.addTrade(id, trade.timestamp, trade.price, trade.volume, closed);
+		int count = 0;
+		for (int i = 0; i < intervals; ++i) {
+			if (!(mask & (1 << i))) {
+				continue;
+			}
+			if (closed[count].symbolId != id || static_cast<int>(closed[count].interval) != i) {
+				mismatches++;
+			}
+			closedBars[id * intervals + i].append(closed[count].bar);
+			count++;
+		}
+		multiClose += count > 1 ? 1 : 0;
+	}
+
+	// Every closed bar, the open bar and each ring's contents against the
+	// reference; a ring holds the newest capacity bars, the open one last
+	QVector<int> fewestBars(intervals, std::numeric_limits<int>::max());
+	bool wrapped = true;
+	for (int s = 0; s < symbols; ++s) {
+		const SymbolId id = static_cast<SymbolId>(s);
+		for (int i = 0; i < intervals; ++i) {
+			const BarInterval interval = static_cast<BarInterval>(i);
+			const QVector<Bar> expected = referenceBars(history[s], BarAggregator::intervalMSecs(interval));
+			const QVector<Bar>& emitted = closedBars[s * intervals + i];
+			const int produced = static_cast<int>(expected.size());
+			const int capacity = aggregator.capacity(interval);
+			fewestBars[i] = qMin(fewestBars[i], produced);
+			wrapped = wrapped && produced > capacity;
+
+			if (emitted.size() != produced - 1) {
+				mismatches++;
+				continue;
+			}
+			for (int b = 0; b < emitted.size(); ++b) {
+				mismatches += sameBar(emitted[b], expected[b]) ? 0 : 1;
+			}
+
+			const QVector<Bar> held = aggregator.bars(id, interval, capacity);
+			const int count = qMin(produced, capacity);
+			if (aggregator.barCount(id, interval) != count || held.size() != count) {
+				mismatches++;
+				continue;
+			}
+			for (int b = 0; b < count; ++b) {
+				mismatches += sameBar(held[b], expected[produced - count + b]) ? 0 : 1;
+				Bar bar;
+				if (!aggregator.bar(id, interval, count - 1 - b, bar) || !sameBar(bar, held[b])) {
+					mismatches++;
+				}
+			}
+		}
+	}
+	const bool lateCounted = aggregator.lateTrades() == expectedLate;
+
+	// Throughput over the same stream into fresh rings
+	BarAggregator timed;
+	position.fill(0);
+	qint64 closedTotal = 0;
+	QElapsedTimer timer;
+	timer.start();
+	for (SymbolId id : stream) {
+		const BarTrade& trade = history[id][position[id]++];
+		closedTotal += timed.addTrade(id, trade.timestamp, trade.price, trade.volume, closed) != 0 ? 1 : 0;
+	}
+	const qint64 elapsedNs = timer.nsecsElapsed();
+
+	QStringList held;
+	for (int i = 0; i < intervals; ++i) {
+		const BarInterval interval = static_cast<BarInterval>(i);
+		held.append(QString("%1 %2 of %3+").arg(BarAggregator::intervalName(interval)).arg(aggregator.capacity(interval)).arg(fewestBars[i]));
+	}
+
+	const bool failed = mismatches != 0 || !lateCounted || !wrapped || multiClose == 0 || closedTotal == 0;
+	return QString("[BENCH] Bar check: %1 trades over %2 symbols, %3 late (%4 counted), %5 trades closed several bars at once, "
+		"bars held %6, %7 mismatches; %8 M trades/s%9")
+		.arg(stream.size())
+		.arg(symbols)
+		.arg(expectedLate)
+		.arg(aggregator.lateTrades())
+		.arg(multiClose)
+		.arg(held.join(", "))
+		.arg(mismatches)
+		.arg(stream.size() * 1000.0 / qMax<qint64>(1, elapsedNs), 0, 'f', 1)
+		.arg(failed ? " - FAILED" : "");
+}
+
+QString MarketDataBenchmark::checkSnapshotLoader()
+{
+	const int maxInFlight = 4;
+	const int backoff = 100;
+	const int maxRetries = 3;
+	const int retryAfter = 1;
+
+	QThread serverThread;
+	serverThread.setObjectName("SnapshotStandIn");
+	SnapshotStandIn* standIn = new SnapshotStandIn();
+	standIn->setResponseDelay(30);  // Long enough for requests to overlap
+	standIn->setRetryAfter(retryAfter);
+	standIn->script("RATE", { 429, 200 });
+	standIn->script("FLAKY", { 503, 502, 200 });
+	standIn->script("DOWN", { 500, 500, 500, 500, 500 });
+	standIn->moveToThread(&serverThread);
+	serverThread.start();
+
+	bool listening = false;
+	QMetaObject::invokeMethod(standIn, [standIn, &listening]() {
+		listening = standIn->start();
+		}, Qt::BlockingQueuedConnection);
+
+	auto stopServer = [&]() {
+		QMetaObject::invokeMethod(standIn, [standIn]() {
+			delete standIn;
+			}, Qt::BlockingQueuedConnection);
+		serverThread.quit();
+		serverThread.wait();
+	};
+	if (!listening) {
+		stopServer();
+		return "[BENCH] Snapshot loader check: cannot listen on a loopback port";
+	}
+
+	QNetworkAccessManager network;
+	SnapshotLoader loader(&network);
+	loader.setBaseUrl(standIn->baseUrl());
+	loader.setApiKey("standin");
+	loader.setMaxInFlight(maxInFlight);
+	loader.setMaxRetries(maxRetries);
+	loader.setRetryBackoff(backoff);
+
+	QHash<QString, int> received;
+	QHash<QString, int> failed;
+	QEventLoop loop;
+	QObject::connect(&loader, &SnapshotLoader::snapshotReceived, &loop, [&](const QString& symbol, const SnapshotQuote&) {
+		received[symbol]++;
+		});
+	QObject::connect(&loader, &SnapshotLoader::snapshotFailed, &loop, [&](const QString& symbol, const QString&) {
+		failed[symbol]++;
+		});
+	QObject::connect(&loader, &SnapshotLoader::progress, &loop, [&]() {
+		if (loader.isIdle()) {
+			loop.quit();
+		}
+		});
+	QTimer timeout;
+	timeout.setSingleShot(true);
+	QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+	// CANCELF takes a slot at once and is cancelled in flight; CANCELQ is
+	// last in the queue and cancelled before it starts
+	QStringList plain;
+	for (int i = 0; i < 24; ++i) {
+		plain.append(QString("S%1").arg(i, 2, 10, QChar('0')));
+	}
+	loader.request("CANCELF");
+	loader.request("RATE");
+	loader.request("FLAKY");
+	loader.request("DOWN");
+	for (const QString& symbol : plain) {
+		loader.request(symbol);
+		loader.request(symbol);  // Coalesced with the first
+	}
+	loader.request("CANCELQ");
+	loader.cancel("CANCELQ");
+	loader.cancel("CANCELF");
+
+	QElapsedTimer elapsed;
+	elapsed.start();
+	timeout.start(20000);
+	loop.exec();
+	const bool idle = loader.isIdle();
+
+	QStringList report;
+	int passed = 0;
+	int checks = 0;
+	auto check = [&](bool ok, const QString& detail) {
+		checks++;
+		passed += ok ? 1 : 0;
+		report.append(QString("  %1 %2").arg(QString(ok ? "ok  " : "FAIL"), detail));
+	};
+
+	int plainRequests = 0;
+	bool eachOnce = true;
+	for (const QString& symbol : plain) {
+		plainRequests += standIn->requests(symbol).size();
+		eachOnce = eachOnce && received.value(symbol) == 1 && standIn->requests(symbol).size() == 1;
+	}
+	check(eachOnce, QString("dedup: %1 symbols requested twice, %2 server requests, each delivered once")
+		.arg(plain.size()).arg(plainRequests));
+
+	const int peak = standIn->maxConcurrent();
+	check(peak == maxInFlight, QString("in-flight cap: at most %1 requests open at the server (limit %2)")
+		.arg(peak).arg(maxInFlight));
+
+	// Gaps between successive attempts at the server
+	auto gaps = [&](const QString& symbol) {
+		QList<qint64> result;
+		const QList<SnapshotStandIn::Request> requests = standIn->requests(symbol);
+		for (int i = 1; i < requests.size(); ++i) {
+			result.append(requests[i].receivedAt - requests[i - 1].receivedAt);
+		}
+		return result;
+	};
+	auto formatGaps = [](const QList<qint64>& values) {
+		QStringList parts;
+		for (qint64 value : values) {
+			parts.append(QString::number(value));
+		}
+		return parts.join(", ");
+	};
+
+	const QList<qint64> rateGaps = gaps("RATE");
+	check(rateGaps.size() == 1 && rateGaps[0] >= retryAfter * 1000 && received.value("RATE") == 1,
+		QString("429 with Retry-After %1 s: retried after %2 ms, delivered %3")
+		.arg(retryAfter).arg(formatGaps(rateGaps)).arg(received.value("RATE")));
+
+	// Backoff doubles per attempt; jitter adds up to half the base delay
+	const QList<qint64> flakyGaps = gaps("FLAKY");
+	bool backedOff = flakyGaps.size() == 2 && received.value("FLAKY") == 1;
+	for (int i = 0; backedOff && i < flakyGaps.size(); ++i) {
+		backedOff = flakyGaps[i] >= (backoff << i);
+	}
+	check(backedOff, QString("503, 502 then 200: retried after %1 ms (backoff %2 ms doubling, jitter up to %3 ms), delivered %4")
+		.arg(formatGaps(flakyGaps)).arg(backoff).arg(backoff / 2).arg(received.value("FLAKY")));
+
+	const int downAttempts = standIn->requests("DOWN").size();
+	check(downAttempts == maxRetries + 1 && failed.value("DOWN") == 1 && !received.contains("DOWN"),
+		QString("persistent 500: %1 attempts (1 + %2 retries), failure reported %3 time(s), gaps %4 ms")
+		.arg(downAttempts).arg(maxRetries).arg(failed.value("DOWN")).arg(formatGaps(gaps("DOWN"))));
+
+	check(standIn->requests("CANCELQ").isEmpty() && !received.contains("CANCELQ") && !failed.contains("CANCELQ"),
+		QString("cancel while queued: %1 server requests, no result reported").arg(standIn->requests("CANCELQ").size()));
+	check(standIn->requests("CANCELF").size() == 1 && !received.contains("CANCELF") && !failed.contains("CANCELF"),
+		QString("cancel in flight: %1 server request, no result reported").arg(standIn->requests("CANCELF").size()));
+	check(idle, QString("loader idle after %1 ms").arg(elapsed.elapsed()));
+
+	stopServer();
+	report.prepend(QString("[BENCH] Snapshot loader check against a loopback HTTP stand-in: %1 of %2 checks passed%3")
+		.arg(passed).arg(checks).arg(passed == checks ? "" : " - FAILED"));
+	return report.join('\n');
+}
+
+namespace {
+	PacketSequenceStats sequenceStats(quint64 packets, quint64 gaps, quint64 missing, quint64 late, quint64 duplicates, quint64 resets)
+	{
+		PacketSequenceStats stats;
+		stats.packets = packets;
+		stats.gaps = gaps;
+		stats.missing = missing;
+		stats.late = late;
+		stats.duplicates = duplicates;
+		stats.resets = resets;
+		return stats;
+	}
+
+	bool sameSequenceStats(const PacketSequenceStats& a, const PacketSequenceStats& b)
+	{
+		return a.packets == b.packets && a.gaps == b.gaps && a.missing == b.missing
+			&& a.late == b.late && a.duplicates == b.duplicates && a.resets == b.resets;
+	}
+
+	QString formatSequenceStats(const PacketSequenceStats& stats)
+	{
+		return QString("%1 packets, %2 gaps, %3 missing, %4 late, %5 duplicates, %6 resets")
+			.arg(stats.packets).arg(stats.gaps).arg(stats.missing)
+			.arg(stats.late).arg(stats.duplicates).arg(stats.resets);
+	}
+}
+
+QString MarketDataBenchmark::checkSequenceTracker(int packets, double lossRatio)
+{
+	typedef PacketSequenceTracker::Result Result;
+	const quint64 window = PacketSequenceTracker::WindowSize;
+
+	QStringList report;
+	int passed = 0;
+	int checks = 0;
+	auto check = [&](bool ok, const QString& detail) {
+		checks++;
+		passed += ok ? 1 : 0;
+		report.append(QString("  %1 %2").arg(QString(ok ? "ok  " : "FAIL"), detail));
+	};
+
+	// Scripted sequences: every result must match, then every counter
+	auto feed = [](PacketSequenceTracker& tracker, quint64 sequence, Result expected) {
+		return tracker.onPacket(sequence) == expected;
+	};
+	auto feedRange = [](PacketSequenceTracker& tracker, quint64 first, quint64 last) {
+		bool ok = true;
+		for (quint64 sequence = first; sequence <= last; ++sequence) {
+			const Result expected = tracker.expected() == 0 ? Result::First : Result::InOrder;
+			ok = tracker.onPacket(sequence) == expected && ok;
+		}
+		return ok;
+	};
+	auto verify = [&](const QString& name, const PacketSequenceTracker& tracker, bool results, const PacketSequenceStats& expected) {
+		check(results && sameSequenceStats(tracker.stats(), expected), QString("%1: %2%3")
+			.arg(name, formatSequenceStats(tracker.stats()))
+			.arg(results ? "" : ", unexpected result"));
+	};
+
+	{
+		PacketSequenceTracker tracker;
+		const bool results = feedRange(tracker, 1, 5) && feed(tracker, 8, Result::Gap)
+			&& feed(tracker, 6, Result::Late) && feed(tracker, 6, Result::Duplicate)
+			&& feed(tracker, 8, Result::Duplicate) && feed(tracker, 9, Result::InOrder)
+			&& feed(tracker, 7, Result::Late);
+		verify("gap of 2 filled late, duplicates of a late and a gap packet", tracker, results, sequenceStats(9, 1, 0, 2, 2, 0));
+	}
+	{
+		// 1025 in order, so 2 is exactly WindowSize back and 1 is past the window
+		PacketSequenceTracker tracker;
+		const bool results = feedRange(tracker, 1, window + 1) && feed(tracker, 2, Result::Duplicate)
+			&& feed(tracker, 1, Result::Reset) && feed(tracker, 2, Result::InOrder);
+		verify("duplicate exactly WindowSize back, reset one further", tracker, results, sequenceStats(window + 3, 0, 0, 0, 1, 1));
+	}
+	{
+		// A gap of exactly WindowSize clears the whole bitmap
+		PacketSequenceTracker tracker;
+		const bool results = feed(tracker, 1, Result::First) && feed(tracker, window + 2, Result::Gap)
+			&& feed(tracker, 3, Result::Late) && feed(tracker, 3, Result::Duplicate)
+			&& feed(tracker, 2, Result::Reset);
+		verify("gap of WindowSize, late exactly WindowSize back", tracker, results, sequenceStats(4, 1, window - 1, 1, 1, 1));
+	}
+	{
+		// 1025 shares a slot with 1, which must not read as already seen
+		PacketSequenceTracker tracker;
+		const bool results = feedRange(tracker, 1, 100) && feed(tracker, window + 105, Result::Gap)
+			&& feed(tracker, window + 1, Result::Late) && feed(tracker, window + 1, Result::Duplicate)
+			&& feed(tracker, window + 106, Result::InOrder);
+		verify("gap past the window clears stale slots", tracker, results, sequenceStats(103, 1, window + 3, 1, 1, 0));
+	}
+	{
+		// The skipped 1001..1499 reuse the slots of 1..475; 900 keeps its bit
+		PacketSequenceTracker tracker;
+		const bool results = feedRange(tracker, 1, 1000) && feed(tracker, 1500, Result::Gap)
+			&& feed(tracker, 1100, Result::Late) && feed(tracker, 900, Result::Duplicate)
+			&& feed(tracker, 1499, Result::Late);
+		verify("gap inside the window wrapping the slots", tracker, results, sequenceStats(1003, 1, 497, 2, 1, 0));
+	}
+	{
+		// The first skipped number, 1125, shares a slot with 101
+		PacketSequenceTracker tracker;
+		const bool results = feedRange(tracker, 1, window + 100) && feed(tracker, window + 110, Result::Gap)
+			&& feed(tracker, window + 101, Result::Late);
+		verify("first skipped number's slot still set from a window ago", tracker, results, sequenceStats(window + 102, 1, 8, 1, 0, 0));
+	}
+	{
+		PacketSequenceTracker tracker;
+		bool results = feedRange(tracker, 1, 3) && feed(tracker, 5, Result::Gap);
+		tracker.reset();
+		results = results && feed(tracker, 1, Result::First) && feed(tracker, 2, Result::InOrder);
+		verify("reset() restarts tracking and keeps the counters", tracker, results, sequenceStats(6, 1, 1, 0, 0, 0));
+	}
+	{
+		PacketSequenceTracker tracker;
+		const bool results = feedRange(tracker, 5000, 5002) && feed(tracker, 10, Result::Reset)
+			&& feed(tracker, 11, Result::InOrder) && feed(tracker, 5003, Result::Gap);
+		verify("publisher restart far back, then a jump forward", tracker, results, sequenceStats(6, 1, 4991, 0, 0, 1));
+	}
+
+	// Loopback run: the publisher numbers every datagram but skips lossRatio
+	// of them, so the handler must count exactly those as missing - except a
+	// run of skips at the very end, which no later packet reveals
+	QTemporaryDir directory;
+	const QString capturePath = directory.filePath("sequence-check.ltf");
+	const int recordsPerPacket = 20;
+	const int tradesPerFrame = 8;
+	if (!directory.isValid()
+		|| !writeTickFile(capturePath, generateTradeCorpus(packets * recordsPerPacket / tradesPerFrame, tradesPerFrame), 1000)) {
+		check(false, "loopback: cannot write the capture");
+	}
+	else {
+		SpscRing<FeedTick> ring(1 << 16);
+		MulticastFeedHandler handler(&ring, FirstSessionSource);
+		MulticastPublisher publisher;
+
+		MulticastFeedConfig feedConfig = MulticastFeedHandler::defaultConfig();
+		feedConfig.group = "239.192.0.254";  // Away from the sessions' default group
+		feedConfig.port = 30999;
+		feedConfig.interfaceAddress = "127.0.0.1";
+		MulticastPublisherConfig publisherConfig = MulticastPublisher::defaultConfig();
+		publisherConfig.group = feedConfig.group;
+		publisherConfig.port = feedConfig.port;
+		publisherConfig.packetsPerSecond = 50000;
+		publisherConfig.recordsPerPacket = recordsPerPacket;
+		publisherConfig.loops = 1;
+		publisherConfig.lossRatio = lossRatio;
+
+		QString startError;
+		QMetaObject::Connection handlerLog = QObject::connect(&handler, &MulticastFeedHandler::logMessage, [&](const QString& message) {
+			startError = message;
+			});
+		QMetaObject::Connection publisherLog = QObject::connect(&publisher, &MulticastPublisher::logMessage, [&](const QString& message) {
+			startError = message;
+			});
+		const bool started = handler.start(feedConfig) && publisher.start(capturePath, publisherConfig);
+		QObject::disconnect(handlerLog);
+		QObject::disconnect(publisherLog);
+
+		if (!started) {
+			// No multicast on this host (or not Linux); the scripted checks still stand
+			handler.stop();
+			report.append(QString("  skip loopback run: %1").arg(startError));
+		}
+		else {
+			quint64 drained = 0;
+			FeedTick tick;
+			auto drain = [&]() {
+				while (ring.tryPop(tick)) {
+					drained++;
+				}
+			};
+			QElapsedTimer elapsed;
+			elapsed.start();
+			while (publisher.isRunning() && elapsed.elapsed() < 60000) {
+				drain();
+				QThread::msleep(1);
+			}
+			QElapsedTimer settle;
+			settle.start();
+			while (handler.stats().packets < publisher.stats().packetsSent && settle.elapsed() < 2000) {
+				drain();
+				QThread::msleep(1);
+			}
+			publisher.stop();
+			handler.stop();
+			drain();
+
+			const MulticastPublisherStats sent = publisher.stats();
+			const MulticastFeedStats received = handler.stats();
+			const quint64 numbered = sent.packetsSent + sent.packetsSkipped + sent.sendErrors;
+			const quint64 unseen = numbered - qMin(numbered, received.sequence.packets + received.sequence.missing);
+			check(received.packets == sent.packetsSent && received.sequence.packets == sent.packetsSent,
+				QString("loopback: %1 datagrams numbered, %2 sent, %3 received")
+				.arg(numbered).arg(sent.packetsSent).arg(received.packets));
+			check(sent.packetsSkipped > 0 && received.sequence.missing + unseen == sent.packetsSkipped + sent.sendErrors && unseen < 16,
+				QString("loopback: %1 skipped by the publisher, %2 send errors, %3 missing in %4 gaps, %5 trailing")
+				.arg(sent.packetsSkipped).arg(sent.sendErrors).arg(received.sequence.missing)
+				.arg(received.sequence.gaps).arg(unseen));
+			check(received.sequence.late == 0 && received.sequence.duplicates == 0 && received.sequence.resets == 0,
+				QString("loopback: %1 late, %2 duplicates, %3 resets")
+				.arg(received.sequence.late).arg(received.sequence.duplicates).arg(received.sequence.resets));
+			check(received.ticksEnqueued + received.ticksDropped == sent.recordsSent && drained == received.ticksEnqueued
+				&& received.malformed == 0,
+				QString("loopback: %1 records sent, %2 ticks enqueued, %3 dropped on a full ring, %4 malformed")
+				.arg(sent.recordsSent).arg(received.ticksEnqueued).arg(received.ticksDropped).arg(received.malformed));
+		}
+	}
+
+	report.prepend(QString("[BENCH] Packet sequence check: %1 of %2 checks passed%3")
+		.arg(passed).arg(checks).arg(passed == checks ? "" : " - FAILED"));
+	return report.join('\n');
+}
+
+QString MarketDataBenchmark::compareTransports(int roundTrips, int messages)
+{
+	const int window = 256;
+
+	// Echo server on its own thread, so the client loop only runs the transport
+	QThread serverThread;
+	serverThread.setObjectName("TransportBenchmarkEcho");
+	QWebSocketServer* server = new QWebSocketServer("LightningTrade Echo", QWebSocketServer::NonSecureMode);
+	server->moveToThread(&serverThread);
+	serverThread.start();
+
+	quint16 port = 0;
+	QMetaObject::invokeMethod(server, [server, &port]() {
+		QObject::connect(server, &QWebSocketServer::newConnection, server, [server]() {
+			while (QWebSocket* client = server->nextPendingConnection()) {
+				QObject::connect(client, &QWebSocket::textMessageReceived, client, [client](const QString& message) {
+					client->sendTextMessage(message);
+					});
+				QObject::connect(client, &QWebSocket::disconnected, client, &QObject::deleteLater);
+			}
+			});
+		if (server->listen(QHostAddress::LocalHost, 0)) {
+			port = server->serverPort();
+		}
+		}, Qt::BlockingQueuedConnection);
+
+	auto stopServer = [&]() {
+		QMetaObject::invokeMethod(server, [server]() {
+			server->close();
+			delete server;
+			}, Qt::BlockingQueuedConnection);
+		serverThread.quit();
+		serverThread.wait();
+	};
+	if (port == 0) {
+		stopServer();
+		return "[BENCH] Transport benchmark: cannot listen on a loopback port";
+	}
+
+	const QUrl url(QString("ws://127.0.0.1:%1/").arg(port));
+	const QString payload = QString::fromUtf8(generateTradeCorpus(1, 2).first());
+	const QStringList batch(window, payload);
+
+	QStringList report;
+	const WebSocketTransportKind kinds[] = { WebSocketTransportKind::Qt, WebSocketTransportKind::IoUring };
+	for (WebSocketTransportKind kind : kinds) {
+		const QString name = WebSocketTransport::kindName(kind);
+		if (!WebSocketTransport::isAvailable(kind)) {
+			report.append(QString("[BENCH] %1 transport: not available on this system").arg(name));
+			continue;
+		}
+
+		std::unique_ptr<WebSocketTransport> transport(WebSocketTransport::create(kind));
+		std::unique_ptr<LatencyHistogram> latency(new LatencyHistogram());
+		QEventLoop loop;
+		QTimer timeout;
+		timeout.setSingleShot(true);
+		QObject::connect(&timeout, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+		enum Phase { Connecting, PingPong, Pipelined };
+		Phase phase = Connecting;
+		QString error;
+		int sent = 0;
+		int received = 0;
+		qint64 sentAt = 0;
+
+		auto onEcho = [&]() {
+			const qint64 now = MonotonicClock::now();
+			received++;
+			if (phase == PingPong) {
+				latency->record(now - sentAt);
+				if (received == roundTrips) {
+					loop.quit();
+					return;
+				}
+				sentAt = now;
+				transport->sendTextMessage(payload);
+			}
+			else if (phase == Pipelined) {
+				if (received == messages) {
+					loop.quit();
+					return;
+				}
+				// Top the window back up in one batch once half of it has drained
+				const int inFlight = sent - received;
+				const int refill = qMin(window - inFlight, messages - sent);
+				if (inFlight <= window / 2 && refill > 0) {
+					transport->sendTextMessages(refill == window ? batch : batch.mid(0, refill));
+					sent += refill;
+				}
+			}
+		};
+		QObject::connect(transport.get(), &WebSocketTransport::textMessageReceived, &loop, onEcho);
+		QObject::connect(transport.get(), &WebSocketTransport::textFrameReceived, &loop, onEcho, Qt::DirectConnection);
+		QObject::connect(transport.get(), &WebSocketTransport::connected, &loop, &QEventLoop::quit);
+		QObject::connect(transport.get(), &WebSocketTransport::disconnected, &loop, &QEventLoop::quit);
+		QObject::connect(transport.get(), &WebSocketTransport::errorOccurred, &loop, [&](const QString& message) {
+			error = message;
+			loop.quit();
+			});
+
+		transport->open(url);
+		timeout.start(5000);
+		loop.exec();
+		if (!transport->isValid()) {
+			report.append(QString("[BENCH] %1 transport: connect failed: %2").arg(name, error.isEmpty() ? "timed out" : error));
+			continue;
+		}
+
+		phase = PingPong;
+		received = 0;
+		sentAt = MonotonicClock::now();
+		transport->sendTextMessage(payload);
+		timeout.start(30000);
+		loop.exec();
+		const int roundTripsDone = received;
+
+		phase = Pipelined;
+		received = 0;
+		sent = qMin(window, messages);
+		QElapsedTimer elapsed;
+		elapsed.start();
+		transport->sendTextMessages(batch.mid(0, sent));
+		timeout.start(30000);
+		loop.exec();
+		const double seconds = elapsed.nsecsElapsed() / 1e9;
+		const int pipelinedDone = received;
+		timeout.stop();
+		transport->close();
+
+		const LatencySnapshot rtt = latency->snapshot();
+		report.append(QString("[BENCH] %1 transport: %2 k msg/s pipelined (%3 of %4), round trip p50 %5 p99 %6 p99.9 %7 max %8 (%9 of %10)%11")
+			.arg(name)
+			.arg(pipelinedDone / seconds / 1e3, 0, 'f', 1)
+			.arg(pipelinedDone).arg(messages)
+			.arg(LatencyMonitor::formatNanos(rtt.percentile(50.0)))
+			.arg(LatencyMonitor::formatNanos(rtt.percentile(99.0)))
+			.arg(LatencyMonitor::formatNanos(rtt.percentile(99.9)))
+			.arg(LatencyMonitor::formatNanos(rtt.max()))
+			.arg(roundTripsDone).arg(roundTrips)
+			.arg(error.isEmpty() ? "" : " - " + error));
+	}
+
+	stopServer();
+	report.append(QString("[BENCH] %1 byte trade frames; echo server is QWebSocketServer on its own thread").arg(payload.toUtf8().size()));
+	return report.join('\n');
+}
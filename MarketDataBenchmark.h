@@ -0,0 +1,62 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QByteArray>
+
+// In-process micro benchmarks for the market data hot paths. Results are
+// returned as human-readable reports for the System Log.
+class MarketDataBenchmark {
+public:
+	// Recorded corpus: one raw WebSocket frame per line
+	static QList<QByteArray> loadCorpus(const QString& path);
+	static QList<QByteArray> generateTradeCorpus(int frames, int tradesPerFrame);
+
+	// Writes frames as a tick file for ReplayFeed, one every frameIntervalUs
+	static bool writeTickFile(const QString& path, const QList<QByteArray>& frames, int frameIntervalUs);
+
+	// QJsonDocument decode (legacy path) vs FinnhubTradeParser on the same frames
+	static QString compareTradeParsers(const QList<QByteArray>& corpus, int iterations = 10);
+
+	// OrderBook level updates (modify, delete + re-add) skewed towards the top,
+	// at each book depth, plus a top-5 read every 10 updates
+	static QString benchmarkOrderBook(const QList<int>& depths = { 10, 50, 500 }, int updates = 2000000);
+
+	// MarketDataBus publishing conflated updates over uniformly random
+	// symbols to one wildcard subscriber and per-symbol subscribers, with
+	// endBatch() every 500 updates, against broadcasting every update to
+	// every subscriber and filtering there
+	static QString benchmarkBus(int symbols = 3000, int subscribers = 20, int symbolsPerSubscriber = 100, int updates = 3000000);
+
+	// One thread updating a MarketData flat out while readers take snapshots
+	// and check that every field in each came from the same update
+	static QString stressSnapshots(int readers = 3, int milliseconds = 2000);
+
+	// IndicatorEngine against a naive recompute over each symbol's full bar
+	// history, with zero to four bars per symbol between update() calls as
+	// in fast replay, checked after every batch
+	static QString checkIndicators(int symbols = 256, int batches = 200);
+
+	// BarAggregator against bars rebuilt from each symbol's full trade list,
+	// with late trades, jumps that close several intervals in one trade and
+	// enough history to wrap every ring; then trades/s over the same stream
+	static QString checkBars(int symbols = 32, int tradesPerSymbol = 50000);
+
+	// SnapshotLoader against a SnapshotStandIn on its own thread: repeated
+	// symbols, a 429 with Retry-After, 5xx retries with backoff, a symbol
+	// that never succeeds, and cancels while queued and while in flight.
+	// Blocks the caller's thread.
+	static QString checkSnapshotLoader();
+
+	// PacketSequenceTracker on scripted sequences - gaps, late fills,
+	// duplicates, the edges of the window, reset() and publisher restarts -
+	// with every counter checked, then a MulticastPublisher dropping
+	// lossRatio of its datagrams to a MulticastFeedHandler over loopback.
+	// Blocks the caller's thread.
+	static QString checkSequenceTracker(int packets = 50000, double lossRatio = 0.02);
+
+	// Each available WebSocketTransport against a loopback echo server on its
+	// own thread: one trade frame at a time for round-trip latency, then
+	// messages pipelined 256 deep for throughput. Blocks the caller's thread.
+	static QString compareTransports(int roundTrips = 20000, int messages = 200000);
+};
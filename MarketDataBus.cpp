@@ -0,0 +1,242 @@
+#include "MarketDataBus.h"
+
+MarketDataSubscriber::~MarketDataSubscriber()
+{
+	if (m_attachedBus) {
+		m_attachedBus->detach(this);
+	}
+}
+
+MarketDataBus::MarketDataBus()
+	: m_wildcardKinds(0)
+	, m_deliveries(0)
+	, m_dispatchDepth(0)
+	, m_needsCompaction(false)
+{
+}
+
+MarketDataBus::~MarketDataBus()
+{
+	for (MarketDataSubscriber* subscriber : m_attached) {
+		subscriber->m_attachedBus = nullptr;
+	}
+}
+
+void MarketDataBus::subscribe(SymbolId id, quint8 kinds, MarketDataSubscriber* subscriber)
+{
+	if (id == InvalidSymbolId || !subscriber) {
+		return;
+	}
+	attach(subscriber);
+	if (id >= static_cast<SymbolId>(m_symbols.size())) {
+		m_symbols.resize(static_cast<qsizetype>(id) + 1);
+	}
+	ensureSymbolCapacity(m_kinds, id, quint8(0));
+
+	QVector<Entry>& entries = m_symbols[id];
+	bool found = false;
+	for (Entry& entry : entries) {
+		if (entry.subscriber == subscriber) {
+			entry.kinds = kinds;
+			found = true;
+		}
+	}
+	if (!found) {
+		entries.append({ subscriber, kinds });
+	}
+	m_kinds[id] = unionKinds(entries);
+}
+
+void MarketDataBus::unsubscribe(SymbolId id, MarketDataSubscriber* subscriber)
+{
+	if (id >= static_cast<SymbolId>(m_symbols.size())) {
+		return;
+	}
+	if (removeEntry(m_symbols[id], subscriber)) {
+		m_kinds[id] = unionKinds(m_symbols[id]);
+	}
+}
+
+void MarketDataBus::subscribeAll(quint8 kinds, MarketDataSubscriber* subscriber)
+{
+	if (!subscriber) {
+		return;
+	}
+	attach(subscriber);
+	bool found = false;
+	for (Entry& entry : m_wildcard) {
+		if (entry.subscriber == subscriber) {
+			entry.kinds = kinds;
+			found = true;
+		}
+	}
+	if (!found) {
+		m_wildcard.append({ subscriber, kinds });
+	}
+	m_wildcardKinds = unionKinds(m_wildcard);
+}
+
+void MarketDataBus::unsubscribeAll(MarketDataSubscriber* subscriber)
+{
+	if (removeEntry(m_wildcard, subscriber)) {
+		m_wildcardKinds = unionKinds(m_wildcard);
+	}
+}
+
+void MarketDataBus::detach(MarketDataSubscriber* subscriber)
+{
+	if (!m_attached.removeOne(subscriber)) {
+		return;
+	}
+	subscriber->m_attachedBus = nullptr;
+	m_batchTouched.removeOne(subscriber);
+
+	unsubscribeAll(subscriber);
+	for (int id = 0; id < m_symbols.size(); ++id) {
+		if (!m_symbols[id].isEmpty() && removeEntry(m_symbols[id], subscriber)) {
+			m_kinds[id] = unionKinds(m_symbols[id]);
+		}
+	}
+}
+
+int MarketDataBus::subscriberCount(SymbolId id) const
+{
+	int count = 0;
+	if (id < static_cast<SymbolId>(m_symbols.size())) {
+		for (const Entry& entry : m_symbols[id]) {
+			count += entry.subscriber ? 1 : 0;
+		}
+	}
+	return count;
+}
+
+template<typename Deliver>
+void MarketDataBus::dispatch(SymbolId id, MarketDataEventKind kind, Deliver deliver)
+{
+	m_dispatchDepth++;
+
+	// By index and re-read each time: a handler may subscribe or unsubscribe
+	if (id < static_cast<SymbolId>(m_symbols.size()) && (m_kinds[id] & kind)) {
+		for (int i = 0; i < m_symbols.at(id).size(); ++i) {
+			const Entry entry = m_symbols.at(id).at(i);
+			if (entry.subscriber && (entry.kinds & kind)) {
+				if (!entry.subscriber->m_batchPending) {
+					entry.subscriber->m_batchPending = true;
+					m_batchTouched.append(entry.subscriber);
+				}
+				deliver(entry.subscriber);
+				m_deliveries++;
+			}
+		}
+	}
+	if (m_wildcardKinds & kind) {
+		for (int i = 0; i < m_wildcard.size(); ++i) {
+			const Entry entry = m_wildcard.at(i);
+			if (entry.subscriber && (entry.kinds & kind)) {
+				if (!entry.subscriber->m_batchPending) {
+					entry.subscriber->m_batchPending = true;
+					m_batchTouched.append(entry.subscriber);
+				}
+				deliver(entry.subscriber);
+				m_deliveries++;
+			}
+		}
+	}
+
+	if (--m_dispatchDepth == 0 && m_needsCompaction) {
+		compact();
+	}
+}
+
+void MarketDataBus::publishUpdate(const MarketDataUpdate& update)
+{
+	dispatch(update.symbolId, UpdateEvents, [&update](MarketDataSubscriber* subscriber) {
+		subscriber->onMarketDataUpdate(update);
+		});
+}
+
+void MarketDataBus::publishTrade(SymbolId id, double price, double volume)
+{
+	dispatch(id, TradeEvents, [id, price, volume](MarketDataSubscriber* subscriber) {
+		subscriber->onTrade(id, price, volume);
+		});
+}
+
+void MarketDataBus::publishQuote(SymbolId id, double bid, double ask)
+{
+	dispatch(id, QuoteEvents, [id, bid, ask](MarketDataSubscriber* subscriber) {
+		subscriber->onQuote(id, bid, ask);
+		});
+}
+
+void MarketDataBus::publishBar(const ClosedBar& bar)
+{
+	dispatch(bar.symbolId, BarEvents, [&bar](MarketDataSubscriber* subscriber) {
+		subscriber->onBarClosed(bar);
+		});
+}
+
+void MarketDataBus::endBatch()
+{
+	// Swapped out first: a handler may start the next batch's deliveries
+	QVector<MarketDataSubscriber*> touched;
+	touched.swap(m_batchTouched);
+	for (MarketDataSubscriber* subscriber : touched) {
+		subscriber->m_batchPending = false;
+	}
+	for (int i = 0; i < touched.size(); ++i) {
+		// Skip anyone detached by an earlier handler in this loop
+		if (m_attached.contains(touched[i])) {
+			touched[i]->onMarketDataBatchEnd();
+		}
+	}
+}
+
+void MarketDataBus::attach(MarketDataSubscriber* subscriber)
+{
+	if (subscriber->m_attachedBus != this) {
+		if (subscriber->m_attachedBus) {
+			subscriber->m_attachedBus->detach(subscriber);  // One bus per subscriber
+		}
+		subscriber->m_attachedBus = this;
+		m_attached.append(subscriber);
+	}
+}
+
+bool MarketDataBus::removeEntry(QVector<Entry>& entries, MarketDataSubscriber* subscriber)
+{
+	for (int i = 0; i < entries.size(); ++i) {
+		if (entries[i].subscriber != subscriber) {
+			continue;
+		}
+		if (m_dispatchDepth > 0) {
+			entries[i].subscriber = nullptr;
+			entries[i].kinds = 0;
+			m_needsCompaction = true;
+		}
+		else {
+			entries.remove(i);
+		}
+		return true;
+	}
+	return false;
+}
+
+void MarketDataBus::compact()
+{
+	m_needsCompaction = false;
+	auto isCleared = [](const Entry& entry) { return entry.subscriber == nullptr; };
+	for (QVector<Entry>& entries : m_symbols) {
+		entries.removeIf(isCleared);
+	}
+	m_wildcard.removeIf(isCleared);
+}
+
+quint8 MarketDataBus::unionKinds(const QVector<Entry>& entries)
+{
+	quint8 kinds = 0;
+	for (const Entry& entry : entries) {
+		kinds |= entry.kinds;
+	}
+	return kinds;
+}
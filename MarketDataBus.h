@@ -0,0 +1,119 @@
+#pragma once
+#include <QVector>
+#include "SymbolTable.h"
+#include "BarAggregator.h"
+
+class MarketData;
+class MarketDataBus;
+
+// One symbol's coalesced state for a publish interval. `data` holds the
+// latest values; volume and tradeCount accumulate since the previous batch.
+struct MarketDataUpdate {
+	SymbolId symbolId;
+	MarketData* data;
+	double volume;
+	int tradeCount;
+};
+
+// Event kinds a subscriber asks for, combined as a mask
+enum MarketDataEventKind : quint8 {
+	UpdateEvents = 1,  // Conflated, at most one per symbol per publish interval
+	TradeEvents = 2,   // Every trade as it is drained
+	QuoteEvents = 4,   // Every quote as it is drained
+	BarEvents = 8,     // Closed bars, delivered with the batch
+	AllMarketDataEvents = 15
+};
+
+// Receives MarketDataBus events; override the handlers for the kinds
+// subscribed to. Detaches itself from the bus when destroyed.
+class MarketDataSubscriber {
+public:
+	virtual ~MarketDataSubscriber();
+
+	virtual void onMarketDataUpdate(const MarketDataUpdate& update) { Q_UNUSED(update); }
+	virtual void onTrade(SymbolId id, double price, double volume) { Q_UNUSED(id); Q_UNUSED(price); Q_UNUSED(volume); }
+	virtual void onQuote(SymbolId id, double bid, double ask) { Q_UNUSED(id); Q_UNUSED(bid); Q_UNUSED(ask); }
+	virtual void onBarClosed(const ClosedBar& bar) { Q_UNUSED(bar); }
+
+	// Once after each batch in which this subscriber was delivered anything;
+	// the place for work that should not repeat per symbol
+	virtual void onMarketDataBatchEnd() {}
+
+private:
+	friend class MarketDataBus;
+	MarketDataBus* m_attachedBus = nullptr;
+	bool m_batchPending = false;
+};
+
+// In-process market data distribution by symbol.
+//
+// Subscribers register for specific SymbolIds and event kinds, and each
+// symbol keeps its own subscriber list, so publishing an event costs one
+// direct call per interested subscriber - no queued signal marshalling and
+// no consumer filtering symbols it does not show. Subscribers that want
+// everything (a blotter of every symbol) use subscribeAll().
+//
+// wants() is the publisher's check before building an event, so kinds no
+// one asked for cost nothing.
+//
+// Consumer-thread only; the feed's consumer is the GUI thread, so widgets
+// subscribe directly.
+class MarketDataBus {
+public:
+	MarketDataBus();
+	~MarketDataBus();
+
+	MarketDataBus(const MarketDataBus&) = delete;
+	MarketDataBus& operator=(const MarketDataBus&) = delete;
+
+	// kinds is a MarketDataEventKind mask; subscribing again replaces it
+	void subscribe(SymbolId id, quint8 kinds, MarketDataSubscriber* subscriber);
+	void unsubscribe(SymbolId id, MarketDataSubscriber* subscriber);
+	void subscribeAll(quint8 kinds, MarketDataSubscriber* subscriber);
+	void unsubscribeAll(MarketDataSubscriber* subscriber);  // Wildcard only
+	void detach(MarketDataSubscriber* subscriber);          // Everything it holds
+
+	bool wants(SymbolId id, MarketDataEventKind kind) const
+	{
+		const quint8 kinds = id < static_cast<SymbolId>(m_kinds.size()) ? m_kinds[id] : 0;
+		return ((kinds | m_wildcardKinds) & kind) != 0;
+	}
+	int subscriberCount(SymbolId id) const;
+	quint64 deliveries() const { return m_deliveries; }
+
+	void publishUpdate(const MarketDataUpdate& update);
+	void publishTrade(SymbolId id, double price, double volume);
+	void publishQuote(SymbolId id, double bid, double ask);
+	void publishBar(const ClosedBar& bar);
+	void endBatch();  // Calls onMarketDataBatchEnd() on everyone delivered to since the last call
+
+private:
+	struct Entry {
+		MarketDataSubscriber* subscriber;
+		quint8 kinds;
+	};
+
+	template<typename Deliver>
+	void dispatch(SymbolId id, MarketDataEventKind kind, Deliver deliver);
+	void attach(MarketDataSubscriber* subscriber);
+	bool removeEntry(QVector<Entry>& entries, MarketDataSubscriber* subscriber);
+	void compact();
+	static quint8 unionKinds(const QVector<Entry>& entries);
+
+private:
+	// Indexed by SymbolId; m_kinds is the union of the list's masks
+	QVector<QVector<Entry>> m_symbols;
+	QVector<quint8> m_kinds;
+
+	QVector<Entry> m_wildcard;
+	quint8 m_wildcardKinds;
+
+	QVector<MarketDataSubscriber*> m_attached;
+	QVector<MarketDataSubscriber*> m_batchTouched;
+	quint64 m_deliveries;
+
+	// Lists are walked by index while dispatching; removals in a handler
+	// only clear the entry, and the lists are compacted afterwards
+	int m_dispatchDepth;
+	bool m_needsCompaction;
+};
@@ -1,71 +1,161 @@
 #include "MarketDataFeed.h"
+#include "BinaryLogger.h"
+#include "LatencyMonitor.h"
+#include "MonotonicClock.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QRandomGenerator>
+#include <QMetaMethod>
+#include <QtAlgorithms>
 #include <QDebug>
 
 MarketDataFeed::MarketDataFeed(QObject* parent)
 	: QObject(parent)
-	, m_webSocket(new QWebSocket())
+	, m_feedThread(new QThread(this))
+	, m_feedHandler(new FeedHandler(&m_tickRing))
+	, m_replayFeed(new ReplayFeed(&m_tickRing))
+	, m_journal(nullptr)
+	, m_tickStore(nullptr)
+	, m_generator(new SyntheticMarketGenerator(this))
+	, m_feedManager(new FeedManager(m_feedThread, this))
+	, m_loadTestActive(false)
+	, m_tickRing(65536)
 	, m_networkManager(new QNetworkAccessManager(this))
+	, m_snapshotLoader(new SnapshotLoader(m_networkManager, this))
 	, m_status(FeedStatus::Disconnected)
+	, m_autoReconnect(false)
+	, m_recovery(new FeedRecovery(this))
+	, m_fallbackSimulation(false)
 	, m_webSocketUrl("wss://ws.finnhub.io")  // Finnhub WebSocket URL
 	, m_restApiUrl("https://finnhub.io/api/v1")  // Finnhub REST API
 	, m_updateInterval(1000)
 	, m_useSimulation(false)  // Try real data first
+	, m_replayActive(false)
 	, m_finnhubApiKey("d3vbvs9r01qt2ctp2tugd3vbvs9r01qt2ctp2tv0")  // ADD YOUR API KEY
-	, m_reconnectTimer(new QTimer(this))
-	, m_heartbeatTimer(new QTimer(this))
-	, m_simulationTimer(new QTimer(this))
-	, m_messagesReceived(0)
+	, m_transportKind(WebSocketTransportKind::Qt)
+	, m_sessionSubscriber(-1)
+	, m_subscriptionTimer(new QTimer(this))
+	, m_watchdogTimer(new QTimer(this))
+	, m_publishTimer(new QTimer(this))
 	, m_messagesProcessed(0)
 {
-	// Connect WebSocket signals
-	connect(m_webSocket, &QWebSocket::connected, this, &MarketDataFeed::onWebSocketConnected);
-	connect(m_webSocket, &QWebSocket::disconnected, this, &MarketDataFeed::onWebSocketDisconnected);
-	connect(m_webSocket, QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::errorOccurred),
-		this, &MarketDataFeed::onWebSocketError);
-	connect(m_webSocket, &QWebSocket::textMessageReceived,
-		this, &MarketDataFeed::onWebSocketTextMessageReceived);
-	connect(m_webSocket, &QWebSocket::binaryMessageReceived,
-		this, &MarketDataFeed::onWebSocketBinaryMessageReceived);
-
-	// Setup timers
-	m_reconnectTimer->setInterval(5000);  // Reconnect every 5 seconds
-	m_reconnectTimer->setSingleShot(true);
-	connect(m_reconnectTimer, &QTimer::timeout, this, &MarketDataFeed::connectToFeed);
-
-	m_heartbeatTimer->setInterval(30000);  // Heartbeat every 30 seconds
-	connect(m_heartbeatTimer, &QTimer::timeout, this, [this]() {
-		if (m_webSocket->isValid()) {
-			// Finnhub WebSocket ping
-			QJsonObject ping;
-			ping["type"] = "ping";
-			m_webSocket->sendTextMessage(QJsonDocument(ping).toJson(QJsonDocument::Compact));
+	// Socket I/O and decoding run on the feed thread; everything below is
+	// delivered to this (GUI) thread through queued connections.
+	m_feedThread->setObjectName("MarketDataFeed");
+	m_feedHandler->moveToThread(m_feedThread);
+	connect(m_feedThread, &QThread::finished, m_feedHandler, &QObject::deleteLater);
+
+	connect(m_feedHandler, &FeedHandler::connected, this, &MarketDataFeed::onWebSocketConnected);
+	connect(m_feedHandler, &FeedHandler::disconnected, this, &MarketDataFeed::onWebSocketDisconnected);
+	connect(m_feedHandler, &FeedHandler::errorOccurred, this, &MarketDataFeed::onWebSocketError);
+	connect(m_feedHandler, &FeedHandler::ticksAvailable, this, &MarketDataFeed::drainTicks);
+	connect(m_feedHandler, &FeedHandler::logMessage, this, &MarketDataFeed::logMessage);
+
+	m_replayFeed->moveToThread(m_feedThread);
+	connect(m_feedThread, &QThread::finished, m_replayFeed, &QObject::deleteLater);
+	connect(m_replayFeed, &ReplayFeed::ticksAvailable, this, &MarketDataFeed::drainTicks);
+	connect(m_replayFeed, &ReplayFeed::started, this, &MarketDataFeed::onReplayStarted);
+	connect(m_replayFeed, &ReplayFeed::finished, this, &MarketDataFeed::onReplayFinished);
+	connect(m_replayFeed, &ReplayFeed::logMessage, this, &MarketDataFeed::logMessage);
+
+	m_feedThread->start();
+
+	m_snapshotLoader->setBaseUrl(m_restApiUrl);
+	m_snapshotLoader->setApiKey(m_finnhubApiKey);
+	connect(m_snapshotLoader, &SnapshotLoader::snapshotReceived, this, &MarketDataFeed::onSnapshotReceived);
+	connect(m_snapshotLoader, &SnapshotLoader::snapshotFailed, this, [this](const QString& symbol, const QString& error) {
+		emit logMessage(QString("[FEED] Error fetching %1: %2").arg(symbol, error));
+		});
+	connect(m_snapshotLoader, &SnapshotLoader::progress, this, &MarketDataFeed::snapshotProgress);
+	connect(m_snapshotLoader, &SnapshotLoader::logMessage, this, &MarketDataFeed::logMessage);
+
+	// Reconnects back off from 500 ms to a minute; the recovery decides when, we do the work
+	m_recovery->setBackoff(500, 60000);
+	connect(m_recovery, &FeedRecovery::logMessage, this, &MarketDataFeed::logMessage);
+	connect(m_recovery, &FeedRecovery::stateChanged, this, &MarketDataFeed::onRecoveryStateChanged);
+	connect(m_recovery, &FeedRecovery::reconnectDue, this, &MarketDataFeed::openPrimarySocket);
+	connect(m_recovery, &FeedRecovery::outageEnded, this, [this](qint64 blindNanos, int attempts) {
+		emit logMessage(QString("[FEED] Live data restored after %1 blind, %2 reconnect attempt(s)")
+			.arg(LatencyMonitor::formatNanos(blindNanos))
+			.arg(attempts));
+		});
+
+	// Subscriber 0 is DefaultSubscriber - the application's own symbols and replays
+	m_subscriptions.addConsumer("Default");
+	m_sessionSubscriber = m_subscriptions.addConsumer("Sessions", false);
+
+	// Subscription changes made in one event-loop pass go to the feed thread together
+	m_subscriptionTimer->setSingleShot(true);
+	m_subscriptionTimer->setInterval(0);
+	connect(m_subscriptionTimer, &QTimer::timeout, this, &MarketDataFeed::flushSubscriptions);
+
+	connect(m_generator, &SyntheticMarketGenerator::ticksAvailable, this, &MarketDataFeed::drainTicks);
+
+	connect(m_feedManager, &FeedManager::ticksAvailable, this, &MarketDataFeed::drainTicks);
+	connect(m_feedManager, &FeedManager::logMessage, this, &MarketDataFeed::logMessage);
+	connect(m_feedManager, &FeedManager::symbolsDiscovered, this, &MarketDataFeed::registerSymbols);
+	connect(m_feedManager, &FeedManager::sessionAdded, this, [this](FeedSourceId sourceId) {
+		m_arbiter.resetSource(sourceId);  // IDs are reused after a session is removed
+		m_watchdog.resetSource(sourceId);
+		});
+	connect(m_feedManager, &FeedManager::sessionsChanged, this, [this]() {
+		// A single source has nothing to arbitrate against
+		m_arbiter.setArbitrationEnabled(!m_feedManager->isEmpty());
+
+		// A removed session going quiet is not an outage
+		for (int id = FirstSessionSource; id < MaxFeedSources; ++id) {
+			if (m_feedManager->sessionName(static_cast<FeedSourceId>(id)).isEmpty()) {
+				m_watchdog.resetSource(static_cast<FeedSourceId>(id));
+			}
 		}
 		});
 
-	m_simulationTimer->setInterval(m_updateInterval);
-	connect(m_simulationTimer, &QTimer::timeout, this, &MarketDataFeed::simulateMarketData);
+	// Matches the watchdog's wheel resolution
+	m_watchdogTimer->setInterval(250);
+	connect(m_watchdogTimer, &QTimer::timeout, this, &MarketDataFeed::checkFeedHealth);
+	m_watchdogTimer->start();
+
+	// Armed by the first dirty symbol, so an idle feed costs nothing
+	m_publishTimer->setInterval(16);
+	m_publishTimer->setSingleShot(true);
+	m_publishTimer->setTimerType(Qt::PreciseTimer);
+	connect(m_publishTimer, &QTimer::timeout, this, &MarketDataFeed::publishUpdates);
 }
 
 MarketDataFeed::~MarketDataFeed()
 {
 	disconnectFromFeed();
+	stopJournal();
+	stopTickStore();
+	m_generator->stop();
+	m_feedManager->removeAllSessions();
+
+	// Make sure the socket and replay file are closed before the thread goes away
+	m_replayFeed->requestStop();
+	QMetaObject::invokeMethod(m_replayFeed, &ReplayFeed::cancel, Qt::BlockingQueuedConnection);
+	QMetaObject::invokeMethod(m_feedHandler, &FeedHandler::close, Qt::BlockingQueuedConnection);
+	m_feedThread->quit();
+	m_feedThread->wait();
+
 	qDeleteAll(m_marketData);
 	m_marketData.clear();
-	delete m_webSocket;
+	qDeleteAll(m_orderBooks);
+	m_orderBooks.clear();
 }
 
 void MarketDataFeed::connectToFeed()
 {
+	if (m_replayActive) {
+		stopReplay();
+	}
 	if (m_status == FeedStatus::Connected || m_status == FeedStatus::Connecting) {
 		return;
 	}
 
 	emit logMessage("[FEED] Connecting to Finnhub market data feed...");
 	setStatus(FeedStatus::Connecting);
+	m_autoReconnect = true;
 
 	if (m_useSimulation) {
 		// Use simulation mode
@@ -75,164 +165,709 @@ void MarketDataFeed::connectToFeed()
 		emit connected();
 	}
 	else {
-		// Connect to Finnhub WebSocket with API key
-		QString url = QString("%1?token=%2").arg(m_webSocketUrl, m_finnhubApiKey);
-		emit logMessage(QString("[FEED] Connecting to: %1").arg(m_webSocketUrl));
-		m_webSocket->open(QUrl(url));
+		m_recovery->start();
+		openPrimarySocket();
 	}
 }
 
+void MarketDataFeed::openPrimarySocket()
+{
+	// Connect to Finnhub WebSocket with API key
+	QString url = QString("%1?token=%2").arg(m_webSocketUrl, m_finnhubApiKey);
+	emit logMessage(QString("[FEED] Connecting to: %1").arg(m_webSocketUrl));
+	QMetaObject::invokeMethod(m_feedHandler, [this, url]() {
+		m_feedHandler->open(QUrl(url));
+		}, Qt::QueuedConnection);
+}
+
 void MarketDataFeed::disconnectFromFeed()
 {
 	emit logMessage("[FEED] Disconnecting from market data feed...");
+	m_autoReconnect = false;
 
-	if (m_useSimulation) {
+	if (m_useSimulation || m_fallbackSimulation) {
 		stopSimulation();
+		m_fallbackSimulation = false;
 	}
-	else {
-		m_webSocket->close();
+	if (!m_useSimulation) {
+		QMetaObject::invokeMethod(m_feedHandler, &FeedHandler::close, Qt::QueuedConnection);
 	}
 
-	m_reconnectTimer->stop();
-	m_heartbeatTimer->stop();
+	m_subscriptionTimer->stop();
+	m_recovery->stop();
+	m_watchdog.resetSource(PrimaryFeedSource);
 	setStatus(FeedStatus::Disconnected);
 }
 
-void MarketDataFeed::subscribe(const QString& symbol)
+void MarketDataFeed::connectToEndpoint(const QString& url)
 {
-	if (m_subscribedSymbols.contains(symbol)) {
+	disconnectFromFeed();
+
+	// The close is queued ahead of the open, so the feed thread sees them in order
+	m_webSocketUrl = url;
+	m_useSimulation = false;
+	connectToFeed();
+}
+
+void MarketDataFeed::startReplay(const QString& path, double speed)
+{
+	// Replay replaces whatever source is running
+	disconnectFromFeed();
+	m_replayActive = true;
+	setStatus(FeedStatus::Connecting);
+
+	QMetaObject::invokeMethod(m_replayFeed, [this, path, speed]() {
+		m_replayFeed->start(path, speed);
+		}, Qt::QueuedConnection);
+}
+
+void MarketDataFeed::stopReplay()
+{
+	if (!m_replayActive) {
 		return;
 	}
 
-	m_subscribedSymbols.append(symbol);
+	// The flag breaks a backpressure wait; the queued call tears the replay down
+	m_replayActive = false;
+	m_replayFeed->requestStop();
+	QMetaObject::invokeMethod(m_replayFeed, &ReplayFeed::cancel, Qt::QueuedConnection);
+	m_watchdog.resetSource(ReplayFeedSource);
+	setStatus(FeedStatus::Disconnected);
+}
 
-	// Create market data object if it doesn't exist
-	if (!m_marketData.contains(symbol)) {
-		m_marketData[symbol] = new MarketData(symbol, MarketDataType::Trade);
+bool MarketDataFeed::startJournal(const QString& directory)
+{
+	stopJournal();
+
+	m_journal = new FeedJournal(directory, this);
+	connect(m_journal, &FeedJournal::logMessage, this, &MarketDataFeed::logMessage);
+	if (!m_journal->start()) {
+		delete m_journal;
+		m_journal = nullptr;
+		return false;
 	}
 
-	emit logMessage(QString("[FEED] Subscribed to %1").arg(symbol));
+	FeedJournal* journal = m_journal;
+	QMetaObject::invokeMethod(m_feedHandler, [this, journal]() {
+		m_feedHandler->setJournal(journal);
+		}, Qt::QueuedConnection);
+	return true;
+}
+
+void MarketDataFeed::stopJournal()
+{
+	if (!m_journal) {
+		return;
+	}
+
+	// Detach on the feed thread first so nothing appends while the writer drains
+	QMetaObject::invokeMethod(m_feedHandler, [this]() {
+		m_feedHandler->setJournal(nullptr);
+		}, Qt::BlockingQueuedConnection);
+
+	m_journal->stop();
+	delete m_journal;
+	m_journal = nullptr;
+}
+
+bool MarketDataFeed::startTickStore(const QString& directory)
+{
+	stopTickStore();
 
-	// Send subscription message to Finnhub if connected
-	if (m_status == FeedStatus::Connected && !m_useSimulation) {
-		QJsonObject msg;
-		msg["type"] = "subscribe";
-		msg["symbol"] = symbol;
-		QString jsonMsg = QJsonDocument(msg).toJson(QJsonDocument::Compact);
-		m_webSocket->sendTextMessage(jsonMsg);
-		emit logMessage(QString("[FEED] Sent subscribe message: %1").arg(jsonMsg));
+	TickStore* store = new TickStore(directory, this);
+	connect(store, &TickStore::logMessage, this, &MarketDataFeed::logMessage);
+	if (!store->start()) {
+		delete store;
+		return false;
 	}
+	m_tickStore = store;
+	return true;
+}
+
+void MarketDataFeed::stopTickStore()
+{
+	if (!m_tickStore) {
+		return;
+	}
+
+	// Appends happen on this thread, so once detached the writer can drain
+	TickStore* store = m_tickStore;
+	m_tickStore = nullptr;
+	store->stop();
+	delete store;
+}
+
+void MarketDataFeed::startLoadTest(int symbolCount, qint64 eventsPerSecond, int threads, quint64 seed)
+{
+	stopLoadTest();
+	stopReplay();
+	disconnectFromFeed();
+
+	SyntheticGeneratorConfig config;
+	config.seed = seed;
+	config.sourceId = SyntheticFeedSource;
+	config.threads = threads;
+	config.eventsPerSecond = eventsPerSecond;
+	config.secondsPerEvent = 0.001;
+	config.symbols = SyntheticMarketGenerator::makeUniverse(symbolCount);
+
+	// Registered quietly - tens of thousands of subscribe messages would swamp the log
+	for (const SyntheticSymbolConfig& symbol : config.symbols) {
+		SymbolId id = SymbolTable::instance().intern(symbol.symbol);
+		registerSymbol(id, symbol.symbol);
+		m_loadTestIds.append(id);
+	}
+
+	m_useSimulation = true;
+	m_loadTestActive = true;
+	m_generator->start(config);
+	setStatus(FeedStatus::Connected);
+
+	emit logMessage(QString("[LOADTEST] %1 symbols, %2 events/sec, %3 threads, seed %4")
+		.arg(symbolCount)
+		.arg(eventsPerSecond > 0 ? QString::number(eventsPerSecond) : QString("unbounded"))
+		.arg(threads)
+		.arg(seed));
+}
+
+void MarketDataFeed::stopLoadTest()
+{
+	if (!m_loadTestActive) {
+		return;
+	}
+
+	m_generator->stop();
+	m_watchdog.resetSource(SyntheticFeedSource);
+	for (SymbolId id : m_loadTestIds) {
+		if (m_subscriptions.contains(id)) {
+			continue;  // Also subscribed for real
+		}
+		m_subscribed[id] = false;
+		m_watchdog.untrack(id);
+		m_bars.removeSymbol(id);
+		m_indicators.removeSymbol(id);
+	}
+	m_loadTestIds.clear();
+	m_loadTestActive = false;
+	m_useSimulation = false;
+	setStatus(FeedStatus::Disconnected);
+
+	emit logMessage("[LOADTEST] Stopped");
+}
+
+void MarketDataFeed::onReplayStarted(const QStringList& symbols)
+{
+	if (!m_replayActive) {
+		return;
+	}
+
+	for (const QString& symbol : symbols) {
+		subscribe(symbol);
+	}
+	setStatus(FeedStatus::Connected);
+	emit connected();
+}
+
+void MarketDataFeed::onReplayFinished(const QString& summary)
+{
+	if (m_replayActive) {
+		m_replayActive = false;
+		setStatus(FeedStatus::Disconnected);
+		emit disconnected();
+	}
+	m_watchdog.resetSource(ReplayFeedSource);
+	emit replayFinished(summary);
+}
+
+void MarketDataFeed::subscribe(const QString& symbol, int subscriber)
+{
+	// Interning happens once here; everything downstream works on the ID
+	SymbolId id = SymbolTable::instance().intern(symbol);
+	const bool first = m_subscriptions.acquire(id, subscriber);
+	scheduleSubscriptionFlush();  // A session's symbol may only now be going on the wire
+	if (!first) {
+		return;
+	}
+
+	registerSymbol(id, symbol);
+	m_feedManager->addSymbol(symbol, id);
+
+	emit logMessage(QString("[FEED] Subscribed to %1").arg(symbol));
 
 	// Fetch initial snapshot from REST API
-	if (!m_useSimulation) {
+	if (!m_useSimulation && !m_replayActive) {
 		fetchSnapshotData(symbol);
 	}
+
+	// The generator's symbol set is fixed per run; restart it to include the new one
+	if ((m_useSimulation || m_fallbackSimulation) && m_generator->isRunning() && !m_loadTestActive) {
+		startSimulation();
+	}
 }
 
-void MarketDataFeed::unsubscribe(const QString& symbol)
+void MarketDataFeed::registerSymbol(SymbolId id, const QString& symbol)
 {
-	m_subscribedSymbols.removeAll(symbol);
+	ensureSymbolCapacity(m_subscribed, id, false);
+	ensureSymbolCapacity(m_marketData, id, static_cast<MarketData*>(nullptr));
+	ensureSymbolCapacity(m_dirty, id, false);
+	ensureSymbolCapacity(m_pendingVolume, id, 0.0);
+	ensureSymbolCapacity(m_pendingTrades, id, 0);
+	ensureSymbolCapacity(m_lastLiveUpdate, id, qint64(0));
 
-	emit logMessage(QString("[FEED] Unsubscribed from %1").arg(symbol));
+	m_subscribed[id] = true;
+	m_watchdog.track(id, MonotonicClock::now());
 
-	// Send unsubscribe message to Finnhub if connected
-	if (m_status == FeedStatus::Connected && !m_useSimulation) {
-		QJsonObject msg;
-		msg["type"] = "unsubscribe";
-		msg["symbol"] = symbol;
-		m_webSocket->sendTextMessage(QJsonDocument(msg).toJson(QJsonDocument::Compact));
+	// Create market data object if it doesn't exist
+	if (!m_marketData[id]) {
+		m_marketData[id] = new MarketData(symbol, MarketDataType::Trade);
 	}
 }
 
-void MarketDataFeed::subscribeMultiple(const QStringList& symbols)
+void MarketDataFeed::registerSymbols(const QStringList& symbols)
 {
+	// Symbols a session brings with it: tracked and shown, but not pushed to the primary feed
 	for (const QString& symbol : symbols) {
-		subscribe(symbol);
+		SymbolId id = SymbolTable::instance().intern(symbol);
+		if (m_subscriptions.acquire(id, m_sessionSubscriber)) {
+			registerSymbol(id, symbol);
+		}
+	}
+}
+
+bool MarketDataFeed::registerDiscovered(const FeedTick& tick)
+{
+	// symbolsDiscovered() is queued from the receive thread after the ticks
+	// that introduced the symbols, and a drain already under way reaches
+	// them first. Taking the symbol up here is what the signal would do;
+	// when it arrives it finds the symbol held.
+	if (tick.symbolId == InvalidSymbolId || tick.sourceId >= MaxFeedSources
+		|| !(m_feedManager->discoveringSources() & (1u << tick.sourceId))
+		|| m_subscriptions.isHeldBy(tick.symbolId, m_sessionSubscriber)) {
+		return false;
+	}
+	registerSymbols({ SymbolTable::instance().symbol(tick.symbolId) });
+	return isSubscribed(tick.symbolId);
+}
+
+void MarketDataFeed::unsubscribe(const QString& symbol, int subscriber)
+{
+	SymbolId id = SymbolTable::instance().find(symbol);
+	const bool last = m_subscriptions.release(id, subscriber);
+	scheduleSubscriptionFlush();
+	if (!last) {
+		return;  // Still held by another subscriber
+	}
+
+	m_subscribed[id] = false;
+	m_watchdog.untrack(id);
+	m_bars.removeSymbol(id);
+	m_indicators.removeSymbol(id);
+	m_snapshotLoader->cancel(symbol);
+	m_feedManager->removeSymbol(symbol);
+
+	if ((m_useSimulation || m_fallbackSimulation) && m_generator->isRunning() && !m_loadTestActive) {
+		startSimulation();
+	}
+
+	emit logMessage(QString("[FEED] Unsubscribed from %1").arg(symbol));
+}
+
+void MarketDataFeed::subscribeMultiple(const QStringList& symbols, int subscriber)
+{
+	for (const QString& symbol : symbols) {
+		subscribe(symbol, subscriber);
 	}
 }
 
 QStringList MarketDataFeed::getSubscribedSymbols() const
 {
-	return m_subscribedSymbols;
+	QStringList symbols;
+	const QVector<SymbolId> ids = m_subscriptions.symbols();
+	symbols.reserve(ids.size());
+	for (SymbolId id : ids) {
+		symbols.append(SymbolTable::instance().symbol(id));
+	}
+	return symbols;
 }
 
 MarketData* MarketDataFeed::getMarketData(const QString& symbol)
 {
-	if (m_marketData.contains(symbol)) {
-		return m_marketData[symbol];
+	return getMarketData(SymbolTable::instance().find(symbol));
+}
+
+MarketData* MarketDataFeed::getMarketData(SymbolId id) const
+{
+	if (id == InvalidSymbolId || id >= static_cast<SymbolId>(m_marketData.size())) {
+		return nullptr;
 	}
-	return nullptr;
+	return m_marketData[id];
+}
+
+const OrderBook* MarketDataFeed::getOrderBook(SymbolId id) const
+{
+	if (id == InvalidSymbolId || id >= static_cast<SymbolId>(m_orderBooks.size())) {
+		return nullptr;
+	}
+	return m_orderBooks[id];
 }
 
 QList<MarketData*> MarketDataFeed::getAllMarketData() const
 {
 	QList<MarketData*> dataList;
-	for (auto it = m_marketData.begin(); it != m_marketData.end(); ++it) {
-		dataList.append(it.value());
+	for (MarketData* data : m_marketData) {
+		if (data) {
+			dataList.append(data);
+		}
 	}
 	return dataList;
 }
 
+bool MarketDataFeed::isSubscribed(SymbolId id) const
+{
+	return id != InvalidSymbolId && id < static_cast<SymbolId>(m_subscribed.size()) && m_subscribed[id];
+}
+
 void MarketDataFeed::onWebSocketConnected()
 {
 	emit logMessage("[FEED] WebSocket connected to Finnhub");
+
+	// Live prices are back; the snapshot refresh replaces anything simulated
+	if (m_fallbackSimulation) {
+		stopSimulation();
+		m_fallbackSimulation = false;
+	}
+
+	m_recovery->onConnected();
 	setStatus(FeedStatus::Connected);
-	m_heartbeatTimer->start();
 	emit connected();
 
-	// Subscribe to all symbols
-	for (const QString& symbol : m_subscribedSymbols) {
-		QJsonObject msg;
-		msg["type"] = "subscribe";
-		msg["symbol"] = symbol;
-		QString jsonMsg = QJsonDocument(msg).toJson(QJsonDocument::Compact);
-		m_webSocket->sendTextMessage(jsonMsg);
-		emit logMessage(QString("[FEED] Subscribed to %1").arg(symbol));
+	// A new connection knows nothing; everything held goes out in one batch
+	m_subscriptions.resetFeed();
+	flushSubscriptions();
+
+	// Read before the recovery clears it on reaching Live
+	const qint64 outageStart = m_recovery->outageStart();
+	m_recovery->onResubscribed();
+	if (outageStart != 0) {
+		refreshStaleSnapshots(outageStart);
+	}
+}
+
+void MarketDataFeed::refreshStaleSnapshots(qint64 since)
+{
+	// Symbols another live session kept updating through the gap are already current
+	int requested = 0;
+	for (SymbolId id : m_subscriptions.symbols()) {
+		if (isSubscribed(id) && m_lastLiveUpdate[id] < since) {
+			fetchSnapshotData(SymbolTable::instance().symbol(id));
+			requested++;
+		}
 	}
+	emit logMessage(QString("[FEED] Refreshing snapshots for %1 of %2 symbols stale during the outage")
+		.arg(requested).arg(m_subscriptions.size()));
 }
 
 void MarketDataFeed::onWebSocketDisconnected()
 {
 	emit logMessage("[FEED] WebSocket disconnected from Finnhub");
-	m_heartbeatTimer->stop();
+	m_subscriptionTimer->stop();
 	setStatus(FeedStatus::Disconnected);
 	emit disconnected();
 
-	// Attempt reconnection
-	if (!m_useSimulation) {
+	// Attempt reconnection unless the disconnect was requested
+	if (!m_useSimulation && m_autoReconnect) {
 		setStatus(FeedStatus::Reconnecting);
-		emit logMessage("[FEED] Attempting to reconnect in 5 seconds...");
-		m_reconnectTimer->start();
+		m_recovery->onLinkLost("disconnected");
 	}
 }
 
-void MarketDataFeed::onWebSocketError(QAbstractSocket::SocketError error)
+void MarketDataFeed::onWebSocketError(const QString& error)
 {
-	QString errorMsg = QString("[FEED] WebSocket error: %1").arg(m_webSocket->errorString());
+	QString errorMsg = QString("[FEED] WebSocket error: %1").arg(error);
 	emit logMessage(errorMsg);
 	emit connectionError(errorMsg);
-	setStatus(FeedStatus::Error);
 
-	// Fall back to simulation mode
-	if (!m_useSimulation) {
-		emit logMessage("[FEED] Failed to connect to Finnhub - falling back to simulation mode");
-		m_useSimulation = true;
+	if (!m_useSimulation && !m_replayActive && m_autoReconnect) {
+		setStatus(FeedStatus::Reconnecting);
+		m_recovery->onLinkLost(error);
+	}
+	else {
+		setStatus(FeedStatus::Error);
+	}
+}
+
+void MarketDataFeed::onRecoveryStateChanged(RecoveryState state, RecoveryState previous, qint64 nanosInPrevious)
+{
+	Q_UNUSED(previous);
+	Q_UNUSED(nanosInPrevious);
+
+	// Keep the screen moving during a long outage, and say so - it ends when the link returns
+	const int fallbackAfterAttempts = 3;
+	if (state == RecoveryState::Backoff && !m_fallbackSimulation && !m_replayActive
+		&& m_recovery->attempt() >= fallbackAfterAttempts) {
+		emit logMessage(QString("[FEED] Finnhub unreachable after %1 attempts - showing SIMULATED prices until it recovers")
+			.arg(m_recovery->attempt()));
+		m_fallbackSimulation = true;
 		startSimulation();
-		setStatus(FeedStatus::Connected);
 	}
+
+	emit recoveryStateChanged(state, m_recovery->attempt());
+}
+
+void MarketDataFeed::drainTicks()
+{
+	// Acknowledge first so ticks pushed while we drain trigger another pass
+	m_feedHandler->acknowledgeTicks();
+	m_replayFeed->acknowledgeTicks();
+	m_generator->acknowledgeTicks();
+	m_feedManager->acknowledgeTicks();
+
+	// Bound the work per call so a burst cannot starve the GUI event loop
+	const int maxTicksPerDrain = 4096;
+
+	// Checked once per drain; the per-trade signals cost nothing when unused
+	static const QMetaMethod tradeSignal = QMetaMethod::fromSignal(&MarketDataFeed::tradeReceived);
+	static const QMetaMethod updateSignal = QMetaMethod::fromSignal(&MarketDataFeed::marketDataUpdated);
+	static const QMetaMethod quoteSignal = QMetaMethod::fromSignal(&MarketDataFeed::quoteReceived);
+	static const QMetaMethod barsSignal = QMetaMethod::fromSignal(&MarketDataFeed::barsClosed);
+	RawListeners listeners;
+	listeners.trades = isSignalConnected(tradeSignal);
+	listeners.updates = isSignalConnected(updateSignal);
+	listeners.quotes = isSignalConnected(quoteSignal);
+	listeners.bars = isSignalConnected(barsSignal);
+
+	int drained = drainRing(m_tickRing, maxTicksPerDrain, listeners);
+	bool pending = !m_tickRing.isEmpty();
+
+	// Synthetic generator threads each have their own ring
+	for (int i = 0; i < m_generator->ringCount(); ++i) {
+		SpscRing<FeedTick>* ring = m_generator->ring(i);
+		drained += drainRing(*ring, maxTicksPerDrain - drained, listeners);
+		pending = pending || !ring->isEmpty();
+	}
+
+	for (int i = 0; i < m_feedManager->ringCount(); ++i) {
+		SpscRing<FeedTick>* ring = m_feedManager->ring(i);
+		drained += drainRing(*ring, maxTicksPerDrain - drained, listeners);
+		pending = pending || !ring->isEmpty();
+	}
+
+	if (pending) {
+		QMetaObject::invokeMethod(this, &MarketDataFeed::drainTicks, Qt::QueuedConnection);
+	}
+}
+
+int MarketDataFeed::drainRing(SpscRing<FeedTick>& ring, int budget, const RawListeners& listeners)
+{
+	int drained = 0;
+	FeedTick tick;
+	while (drained < budget && ring.tryPop(tick)) {
+		drained++;
+
+		if (!isSubscribed(tick.symbolId) && !registerDiscovered(tick)) {
+			continue;
+		}
+		m_watchdog.onTick(tick.symbolId, tick.sourceId, tick.receiveTime);  // A duplicate still shows the source is alive
+		if (!m_arbiter.accept(tick)) {
+			continue;  // Already delivered by a faster source
+		}
+		if (tick.sourceId != SyntheticFeedSource && tick.sourceId != ReplayFeedSource) {
+			m_lastLiveUpdate[tick.symbolId] = tick.receiveTime;
+		}
+
+		MarketData* data = m_marketData[tick.symbolId];
+		if (tick.type == FeedTickType::Quote) {
+			data->updateQuote(tick.price, tick.volume, tick.askPrice, tick.askVolume,
+				tick.exchangeTime, tick.receiveTime);
+			LatencyMonitor::record(LatencyStage::ParsedToModel, data->processTime() - tick.parsedTime);
+			markDirty(tick.symbolId, 0.0, 0);
+
+			ensureSymbolCapacity(m_orderBooks, tick.symbolId, static_cast<OrderBook*>(nullptr));
+			OrderBook*& book = m_orderBooks[tick.symbolId];
+			if (!book) {
+				book = new OrderBook(tick.symbolId);
+			}
+			book->applyQuote(tick.price, tick.volume, tick.askPrice, tick.askVolume);
+
+			if (m_bus.wants(tick.symbolId, QuoteEvents)) {
+				m_bus.publishQuote(tick.symbolId, tick.price, tick.askPrice);
+			}
+			if (listeners.quotes) {
+				emit quoteReceived(data->symbol(), tick.price, tick.askPrice);
+			}
+			if (listeners.updates) {
+				emit marketDataUpdated(data->symbol(), data);
+			}
+			m_messagesProcessed++;
+			continue;
+		}
+
+		data->updateTrade(tick.price, tick.volume, tick.exchangeTime, tick.receiveTime);
+		LatencyMonitor::record(LatencyStage::ParsedToModel, data->processTime() - tick.parsedTime);
+		markDirty(tick.symbolId, tick.volume, 1);
+
+		// Bars follow the exchange's clock where the source provides one
+		const qint64 barTime = tick.exchangeTime > 0 ? tick.exchangeTime : MonotonicClock::toWallMSecs(tick.receiveTime);
+		ClosedBar closed[static_cast<int>(BarInterval::Count)];
+		const int closedMask = m_bars.addTrade(tick.symbolId, barTime, tick.price, tick.volume, closed);
+		for (int i = 0; i < qPopulationCount(static_cast<quint32>(closedMask)); ++i) {
+			if (closed[i].interval == m_indicators.interval()) {
+				m_indicators.addBar(tick.symbolId, closed[i].bar);
+			}
+			if (listeners.bars || m_bus.wants(tick.symbolId, BarEvents)) {
+				m_closedBars.append(closed[i]);
+			}
+		}
+
+		// Replayed trades are history already
+		if (m_tickStore && tick.sourceId != ReplayFeedSource) {
+			const qint64 storeTime = tick.exchangeTime > 0 ? tick.exchangeTime * 1000000 : MonotonicClock::toWallNanos(tick.receiveTime);
+			m_tickStore->append(tick.symbolId, storeTime, tick.price, tick.volume);
+		}
+
+		if (m_bus.wants(tick.symbolId, TradeEvents)) {
+			m_bus.publishTrade(tick.symbolId, tick.price, tick.volume);
+		}
+		if (listeners.trades) {
+			emit tradeReceived(data->symbol(), tick.price, tick.volume);
+		}
+		if (listeners.updates) {
+			emit marketDataUpdated(data->symbol(), data);
+		}
+		m_messagesProcessed++;
+
+		if (BinaryLogger::isEnabled(LogEventId::FeedTrade)) {
+			BinaryLogger::log(LogEventId::FeedTrade,
+				{ logSymbol(tick.symbolId), logReal(tick.price), logReal(tick.volume) });
+		}
+	}
+	return drained;
+}
+
+void MarketDataFeed::markDirty(SymbolId id, double volume, int trades)
+{
+	if (id >= static_cast<SymbolId>(m_dirty.size())) {
+		return;
+	}
+
+	m_pendingVolume[id] += volume;
+	m_pendingTrades[id] += trades;
+	if (!m_dirty[id]) {
+		m_dirty[id] = true;
+		m_dirtyIds.append(id);
+	}
+
+	if (!m_publishTimer->isActive()) {
+		m_publishTimer->start();
+	}
+}
+
+void MarketDataFeed::publishUpdates()
+{
+	// One pass over every symbol's indicators, before widgets read them
+	m_indicators.update();
+
+	if (!m_closedBars.isEmpty()) {
+		for (const ClosedBar& bar : m_closedBars) {
+			m_bus.publishBar(bar);
+		}
+		emit barsClosed(m_closedBars);
+		m_closedBars.clear();
+	}
+
+	// The broadcast batch is only built for receivers that still use it
+	static const QMetaMethod batchSignal = QMetaMethod::fromSignal(&MarketDataFeed::marketDataBatchUpdated);
+	const bool broadcast = isSignalConnected(batchSignal);
+	QVector<MarketDataUpdate> updates;
+	if (broadcast) {
+		updates.reserve(m_dirtyIds.size());
+	}
+
+	for (SymbolId id : m_dirtyIds) {
+		MarketDataUpdate update;
+		update.symbolId = id;
+		update.data = m_marketData[id];
+		update.volume = m_pendingVolume[id];
+		update.tradeCount = m_pendingTrades[id];
+		m_bus.publishUpdate(update);
+		if (broadcast) {
+			updates.append(update);
+		}
+
+		m_dirty[id] = false;
+		m_pendingVolume[id] = 0.0;
+		m_pendingTrades[id] = 0;
+	}
+	m_dirtyIds.clear();
+	m_bus.endBatch();
+
+	if (!updates.isEmpty()) {
+		emit marketDataBatchUpdated(updates);
+	}
+}
+
+void MarketDataFeed::setPublishInterval(int milliseconds)
+{
+	m_publishTimer->setInterval(qMax(1, milliseconds));
+}
+
+int MarketDataFeed::publishInterval() const
+{
+	return m_publishTimer->interval();
+}
+
+FeedSourceId MarketDataFeed::addWebSocketSession(const QString& name, const QString& url)
+{
+	// Finnhub needs the same token as the primary connection
+	QUrl sessionUrl(url);
+	if (sessionUrl.host().endsWith("finnhub.io") && !sessionUrl.hasQuery()) {
+		sessionUrl.setQuery(QString("token=%1").arg(m_finnhubApiKey));
+	}
+	return m_feedManager->addWebSocketSession(name, sessionUrl);
 }
 
-void MarketDataFeed::onWebSocketTextMessageReceived(const QString& message)
+QVector<FeedSourceSummary> MarketDataFeed::sourceSummaries() const
 {
-	m_messagesReceived++;
-	m_lastMessageTime = QDateTime::currentDateTime();
-	processWebSocketMessage(message);
+	QVector<FeedSourceSummary> summaries;
+
+	// Built-in sources only once they have produced something
+	const FeedSourceId builtIn[] = { PrimaryFeedSource, ReplayFeedSource, SyntheticFeedSource };
+	for (int i = 0; i < 3; ++i) {
+		FeedSourceSummary summary;
+		summary.sourceId = builtIn[i];
+		summary.name = sourceName(builtIn[i]);
+		summary.stats = m_arbiter.sourceStats(builtIn[i]);
+		summary.sequenceGaps = builtIn[i] == PrimaryFeedSource ? m_feedHandler->sequenceGaps() : 0;
+		summary.ticksDropped = builtIn[i] == PrimaryFeedSource ? m_feedHandler->ticksDropped() : 0;
+		summary.rate = m_watchdog.rateStatus(builtIn[i]);
+		if (summary.stats.received > 0) {
+			summaries.append(summary);
+		}
+	}
+
+	for (const FeedSessionInfo& session : m_feedManager->sessions()) {
+		FeedSourceSummary summary;
+		summary.sourceId = session.sourceId;
+		summary.name = session.name;
+		summary.stats = m_arbiter.sourceStats(session.sourceId);
+		summary.sequenceGaps = session.sequenceGaps;
+		summary.ticksDropped = session.ticksDropped;
+		summary.rate = m_watchdog.rateStatus(session.sourceId);
+		summaries.append(summary);
+	}
+	return summaries;
 }
 
-void MarketDataFeed::onWebSocketBinaryMessageReceived(const QByteArray& message)
+FeedQueueStats MarketDataFeed::queueStats() const
 {
-	m_messagesReceived++;
-	m_lastMessageTime = QDateTime::currentDateTime();
+	FeedQueueStats stats;
+	stats.depth = m_tickRing.size();
+	stats.capacity = m_tickRing.capacity();
+	stats.highWaterMark = m_feedHandler->highWaterMark();
+	stats.framesReceived = m_feedHandler->framesReceived();
+	stats.ticksEnqueued = m_feedHandler->ticksEnqueued();
+	stats.ticksDropped = m_feedHandler->ticksDropped();
+	return stats;
 }
 
 void MarketDataFeed::onRestApiReplyFinished()
@@ -251,12 +886,6 @@ void MarketDataFeed::onRestApiReplyFinished()
 	}
 }
 
-void MarketDataFeed::simulateMarketData()
-{
-	for (const QString& symbol : m_subscribedSymbols) {
-		generateRandomMarketData(symbol);
-	}
-}
 
 void MarketDataFeed::setStatus(FeedStatus status)
 {
@@ -266,54 +895,53 @@ void MarketDataFeed::setStatus(FeedStatus status)
 	}
 }
 
-void MarketDataFeed::processWebSocketMessage(const QString& message)
+void MarketDataFeed::scheduleSubscriptionFlush()
 {
-	QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
-	if (doc.isNull() || !doc.isObject()) {
-		return;
+	if (m_subscriptions.hasChanges() && !m_subscriptionTimer->isActive()) {
+		m_subscriptionTimer->start();
 	}
+}
 
-	QJsonObject obj = doc.object();
-	QString type = obj["type"].toString();
+void MarketDataFeed::flushSubscriptions()
+{
+	m_subscriptionTimer->stop();
+	if (m_status != FeedStatus::Connected || m_useSimulation || m_replayActive) {
+		return;  // Left queued; connecting sends everything held anyway
+	}
 
-	// Handle Finnhub WebSocket response format
-	if (type == "ping") {
-		// Respond to ping
+	QVector<SymbolId> added;
+	QVector<SymbolId> removed;
+	m_subscriptions.takeChanges(added, removed);
+	if (added.isEmpty() && removed.isEmpty()) {
 		return;
 	}
-	else if (type == "trade") {
-		// Finnhub sends trade data in "data" array
-		QJsonArray dataArray = obj["data"].toArray();
-
-		for (const QJsonValue& val : dataArray) {
-			QJsonObject trade = val.toObject();
-
-			QString symbol = trade["s"].toString();  // Symbol
-			double price = trade["p"].toDouble();    // Price
-			double volume = trade["v"].toDouble();   // Volume
-			qint64 timestamp = trade["t"].toVariant().toLongLong();  // Timestamp
 
-			if (!m_marketData.contains(symbol)) {
-				continue;
-			}
-
-			MarketData* data = m_marketData[symbol];
-			data->updateTrade(price, volume);
-
-			emit tradeReceived(symbol, price, volume);
-			emit marketDataUpdated(symbol, data);
-			m_messagesProcessed++;
-
-			emit logMessage(QString("[FEED] Trade: %1 @ $%2 (Vol: %3)")
-				.arg(symbol)
-				.arg(price, 0, 'f', 2)
-				.arg(volume));
-		}
+	// Finnhub takes one symbol per frame, so the batching is in the hop: the
+	// name -> ID mappings and every frame cross to the feed thread together
+	QVector<QPair<QByteArray, SymbolId>> mappings;
+	QStringList messages;
+	mappings.reserve(added.size());
+	messages.reserve(added.size() + removed.size());
+	SymbolTable& symbols = SymbolTable::instance();
+	for (SymbolId id : added) {
+		mappings.append(qMakePair(symbols.symbolUtf8(id), id));
+		messages.append(FeedHandler::subscriptionMessage("subscribe", symbols.symbol(id)));
 	}
-	else {
-		// Log unknown message types for debugging
-		emit logMessage(QString("[FEED] Unknown message type: %1").arg(type));
+	for (SymbolId id : removed) {
+		messages.append(FeedHandler::subscriptionMessage("unsubscribe", symbols.symbol(id)));
 	}
+
+	FeedHandler* handler = m_feedHandler;
+	QMetaObject::invokeMethod(handler, [handler, mappings, messages]() {
+		for (const QPair<QByteArray, SymbolId>& mapping : mappings) {
+			handler->addSymbol(mapping.first, mapping.second);
+		}
+		handler->sendTextMessages(messages);
+		}, Qt::QueuedConnection);
+
+	emit logMessage(added.size() + removed.size() == 1
+		? QString("[FEED] Sent %1 message: %2").arg(added.isEmpty() ? "unsubscribe" : "subscribe", messages.first())
+		: QString("[FEED] Sent %1 subscribe and %2 unsubscribe messages").arg(added.size()).arg(removed.size()));
 }
 
 void MarketDataFeed::processRestApiData(const QByteArray& data)
@@ -341,129 +969,144 @@ void MarketDataFeed::processRestApiData(const QByteArray& data)
 
 void MarketDataFeed::fetchSnapshotData(const QString& symbol)
 {
-	// Finnhub REST API endpoint for quote data
-	QString url = QString("%1/quote?symbol=%2&token=%3")
-		.arg(m_restApiUrl, symbol, m_finnhubApiKey);
-
-	emit logMessage(QString("[FEED] Fetching snapshot for %1").arg(symbol));
-
-	QNetworkRequest request(url);
-	QNetworkReply* reply = m_networkManager->get(request);
-
-	// Store symbol in reply property so we can use it in the callback
-	reply->setProperty("symbol", symbol);
-
-	connect(reply, &QNetworkReply::finished, this, [this, reply]() {
-		if (!reply) return;
-
-		QString symbol = reply->property("symbol").toString();
-		reply->deleteLater();
+	// Queued, deduplicated and rate-limited by the loader
+	m_snapshotLoader->request(symbol);
+}
 
-		if (reply->error() != QNetworkReply::NoError) {
-			emit logMessage(QString("[FEED] Error fetching %1: %2")
-				.arg(symbol, reply->errorString()));
-			return;
-		}
+void MarketDataFeed::onSnapshotReceived(const QString& symbol, const SnapshotQuote& quote)
+{
+	MarketData* marketData = getMarketData(symbol);
+	if (!marketData || quote.currentPrice <= 0) {
+		return;
+	}
 
-		QByteArray data = reply->readAll();
-		QJsonDocument doc = QJsonDocument::fromJson(data);
+	marketData->setOpenPrice(quote.openPrice);
+	marketData->setHighPrice(quote.highPrice);
+	marketData->setLowPrice(quote.lowPrice);
+	// setPreviousClose doesn't exist in MarketData - skip it
+	marketData->updateTrade(quote.currentPrice, 0, quote.exchangeTime);  // Initialize with current price
+
+	emit logMessage(QString("[FEED] Snapshot for %1: $%2 (Open: $%3, High: $%4, Low: $%5)")
+		.arg(symbol)
+		.arg(quote.currentPrice, 0, 'f', 2)
+		.arg(quote.openPrice, 0, 'f', 2)
+		.arg(quote.highPrice, 0, 'f', 2)
+		.arg(quote.lowPrice, 0, 'f', 2));
+
+	markDirty(marketData->symbolId(), 0.0, 0);
+	emit marketDataUpdated(symbol, marketData);
+}
 
-		if (doc.isNull() || !doc.isObject()) {
-			return;
+void MarketDataFeed::checkFeedHealth()
+{
+	const qint64 now = MonotonicClock::now();
+	WatchdogEvents events;
+	m_watchdog.advance(now, events);
+
+	if (!events.stale.isEmpty() || !events.recovered.isEmpty()) {
+		if (!events.stale.isEmpty()) {
+			// Name a few; a whole universe going quiet is one line, not thousands
+			QStringList names;
+			for (int i = 0; i < events.stale.size() && i < 5; ++i) {
+				names.append(SymbolTable::instance().symbol(events.stale[i]));
+			}
+			if (events.stale.size() > names.size()) {
+				names.append(QString("+%1 more").arg(events.stale.size() - names.size()));
+			}
+			emit logMessage(QString("[WATCHDOG] No update for %1 s: %2")
+				.arg(m_watchdog.staleAfter() / 1000000000)
+				.arg(names.join(", ")));
 		}
+		emit staleSymbolsChanged(events.stale, events.recovered);
+	}
 
-		QJsonObject obj = doc.object();
+	for (FeedSourceId sourceId : events.rateAlerts) {
+		FeedRateStatus rate = m_watchdog.rateStatus(sourceId);
+		QString message = QString("[WATCHDOG] %1 message rate %2/s is below its %3/s baseline")
+			.arg(sourceName(sourceId))
+			.arg(rate.rate, 0, 'f', 1)
+			.arg(rate.baseline, 0, 'f', 1);
+		emit logMessage(message);
+		emit feedHealthAlert(sourceId, message);
+	}
+	for (FeedSourceId sourceId : events.rateRecoveries) {
+		emit logMessage(QString("[WATCHDOG] %1 message rate back to %2/s")
+			.arg(sourceName(sourceId))
+			.arg(m_watchdog.rateStatus(sourceId).rate, 0, 'f', 1));
+	}
 
-		if (!m_marketData.contains(symbol)) {
-			return;
-		}
+	// Finnhub pings an idle connection, so a live socket that has gone silent is dead
+	const qint64 linkSilenceNanos = 120000000000LL;
+	if (m_recovery->state() == RecoveryState::Live
+		&& now - m_feedHandler->lastMessageTime() > linkSilenceNanos) {
+		QString message = QString("[WATCHDOG] No frames from %1 for %2 s - reconnecting")
+			.arg(m_webSocketUrl)
+			.arg((now - m_feedHandler->lastMessageTime()) / 1000000000);
+		emit logMessage(message);
+		emit feedHealthAlert(PrimaryFeedSource, message);
+		setStatus(FeedStatus::Reconnecting);
+		m_recovery->onLinkLost("link silent");
+		QMetaObject::invokeMethod(m_feedHandler, &FeedHandler::close, Qt::QueuedConnection);
+	}
+}
 
-		MarketData* marketData = m_marketData[symbol];
-
-		double currentPrice = obj["c"].toDouble();
-		double open = obj["o"].toDouble();
-		double high = obj["h"].toDouble();
-		double low = obj["l"].toDouble();
-		double previousClose = obj["pc"].toDouble();
-
-		if (currentPrice > 0) {
-			marketData->setOpenPrice(open);
-			marketData->setHighPrice(high);
-			marketData->setLowPrice(low);
-			// setPreviousClose doesn't exist in MarketData - skip it
-			marketData->updateTrade(currentPrice, 0);  // Initialize with current price
-
-			emit logMessage(QString("[FEED] Snapshot for %1: $%2 (Open: $%3, High: $%4, Low: $%5)")
-				.arg(symbol)
-				.arg(currentPrice, 0, 'f', 2)
-				.arg(open, 0, 'f', 2)
-				.arg(high, 0, 'f', 2)
-				.arg(low, 0, 'f', 2));
-
-			emit marketDataUpdated(symbol, marketData);
-		}
-		});
+QString MarketDataFeed::sourceName(FeedSourceId sourceId) const
+{
+	switch (sourceId) {
+	case PrimaryFeedSource: return "Primary";
+	case ReplayFeedSource: return "Replay";
+	case SyntheticFeedSource: return "Synthetic";
+	default: return m_feedManager->sessionName(sourceId);
+	}
 }
 
 void MarketDataFeed::startSimulation()
 {
 	emit logMessage("[FEED] Starting market data simulation");
-	m_simulationTimer->start();
+
+	// Roughly the old cadence: one trade and one quote per symbol per update interval
+	SyntheticGeneratorConfig config;
+	config.seed = 1;
+	config.sourceId = SyntheticFeedSource;
+	config.threads = 1;
+	const QStringList symbols = getSubscribedSymbols();
+	config.eventsPerSecond = qMax<qint64>(1, symbols.size() * 2 * 1000 / qMax(1, m_updateInterval));
+	config.secondsPerEvent = m_updateInterval / 2000.0;
+	for (const QString& symbol : symbols) {
+		SyntheticSymbolConfig symbolConfig = SyntheticMarketGenerator::defaultSymbolConfig(symbol);
+		MarketData* data = getMarketData(symbol);
+		if (data && data->lastPrice() > 0.0) {
+			symbolConfig.startPrice = data->lastPrice();  // Continue from where prices are
+		}
+		config.symbols.append(symbolConfig);
+	}
+	m_generator->start(config);
 }
 
 void MarketDataFeed::stopSimulation()
 {
 	emit logMessage("[FEED] Stopping market data simulation");
-	m_simulationTimer->stop();
+	m_generator->stop();
+	m_watchdog.resetSource(SyntheticFeedSource);
 }
 
-void MarketDataFeed::generateRandomMarketData(const QString& symbol)
-{
-	if (!m_marketData.contains(symbol)) {
-		return;
-	}
-
-	MarketData* data = m_marketData[symbol];
-
-	// Generate random price movement
-	double lastPrice = data->lastPrice();
-	if (lastPrice == 0.0) {
-		// Initialize with a base price
-		if (symbol == "AAPL") lastPrice = 182.50;
-		else if (symbol == "MSFT") lastPrice = 384.90;
-		else if (symbol == "GOOGL") lastPrice = 149.34;
-		else if (symbol == "TSLA") lastPrice = 253.80;
-		else if (symbol == "AMZN") lastPrice = 151.94;
-		else if (symbol == "NVDA") lastPrice = 722.48;
-		else if (symbol == "META") lastPrice = 434.61;
-		else if (symbol == "SPY") lastPrice = 469.50;
-		else if (symbol == "QQQ") lastPrice = 395.80;
-		else lastPrice = 100.0;
-
-		data->setOpenPrice(lastPrice);
-	}
-
-	// Random walk with mean reversion
-	double change = (QRandomGenerator::global()->bounded(200) - 100) / 10000.0 * lastPrice;
-	double newPrice = lastPrice + change;
-	double volume = QRandomGenerator::global()->bounded(1000) + 100;
-
-	data->updateTrade(newPrice, volume);
-
-	// Generate quote data
-	double spread = newPrice * 0.001;  // 0.1% spread
-	double bid = newPrice - spread / 2.0;
-	double ask = newPrice + spread / 2.0;
-	double bidSize = QRandomGenerator::global()->bounded(500) + 100;
-	double askSize = QRandomGenerator::global()->bounded(500) + 100;
-
-	data->updateQuote(bid, bidSize, ask, askSize);
-
-	emit marketDataUpdated(symbol, data);
-	emit tradeReceived(symbol, newPrice, volume);
-}
 
 void MarketDataFeed::setFinnhubApiKey(const QString& apiKey)
 {
 	m_finnhubApiKey = apiKey;
+	m_snapshotLoader->setApiKey(apiKey);
+}
+
+void MarketDataFeed::setTransportKind(WebSocketTransportKind kind)
+{
+	if (kind == m_transportKind) {
+		return;
+	}
+	m_transportKind = kind;
+	QMetaObject::invokeMethod(m_feedHandler, [this, kind]() {
+		m_feedHandler->setTransportKind(kind);
+		}, Qt::QueuedConnection);
+	m_feedManager->setTransportKind(kind);
+	emit logMessage(QString("[FEED] WebSocket transport: %1 (from the next connection)")
+		.arg(WebSocketTransport::kindName(kind)));
 }
\ No newline at end of file
@@ -1,11 +1,25 @@
 #pragma once
 #include <QObject>
-#include <QMap>
+#include <QVector>
 #include <QTimer>
-#include <QWebSocket>
+#include <QThread>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include "MarketData.h"
+#include "OrderBook.h"
+#include "FeedHandler.h"
+#include "SnapshotLoader.h"
+#include "ReplayFeed.h"
+#include "SyntheticMarketGenerator.h"
+#include "FeedManager.h"
+#include "FeedArbiter.h"
+#include "FeedRecovery.h"
+#include "FeedWatchdog.h"
+#include "BarAggregator.h"
+#include "IndicatorEngine.h"
+#include "TickStore.h"
+#include "SubscriptionRegistry.h"
+#include "MarketDataBus.h"
 
 enum class FeedStatus {
 	Disconnected,
@@ -15,6 +29,16 @@ enum class FeedStatus {
 	Error
 };
 
+// Per-source arbitration and loss figures for diagnostics
+struct FeedSourceSummary {
+	FeedSourceId sourceId;
+	QString name;
+	FeedSourceStats stats;
+	quint64 sequenceGaps;
+	quint64 ticksDropped;
+	FeedRateStatus rate;
+};
+
 class MarketDataFeed : public QObject
 {
 	Q_OBJECT
@@ -26,36 +50,115 @@ public:
 	// Connection management
 	void connectToFeed();
 	void disconnectFromFeed();
+	void connectToEndpoint(const QString& url);  // Drop the current source and stream from url
+
+	// Replay a recorded tick file instead of the live feed; speed 0 = max
+	void startReplay(const QString& path, double speed);
+	void stopReplay();
+	bool isReplaying() const { return m_replayActive; }
+	ReplayStats replayStats() const { return m_replayFeed->stats(); }
+
+	// Synthetic load test: symbolCount generated symbols; eventsPerSecond 0 = unbounded
+	void startLoadTest(int symbolCount, qint64 eventsPerSecond, int threads, quint64 seed);
+	void stopLoadTest();
+	bool isLoadTesting() const { return m_loadTestActive; }
+	quint64 syntheticEventsGenerated() const { return m_generator->eventsGenerated(); }
+
+	// Additional sessions, arbitrated against each other and the primary source
+	FeedSourceId addWebSocketSession(const QString& name, const QString& url);
+	FeedManager* feedManager() const { return m_feedManager; }
+	QVector<FeedSourceSummary> sourceSummaries() const;
+
+	// Per-symbol delivery of updates, trades, quotes and bars to the
+	// subscribers of each symbol; preferred over the broadcast signals below
+	MarketDataBus& bus() { return m_bus; }
+
+	// OHLCV bars for every subscribed symbol, built from its trades
+	const BarAggregator& bars() const { return m_bars; }
+
+	// Indicators on each symbol's closed one-minute bars, as of the last batch
+	const IndicatorEngine& indicators() const { return m_indicators; }
+
+	// Health - symbols with no update for the stale threshold, and message rates
+	bool isStale(SymbolId id) const { return m_watchdog.isStale(id); }
+	int staleSymbolCount() const { return m_watchdog.staleCount(); }
+	quint64 arbiterOverflows() const { return m_arbiter.windowOverflows(); }
+	double messageRate() const { return m_watchdog.totalRate(); }
+
+	// Raw frame capture to rotating segment files in directory
+	bool startJournal(const QString& directory);
+	void stopJournal();
+	const FeedJournal* journal() const { return m_journal; }  // nullptr when not capturing
+
+	// Compressed trade history in directory, queryable through TickStoreReader
+	bool startTickStore(const QString& directory);
+	void stopTickStore();
+	const TickStore* tickStore() const { return m_tickStore; }  // nullptr when not recording
 	bool isConnected() const { return m_status == FeedStatus::Connected; }
 	FeedStatus status() const { return m_status; }
+	RecoveryState recoveryState() const { return m_recovery->state(); }
+	int reconnectAttempt() const { return m_recovery->attempt(); }
+	bool isFallbackSimulation() const { return m_fallbackSimulation; }  // Simulated prices while the live feed is down
 
-	// Subscription management
-	void subscribe(const QString& symbol);
-	void unsubscribe(const QString& symbol);
-	void subscribeMultiple(const QStringList& symbols);
+	// Subscription management. Each subscriber holds its own reference, so a
+	// symbol stays subscribed until every subscriber holding it lets go.
+	// Wire frames for all changes in one event-loop pass go out together.
+	static const int DefaultSubscriber = 0;
+	int addSubscriber(const QString& name) { return m_subscriptions.addConsumer(name); }
+	void subscribe(const QString& symbol, int subscriber = DefaultSubscriber);
+	void unsubscribe(const QString& symbol, int subscriber = DefaultSubscriber);
+	void subscribeMultiple(const QStringList& symbols, int subscriber = DefaultSubscriber);
 	QStringList getSubscribedSymbols() const;
+	const SubscriptionRegistry& subscriptions() const { return m_subscriptions; }
 
 	// Data access
 	MarketData* getMarketData(const QString& symbol);
+	MarketData* getMarketData(SymbolId id) const;
+	const OrderBook* getOrderBook(SymbolId id) const;  // nullptr until the symbol has quoted
 	QList<MarketData*> getAllMarketData() const;
+	bool isSubscribed(SymbolId id) const;
 
 	// Configuration
 	void setUpdateInterval(int milliseconds) { m_updateInterval = milliseconds; }
+	void setPublishInterval(int milliseconds);  // Conflation window, default 16 ms
+	int publishInterval() const;
+	void setStaleThreshold(int milliseconds) { m_watchdog.setStaleAfter(milliseconds * qint64(1000000)); }  // Default 30 s
+	int staleThresholdSeconds() const { return static_cast<int>(m_watchdog.staleAfter() / 1000000000); }
 	void setWebSocketUrl(const QString& url) { m_webSocketUrl = url; }
-	void setRestApiUrl(const QString& url) { m_restApiUrl = url; }
+	QString webSocketUrl() const { return m_webSocketUrl; }
+	void setRestApiUrl(const QString& url) { m_restApiUrl = url; m_snapshotLoader->setBaseUrl(url); }
 	void setFinnhubApiKey(const QString& apiKey);  // NEW: Set API key
 
+	// Socket backend for the primary feed and WebSocket sessions; applies from
+	// the next connection. wss:// always uses Qt.
+	void setTransportKind(WebSocketTransportKind kind);
+	WebSocketTransportKind transportKind() const { return m_transportKind; }
+
+	// Feed thread -> GUI handoff statistics
+	FeedQueueStats queueStats() const;
+	quint64 messagesProcessed() const { return m_messagesProcessed; }
+
 signals:
 	// Connection signals
 	void connected();
 	void disconnected();
 	void connectionError(const QString& error);
 	void statusChanged(FeedStatus status);
+	void recoveryStateChanged(RecoveryState state, int attempt);
+	void staleSymbolsChanged(const QVector<SymbolId>& stale, const QVector<SymbolId>& recovered);
+	void feedHealthAlert(FeedSourceId sourceId, const QString& message);
 
-	// Data signals
+	// Data signals - conflated, at most one batch per publish interval. Every
+	// receiver gets every symbol; bus() delivers only what was subscribed to.
+	void marketDataBatchUpdated(const QVector<MarketDataUpdate>& updates);
+	void barsClosed(const QVector<ClosedBar>& bars);  // With the batch; only collected while connected
+
+	// Raw stream - one emission per trade, only built while something is connected
 	void marketDataUpdated(const QString& symbol, MarketData* data);
 	void tradeReceived(const QString& symbol, double price, double volume);
 	void quoteReceived(const QString& symbol, double bid, double ask);
+	void snapshotProgress(int completed, int total);
+	void replayFinished(const QString& summary);
 
 	// System signals
 	void logMessage(const QString& message);
@@ -63,45 +166,96 @@ signals:
 private slots:
 	void onWebSocketConnected();
 	void onWebSocketDisconnected();
-	void onWebSocketError(QAbstractSocket::SocketError error);
-	void onWebSocketTextMessageReceived(const QString& message);
-	void onWebSocketBinaryMessageReceived(const QByteArray& message);
+	void onWebSocketError(const QString& error);
+	void onRecoveryStateChanged(RecoveryState state, RecoveryState previous, qint64 nanosInPrevious);
+	void flushSubscriptions();
+	void checkFeedHealth();
+	void drainTicks();
+	void publishUpdates();
 	void onRestApiReplyFinished();
-	void simulateMarketData();
+	void onSnapshotReceived(const QString& symbol, const SnapshotQuote& quote);
+	void onReplayStarted(const QStringList& symbols);
+	void onReplayFinished(const QString& summary);
 
 private:
+	struct RawListeners {
+		bool trades;
+		bool quotes;
+		bool updates;
+		bool bars;
+	};
+
 	void setStatus(FeedStatus status);
-	void processWebSocketMessage(const QString& message);
+	void registerSymbol(SymbolId id, const QString& symbol);
+	void registerSymbols(const QStringList& symbols);
+	bool registerDiscovered(const FeedTick& tick);  // Tick for a symbol its session has not announced yet
+	int drainRing(SpscRing<FeedTick>& ring, int budget, const RawListeners& listeners);
+	void scheduleSubscriptionFlush();
+	void openPrimarySocket();
+	void refreshStaleSnapshots(qint64 since);
+	QString sourceName(FeedSourceId sourceId) const;
+	void markDirty(SymbolId id, double volume, int trades);
 	void processRestApiData(const QByteArray& data);
 	void fetchSnapshotData(const QString& symbol);
 	void startSimulation();
 	void stopSimulation();
-	void generateRandomMarketData(const QString& symbol);
 
 private:
-	// Connection
-	QWebSocket* m_webSocket;
+	// Connection - the WebSocket lives on m_feedThread inside m_feedHandler
+	QThread* m_feedThread;
+	FeedHandler* m_feedHandler;
+	ReplayFeed* m_replayFeed;  // Also on m_feedThread, so the tick ring keeps a single producer
+	FeedJournal* m_journal;
+	TickStore* m_tickStore;
+	SyntheticMarketGenerator* m_generator;  // Simulation mode and load tests
+	FeedManager* m_feedManager;
+	FeedArbiter m_arbiter;
+	FeedWatchdog m_watchdog;
+	BarAggregator m_bars;
+	IndicatorEngine m_indicators;
+	MarketDataBus m_bus;
+	bool m_loadTestActive;
+	QVector<SymbolId> m_loadTestIds;
+	SpscRing<FeedTick> m_tickRing;
 	QNetworkAccessManager* m_networkManager;
+	SnapshotLoader* m_snapshotLoader;
 	FeedStatus m_status;
+	bool m_autoReconnect;
+	FeedRecovery* m_recovery;
+	bool m_fallbackSimulation;  // Started by the recovery, not chosen by the user
 
 	// Configuration
 	QString m_webSocketUrl;
 	QString m_restApiUrl;
 	int m_updateInterval;
 	bool m_useSimulation;
+	bool m_replayActive;
 	QString m_finnhubApiKey;  // NEW: Store Finnhub API key
+	WebSocketTransportKind m_transportKind;
+
+	// Data storage - per-symbol arrays indexed by SymbolId
+	QVector<MarketData*> m_marketData;
+	QVector<OrderBook*> m_orderBooks;  // Built from quotes, created on first quote
+	QVector<bool> m_subscribed;  // Tracked from any source, including load tests
+	SubscriptionRegistry m_subscriptions;
+	int m_sessionSubscriber;  // Symbols sessions brought with them; not sent to the primary feed
+
+	// Conflation state, indexed by SymbolId
+	QVector<bool> m_dirty;
+	QVector<double> m_pendingVolume;
+	QVector<int> m_pendingTrades;
+	QVector<SymbolId> m_dirtyIds;
+	QVector<ClosedBar> m_closedBars;
 
-	// Data storage
-	QMap<QString, MarketData*> m_marketData;
-	QStringList m_subscribedSymbols;
+	// Receive time of the last tick from a live source, indexed by SymbolId;
+	// symbols older than an outage need a snapshot once it ends
+	QVector<qint64> m_lastLiveUpdate;
 
 	// Timers
-	QTimer* m_reconnectTimer;
-	QTimer* m_heartbeatTimer;
-	QTimer* m_simulationTimer;
+	QTimer* m_subscriptionTimer;  // Zero-interval, single shot: coalesces one event-loop pass
+	QTimer* m_watchdogTimer;
+	QTimer* m_publishTimer;
 
 	// Statistics
-	int m_messagesReceived;
-	int m_messagesProcessed;
-	QDateTime m_lastMessageTime;
+	quint64 m_messagesProcessed;
 };
\ No newline at end of file
@@ -1,18 +1,22 @@
 #include "MarketDataWidget.h"
 #include <QHeaderView>
 #include <QMessageBox>
+#include <QtNumeric>
 
 MarketDataWidget::MarketDataWidget(MarketDataFeed* feed, QWidget* parent)
 	: QWidget(parent)
 	, m_feed(feed)
+	, m_subscriber(feed->addSubscriber("Market Data"))
 {
 	setupUI();
 
-	// Connect feed signals
-	connect(m_feed, &MarketDataFeed::marketDataUpdated,
-		this, &MarketDataWidget::onMarketDataUpdated);
+	// Conflated updates arrive through the bus, per subscribed symbol
 	connect(m_feed, &MarketDataFeed::statusChanged,
 		this, &MarketDataWidget::onFeedStatusChanged);
+	connect(m_feed, &MarketDataFeed::recoveryStateChanged,
+		this, &MarketDataWidget::onRecoveryStateChanged);
+	connect(m_feed, &MarketDataFeed::staleSymbolsChanged,
+		this, &MarketDataWidget::onStaleSymbolsChanged);
 }
 
 void MarketDataWidget::setupUI()
@@ -49,10 +53,11 @@ void MarketDataWidget::setupUI()
 	toolbarLayout->addWidget(m_connectButton);
 
 	// Market data table
-	m_dataTable = new QTableWidget(0, 10, this);
+	m_dataTable = new QTableWidget(0, 12, this);
+	const QString barName = BarAggregator::intervalName(m_feed->indicators().interval());
 	QStringList headers = {
 		"Symbol", "Last", "Change", "Change %", "Bid", "Ask",
-		"Bid Size", "Ask Size", "Volume", "Time"
+		"Bid Size", "Ask Size", "Volume", QString("RSI %1").arg(barName), QString("MACD %1").arg(barName), "Time"
 	};
 	m_dataTable->setHorizontalHeaderLabels(headers);
 	m_dataTable->setAlternatingRowColors(true);
@@ -71,7 +76,9 @@ void MarketDataWidget::setupUI()
 	m_dataTable->setColumnWidth(6, 80);   // Bid Size
 	m_dataTable->setColumnWidth(7, 80);   // Ask Size
 	m_dataTable->setColumnWidth(8, 100);  // Volume
-	m_dataTable->setColumnWidth(9, 120);  // Time
+	m_dataTable->setColumnWidth(9, 70);   // RSI
+	m_dataTable->setColumnWidth(10, 80);  // MACD histogram
+	m_dataTable->setColumnWidth(11, 120); // Time
 
 	mainLayout->addLayout(toolbarLayout);
 	mainLayout->addWidget(m_dataTable);
@@ -98,6 +105,11 @@ void MarketDataWidget::addSymbol(const QString& symbol)
 	// Add to table
 	int row = m_dataTable->rowCount();
 	m_dataTable->insertRow(row);
+
+	SymbolId id = SymbolTable::instance().intern(upperSymbol);
+	ensureSymbolCapacity(m_rowBySymbol, id, -1);
+	ensureSymbolCapacity(m_previousPrices, id, -1.0);
+	m_rowBySymbol[id] = row;
 	m_dataTable->setItem(row, 0, new QTableWidgetItem(upperSymbol));
 
 	// Initialize other columns
@@ -106,35 +118,62 @@ void MarketDataWidget::addSymbol(const QString& symbol)
 	}
 
 	// Subscribe to feed
-	m_feed->subscribe(upperSymbol);
+	m_feed->subscribe(upperSymbol, m_subscriber);
+	m_feed->bus().subscribe(id, UpdateEvents, this);
 }
 
 void MarketDataWidget::removeSymbol(const QString& symbol)
 {
-	int row = findSymbolRow(symbol);
+	SymbolId id = SymbolTable::instance().find(symbol);
+	int row = findSymbolRow(id);
 	if (row >= 0) {
 		m_dataTable->removeRow(row);
-		m_feed->unsubscribe(symbol);
-		m_previousPrices.remove(symbol);
+		m_feed->unsubscribe(symbol, m_subscriber);
+		m_feed->bus().unsubscribe(id, this);
+		m_rowBySymbol[id] = -1;
+		m_previousPrices[id] = -1.0;
+
+		// Rows below the removed one shift up by one
+		for (int& r : m_rowBySymbol) {
+			if (r > row) {
+				r--;
+			}
+		}
 	}
 }
 
 void MarketDataWidget::clearSymbols()
 {
 	m_dataTable->setRowCount(0);
-	m_previousPrices.clear();
+	for (int id = 0; id < m_rowBySymbol.size(); ++id) {
+		if (m_rowBySymbol[id] >= 0) {
+			m_feed->unsubscribe(SymbolTable::instance().symbol(static_cast<SymbolId>(id)), m_subscriber);
+		}
+	}
+	m_feed->bus().detach(this);
+	m_rowBySymbol.fill(-1);
+	m_previousPrices.fill(-1.0);
 }
 
 void MarketDataWidget::onMarketDataUpdated(const QString& symbol, MarketData* data)
 {
+	Q_UNUSED(symbol);
 	if (!data) return;
 
-	int row = findSymbolRow(symbol);
+	int row = findSymbolRow(data->symbolId());
 	if (row >= 0) {
 		updateMarketDataRow(row, data);
 	}
 }
 
+void MarketDataWidget::onMarketDataUpdate(const MarketDataUpdate& update)
+{
+	int row = findSymbolRow(update.symbolId);
+	if (row >= 0 && update.data) {
+		updateMarketDataRow(row, update.data);
+	}
+}
+
 void MarketDataWidget::onAddSymbolClicked()
 {
 	QString symbol = m_symbolEdit->text().trimmed().toUpper();
@@ -158,7 +197,7 @@ void MarketDataWidget::onRemoveSymbolClicked()
 
 void MarketDataWidget::onConnectClicked()
 {
-	if (m_feed->isConnected()) {
+	if (m_feed->isConnected() || m_feed->status() == FeedStatus::Reconnecting) {
 		m_feed->disconnectFromFeed();
 		m_connectButton->setText("Connect");
 	}
@@ -191,7 +230,8 @@ void MarketDataWidget::onFeedStatusChanged(FeedStatus status)
 	case FeedStatus::Reconnecting:
 		m_statusLabel->setText("Reconnecting...");
 		m_statusLabel->setStyleSheet("QLabel { color: #ffa500; }");
-		m_connectButton->setEnabled(false);
+		m_connectButton->setText("Disconnect");  // Lets the user stop retrying
+		m_connectButton->setEnabled(true);
 		break;
 	case FeedStatus::Error:
 		m_statusLabel->setText("Error");
@@ -202,15 +242,63 @@ void MarketDataWidget::onFeedStatusChanged(FeedStatus status)
 	}
 }
 
+void MarketDataWidget::onRecoveryStateChanged(RecoveryState state, int attempt)
+{
+	if (m_feed->status() != FeedStatus::Reconnecting) {
+		return;
+	}
+
+	QString text = state == RecoveryState::Connecting
+		? QString("Reconnecting (attempt %1)...").arg(attempt)
+		: QString("Reconnecting (%1 failed)...").arg(attempt);
+	if (m_feed->isFallbackSimulation()) {
+		text += " - SIMULATED";
+	}
+	m_statusLabel->setText(text);
+}
+
+void MarketDataWidget::onStaleSymbolsChanged(const QVector<SymbolId>& stale, const QVector<SymbolId>& recovered)
+{
+	// Only the symbol cell is touched; row updates leave it alone, so the flag sticks
+	for (SymbolId id : stale) {
+		int row = findSymbolRow(id);
+		if (row >= 0) {
+			setSymbolStale(row, true);
+		}
+	}
+	for (SymbolId id : recovered) {
+		int row = findSymbolRow(id);
+		if (row >= 0) {
+			setSymbolStale(row, false);
+		}
+	}
+}
+
+void MarketDataWidget::setSymbolStale(int row, bool stale)
+{
+	QTableWidgetItem* item = m_dataTable->item(row, 0);
+	if (!item) {
+		return;
+	}
+	QFont font = item->font();
+	font.setItalic(stale);
+	item->setFont(font);
+	item->setForeground(stale ? QColor(128, 128, 128) : QColor(255, 255, 255));
+	item->setToolTip(stale ? QString("Stale - no update in the last %1 s").arg(m_feed->staleThresholdSeconds()) : QString());
+}
+
 void MarketDataWidget::updateMarketDataRow(int row, MarketData* data)
 {
 	if (!data || row < 0 || row >= m_dataTable->rowCount()) {
 		return;
 	}
 
-	QString symbol = data->symbol();
-	double currentPrice = data->lastPrice();
-	double previousPrice = m_previousPrices.value(symbol, currentPrice);
+	// One consistent copy, so price, change and quote all come from the same update
+	const MarketDataSnapshot snapshot = data->snapshot();
+
+	SymbolId id = snapshot.symbolId;
+	double currentPrice = snapshot.lastPrice;
+	double previousPrice = m_previousPrices[id] >= 0.0 ? m_previousPrices[id] : currentPrice;
 
 	// Update price with color
 	QTableWidgetItem* priceItem = new QTableWidgetItem(QString::number(currentPrice, 'f', 2));
@@ -218,26 +306,26 @@ void MarketDataWidget::updateMarketDataRow(int row, MarketData* data)
 	m_dataTable->setItem(row, 1, priceItem);
 
 	// Change amount
-	double changeAmount = data->changeAmount();
+	double changeAmount = snapshot.changeAmount();
 	QTableWidgetItem* changeItem = new QTableWidgetItem(QString::number(changeAmount, 'f', 2));
 	changeItem->setForeground(getPriceColor(changeAmount));
 	m_dataTable->setItem(row, 2, changeItem);
 
 	// Change percent
-	double changePercent = data->changePercent();
+	double changePercent = snapshot.changePercent();
 	QString percentStr = QString("%1%").arg(changePercent, 0, 'f', 2);
 	QTableWidgetItem* percentItem = new QTableWidgetItem(percentStr);
 	percentItem->setForeground(getPriceColor(changeAmount));
 	m_dataTable->setItem(row, 3, percentItem);
 
 	// Bid/Ask
-	m_dataTable->setItem(row, 4, new QTableWidgetItem(QString::number(data->bidPrice(), 'f', 2)));
-	m_dataTable->setItem(row, 5, new QTableWidgetItem(QString::number(data->askPrice(), 'f', 2)));
-	m_dataTable->setItem(row, 6, new QTableWidgetItem(QString::number(data->bidVolume(), 'f', 0)));
-	m_dataTable->setItem(row, 7, new QTableWidgetItem(QString::number(data->askVolume(), 'f', 0)));
+	m_dataTable->setItem(row, 4, new QTableWidgetItem(QString::number(snapshot.bidPrice, 'f', 2)));
+	m_dataTable->setItem(row, 5, new QTableWidgetItem(QString::number(snapshot.askPrice, 'f', 2)));
+	m_dataTable->setItem(row, 6, new QTableWidgetItem(QString::number(snapshot.bidVolume, 'f', 0)));
+	m_dataTable->setItem(row, 7, new QTableWidgetItem(QString::number(snapshot.askVolume, 'f', 0)));
 
 	// Volume
-	double volume = data->totalVolume();
+	double volume = snapshot.totalVolume;
 	QString volumeStr;
 	if (volume >= 1000000) {
 		volumeStr = QString("%1M").arg(volume / 1000000.0, 0, 'f', 2);
@@ -250,23 +338,51 @@ void MarketDataWidget::updateMarketDataRow(int row, MarketData* data)
 	}
 	m_dataTable->setItem(row, 8, new QTableWidgetItem(volumeStr));
 
+	// Indicators, once enough bars have closed
+	IndicatorValues indicators;
+	if (m_feed->indicators().values(id, indicators)) {
+		QTableWidgetItem* rsiItem = new QTableWidgetItem(qIsNaN(indicators.rsi) ? QString("-") : QString::number(indicators.rsi, 'f', 1));
+		if (indicators.rsi >= 70.0) {
+			rsiItem->setForeground(getPriceColor(-1.0));  // Overbought
+		}
+		else if (indicators.rsi <= 30.0) {
+			rsiItem->setForeground(getPriceColor(1.0));   // Oversold
+		}
+		m_dataTable->setItem(row, 9, rsiItem);
+
+		QTableWidgetItem* macdItem = new QTableWidgetItem(qIsNaN(indicators.macdHistogram) ? QString("-") : QString::number(indicators.macdHistogram, 'f', 3));
+		macdItem->setForeground(getPriceColor(qIsNaN(indicators.macdHistogram) ? 0.0 : indicators.macdHistogram));
+		macdItem->setToolTip(QString("%1 bars\nEMA %2  SMA %3\nBollinger %4 - %5\nMACD %6  signal %7\nATR %8")
+			.arg(indicators.bars)
+			.arg(indicators.ema, 0, 'f', 2)
+			.arg(indicators.sma, 0, 'f', 2)
+			.arg(indicators.bollingerLower, 0, 'f', 2)
+			.arg(indicators.bollingerUpper, 0, 'f', 2)
+			.arg(indicators.macd, 0, 'f', 3)
+			.arg(indicators.macdSignal, 0, 'f', 3)
+			.arg(indicators.atr, 0, 'f', 3));
+		m_dataTable->setItem(row, 10, macdItem);
+	}
+
 	// Time
-	QString timeStr = data->timestamp().toString("hh:mm:ss");
-	m_dataTable->setItem(row, 9, new QTableWidgetItem(timeStr));
+	QString timeStr = snapshot.timestamp().toString("hh:mm:ss");
+	m_dataTable->setItem(row, 11, new QTableWidgetItem(timeStr));
 
 	// Store current price for next update
-	m_previousPrices[symbol] = currentPrice;
+	m_previousPrices[id] = currentPrice;
 }
 
-int MarketDataWidget::findSymbolRow(const QString& symbol)
+int MarketDataWidget::findSymbolRow(const QString& symbol) const
 {
-	for (int row = 0; row < m_dataTable->rowCount(); ++row) {
-		QTableWidgetItem* item = m_dataTable->item(row, 0);
-		if (item && item->text() == symbol) {
-			return row;
-		}
+	return findSymbolRow(SymbolTable::instance().find(symbol));
+}
+
+int MarketDataWidget::findSymbolRow(SymbolId id) const
+{
+	if (id == InvalidSymbolId || id >= static_cast<SymbolId>(m_rowBySymbol.size())) {
+		return -1;
 	}
-	return -1;
+	return m_rowBySymbol[id];
 }
 
 QColor MarketDataWidget::getPriceColor(double change)
@@ -10,7 +10,7 @@
 #include "MarketData.h"
 #include "MarketDataFeed.h"
 
-class MarketDataWidget : public QWidget
+class MarketDataWidget : public QWidget, public MarketDataSubscriber
 {
 	Q_OBJECT
 
@@ -21,21 +21,29 @@ public:
 	void removeSymbol(const QString& symbol);
 	void clearSymbols();
 
+	// MarketDataSubscriber - only the symbols in the table are subscribed
+	void onMarketDataUpdate(const MarketDataUpdate& update) override;
+
 private slots:
 	void onMarketDataUpdated(const QString& symbol, MarketData* data);
 	void onAddSymbolClicked();
 	void onRemoveSymbolClicked();
 	void onConnectClicked();
 	void onFeedStatusChanged(FeedStatus status);
+	void onRecoveryStateChanged(RecoveryState state, int attempt);
+	void onStaleSymbolsChanged(const QVector<SymbolId>& stale, const QVector<SymbolId>& recovered);
 
 private:
 	void setupUI();
 	void updateMarketDataRow(int row, MarketData* data);
-	int findSymbolRow(const QString& symbol);
+	void setSymbolStale(int row, bool stale);
+	int findSymbolRow(const QString& symbol) const;
+	int findSymbolRow(SymbolId id) const;
 	QColor getPriceColor(double change);
 
 private:
 	MarketDataFeed* m_feed;
+	int m_subscriber;  // Our references in the feed's subscription registry
 
 	QGroupBox* m_groupBox;
 	QTableWidget* m_dataTable;
@@ -45,5 +53,7 @@ private:
 	QPushButton* m_connectButton;
 	QLabel* m_statusLabel;
 
-	QMap<QString, double> m_previousPrices;  // For price change detection
+	// Per-symbol state indexed by SymbolId
+	QVector<int> m_rowBySymbol;         // Table row, -1 if not shown
+	QVector<double> m_previousPrices;   // For price change detection, -1 if unset
 };
\ No newline at end of file
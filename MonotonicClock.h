@@ -0,0 +1,51 @@
+#pragma once
+#include <QtGlobal>
+#include <QDateTime>
+#include <chrono>
+
+// Process-wide monotonic nanosecond clock for hot paths. Values are
+// steady_clock ns and only comparable within one process run; convert to
+// wall-clock time for display or persistence, never to order events.
+class MonotonicClock {
+public:
+	static qint64 now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Wall-clock conversion against a single anchor captured on first use,
+	// so converted times stay monotonic even if the system clock is stepped
+	static qint64 toWallNanos(qint64 monotonicNanos)
+	{
+		const Anchor& a = anchor();
+		return a.wallNanos + (monotonicNanos - a.monotonicNanos);
+	}
+
+	static qint64 toWallMSecs(qint64 monotonicNanos)
+	{
+		const qint64 wall = toWallNanos(monotonicNanos);
+		return wall >= 0 ? wall / 1000000 : (wall - 999999) / 1000000;
+	}
+
+	static QDateTime toDateTime(qint64 monotonicNanos)
+	{
+		return QDateTime::fromMSecsSinceEpoch(toWallMSecs(monotonicNanos));
+	}
+
+private:
+	struct Anchor {
+		qint64 monotonicNanos;
+		qint64 wallNanos;
+	};
+
+	static const Anchor& anchor()
+	{
+		static const Anchor a = {
+			now(),
+			std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::system_clock::now().time_since_epoch()).count()
+		};
+		return a;
+	}
+};
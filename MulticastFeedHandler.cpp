@@ -0,0 +1,288 @@
+#include "MulticastFeedHandler.h"
+#include "BinaryFeedProtocol.h"
+#include "LatencyMonitor.h"
+#include "MonotonicClock.h"
+#include <QVector>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace {
+
+const int MaxDatagramSize = 65536;  // Anything larger cannot be a UDP payload
+
+QString systemError()
+{
+	return QString::fromLocal8Bit(std::strerror(errno));
+}
+
+}
+#endif
+
+MulticastFeedHandler::MulticastFeedHandler(SpscRing<FeedTick>* ring, FeedSourceId sourceId, QObject* parent)
+	: QObject(parent)
+	, m_ring(ring)
+	, m_sourceId(sourceId)
+	, m_config(defaultConfig())
+	, m_socket(-1)
+	, m_thread(nullptr)
+	, m_stopRequested(false)
+	, m_wakePending(false)
+{
+	std::memset(&m_stats, 0, sizeof(m_stats));
+}
+
+MulticastFeedHandler::~MulticastFeedHandler()
+{
+	stop();
+}
+
+MulticastFeedConfig MulticastFeedHandler::defaultConfig()
+{
+	MulticastFeedConfig config;
+	config.group = "239.192.0.1";
+	config.port = 30001;
+	config.batchSize = 64;
+	config.receiveBufferBytes = 8 * 1024 * 1024;
+	return config;
+}
+
+bool MulticastFeedHandler::start(const MulticastFeedConfig& config)
+{
+#ifdef Q_OS_LINUX
+	if (isRunning()) {
+		return true;
+	}
+
+	const QString target = QString("%1:%2").arg(config.group).arg(config.port);
+	in_addr group;
+	in_addr local;
+	local.s_addr = htonl(INADDR_ANY);
+	if (inet_pton(AF_INET, config.group.toLatin1().constData(), &group) != 1 || !IN_MULTICAST(ntohl(group.s_addr))) {
+		emit logMessage(QString("[MCAST] %1 is not an IPv4 multicast group").arg(config.group));
+		return false;
+	}
+	if (!config.interfaceAddress.isEmpty()
+		&& inet_pton(AF_INET, config.interfaceAddress.toLatin1().constData(), &local) != 1) {
+		emit logMessage(QString("[MCAST] Bad interface address %1").arg(config.interfaceAddress));
+		return false;
+	}
+
+	m_socket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	if (m_socket < 0) {
+		emit logMessage(QString("[MCAST] socket: %1").arg(systemError()));
+		return false;
+	}
+
+	// Several sessions on one box may listen to the same group
+	const int on = 1;
+	setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+	// Bursts arrive faster than one recvmmsg pass, so the kernel buffer absorbs them
+	setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &config.receiveBufferBytes, sizeof(config.receiveBufferBytes));
+	int receiveBuffer = 0;
+	socklen_t optionLength = sizeof(receiveBuffer);
+	getsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, &optionLength);
+
+	// Wakes the receive thread to check for stop() while the group is quiet
+	timeval timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_usec = 100000;
+	setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+	// Bound to the group, so datagrams for other groups on the port are not delivered here
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(config.port);
+	address.sin_addr = group;
+	ip_mreq membership;
+	membership.imr_multiaddr = group;
+	membership.imr_interface = local;
+	if (bind(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0
+		|| setsockopt(m_socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+		emit logMessage(QString("[MCAST] Cannot join %1: %2").arg(target, systemError()));
+		::close(m_socket);
+		m_socket = -1;
+		return false;
+	}
+
+	m_config = config;
+	m_config.batchSize = qBound(1, config.batchSize, 1024);
+	m_symbolIds.clear();
+	m_tracker.reset();
+	std::memset(&m_stats, 0, sizeof(m_stats));
+	m_published.store(m_stats);
+	m_stopRequested.store(false, std::memory_order_relaxed);
+
+	m_thread = QThread::create([this]() { run(); });
+	m_thread->setObjectName("MulticastFeed");
+	m_thread->start();
+
+	emit logMessage(QString("[MCAST] Joined %1 on %2, %3 KB receive buffer, %4 datagrams per recvmmsg")
+		.arg(target)
+		.arg(config.interfaceAddress.isEmpty() ? QString("default interface") : config.interfaceAddress)
+		.arg(receiveBuffer / 1024)
+		.arg(m_config.batchSize));
+	return true;
+#else
+	Q_UNUSED(config);
+	emit logMessage("[MCAST] Multicast sessions need Linux (recvmmsg)");
+	return false;
+#endif
+}
+
+void MulticastFeedHandler::stop()
+{
+#ifdef Q_OS_LINUX
+	if (!m_thread) {
+		return;
+	}
+
+	m_stopRequested.store(true, std::memory_order_relaxed);
+	m_thread->wait();  // Returns within one receive timeout
+	delete m_thread;
+	m_thread = nullptr;
+	::close(m_socket);  // Leaves the group
+	m_socket = -1;
+
+	const MulticastFeedStats stats = m_published.load();
+	emit logMessage(QString("[MCAST] Left %1:%2 after %3 packets, %4 missing, %5 late, %6 duplicates")
+		.arg(m_config.group).arg(m_config.port)
+		.arg(stats.packets).arg(stats.sequence.missing)
+		.arg(stats.sequence.late).arg(stats.sequence.duplicates));
+#endif
+}
+
+void MulticastFeedHandler::run()
+{
+#ifdef Q_OS_LINUX
+	// One slot per datagram, reused for every call
+	const int slots = m_config.batchSize;
+	QByteArray buffer(slots * MaxDatagramSize, Qt::Uninitialized);
+	QVector<iovec> vectors(slots);
+	QVector<mmsghdr> messages(slots);
+	for (int i = 0; i < slots; ++i) {
+		vectors[i].iov_base = buffer.data() + i * MaxDatagramSize;
+		vectors[i].iov_len = MaxDatagramSize;
+		std::memset(&messages[i], 0, sizeof(mmsghdr));
+		messages[i].msg_hdr.msg_iov = &vectors[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	while (!m_stopRequested.load(std::memory_order_relaxed)) {
+		// Blocks for the first datagram, then takes whatever else is queued
+		const int received = recvmmsg(m_socket, messages.data(), static_cast<unsigned>(slots), MSG_WAITFORONE, nullptr);
+		if (received <= 0) {
+			if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				emit logMessage(QString("[MCAST] recvmmsg: %1").arg(systemError()));
+				QThread::msleep(100);
+			}
+			continue;
+		}
+
+		// One receive time for the call, like one per WebSocket frame
+		const qint64 receiveTime = MonotonicClock::now();
+		m_stats.receiveCalls++;
+		for (int i = 0; i < received; ++i) {
+			const int length = static_cast<int>(messages[i].msg_len);
+			m_stats.packets++;
+			m_stats.bytes += static_cast<quint64>(length);
+			if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+				m_stats.malformed++;
+				continue;
+			}
+			decodePacket(static_cast<const char*>(vectors[i].iov_base), length, receiveTime);
+		}
+
+		m_stats.sequence = m_tracker.stats();
+		m_published.store(m_stats);
+		if (!m_discovered.isEmpty()) {
+			// The consumer may drain their first ticks before this arrives; it
+			// registers them on sight (see MarketDataFeed::registerDiscovered)
+			emit symbolsDiscovered(m_discovered);
+			m_discovered.clear();
+		}
+		wakeConsumer();
+	}
+#endif
+}
+
+void MulticastFeedHandler::decodePacket(const char* data, int length, qint64 receiveTime)
+{
+	BinaryFeedReader reader(data, length);
+	if (!reader.isValid()) {
+		m_stats.malformed++;
+		return;
+	}
+	const PacketSequenceTracker::Result result = m_tracker.onPacket(reader.sequence());
+	if (!m_tracker.accepts(result)) {
+		return;
+	}
+
+	FeedTick tick;
+	tick.sourceId = m_sourceId;
+	tick.receiveTime = receiveTime;
+	BinaryFeedRecord record;
+	while (reader.next(record)) {
+		tick.symbolId = lookupSymbol(record.symbol, record.symbolLength);
+		tick.type = record.type == BinaryFeedRecordType::Quote ? FeedTickType::Quote : FeedTickType::Trade;
+		tick.price = record.price;
+		tick.volume = record.volume;
+		tick.askPrice = record.askPrice;
+		tick.askVolume = record.askVolume;
+		tick.exchangeTime = record.exchangeTime;
+		tick.parsedTime = MonotonicClock::now();
+		pushTick(tick);
+	}
+	if (reader.hasError()) {
+		m_stats.malformed++;
+	}
+}
+
+SymbolId MulticastFeedHandler::lookupSymbol(const char* symbol, int length)
+{
+	auto it = m_symbolIds.constFind(QByteArray::fromRawData(symbol, length));
+	if (it != m_symbolIds.constEnd()) {
+		return it.value();
+	}
+
+	// Deep copy - the raw bytes belong to the receive slot
+	QByteArray key(symbol, length);
+	QString name = QString::fromUtf8(key);
+	SymbolId id = SymbolTable::instance().intern(name);
+	m_symbolIds.insert(key, id);
+	m_discovered.append(name);
+	return id;
+}
+
+void MulticastFeedHandler::pushTick(const FeedTick& tick)
+{
+	if (!m_ring->tryPush(tick)) {
+		// Like any live feed, a slow consumer loses ticks rather than stalling the socket
+		m_stats.ticksDropped++;
+		return;
+	}
+	m_stats.ticksEnqueued++;
+
+	LatencyMonitor::record(LatencyStage::ReceiveToParsed, tick.parsedTime - tick.receiveTime);
+	if (tick.exchangeTime > 0) {
+		LatencyMonitor::record(LatencyStage::ExchangeToReceive,
+			MonotonicClock::toWallNanos(tick.receiveTime) - tick.exchangeTime * 1000000);
+	}
+}
+
+void MulticastFeedHandler::wakeConsumer()
+{
+	if (m_ring->isEmpty()) {
+		return;
+	}
+	if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+		emit ticksAvailable();
+	}
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QThread>
+#include <atomic>
+#include "SpscRing.h"
+#include "FeedTick.h"
+#include "SymbolTable.h"
+#include "SeqLock.h"
+#include "PacketSequenceTracker.h"
+
+struct MulticastFeedConfig {
+	QString group;              // IPv4 multicast address, e.g. 239.192.0.1
+	quint16 port;
+	QString interfaceAddress;   // Local address of the interface to join on; empty = kernel's choice
+	int batchSize;              // Datagrams per recvmmsg
+	int receiveBufferBytes;     // SO_RCVBUF request; capped by net.core.rmem_max
+};
+
+struct MulticastFeedStats {
+	quint64 packets;        // Datagrams received
+	quint64 bytes;
+	quint64 receiveCalls;   // recvmmsg calls that returned data
+	quint64 ticksEnqueued;
+	quint64 ticksDropped;   // Tick ring full
+	quint64 malformed;      // Not a valid batch, or cut short by the receive slot
+	PacketSequenceStats sequence;
+};
+
+// UDP multicast market data session. Each datagram carries one
+// BinaryFeedProtocol batch whose batch sequence doubles as the packet
+// sequence. A dedicated receive thread drains the socket with recvmmsg,
+// runs the packets through a PacketSequenceTracker - duplicates are
+// dropped, late packets still delivered - and decodes the records into the
+// session's tick ring, so the consumer side is the same as for every other
+// source. Symbols are taken as they appear on the wire: new ones are
+// interned and reported through symbolsDiscovered(). The signal can arrive
+// after the symbol's first ticks are drained, so the consumer also
+// registers a symbol from this source when it first sees one of its ticks.
+class MulticastFeedHandler : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit MulticastFeedHandler(SpscRing<FeedTick>* ring, FeedSourceId sourceId, QObject* parent = nullptr);
+	~MulticastFeedHandler();
+
+	static MulticastFeedConfig defaultConfig();
+
+	// Opens the socket and joins the group on the caller's thread, so
+	// configuration errors come back here; false after logging them
+	bool start(const MulticastFeedConfig& config);
+	void stop();
+	bool isRunning() const { return m_thread != nullptr; }
+
+	// Thread-safe; published by the receive thread once per recvmmsg
+	MulticastFeedStats stats() const { return m_published.load(); }
+	void acknowledgeTicks() { m_wakePending.store(false, std::memory_order_release); }
+
+signals:
+	void ticksAvailable();
+	void symbolsDiscovered(const QStringList& symbols);
+	void logMessage(const QString& message);
+
+private:
+	void run();
+	void decodePacket(const char* data, int length, qint64 receiveTime);
+	SymbolId lookupSymbol(const char* symbol, int length);
+	void pushTick(const FeedTick& tick);
+	void wakeConsumer();
+
+private:
+	SpscRing<FeedTick>* m_ring;
+	FeedSourceId m_sourceId;
+	MulticastFeedConfig m_config;
+	int m_socket;
+	QThread* m_thread;
+	std::atomic<bool> m_stopRequested;
+	std::atomic<bool> m_wakePending;
+
+	// Receive thread only
+	QHash<QByteArray, SymbolId> m_symbolIds;
+	QStringList m_discovered;  // Interned during the current batch
+	PacketSequenceTracker m_tracker;
+	MulticastFeedStats m_stats;
+
+	SeqLock<MulticastFeedStats> m_published;
+};
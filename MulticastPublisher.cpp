@@ -0,0 +1,304 @@
+#include "MulticastPublisher.h"
+#include "BinaryFeedProtocol.h"
+#include "FinnhubTradeParser.h"
+#include "TickFile.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QtEndian>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+MulticastPublisher::MulticastPublisher(QObject* parent)
+	: QObject(parent)
+	, m_config(defaultConfig())
+	, m_capturedRecords(0)
+	, m_socket(-1)
+	, m_thread(nullptr)
+	, m_stopRequested(false)
+	, m_running(false)
+{
+}
+
+MulticastPublisher::~MulticastPublisher()
+{
+	stop();
+}
+
+MulticastPublisherConfig MulticastPublisher::defaultConfig()
+{
+	MulticastPublisherConfig config;
+	config.group = "239.192.0.1";
+	config.port = 30001;
+	config.interfaceAddress = "127.0.0.1";
+	config.ttl = 0;
+	config.packetsPerSecond = 10000;
+	config.recordsPerPacket = 20;  // Quotes included, under a 1500 byte MTU
+	config.burst = 32;
+	config.loops = 1;
+	config.lossRatio = 0.0;
+	return config;
+}
+
+bool MulticastPublisher::start(const QString& capturePath, const MulticastPublisherConfig& config)
+{
+#ifdef Q_OS_LINUX
+	if (isRunning()) {
+		return false;
+	}
+	stop();  // Joins a previous run that finished on its own
+
+	sockaddr_in destination;
+	std::memset(&destination, 0, sizeof(destination));
+	destination.sin_family = AF_INET;
+	destination.sin_port = htons(config.port);
+	in_addr local;
+	if (inet_pton(AF_INET, config.group.toLatin1().constData(), &destination.sin_addr) != 1
+		|| inet_pton(AF_INET, config.interfaceAddress.toLatin1().constData(), &local) != 1) {
+		emit logMessage(QString("[MCASTPUB] Bad group %1 or interface %2").arg(config.group, config.interfaceAddress));
+		return false;
+	}
+
+	if (!loadCapture(capturePath, qBound(1, config.recordsPerPacket, 1000))) {
+		return false;
+	}
+
+	m_socket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+	const unsigned char ttl = static_cast<unsigned char>(qBound(0, config.ttl, 255));
+	const unsigned char loop = 1;
+	if (m_socket < 0
+		|| setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_IF, &local, sizeof(local)) < 0
+		|| setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) < 0
+		|| setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0
+		|| ::connect(m_socket, reinterpret_cast<sockaddr*>(&destination), sizeof(destination)) < 0) {
+		emit logMessage(QString("[MCASTPUB] Cannot send to %1:%2 via %3: %4")
+			.arg(config.group).arg(config.port).arg(config.interfaceAddress)
+			.arg(QString::fromLocal8Bit(std::strerror(errno))));
+		if (m_socket >= 0) {
+			::close(m_socket);
+			m_socket = -1;
+		}
+		m_packets.clear();
+		return false;
+	}
+
+	m_config = config;
+	m_config.burst = qBound(1, config.burst, 1024);
+	MulticastPublisherStats empty;
+	std::memset(&empty, 0, sizeof(empty));
+	m_published.store(empty);
+	m_stopRequested.store(false, std::memory_order_relaxed);
+	m_running.store(true, std::memory_order_relaxed);
+
+	m_thread = QThread::create([this]() { run(); });
+	m_thread->setObjectName("MulticastPublisher");
+	m_thread->start();
+
+	emit logMessage(QString("[MCASTPUB] Sending %1 records of %2 as %3 datagrams to %4:%5 via %6 at %7, %8 loop(s)%9")
+		.arg(m_capturedRecords)
+		.arg(QFileInfo(capturePath).fileName())
+		.arg(m_packets.size())
+		.arg(config.group).arg(config.port).arg(config.interfaceAddress)
+		.arg(config.packetsPerSecond > 0 ? QString("%1 packets/s").arg(config.packetsPerSecond) : QString("max rate"))
+		.arg(config.loops > 0 ? QString::number(config.loops) : QString("unlimited"))
+		.arg(config.lossRatio > 0.0 ? QString(", %1% simulated loss").arg(config.lossRatio * 100.0, 0, 'f', 2) : QString()));
+	return true;
+#else
+	Q_UNUSED(capturePath);
+	Q_UNUSED(config);
+	emit logMessage("[MCASTPUB] The multicast publisher needs Linux (sendmmsg)");
+	return false;
+#endif
+}
+
+void MulticastPublisher::stop()
+{
+#ifdef Q_OS_LINUX
+	if (!m_thread) {
+		return;
+	}
+	m_stopRequested.store(true, std::memory_order_relaxed);
+	m_thread->wait();
+	delete m_thread;
+	m_thread = nullptr;
+	::close(m_socket);
+	m_socket = -1;
+	m_packets.clear();
+#endif
+}
+
+bool MulticastPublisher::loadCapture(const QString& path, int recordsPerPacket)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		emit logMessage(QString("[MCASTPUB] Cannot open %1: %2").arg(path, file.errorString()));
+		return false;
+	}
+	uchar* map = file.map(0, file.size());
+	if (!map) {
+		emit logMessage(QString("[MCASTPUB] Cannot map %1: %2").arg(path, file.errorString()));
+		return false;
+	}
+	TickFileReader reader(reinterpret_cast<const char*>(map), file.size());
+	if (!reader.isValid()) {
+		emit logMessage(QString("[MCASTPUB] %1 is not a tick file").arg(path));
+		file.unmap(map);
+		return false;
+	}
+
+	// Repacked up front, so the send loop only stamps headers
+	m_packets.clear();
+	m_capturedRecords = 0;
+	QByteArray packet;
+	BinaryFeedWriter writer(&packet);
+	writer.begin(0, 0);
+	auto flush = [&]() {
+		writer.finish();
+		m_packets.append(packet);
+		writer.begin(0, 0);
+	};
+
+	TickFileRecord record;
+	while (reader.next(record)) {
+		if (record.kind == TickFilePayload::Binary) {
+			BinaryFeedReader batch(record.payload, record.length);
+			BinaryFeedRecord entry;
+			while (batch.next(entry)) {
+				const QByteArray symbol = QByteArray::fromRawData(entry.symbol, entry.symbolLength);
+				const bool added = entry.type == BinaryFeedRecordType::Quote
+					? writer.addQuote(symbol, entry.price, entry.volume, entry.askPrice, entry.askVolume, entry.exchangeTime)
+					: writer.addTrade(symbol, entry.price, entry.volume, entry.exchangeTime);
+				if (added && ++m_capturedRecords % recordsPerPacket == 0) {
+					flush();
+				}
+			}
+			continue;
+		}
+
+		FinnhubTradeParser parser(record.payload, record.length);
+		FinnhubTrade trade;
+		while (parser.nextTrade(trade)) {
+			const QByteArray symbol = QByteArray::fromRawData(trade.symbol, trade.symbolLength);
+			if (writer.addTrade(symbol, trade.price, trade.volume, trade.timestamp) && ++m_capturedRecords % recordsPerPacket == 0) {
+				flush();
+			}
+		}
+	}
+	if (writer.recordCount() > 0) {
+		flush();
+	}
+	file.unmap(map);
+
+	if (m_packets.isEmpty()) {
+		emit logMessage(QString("[MCASTPUB] %1 has no trades or quotes").arg(path));
+		return false;
+	}
+	return true;
+}
+
+void MulticastPublisher::run()
+{
+#ifdef Q_OS_LINUX
+	const int burst = m_config.burst;
+	QVector<iovec> vectors(burst);
+	QVector<mmsghdr> messages(burst);
+	QVector<int> recordCounts(burst);
+	for (int i = 0; i < burst; ++i) {
+		std::memset(&messages[i], 0, sizeof(mmsghdr));
+		messages[i].msg_hdr.msg_iov = &vectors[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	MulticastPublisherStats stats;
+	std::memset(&stats, 0, sizeof(stats));
+	QRandomGenerator random(0x4D43u);
+	quint64 sequence = 1;
+	quint64 released = 0;  // Datagrams the pacing clock has let through, skipped ones included
+	int index = 0;
+	int loop = 0;
+	bool done = false;
+
+	QElapsedTimer clock;
+	clock.start();
+	while (!done && !m_stopRequested.load(std::memory_order_relaxed)) {
+		int due = burst;
+		if (m_config.packetsPerSecond > 0) {
+			const quint64 allowed = static_cast<quint64>(clock.nsecsElapsed() * (m_config.packetsPerSecond / 1e9));
+			if (allowed <= released) {
+				QThread::usleep(50);
+				continue;
+			}
+			due = static_cast<int>(qMin<quint64>(allowed - released, static_cast<quint64>(burst)));
+		}
+
+		const qint64 sendTime = QDateTime::currentMSecsSinceEpoch();
+		int count = 0;
+		for (int i = 0; i < due; ++i) {
+			if (index == m_packets.size()) {
+				index = 0;
+				if (m_config.loops > 0 && ++loop >= m_config.loops) {
+					done = true;
+					break;
+				}
+			}
+			QByteArray& packet = m_packets[index++];
+			released++;
+			char* header = packet.data();
+			qToLittleEndian<quint64>(sequence++, header + 8);
+			if (m_config.lossRatio > 0.0 && random.generateDouble() < m_config.lossRatio) {
+				stats.packetsSkipped++;
+				continue;
+			}
+			qToLittleEndian<qint64>(sendTime, header + 16);
+			vectors[count].iov_base = header;
+			vectors[count].iov_len = static_cast<size_t>(packet.size());
+			recordCounts[count] = qFromLittleEndian<quint16>(header + 6);
+			count++;
+		}
+		if (count == 0) {
+			continue;
+		}
+
+		const int sent = sendmmsg(m_socket, messages.data(), static_cast<unsigned>(count), 0);
+		stats.sendCalls++;
+		if (sent < count) {
+			// Still numbered, so the receiver sees them as lost
+			stats.sendErrors += static_cast<quint64>(count - qMax(sent, 0));
+		}
+		for (int i = 0; i < sent; ++i) {
+			stats.recordsSent += static_cast<quint64>(recordCounts[i]);
+		}
+		stats.packetsSent += static_cast<quint64>(qMax(sent, 0));
+		stats.elapsedNanos = clock.nsecsElapsed();
+		m_published.store(stats);
+	}
+
+	stats.elapsedNanos = clock.nsecsElapsed();
+	m_published.store(stats);
+	m_running.store(false, std::memory_order_relaxed);
+	emit finished(summary(stats));
+#endif
+}
+
+QString MulticastPublisher::summary(const MulticastPublisherStats& stats) const
+{
+	const double seconds = qMax<qint64>(stats.elapsedNanos, 1) / 1e9;
+	return QString("[MCASTPUB] %1 datagrams (%2 records) in %3 s: %4 k packets/s, %5 k records/s, %6 per sendmmsg, %7 skipped, %8 send errors")
+		.arg(stats.packetsSent)
+		.arg(stats.recordsSent)
+		.arg(seconds, 0, 'f', 2)
+		.arg(stats.packetsSent / seconds / 1e3, 0, 'f', 1)
+		.arg(stats.recordsSent / seconds / 1e3, 0, 'f', 1)
+		.arg(stats.sendCalls > 0 ? static_cast<double>(stats.packetsSent) / stats.sendCalls : 0.0, 0, 'f', 1)
+		.arg(stats.packetsSkipped)
+		.arg(stats.sendErrors);
+}
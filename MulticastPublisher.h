@@ -0,0 +1,71 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QThread>
+#include <atomic>
+#include "SeqLock.h"
+
+struct MulticastPublisherConfig {
+	QString group;
+	quint16 port;
+	QString interfaceAddress;  // Outgoing interface; 127.0.0.1 keeps the test on loopback
+	int ttl;                   // 0 = never leaves the host
+	int packetsPerSecond;      // 0 = as fast as the socket takes them
+	int recordsPerPacket;      // Capture records repacked into datagrams of this many
+	int burst;                 // Datagrams per sendmmsg
+	int loops;                 // Passes over the capture; 0 = until stopped
+	double lossRatio;          // Fraction of datagrams numbered but never sent, to exercise gap handling
+};
+
+struct MulticastPublisherStats {
+	quint64 packetsSent;
+	quint64 recordsSent;
+	quint64 sendCalls;
+	quint64 packetsSkipped;  // Deliberate loss
+	quint64 sendErrors;      // Datagrams the kernel refused
+	qint64 elapsedNanos;
+};
+
+// Loopback stand-in for an exchange multicast feed. Replays a tick file
+// capture (see TickFile.h) - JSON trade frames and binary batches alike -
+// as BinaryFeedProtocol datagrams with one packet sequence, paced to a
+// packet rate from a dedicated send thread using sendmmsg. Pairs with
+// MulticastFeedHandler to measure loss and throughput on one machine.
+class MulticastPublisher : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit MulticastPublisher(QObject* parent = nullptr);
+	~MulticastPublisher();
+
+	static MulticastPublisherConfig defaultConfig();
+
+	// Loads and repacks the capture, then starts sending; false after logging why not
+	bool start(const QString& capturePath, const MulticastPublisherConfig& config);
+	void stop();
+	bool isRunning() const { return m_running.load(std::memory_order_relaxed); }
+
+	MulticastPublisherStats stats() const { return m_published.load(); }  // Thread-safe
+
+signals:
+	void finished(const QString& summary);  // From the send thread, when the last loop is done or on stop()
+	void logMessage(const QString& message);
+
+private:
+	bool loadCapture(const QString& path, int recordsPerPacket);
+	void run();
+	QString summary(const MulticastPublisherStats& stats) const;
+
+private:
+	MulticastPublisherConfig m_config;
+	QVector<QByteArray> m_packets;  // Built with sequence 0; stamped as they are sent
+	quint64 m_capturedRecords;
+	int m_socket;
+	QThread* m_thread;
+	std::atomic<bool> m_stopRequested;
+	std::atomic<bool> m_running;
+	SeqLock<MulticastPublisherStats> m_published;
+};
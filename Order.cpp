@@ -10,8 +10,8 @@ Order::Order()
 	, m_price(0.0)
 	, m_filledQuantity(0.0)
 	, m_avgFillPrice(0.0)
-	, m_createdTime(QDateTime::currentDateTime())
-	, m_lastUpdateTime(QDateTime::currentDateTime())
+	, m_createdTime(MonotonicClock::now())
+	, m_lastUpdateTime(m_createdTime)
 {
 }
 
@@ -27,21 +27,21 @@ Order::Order(const QString& symbol, OrderSide side, OrderType type,
 	, m_price(price)
 	, m_filledQuantity(0.0)
 	, m_avgFillPrice(0.0)
-	, m_createdTime(QDateTime::currentDateTime())
-	, m_lastUpdateTime(QDateTime::currentDateTime())
+	, m_createdTime(MonotonicClock::now())
+	, m_lastUpdateTime(m_createdTime)
 {
 }
 
 void Order::setStatus(OrderStatus status)
 {
 	m_status = status;
-	m_lastUpdateTime = QDateTime::currentDateTime();
+	m_lastUpdateTime = MonotonicClock::now();
 }
 
 void Order::setStatusMessage(const QString& message)
 {
 	m_statusMessage = message;
-	m_lastUpdateTime = QDateTime::currentDateTime();
+	m_lastUpdateTime = MonotonicClock::now();
 }
 
 void Order::addFill(double quantity, double price)
@@ -53,7 +53,7 @@ void Order::addFill(double quantity, double price)
 	m_avgFillPrice = ((m_avgFillPrice * m_filledQuantity) + (price * quantity)) / totalFilled;
 
 	m_filledQuantity += quantity;
-	m_lastUpdateTime = QDateTime::currentDateTime();
+	m_lastUpdateTime = MonotonicClock::now();
 
 	// Update status based on fill
 	if (m_filledQuantity >= m_quantity) {
@@ -2,6 +2,7 @@
 #include <QString>
 #include <QDateTime>
 #include <QUuid>
+#include "MonotonicClock.h"
 
 enum class OrderSide {
 	Buy,
@@ -53,8 +54,11 @@ public:
 	double averageFillPrice() const { return m_avgFillPrice; }
 	double remainingQuantity() const { return m_quantity - m_filledQuantity; }
 
-	QDateTime createdTime() const { return m_createdTime; }
-	QDateTime lastUpdateTime() const { return m_lastUpdateTime; }
+	// Stored as MonotonicClock ns; QDateTime conversion is for display
+	QDateTime createdTime() const { return MonotonicClock::toDateTime(m_createdTime); }
+	QDateTime lastUpdateTime() const { return MonotonicClock::toDateTime(m_lastUpdateTime); }
+	qint64 createdNanos() const { return m_createdTime; }
+	qint64 lastUpdateNanos() const { return m_lastUpdateTime; }
 	QString statusMessage() const { return m_statusMessage; }
 
 	// Setters
@@ -88,7 +92,7 @@ private:
 	double m_filledQuantity;
 	double m_avgFillPrice;
 
-	QDateTime m_createdTime;
-	QDateTime m_lastUpdateTime;
+	qint64 m_createdTime;
+	qint64 m_lastUpdateTime;
 	QString m_statusMessage;
 };
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "OrderBook.h"
+#include <cmath>
+
+OrderBook::OrderBook(SymbolId symbolId, double tickSize)
+	: m_symbolId(symbolId)
+	, m_tickSize(tickSize > 0.0 ? tickSize : 0.01)
+	, m_sequence(0)
+{
+	m_bids.reserve(64);
+	m_asks.reserve(64);
+}
+
+qint64 OrderBook::toTicks(double price) const
+{
+	return static_cast<qint64>(std::llround(price / m_tickSize));
+}
+
+int OrderBook::findInsertIndex(BookSide side, qint64 priceTicks) const
+{
+	const QVector<BookLevel>& book = levels(side);
+	const BookLevel* data = book.constData();
+	int high = static_cast<int>(book.size());
+
+	// Most updates touch the first few levels - scan those linearly
+	const int linearLevels = 8;
+	const int stop = qMax(0, high - linearLevels);
+	while (high > stop && isBetter(side, data[high - 1].priceTicks, priceTicks)) {
+		high--;
+	}
+	if (high > stop || high == 0) {
+		return high;
+	}
+
+	// Deeper in the book: binary search [0, high)
+	int low = 0;
+	while (low < high) {
+		const int mid = (low + high) / 2;
+		if (isBetter(side, data[mid].priceTicks, priceTicks)) {
+			high = mid;
+		}
+		else {
+			low = mid + 1;
+		}
+	}
+	return low;
+}
+
+void OrderBook::addLevel(BookSide side, double price, double size, quint32 orderCount)
+{
+	applyLevel(side, price, size, orderCount);
+}
+
+bool OrderBook::modifyLevel(BookSide side, double price, double size, quint32 orderCount)
+{
+	const qint64 ticks = toTicks(price);
+	QVector<BookLevel>& book = levels(side);
+	const int index = findInsertIndex(side, ticks) - 1;
+	if (index < 0 || book[index].priceTicks != ticks) {
+		return false;
+	}
+
+	BookLevel& level = book[index];
+	level.size = size;
+	level.orderCount = orderCount;
+	m_sequence++;
+	return true;
+}
+
+bool OrderBook::deleteLevel(BookSide side, double price)
+{
+	const qint64 ticks = toTicks(price);
+	QVector<BookLevel>& book = levels(side);
+	const int index = findInsertIndex(side, ticks) - 1;
+	if (index < 0 || book[index].priceTicks != ticks) {
+		return false;
+	}
+
+	book.remove(index);
+	m_sequence++;
+	return true;
+}
+
+void OrderBook::applyLevel(BookSide side, double price, double size, quint32 orderCount)
+{
+	if (size <= 0.0) {
+		deleteLevel(side, price);
+		return;
+	}
+
+	const qint64 ticks = toTicks(price);
+	QVector<BookLevel>& book = levels(side);
+	const int index = findInsertIndex(side, ticks);
+
+	// Levels at or below `index` are not better; the one just below may be equal
+	if (index > 0 && book[index - 1].priceTicks == ticks) {
+		BookLevel& level = book[index - 1];
+		level.size = size;
+		level.orderCount = orderCount;
+	}
+	else {
+		BookLevel level;
+		level.priceTicks = ticks;
+		level.size = size;
+		level.orderCount = orderCount;
+		book.insert(index, level);
+	}
+	m_sequence++;
+}
+
+void OrderBook::clear()
+{
+	m_bids.clear();
+	m_asks.clear();
+	m_sequence++;
+}
+
+void OrderBook::applyQuote(double bidPrice, double bidSize, double askPrice, double askSize)
+{
+	const qint64 bidTicks = toTicks(bidPrice);
+	const qint64 askTicks = toTicks(askPrice);
+
+	// Anything better than the quoted best is gone; the arrays end at the best
+	// level, so this only ever trims from the back.
+	while (!m_bids.isEmpty() && (m_bids.constLast().priceTicks > bidTicks || m_bids.constLast().priceTicks >= askTicks)) {
+		m_bids.removeLast();
+	}
+	while (!m_asks.isEmpty() && (m_asks.constLast().priceTicks < askTicks || m_asks.constLast().priceTicks <= bidTicks)) {
+		m_asks.removeLast();
+	}
+
+	applyLevel(BookSide::Bid, bidPrice, bidSize);
+	applyLevel(BookSide::Ask, askPrice, askSize);
+}
+
+BookSideView OrderBook::top(BookSide side, int maxLevels) const
+{
+	const QVector<BookLevel>& book = levels(side);
+	BookSideView view;
+	view.count = qMin(maxLevels, static_cast<int>(book.size()));
+	view.best = book.isEmpty() ? nullptr : book.constData() + book.size() - 1;
+	return view;
+}
+
+int OrderBook::copyTop(BookSide side, BookLevel* out, int maxLevels) const
+{
+	BookSideView view = top(side, maxLevels);
+	for (int i = 0; i < view.count; ++i) {
+		out[i] = view[i];
+	}
+	return view.count;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <QtGlobal>
+#include <QVector>
+#include "SymbolTable.h"
+
+enum class BookSide {
+	Bid,
+	Ask
+};
+
+struct BookLevel {
+	qint64 priceTicks;   // Price in units of the book's tick size
+	double size;
+	quint32 orderCount;
+};
+
+// Read-only view of the best `count` levels of one side, best first. Points
+// into the book and is only valid until the book is next updated.
+struct BookSideView {
+	const BookLevel* best;
+	int count;
+
+	const BookLevel& operator[](int i) const { return *(best - i); }
+};
+
+// Price-level (Level 2) book for one symbol. Each side is one contiguous
+// array sorted so the best level is at the back: the top of the book, where
+// nearly all updates land, is O(1) to reach and cheap to insert into or
+// erase from.
+class OrderBook {
+public:
+	explicit OrderBook(SymbolId symbolId = InvalidSymbolId, double tickSize = 0.01);
+
+	SymbolId symbolId() const { return m_symbolId; }
+	double tickSize() const { return m_tickSize; }
+	quint64 sequence() const { return m_sequence; }  // Bumped by every change
+
+	// Incremental updates
+	void addLevel(BookSide side, double price, double size, quint32 orderCount = 1);
+	bool modifyLevel(BookSide side, double price, double size, quint32 orderCount = 1);
+	bool deleteLevel(BookSide side, double price);
+	void applyLevel(BookSide side, double price, double size, quint32 orderCount = 1);  // size 0 deletes
+	void clear();
+
+	// Top-of-book quote: sets both best levels and drops any level better
+	// than the new best, so a book can be maintained from a quote stream
+	void applyQuote(double bidPrice, double bidSize, double askPrice, double askSize);
+
+	// O(1) best prices; nullptr when the side is empty
+	const BookLevel* bestBid() const { return m_bids.isEmpty() ? nullptr : &m_bids.constLast(); }
+	const BookLevel* bestAsk() const { return m_asks.isEmpty() ? nullptr : &m_asks.constLast(); }
+	int depth(BookSide side) const { return static_cast<int>(levels(side).size()); }
+
+	// Top-N without copying the book
+	BookSideView top(BookSide side, int maxLevels) const;
+	int copyTop(BookSide side, BookLevel* out, int maxLevels) const;
+
+	qint64 toTicks(double price) const;
+	double toPrice(qint64 ticks) const { return ticks * m_tickSize; }
+
+private:
+	const QVector<BookLevel>& levels(BookSide side) const { return side == BookSide::Bid ? m_bids : m_asks; }
+	QVector<BookLevel>& levels(BookSide side) { return side == BookSide::Bid ? m_bids : m_asks; }
+
+	// Index of the first level not better than priceTicks, searching from the top
+	int findInsertIndex(BookSide side, qint64 priceTicks) const;
+
+	static bool isBetter(BookSide side, qint64 a, qint64 b)
+	{
+		return side == BookSide::Bid ? a > b : a < b;
+	}
+
+private:
+	SymbolId m_symbolId;
+	double m_tickSize;
+	quint64 m_sequence;
+	QVector<BookLevel> m_bids;  // Ascending price, best bid at the back
+	QVector<BookLevel> m_asks;  // Descending price, best ask at the back
+};
@@ -1,4 +1,5 @@
 #include "OrderManager.h"
+#include "BinaryLogger.h"
 #include <QTimer>
 #include <QDebug>
 
@@ -35,12 +36,13 @@ QString OrderManager::submitOrder(const QString& symbol, OrderSide side,
 	// Store order
 	m_orders[orderId] = order;
 
-	emit logMessage(QString("[ORDER] Submitted %1 %2 %3 @ %4 - ID: %5")
-		.arg(Order::sideToString(side))
-		.arg(quantity)
-		.arg(symbol)
-		.arg(price)
-		.arg(orderId.left(8)));
+	SymbolId symbolId = SymbolTable::instance().intern(symbol);
+	ensureSymbolCapacity(m_ordersBySymbol, symbolId);
+	m_ordersBySymbol[symbolId].append(order);
+
+	BinaryLogger::log(LogEventId::OrderSubmitted,
+		{ logInt(static_cast<int>(side)), logReal(quantity), logSymbol(symbolId),
+		  logReal(price), logTag(orderId) });
 
 	emit orderSubmitted(orderId);
 
@@ -97,8 +99,7 @@ bool OrderManager::modifyOrder(const QString& orderId, double newQuantity, doubl
 		order->setPrice(newPrice);
 	}
 
-	emit logMessage(QString("[ORDER] Modified %1 - New price: %2")
-		.arg(orderId.left(8)).arg(newPrice));
+	BinaryLogger::log(LogEventId::OrderModified, { logTag(orderId), logReal(newPrice) });
 	emit orderModified(orderId);
 
 	return true;
@@ -134,13 +135,15 @@ QList<Order*> OrderManager::getActiveOrders() const
 
 QList<Order*> OrderManager::getOrdersBySymbol(const QString& symbol) const
 {
-	QList<Order*> orders;
-	for (auto it = m_orders.begin(); it != m_orders.end(); ++it) {
-		if (it.value()->symbol() == symbol) {
-			orders.append(it.value());
-		}
+	return getOrdersBySymbol(SymbolTable::instance().find(symbol));
+}
+
+QList<Order*> OrderManager::getOrdersBySymbol(SymbolId id) const
+{
+	if (id == InvalidSymbolId || id >= static_cast<SymbolId>(m_ordersBySymbol.size())) {
+		return QList<Order*>();
 	}
-	return orders;
+	return m_ordersBySymbol[id];
 }
 
 QList<Order*> OrderManager::getOrdersByStatus(OrderStatus status) const
@@ -197,14 +200,14 @@ void OrderManager::simulateOrderFill(const QString& orderId, double quantity, do
 	order->addFill(quantity, price);
 
 	if (order->isFilled()) {
-		emit logMessage(QString("[FILL] Order %1 fully filled: %2 @ %3")
-			.arg(orderId.left(8)).arg(quantity).arg(price));
+		BinaryLogger::log(LogEventId::OrderFilled,
+			{ logTag(orderId), logReal(quantity), logReal(price) });
 		emit orderFilled(orderId, quantity, price);
 	}
 	else {
-		emit logMessage(QString("[FILL] Order %1 partially filled: %2 @ %3 (%4/%5)")
-			.arg(orderId.left(8)).arg(quantity).arg(price)
-			.arg(order->filledQuantity()).arg(order->quantity()));
+		BinaryLogger::log(LogEventId::OrderPartiallyFilled,
+			{ logTag(orderId), logReal(quantity), logReal(price),
+			  logReal(order->filledQuantity()), logReal(order->quantity()) });
 		emit orderPartiallyFilled(orderId, quantity, price);
 	}
 
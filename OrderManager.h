@@ -2,7 +2,9 @@
 #include <QObject>
 #include <QMap>
 #include <QList>
+#include <QVector>
 #include "Order.h"
+#include "SymbolTable.h"
 
 class OrderManager : public QObject
 {
@@ -23,6 +25,7 @@ public:
 	QList<Order*> getAllOrders() const;
 	QList<Order*> getActiveOrders() const;
 	QList<Order*> getOrdersBySymbol(const QString& symbol) const;
+	QList<Order*> getOrdersBySymbol(SymbolId id) const;
 	QList<Order*> getOrdersByStatus(OrderStatus status) const;
 
 	// Statistics
@@ -59,5 +62,6 @@ private:
 
 private:
 	QMap<QString, Order*> m_orders;
+	QVector<QList<Order*>> m_ordersBySymbol;  // Indexed by SymbolId
 	int m_orderSequence;
 };
\ No newline at end of file
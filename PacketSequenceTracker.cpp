@@ -0,0 +1,83 @@
+#include "PacketSequenceTracker.h"
+#include <cstring>
+
+PacketSequenceTracker::PacketSequenceTracker()
+	: m_expected(0)
+{
+	std::memset(m_window, 0, sizeof(m_window));
+	std::memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void PacketSequenceTracker::reset()
+{
+	m_expected = 0;
+	std::memset(m_window, 0, sizeof(m_window));
+}
+
+PacketSequenceTracker::Result PacketSequenceTracker::onPacket(quint64 sequence)
+{
+	if (m_expected == 0) {
+		std::memset(m_window, 0, sizeof(m_window));
+		testAndSet(sequence);
+		m_expected = sequence + 1;
+		m_stats.packets++;
+		return Result::First;
+	}
+
+	if (sequence == m_expected) {
+		testAndSet(sequence);
+		m_expected++;
+		m_stats.packets++;
+		return Result::InOrder;
+	}
+
+	if (sequence > m_expected) {
+		const quint64 skipped = sequence - m_expected;
+		// Slots of the skipped numbers still hold bits from a window ago
+		clearRange(m_expected, skipped >= WindowSize ? m_expected + WindowSize : sequence);
+		testAndSet(sequence);
+		m_expected = sequence + 1;
+		m_stats.packets++;
+		m_stats.gaps++;
+		m_stats.missing += skipped;
+		return Result::Gap;
+	}
+
+	if (m_expected - sequence > WindowSize) {
+		std::memset(m_window, 0, sizeof(m_window));
+		testAndSet(sequence);
+		m_expected = sequence + 1;
+		m_stats.packets++;
+		m_stats.resets++;
+		return Result::Reset;
+	}
+
+	if (testAndSet(sequence)) {
+		m_stats.duplicates++;
+		return Result::Duplicate;
+	}
+	m_stats.packets++;
+	m_stats.late++;
+	if (m_stats.missing > 0) {
+		m_stats.missing--;
+	}
+	return Result::Late;
+}
+
+bool PacketSequenceTracker::testAndSet(quint64 sequence)
+{
+	const quint64 slot = sequence % WindowSize;
+	const quint64 bit = quint64(1) << (slot % 64);
+	quint64& word = m_window[slot / 64];
+	const bool seen = (word & bit) != 0;
+	word |= bit;
+	return seen;
+}
+
+void PacketSequenceTracker::clearRange(quint64 from, quint64 to)
+{
+	for (quint64 sequence = from; sequence < to; ++sequence) {
+		const quint64 slot = sequence % WindowSize;
+		m_window[slot / 64] &= ~(quint64(1) << (slot % 64));
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <QtGlobal>
+
+struct PacketSequenceStats {
+	quint64 packets;      // Accepted, including late arrivals
+	quint64 gaps;         // Jumps ahead in the sequence
+	quint64 missing;      // Sequence numbers skipped and not (yet) filled in
+	quint64 late;         // Arrived after a higher sequence, filling a gap
+	quint64 duplicates;   // Already seen; dropped
+	quint64 resets;       // Publisher restarts or jumps too far back to be reordering
+};
+
+// Per-packet sequence tracking for a datagram feed. UDP may lose, reorder
+// and duplicate packets, so a bitmap of the last WindowSize sequence
+// numbers tells a late packet (fills a gap, still delivered) from a
+// duplicate (dropped). Anything further back than the window is treated as
+// the publisher restarting its sequence.
+class PacketSequenceTracker {
+public:
+	enum class Result {
+		First,      // First packet since reset()
+		InOrder,
+		Gap,        // Ahead of the expected sequence; the skipped ones count as missing
+		Late,       // Behind, but inside the window and not seen before
+		Duplicate,  // Drop it
+		Reset       // Too far back; tracking restarts from this packet
+	};
+
+	static const int WindowSize = 1024;
+
+	PacketSequenceTracker();
+
+	Result onPacket(quint64 sequence);
+	void reset();
+
+	bool accepts(Result result) const { return result != Result::Duplicate; }
+	quint64 expected() const { return m_expected; }  // 0 until the first packet
+	PacketSequenceStats stats() const { return m_stats; }
+
+private:
+	bool testAndSet(quint64 sequence);
+	void clearRange(quint64 from, quint64 to);  // [from, to)
+
+private:
+	quint64 m_expected;
+	quint64 m_window[WindowSize / 64];  // Bit (seq % WindowSize) set once seq arrived
+	PacketSequenceStats m_stats;
+};
@@ -0,0 +1,291 @@
+#include "ReplayFeed.h"
+#include "FinnhubTradeParser.h"
+#include "BinaryFeedProtocol.h"
+#include <QThread>
+#include <QSet>
+
+ReplayFeed::ReplayFeed(SpscRing<FeedTick>* ring, FeedSourceId sourceId, QObject* parent)
+	: QObject(parent)
+	, m_ring(ring)
+	, m_sourceId(sourceId)
+	, m_timer(new QTimer(this))
+	, m_map(nullptr)
+	, m_hasNext(false)
+	, m_firstReceiveTime(0)
+	, m_speed(1.0)
+	, m_running(false)
+	, m_stopRequested(false)
+	, m_wakePending(false)
+	, m_ticksReplayed(0)
+	, m_lagMs(0)
+	, m_maxLagMs(0)
+	, m_elapsedMs(0)
+	, m_progressPermille(0)
+{
+	m_timer->setSingleShot(true);
+	m_timer->setTimerType(Qt::PreciseTimer);
+	connect(m_timer, &QTimer::timeout, this, &ReplayFeed::replayChunk);
+}
+
+ReplayFeed::~ReplayFeed()
+{
+	if (m_map) {
+		m_file.unmap(m_map);
+	}
+}
+
+ReplayStats ReplayFeed::stats() const
+{
+	ReplayStats stats;
+	stats.running = m_running.load(std::memory_order_relaxed);
+	stats.speed = m_speed.load(std::memory_order_relaxed);
+	stats.progress = m_progressPermille.load(std::memory_order_relaxed) / 1000.0;
+	stats.ticksReplayed = m_ticksReplayed.load(std::memory_order_relaxed);
+	const qint64 elapsedMs = m_elapsedMs.load(std::memory_order_relaxed);
+	stats.ticksPerSecond = elapsedMs > 0 ? stats.ticksReplayed * 1000.0 / elapsedMs : 0.0;
+	stats.lagMs = m_lagMs.load(std::memory_order_relaxed);
+	stats.maxLagMs = m_maxLagMs.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void ReplayFeed::start(const QString& path, double speed)
+{
+	close();
+
+	m_file.setFileName(path);
+	if (!m_file.open(QIODevice::ReadOnly)) {
+		emit logMessage(QString("[REPLAY] Cannot open %1: %2").arg(path, m_file.errorString()));
+		emit finished("Replay failed to start");
+		return;
+	}
+
+	m_map = m_file.map(0, m_file.size());
+	if (!m_map) {
+		emit logMessage(QString("[REPLAY] Cannot map %1: %2").arg(path, m_file.errorString()));
+		m_file.close();
+		emit finished("Replay failed to start");
+		return;
+	}
+
+	m_reader = TickFileReader(reinterpret_cast<const char*>(m_map), m_file.size());
+	if (!m_reader.isValid()) {
+		emit logMessage(QString("[REPLAY] %1 is not a tick file").arg(path));
+		close();
+		emit finished("Replay failed to start");
+		return;
+	}
+
+	// One pass up front to intern every symbol, so the hot loop never locks
+	QStringList symbols = collectSymbols();
+	m_reader.rewind();
+	m_hasNext = m_reader.next(m_next);
+	m_firstReceiveTime = m_hasNext ? m_next.receiveTime : 0;
+
+	m_speed.store(qMax(0.0, speed), std::memory_order_relaxed);
+	m_stopRequested.store(false, std::memory_order_relaxed);
+	m_ticksReplayed.store(0, std::memory_order_relaxed);
+	m_lagMs.store(0, std::memory_order_relaxed);
+	m_maxLagMs.store(0, std::memory_order_relaxed);
+	m_elapsedMs.store(0, std::memory_order_relaxed);
+	m_progressPermille.store(0, std::memory_order_relaxed);
+	m_running.store(true, std::memory_order_relaxed);
+
+	emit logMessage(QString("[REPLAY] Replaying %1 (%2 MB, %3 symbols) at %4")
+		.arg(path)
+		.arg(m_file.size() / (1024.0 * 1024.0), 0, 'f', 1)
+		.arg(symbols.size())
+		.arg(speed > 0 ? QString("%1x").arg(speed) : QString("max speed")));
+	emit started(symbols);
+
+	m_clock.start();
+	m_timer->start(0);
+}
+
+void ReplayFeed::cancel()
+{
+	if (m_running.load(std::memory_order_relaxed)) {
+		finish("Replay stopped");
+	}
+}
+
+void ReplayFeed::close()
+{
+	m_timer->stop();
+	if (m_map) {
+		m_file.unmap(m_map);
+		m_map = nullptr;
+	}
+	if (m_file.isOpen()) {
+		m_file.close();
+	}
+	m_reader = TickFileReader();
+	m_hasNext = false;
+	m_symbolIds.clear();
+	m_running.store(false, std::memory_order_relaxed);
+}
+
+void ReplayFeed::replayChunk()
+{
+	// Bound each pass so the feed thread keeps servicing its event loop
+	const int maxRecordsPerChunk = 1024;
+	const double speed = m_speed.load(std::memory_order_relaxed);
+	int records = 0;
+
+	while (m_hasNext && records < maxRecordsPerChunk) {
+		if (m_stopRequested.load(std::memory_order_relaxed)) {
+			finish("Replay stopped");
+			return;
+		}
+
+		const qint64 elapsedNs = m_clock.nsecsElapsed();
+		if (speed > 0) {
+			const qint64 dueNs = static_cast<qint64>((m_next.receiveTime - m_firstReceiveTime) / speed);
+			if (dueNs > elapsedNs) {
+				// Not due yet - sleep until it is
+				m_lagMs.store(0, std::memory_order_relaxed);
+				wakeConsumer();
+				m_timer->start(static_cast<int>((dueNs - elapsedNs) / 1000000));
+				return;
+			}
+
+			const qint64 lagMs = (elapsedNs - dueNs) / 1000000;
+			m_lagMs.store(lagMs, std::memory_order_relaxed);
+			if (lagMs > m_maxLagMs.load(std::memory_order_relaxed)) {
+				m_maxLagMs.store(lagMs, std::memory_order_relaxed);
+			}
+		}
+
+		replayRecord(m_next);
+		records++;
+		m_hasNext = m_reader.next(m_next);
+		m_elapsedMs.store(elapsedNs / 1000000, std::memory_order_relaxed);
+	}
+
+	m_progressPermille.store(static_cast<int>(m_reader.progress() * 1000), std::memory_order_relaxed);
+	wakeConsumer();
+
+	if (!m_hasNext) {
+		finish("Replay complete");
+		return;
+	}
+	m_timer->start(0);
+}
+
+QStringList ReplayFeed::collectSymbols()
+{
+	QSet<QByteArray> seen;
+	TickFileRecord record;
+	while (m_reader.next(record)) {
+		if (record.kind == TickFilePayload::Binary) {
+			BinaryFeedReader batch(record.payload, record.length);
+			BinaryFeedRecord entry;
+			while (batch.next(entry)) {
+				seen.insert(QByteArray::fromRawData(entry.symbol, entry.symbolLength));
+			}
+		}
+		else {
+			FinnhubTradeParser parser(record.payload, record.length);
+			FinnhubTrade trade;
+			while (parser.nextTrade(trade)) {
+				seen.insert(QByteArray::fromRawData(trade.symbol, trade.symbolLength));
+			}
+		}
+	}
+
+	QStringList symbols;
+	for (const QByteArray& symbol : seen) {
+		// Deep copy - the raw bytes belong to the mapping
+		QByteArray key(symbol.constData(), symbol.size());
+		QString name = QString::fromUtf8(key);
+		m_symbolIds.insert(key, SymbolTable::instance().intern(name));
+		symbols.append(name);
+	}
+	symbols.sort();
+	return symbols;
+}
+
+void ReplayFeed::replayRecord(const TickFileRecord& record)
+{
+	// Ticks are stamped when replayed, not with the recorded receive time,
+	// so feed latency measures this process rather than the capture
+	FeedTick tick;
+	tick.receiveTime = MonotonicClock::now();
+	tick.parsedTime = tick.receiveTime;
+	tick.sourceId = m_sourceId;
+
+	if (record.kind == TickFilePayload::Binary) {
+		BinaryFeedReader batch(record.payload, record.length);
+		BinaryFeedRecord entry;
+		while (batch.next(entry)) {
+			tick.symbolId = lookupSymbol(entry.symbol, entry.symbolLength);
+			tick.type = entry.type == BinaryFeedRecordType::Quote ? FeedTickType::Quote : FeedTickType::Trade;
+			tick.price = entry.price;
+			tick.volume = entry.volume;
+			tick.askPrice = entry.askPrice;
+			tick.askVolume = entry.askVolume;
+			tick.exchangeTime = entry.exchangeTime;
+			pushTick(tick);
+		}
+		return;
+	}
+
+	FinnhubTradeParser parser(record.payload, record.length);
+	FinnhubTrade trade;
+	while (parser.nextTrade(trade)) {
+		tick.symbolId = lookupSymbol(trade.symbol, trade.symbolLength);
+		tick.type = FeedTickType::Trade;
+		tick.price = trade.price;
+		tick.volume = trade.volume;
+		tick.askPrice = 0.0;
+		tick.askVolume = 0.0;
+		tick.exchangeTime = trade.timestamp;
+		pushTick(tick);
+	}
+}
+
+void ReplayFeed::pushTick(const FeedTick& tick)
+{
+	if (tick.symbolId == InvalidSymbolId) {
+		return;
+	}
+
+	// Replays must be reproducible, so a full ring applies backpressure
+	// instead of dropping like the live feed does.
+	while (!m_ring->tryPush(tick)) {
+		if (m_stopRequested.load(std::memory_order_relaxed)) {
+			return;
+		}
+		wakeConsumer();
+		QThread::yieldCurrentThread();
+	}
+	m_ticksReplayed.fetch_add(1, std::memory_order_relaxed);
+}
+
+SymbolId ReplayFeed::lookupSymbol(const char* symbol, int length) const
+{
+	auto it = m_symbolIds.constFind(QByteArray::fromRawData(symbol, length));
+	return it == m_symbolIds.constEnd() ? InvalidSymbolId : it.value();
+}
+
+void ReplayFeed::wakeConsumer()
+{
+	if (m_ring->isEmpty()) {
+		return;
+	}
+	if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+		emit ticksAvailable();
+	}
+}
+
+void ReplayFeed::finish(const QString& reason)
+{
+	ReplayStats summary = stats();
+	close();
+
+	emit logMessage(QString("[REPLAY] %1: %2 ticks, %3 ticks/sec, max lag %4 ms")
+		.arg(reason)
+		.arg(summary.ticksReplayed)
+		.arg(summary.ticksPerSecond, 0, 'f', 0)
+		.arg(summary.maxLagMs));
+	emit finished(reason);
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <QObject>
+#include <QFile>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <atomic>
+#include "FeedHandler.h"
+#include "TickFile.h"
+
+struct ReplayStats {
+	bool running;
+	double speed;            // 0 = as fast as possible
+	double progress;         // 0..1 through the file
+	quint64 ticksReplayed;
+	double ticksPerSecond;   // Average since start
+	qint64 lagMs;            // How far behind the recorded timestamps we are
+	qint64 maxLagMs;
+};
+
+// Replays a recorded tick file (see TickFile.h) into the same tick ring the
+// live FeedHandler fills, so downstream conflation, UI and OMS cannot tell
+// the difference. Lives on the feed thread; the file is memory-mapped and
+// frames are decoded in place.
+class ReplayFeed : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit ReplayFeed(SpscRing<FeedTick>* ring, FeedSourceId sourceId = ReplayFeedSource, QObject* parent = nullptr);
+	~ReplayFeed();
+
+	// Thread-safe
+	ReplayStats stats() const;
+	void requestStop() { m_stopRequested.store(true, std::memory_order_relaxed); }
+	void acknowledgeTicks() { m_wakePending.store(false, std::memory_order_release); }
+
+public slots:
+	// speed: 1.0 = recorded pace, N = N times faster, 0 = as fast as possible
+	void start(const QString& path, double speed);
+	void cancel();
+
+signals:
+	void started(const QStringList& symbols);
+	void finished(const QString& summary);
+	void ticksAvailable();
+	void logMessage(const QString& message);
+
+private slots:
+	void replayChunk();
+
+private:
+	QStringList collectSymbols();
+	void replayRecord(const TickFileRecord& record);
+	void pushTick(const FeedTick& tick);
+	SymbolId lookupSymbol(const char* symbol, int length) const;
+	void wakeConsumer();
+	void finish(const QString& reason);
+	void close();
+
+private:
+	SpscRing<FeedTick>* m_ring;
+	FeedSourceId m_sourceId;
+	QTimer* m_timer;
+	QFile m_file;
+	uchar* m_map;
+	TickFileReader m_reader;
+	TickFileRecord m_next;
+	bool m_hasNext;
+
+	QHash<QByteArray, SymbolId> m_symbolIds;
+	QElapsedTimer m_clock;
+	qint64 m_firstReceiveTime;
+	std::atomic<double> m_speed;
+
+	std::atomic<bool> m_running;
+	std::atomic<bool> m_stopRequested;
+	std::atomic<bool> m_wakePending;
+	std::atomic<quint64> m_ticksReplayed;
+	std::atomic<qint64> m_lagMs;
+	std::atomic<qint64> m_maxLagMs;
+	std::atomic<qint64> m_elapsedMs;
+	std::atomic<int> m_progressPermille;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <QtGlobal>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+// Single-writer sequence lock around a trivially copyable value. The writer
+// never waits; readers copy the value and retry if a write overlapped the
+// copy, so any thread gets a consistent snapshot without locks or
+// allocation. The payload is held as relaxed atomic words, which keeps the
+// racing reads well defined and compiles to plain loads and stores on x86.
+template<typename T>
+class SeqLock {
+	static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+public:
+	SeqLock()
+		: m_sequence(0)
+	{
+		for (int i = 0; i < Words; ++i) {
+			m_words[i].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	SeqLock(const SeqLock&) = delete;
+	SeqLock& operator=(const SeqLock&) = delete;
+
+	// Writer side - one thread only
+	void store(const T& value)
+	{
+		quint64 words[Words] = {};
+		std::memcpy(words, &value, sizeof(T));
+
+		const quint32 sequence = m_sequence.load(std::memory_order_relaxed);
+		m_sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (int i = 0; i < Words; ++i) {
+			m_words[i].store(words[i], std::memory_order_relaxed);
+		}
+		m_sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	// Any thread. False if a write was in progress or overlapped the copy.
+	bool tryLoad(T& out) const
+	{
+		const quint32 before = m_sequence.load(std::memory_order_acquire);
+		if (before & 1) {
+			return false;
+		}
+
+		quint64 words[Words];
+		for (int i = 0; i < Words; ++i) {
+			words[i] = m_words[i].load(std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (m_sequence.load(std::memory_order_relaxed) != before) {
+			return false;
+		}
+
+		std::memcpy(&out, words, sizeof(T));
+		return true;
+	}
+
+	// Any thread; retries until a copy is consistent. Returns the retries.
+	int load(T& out) const
+	{
+		int retries = 0;
+		while (!tryLoad(out)) {
+			// A writer descheduled mid-store would otherwise be spun against
+			if (++retries % 64 == 0) {
+				std::this_thread::yield();
+			}
+		}
+		return retries;
+	}
+
+	T load() const
+	{
+		T out;
+		load(out);
+		return out;
+	}
+
+	// Even, and advances by two per store; lets readers skip unchanged values
+	quint32 version() const { return m_sequence.load(std::memory_order_acquire) & ~1u; }
+
+private:
+	static const int Words = static_cast<int>((sizeof(T) + sizeof(quint64) - 1) / sizeof(quint64));
+
+	alignas(64) std::atomic<quint32> m_sequence;
+	std::atomic<quint64> m_words[Words];
+};
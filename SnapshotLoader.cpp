@@ -0,0 +1,197 @@
+#include "SnapshotLoader.h"
+#include <QNetworkRequest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QUrl>
+
+SnapshotLoader::SnapshotLoader(QNetworkAccessManager* networkManager, QObject* parent)
+	: QObject(parent)
+	, m_networkManager(networkManager)
+	, m_inFlight(0)
+	, m_maxInFlight(4)
+	, m_maxRetries(3)
+	, m_retryBackoff(500)
+	, m_completed(0)
+	, m_total(0)
+{
+}
+
+void SnapshotLoader::setMaxInFlight(int requests)
+{
+	m_maxInFlight = qMax(1, requests);
+	pump();
+}
+
+void SnapshotLoader::setMaxRetries(int retries)
+{
+	m_maxRetries = qMax(0, retries);
+}
+
+void SnapshotLoader::setRetryBackoff(int milliseconds)
+{
+	m_retryBackoff = qMax(1, milliseconds);
+}
+
+void SnapshotLoader::request(const QString& symbol)
+{
+	auto it = m_pending.find(symbol);
+	if (it != m_pending.end()) {
+		// Already queued or loading - one response serves every caller
+		it->cancelled = false;
+		return;
+	}
+
+	PendingSnapshot pending;
+	pending.attempts = 0;
+	pending.cancelled = false;
+	pending.waitingRetry = false;
+	m_pending.insert(symbol, pending);
+	m_queue.enqueue(symbol);
+
+	m_total++;
+	emit progress(m_completed, m_total);
+	pump();
+}
+
+void SnapshotLoader::cancel(const QString& symbol)
+{
+	auto it = m_pending.find(symbol);
+	if (it == m_pending.end()) {
+		return;
+	}
+
+	if (m_queue.removeOne(symbol)) {
+		m_pending.erase(it);
+		finishRequest();
+		return;
+	}
+
+	// In flight or waiting to retry - finish it without reporting a result
+	it->cancelled = true;
+}
+
+void SnapshotLoader::pump()
+{
+	while (m_inFlight < m_maxInFlight && !m_queue.isEmpty()) {
+		start(m_queue.dequeue());
+	}
+}
+
+void SnapshotLoader::start(const QString& symbol)
+{
+	PendingSnapshot& pending = m_pending[symbol];
+	pending.attempts++;
+	pending.waitingRetry = false;
+
+	QUrl url(QString("%1/quote").arg(m_baseUrl));
+	url.setQuery(QString("symbol=%1&token=%2").arg(symbol, m_apiKey));
+
+	QNetworkReply* reply = m_networkManager->get(QNetworkRequest(url));
+	reply->setProperty("symbol", symbol);
+	connect(reply, &QNetworkReply::finished, this, &SnapshotLoader::onReplyFinished);
+	m_inFlight++;
+}
+
+void SnapshotLoader::onReplyFinished()
+{
+	QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
+	if (!reply) return;
+
+	reply->deleteLater();
+	m_inFlight--;
+
+	QString symbol = reply->property("symbol").toString();
+	auto it = m_pending.find(symbol);
+	if (it == m_pending.end()) {
+		pump();
+		return;
+	}
+
+	if (it->cancelled) {
+		m_pending.erase(it);
+		finishRequest();
+		pump();
+		return;
+	}
+
+	const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+	if (reply->error() != QNetworkReply::NoError || httpStatus == 429) {
+		const bool retryable = httpStatus == 429 || httpStatus >= 500 || httpStatus == 0;
+		if (retryable && it->attempts <= m_maxRetries) {
+			// Exponential backoff with jitter; honour Retry-After when the server sends one
+			int delay = m_retryBackoff << (it->attempts - 1);
+			delay += QRandomGenerator::global()->bounded(m_retryBackoff / 2 + 1);
+			bool ok = false;
+			int retryAfter = reply->rawHeader("Retry-After").toInt(&ok);
+			if (ok && retryAfter > 0) {
+				delay = qMax(delay, retryAfter * 1000);
+			}
+
+			emit logMessage(QString("[SNAPSHOT] %1 failed (%2) - retry %3/%4 in %5 ms")
+				.arg(symbol, httpStatus == 429 ? QString("rate limited") : reply->errorString())
+				.arg(it->attempts).arg(m_maxRetries).arg(delay));
+			retryLater(symbol, delay);
+		}
+		else {
+			m_pending.erase(it);
+			emit snapshotFailed(symbol, reply->errorString());
+			finishRequest();
+		}
+		pump();
+		return;
+	}
+
+	m_pending.erase(it);
+
+	QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
+	if (doc.isObject()) {
+		QJsonObject obj = doc.object();
+		SnapshotQuote quote;
+		quote.currentPrice = obj["c"].toDouble();
+		quote.openPrice = obj["o"].toDouble();
+		quote.highPrice = obj["h"].toDouble();
+		quote.lowPrice = obj["l"].toDouble();
+		quote.previousClose = obj["pc"].toDouble();
+		quote.exchangeTime = static_cast<qint64>(obj["t"].toDouble()) * 1000;  // Sent in seconds
+		emit snapshotReceived(symbol, quote);
+	}
+	else {
+		emit snapshotFailed(symbol, "Malformed snapshot response");
+	}
+
+	finishRequest();
+	pump();
+}
+
+void SnapshotLoader::retryLater(const QString& symbol, int delayMs)
+{
+	m_pending[symbol].waitingRetry = true;
+
+	QTimer::singleShot(delayMs, this, [this, symbol]() {
+		auto it = m_pending.find(symbol);
+		if (it == m_pending.end() || !it->waitingRetry) {
+			return;
+		}
+		if (it->cancelled) {
+			m_pending.erase(it);
+			finishRequest();
+			return;
+		}
+		// Back of the queue, so retries never starve first attempts
+		m_queue.enqueue(symbol);
+		pump();
+		});
+}
+
+void SnapshotLoader::finishRequest()
+{
+	m_completed++;
+	emit progress(m_completed, m_total);
+
+	if (isIdle()) {
+		m_completed = 0;
+		m_total = 0;
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QQueue>
+#include <QString>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+// Finnhub /quote response
+struct SnapshotQuote {
+	double currentPrice;
+	double openPrice;
+	double highPrice;
+	double lowPrice;
+	double previousClose;
+	qint64 exchangeTime;  // ms since epoch of the quote, 0 if not sent
+};
+
+// Queues REST snapshot requests so a large watchlist does not open one
+// connection per symbol. Caps requests in flight, coalesces duplicate
+// requests for a symbol that is already queued or loading, and retries
+// failures (including HTTP 429) with exponential backoff.
+class SnapshotLoader : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit SnapshotLoader(QNetworkAccessManager* networkManager, QObject* parent = nullptr);
+
+	// Configuration
+	void setBaseUrl(const QString& url) { m_baseUrl = url; }
+	void setApiKey(const QString& apiKey) { m_apiKey = apiKey; }
+	void setMaxInFlight(int requests);     // Default 4
+	void setMaxRetries(int retries);       // Default 3
+	void setRetryBackoff(int milliseconds);  // First retry delay, doubled each attempt
+
+	void request(const QString& symbol);
+	void cancel(const QString& symbol);  // Drops a queued request; one in flight completes silently
+
+	bool isIdle() const { return m_queue.isEmpty() && m_pending.isEmpty(); }
+	int inFlight() const { return m_inFlight; }
+
+signals:
+	void snapshotReceived(const QString& symbol, const SnapshotQuote& quote);
+	void snapshotFailed(const QString& symbol, const QString& error);
+	void progress(int completed, int total);  // Resets once the loader goes idle
+	void logMessage(const QString& message);
+
+private slots:
+	void onReplyFinished();
+
+private:
+	struct PendingSnapshot {
+		int attempts;
+		bool cancelled;
+		bool waitingRetry;
+	};
+
+	void pump();
+	void start(const QString& symbol);
+	void retryLater(const QString& symbol, int delayMs);
+	void finishRequest();
+
+private:
+	QNetworkAccessManager* m_networkManager;
+	QString m_baseUrl;
+	QString m_apiKey;
+
+	QQueue<QString> m_queue;                    // Waiting for a free slot
+	QHash<QString, PendingSnapshot> m_pending;  // Queued, in flight or waiting to retry
+	int m_inFlight;
+
+	int m_maxInFlight;
+	int m_maxRetries;
+	int m_retryBackoff;
+
+	// Progress of the current burst of requests
+	int m_completed;
+	int m_total;
+};
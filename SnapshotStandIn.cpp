@@ -0,0 +1,238 @@
+#include "SnapshotStandIn.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+#include <QDateTime>
+#include <QTimer>
+#include <QUrlQuery>
+#include <QMutexLocker>
+
+SnapshotStandIn::SnapshotStandIn(QObject* parent)
+	: QObject(parent)
+	, m_server(new QTcpServer(this))
+	, m_responseDelay(0)
+	, m_retryAfter(0)
+	, m_open(0)
+	, m_maxConcurrent(0)
+	, m_port(0)
+{
+	connect(m_server, &QTcpServer::newConnection, this, &SnapshotStandIn::onNewConnection);
+}
+
+SnapshotStandIn::~SnapshotStandIn()
+{
+	stop();
+}
+
+bool SnapshotStandIn::start(quint16 port)
+{
+	if (m_server->isListening()) {
+		return true;
+	}
+
+	if (!m_server->listen(QHostAddress::LocalHost, port)) {
+		emit logMessage(QString("[STANDIN] Failed to listen on port %1: %2")
+			.arg(port).arg(m_server->errorString()));
+		return false;
+	}
+
+	QMutexLocker locker(&m_mutex);
+	m_port = m_server->serverPort();
+	m_requests.clear();
+	m_open = 0;
+	m_maxConcurrent = 0;
+	m_clock.start();
+	return true;
+}
+
+void SnapshotStandIn::stop()
+{
+	m_server->close();
+	for (QTcpSocket* socket : m_connections.keys()) {
+		socket->abort();
+		socket->deleteLater();
+	}
+	m_connections.clear();
+}
+
+QString SnapshotStandIn::baseUrl() const
+{
+	QMutexLocker locker(&m_mutex);
+	return QString("http://127.0.0.1:%1").arg(m_port);
+}
+
+void SnapshotStandIn::setResponseDelay(int milliseconds)
+{
+	m_responseDelay = qMax(0, milliseconds);
+}
+
+void SnapshotStandIn::setRetryAfter(int seconds)
+{
+	m_retryAfter = qMax(0, seconds);
+}
+
+void SnapshotStandIn::script(const QString& symbol, const QList<int>& statuses)
+{
+	QMutexLocker locker(&m_mutex);
+	m_scripts.insert(symbol, statuses);
+}
+
+QList<SnapshotStandIn::Request> SnapshotStandIn::requests() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_requests;
+}
+
+QList<SnapshotStandIn::Request> SnapshotStandIn::requests(const QString& symbol) const
+{
+	QMutexLocker locker(&m_mutex);
+	QList<Request> matching;
+	for (const Request& request : m_requests) {
+		if (request.symbol == symbol) {
+			matching.append(request);
+		}
+	}
+	return matching;
+}
+
+int SnapshotStandIn::maxConcurrent() const
+{
+	QMutexLocker locker(&m_mutex);
+	return m_maxConcurrent;
+}
+
+void SnapshotStandIn::onNewConnection()
+{
+	while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+		m_connections.insert(socket, Connection());
+		connect(socket, &QTcpSocket::readyRead, this, &SnapshotStandIn::onReadyRead);
+		connect(socket, &QTcpSocket::disconnected, this, &SnapshotStandIn::onDisconnected);
+	}
+}
+
+void SnapshotStandIn::onDisconnected()
+{
+	QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+	auto it = m_connections.find(socket);
+	if (it == m_connections.end()) {
+		return;
+	}
+
+	if (it->busy) {
+		// Its held response will never be sent
+		QMutexLocker locker(&m_mutex);
+		m_open--;
+	}
+	m_connections.erase(it);
+	socket->deleteLater();
+}
+
+void SnapshotStandIn::onReadyRead()
+{
+	QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+	auto it = m_connections.find(socket);
+	if (it == m_connections.end()) {
+		return;
+	}
+	it->buffer.append(socket->readAll());
+	serveNext(socket);
+}
+
+void SnapshotStandIn::serveNext(QTcpSocket* socket)
+{
+	// One request at a time per connection, as HTTP/1.1 without pipelining
+	auto it = m_connections.find(socket);
+	if (it == m_connections.end() || it->busy) {
+		return;
+	}
+	const int headerEnd = it->buffer.indexOf("\r\n\r\n");
+	if (headerEnd < 0) {
+		return;
+	}
+	const QByteArray requestLine = it->buffer.left(it->buffer.indexOf("\r\n"));
+	it->buffer.remove(0, headerEnd + 4);
+
+	// "GET /quote?symbol=AAPL&token=... HTTP/1.1"
+	const QList<QByteArray> parts = requestLine.split(' ');
+	const QByteArray target = parts.size() >= 2 ? parts[1] : QByteArray();
+	const int queryStart = target.indexOf('?');
+	const QByteArray path = queryStart >= 0 ? target.left(queryStart) : target;
+	const QString symbol = QUrlQuery(QString::fromLatin1(queryStart >= 0 ? target.mid(queryStart + 1) : QByteArray()))
+		.queryItemValue("symbol");
+
+	int status = 200;
+	if (parts.value(0) != "GET" || path != "/quote" || symbol.isEmpty()) {
+		status = 404;
+	}
+
+	{
+		QMutexLocker locker(&m_mutex);
+		auto script = m_scripts.find(symbol);
+		if (status == 200 && script != m_scripts.end() && !script->isEmpty()) {
+			status = script->takeFirst();
+		}
+		m_requests.append({ symbol, m_clock.elapsed(), status });
+		m_open++;
+		m_maxConcurrent = qMax(m_maxConcurrent, m_open);
+	}
+
+	it->busy = true;
+	QTimer::singleShot(m_responseDelay, socket, [this, socket, symbol, status]() {
+		respond(socket, symbol, status);
+		{
+			QMutexLocker locker(&m_mutex);
+			m_open--;
+		}
+		auto it = m_connections.find(socket);
+		if (it != m_connections.end()) {
+			it->busy = false;
+			serveNext(socket);
+		}
+		});
+}
+
+void SnapshotStandIn::respond(QTcpSocket* socket, const QString& symbol, int status)
+{
+	QByteArray body;
+	QByteArray extraHeaders;
+	if (status == 200) {
+		// A fixed quote derived from the symbol, so repeated loads agree
+		const double price = 50.0 + (qHash(symbol) % 45000) / 100.0;
+		body = QString("{\"c\":%1,\"d\":0,\"dp\":0,\"h\":%2,\"l\":%3,\"o\":%4,\"pc\":%5,\"t\":%6}")
+			.arg(price, 0, 'f', 2)
+			.arg(price * 1.01, 0, 'f', 2)
+			.arg(price * 0.99, 0, 'f', 2)
+			.arg(price * 0.995, 0, 'f', 2)
+			.arg(price * 0.998, 0, 'f', 2)
+			.arg(QDateTime::currentSecsSinceEpoch())
+			.toUtf8();
+		extraHeaders = "Content-Type: application/json\r\n";
+	}
+	else {
+		body = reasonPhrase(status);
+		if (status == 429 && m_retryAfter > 0) {
+			extraHeaders = "Retry-After: " + QByteArray::number(m_retryAfter) + "\r\n";
+		}
+	}
+
+	QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + " " + reasonPhrase(status) + "\r\n";
+	response += extraHeaders;
+	response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+	response += "Connection: keep-alive\r\n\r\n";
+	response += body;
+	socket->write(response);
+}
+
+QByteArray SnapshotStandIn::reasonPhrase(int status)
+{
+	switch (status) {
+	case 200: return "OK";
+	case 404: return "Not Found";
+	case 429: return "Too Many Requests";
+	case 500: return "Internal Server Error";
+	case 502: return "Bad Gateway";
+	case 503: return "Service Unavailable";
+	case 504: return "Gateway Timeout";
+	default: return "Status";
+	}
+}
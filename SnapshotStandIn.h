@@ -0,0 +1,80 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Local stand-in for the Finnhub REST /quote endpoint, so SnapshotLoader can
+// be exercised without the network. Serves GET /quote?symbol=X over plain
+// HTTP/1.1 with keep-alive on a loopback port.
+//
+// A symbol can be scripted with the statuses its successive requests get;
+// unscripted symbols, and requests past the end of a script, get 200 with a
+// quote. Every request is recorded along with the largest number held open
+// at once, and may be read from any thread.
+class SnapshotStandIn : public QObject
+{
+	Q_OBJECT
+
+public:
+	struct Request {
+		QString symbol;
+		qint64 receivedAt;  // ms since start()
+		int status;
+	};
+
+	explicit SnapshotStandIn(QObject* parent = nullptr);
+	~SnapshotStandIn();
+
+	// Call on the stand-in's thread. Port 0 picks a free one.
+	bool start(quint16 port = 0);
+	void stop();
+	QString baseUrl() const;  // For SnapshotLoader::setBaseUrl
+
+	// Configuration - set before requests arrive
+	void setResponseDelay(int milliseconds);  // Each response is held this long
+	void setRetryAfter(int seconds);          // Sent with every 429; 0 sends none
+	void script(const QString& symbol, const QList<int>& statuses);
+
+	QList<Request> requests() const;
+	QList<Request> requests(const QString& symbol) const;
+	int maxConcurrent() const;
+
+signals:
+	void logMessage(const QString& message);
+
+private slots:
+	void onNewConnection();
+	void onReadyRead();
+	void onDisconnected();
+
+private:
+	struct Connection {
+		QByteArray buffer;  // Received, not yet parsed
+		bool busy = false;  // A response is being held
+	};
+
+	void serveNext(QTcpSocket* socket);
+	void respond(QTcpSocket* socket, const QString& symbol, int status);
+	static QByteArray reasonPhrase(int status);
+
+private:
+	QTcpServer* m_server;
+	QHash<QTcpSocket*, Connection> m_connections;
+	QElapsedTimer m_clock;
+	int m_responseDelay;
+	int m_retryAfter;
+
+	mutable QMutex m_mutex;  // Guards everything below
+	QHash<QString, QList<int>> m_scripts;
+	QList<Request> m_requests;
+	int m_open;
+	int m_maxConcurrent;
+	quint16 m_port;
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <QtGlobal>
+#include <atomic>
+#include <vector>
+
+// Bounded single-producer/single-consumer ring. One thread may call tryPush,
+// one (other) thread may call tryPop; size() is safe from anywhere but only
+// approximate while both sides are running.
+template<typename T>
+class SpscRing {
+public:
+	explicit SpscRing(int capacity)
+		: m_head(0)
+		, m_cachedTail(0)
+		, m_tail(0)
+		, m_cachedHead(0)
+	{
+		quint64 size = 2;
+		while (size < static_cast<quint64>(capacity)) {
+			size <<= 1;
+		}
+		m_mask = size - 1;
+		m_buffer.resize(size);
+	}
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+	// Producer side
+	bool tryPush(const T& item)
+	{
+		const quint64 tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_cachedHead > m_mask) {
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail - m_cachedHead > m_mask) {
+				return false;
+			}
+		}
+		m_buffer[tail & m_mask] = item;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side
+	bool tryPop(T& item)
+	{
+		const quint64 head = m_head.load(std::memory_order_relaxed);
+		if (head == m_cachedTail) {
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (head == m_cachedTail) {
+				return false;
+			}
+		}
+		item = m_buffer[head & m_mask];
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	int size() const
+	{
+		const quint64 tail = m_tail.load(std::memory_order_acquire);
+		const quint64 head = m_head.load(std::memory_order_acquire);
+		return tail > head ? static_cast<int>(tail - head) : 0;
+	}
+
+	bool isEmpty() const { return size() == 0; }
+	int capacity() const { return static_cast<int>(m_mask + 1); }
+
+private:
+	// Consumer-owned line
+	alignas(64) std::atomic<quint64> m_head;
+	quint64 m_cachedTail;
+
+	// Producer-owned line
+	alignas(64) std::atomic<quint64> m_tail;
+	quint64 m_cachedHead;
+
+	alignas(64) quint64 m_mask;
+	std::vector<T> m_buffer;
+};
@@ -4,6 +4,7 @@
 StockTickerWidget::StockTickerWidget(MarketDataFeed* dataFeed, QWidget* parent)
 	: QWidget(parent)
 	, m_dataFeed(dataFeed)
+	, m_subscriber(dataFeed->addSubscriber("Ticker"))
 	, m_tickerContainer(nullptr)
 	, m_tickerLayout(nullptr)
 	, m_scrollTimer(new QTimer(this))
@@ -26,10 +27,6 @@ StockTickerWidget::StockTickerWidget(MarketDataFeed* dataFeed, QWidget* parent)
 	layout->setSpacing(10);
 	setLayout(layout);
 
-	// Connect to market data feed for updates
-	connect(m_dataFeed, &MarketDataFeed::marketDataUpdated,
-		this, &StockTickerWidget::onMarketDataUpdated);
-
 	// Setup update timer (no scrolling for now)
 	m_updateTimer->setInterval(1000);
 	connect(m_updateTimer, &QTimer::timeout, this, &StockTickerWidget::updateDisplay);
@@ -47,18 +44,21 @@ void StockTickerWidget::addSymbol(const QString& symbol)
 {
 	qDebug() << "[Ticker] addSymbol:" << symbol;
 
-	if (m_symbols.contains(symbol)) {
+	SymbolId id = SymbolTable::instance().intern(symbol);
+	if (tickerLabel(id)) {
 		qDebug() << "[Ticker] Symbol already exists, skipping";
 		return;
 	}
 
+	ensureSymbolCapacity(m_tickerLabels, id, static_cast<QLabel*>(nullptr));
+	ensureSymbolCapacity(m_separatorLabels, id, static_cast<QLabel*>(nullptr));
 	m_symbols.append(symbol);
 
 	// Add separator if not first
 	if (layout()->count() > 0) {
 		QLabel* separator = new QLabel("│", this);
 		separator->setStyleSheet("color: #888888; font-size: 8pt;");  // Smaller (was 9pt)
-		m_separatorLabels[symbol] = separator;
+		m_separatorLabels[id] = separator;
 		layout()->addWidget(separator);
 		qDebug() << "[Ticker] Added separator";
 	}
@@ -82,11 +82,12 @@ void StockTickerWidget::addSymbol(const QString& symbol)
 	label->installEventFilter(this);
 	label->setProperty("symbol", symbol);
 
-	m_tickerLabels[symbol] = label;
+	m_tickerLabels[id] = label;
 	layout()->addWidget(label);
 
 	// Subscribe to market data
-	m_dataFeed->subscribe(symbol);
+	m_dataFeed->subscribe(symbol, m_subscriber);
+	m_dataFeed->bus().subscribe(id, UpdateEvents, this);
 
 	// Set initial text
 	MarketData* data = m_dataFeed->getMarketData(symbol);
@@ -105,27 +106,26 @@ void StockTickerWidget::addSymbol(const QString& symbol)
 
 void StockTickerWidget::removeSymbol(const QString& symbol)
 {
-	if (!m_symbols.contains(symbol)) {
+	SymbolId id = SymbolTable::instance().find(symbol);
+	QLabel* label = tickerLabel(id);
+	if (!label) {
 		return;
 	}
 
 	m_symbols.removeAll(symbol);
 
-	if (m_tickerLabels.contains(symbol)) {
-		QLabel* label = m_tickerLabels[symbol];
-		layout()->removeWidget(label);
-		label->deleteLater();
-		m_tickerLabels.remove(symbol);
-	}
+	layout()->removeWidget(label);
+	label->deleteLater();
+	m_tickerLabels[id] = nullptr;
 
-	if (m_separatorLabels.contains(symbol)) {
-		QLabel* separator = m_separatorLabels[symbol];
+	if (QLabel* separator = m_separatorLabels[id]) {
 		layout()->removeWidget(separator);
 		separator->deleteLater();
-		m_separatorLabels.remove(symbol);
+		m_separatorLabels[id] = nullptr;
 	}
 
-	m_dataFeed->unsubscribe(symbol);
+	m_dataFeed->unsubscribe(symbol, m_subscriber);
+	m_dataFeed->bus().unsubscribe(id, this);
 }
 
 void StockTickerWidget::clearSymbols()
@@ -149,23 +149,45 @@ void StockTickerWidget::setUpdateInterval(int milliseconds)
 
 void StockTickerWidget::onMarketDataUpdated(const QString& symbol, MarketData* data)
 {
-	if (!m_tickerLabels.contains(symbol)) {
+	if (!data) {
+		return;
+	}
+
+	QLabel* label = tickerLabel(data->symbolId());
+	if (!label) {
 		return;
 	}
 
-	QLabel* label = m_tickerLabels[symbol];
 	label->setText(formatStockDisplay(symbol, data));
 }
 
+void StockTickerWidget::onMarketDataUpdate(const MarketDataUpdate& update)
+{
+	if (update.data) {
+		onMarketDataUpdated(update.data->symbol(), update.data);
+	}
+}
+
 void StockTickerWidget::updateDisplay()
 {
 	// Refresh all ticker displays with latest data
 	for (const QString& symbol : m_symbols) {
 		MarketData* data = m_dataFeed->getMarketData(symbol);
-		if (data && m_tickerLabels.contains(symbol)) {
-			m_tickerLabels[symbol]->setText(formatStockDisplay(symbol, data));
+		if (!data) {
+			continue;
 		}
+		if (QLabel* label = tickerLabel(data->symbolId())) {
+			label->setText(formatStockDisplay(symbol, data));
+		}
+	}
+}
+
+QLabel* StockTickerWidget::tickerLabel(SymbolId id) const
+{
+	if (id == InvalidSymbolId || id >= static_cast<SymbolId>(m_tickerLabels.size())) {
+		return nullptr;
 	}
+	return m_tickerLabels[id];
 }
 
 void StockTickerWidget::scrollTicker()
@@ -179,9 +201,10 @@ QString StockTickerWidget::formatStockDisplay(const QString& symbol, MarketData*
 		return QString("<span style='color: #FFFFFF;'>%1: --</span>").arg(symbol);
 	}
 
-	double price = data->lastPrice();
-	double change = data->changeAmount();
-	double changePercent = data->changePercent();
+	const MarketDataSnapshot snapshot = data->snapshot();
+	double price = snapshot.lastPrice;
+	double change = snapshot.changeAmount();
+	double changePercent = snapshot.changePercent();
 
 	QString priceStr = QString("$%1").arg(price, 0, 'f', 2);
 	QString changeStr;
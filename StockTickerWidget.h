@@ -9,7 +9,7 @@
 #include <QEnterEvent>
 #include "MarketDataFeed.h"
 
-class StockTickerWidget : public QWidget
+class StockTickerWidget : public QWidget, public MarketDataSubscriber
 {
 	Q_OBJECT
 
@@ -23,6 +23,9 @@ public:
 	void setScrollSpeed(int pixelsPerSecond);
 	void setUpdateInterval(int milliseconds);
 
+	// MarketDataSubscriber - only the symbols on the ticker are subscribed
+	void onMarketDataUpdate(const MarketDataUpdate& update) override;
+
 signals:
 	void symbolClicked(const QString& symbol);
 
@@ -40,17 +43,20 @@ private:
 	void setupUI();
 	void createTickerLabels();
 	QString formatStockDisplay(const QString& symbol, MarketData* data);
+	QLabel* tickerLabel(SymbolId id) const;
 
 private:
 	MarketDataFeed* m_dataFeed;
+	int m_subscriber;  // Our references in the feed's subscription registry
 	QWidget* m_tickerContainer;
 	QHBoxLayout* m_tickerLayout;
 	QTimer* m_scrollTimer;
 	QTimer* m_updateTimer;
 
-	QMap<QString, QLabel*> m_tickerLabels;
-	QMap<QString, QLabel*> m_separatorLabels;
-	QStringList m_symbols;
+	// Per-symbol labels indexed by SymbolId
+	QVector<QLabel*> m_tickerLabels;
+	QVector<QLabel*> m_separatorLabels;
+	QStringList m_symbols;  // Display order
 
 	int m_scrollSpeed;
 	int m_scrollPosition;
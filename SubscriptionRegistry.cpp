@@ -0,0 +1,144 @@
+#include "SubscriptionRegistry.h"
+
+SubscriptionRegistry::SubscriptionRegistry()
+	: m_feedConsumers(0)
+	, m_size(0)
+{
+}
+
+int SubscriptionRegistry::addConsumer(const QString& name, bool onFeed)
+{
+	if (m_consumerNames.size() >= MaxConsumers) {
+		return -1;
+	}
+	const int consumer = m_consumerNames.size();
+	m_consumerNames.append(name);
+	if (onFeed) {
+		m_feedConsumers |= 1u << consumer;
+	}
+	return consumer;
+}
+
+QString SubscriptionRegistry::consumerName(int consumer) const
+{
+	return consumer >= 0 && consumer < m_consumerNames.size() ? m_consumerNames[consumer] : QString();
+}
+
+bool SubscriptionRegistry::acquire(SymbolId id, int consumer)
+{
+	if (id == InvalidSymbolId || consumer < 0 || consumer >= m_consumerNames.size()) {
+		return false;
+	}
+	ensureSymbolCapacity(m_holders, id, 0u);
+	ensureSymbolCapacity(m_sent, id, false);
+	ensureSymbolCapacity(m_queued, id, false);
+
+	const quint32 before = m_holders[id];
+	const quint32 after = before | (1u << consumer);
+	if (after == before) {
+		return false;
+	}
+	m_holders[id] = after;
+
+	if (!(before & m_feedConsumers) && (after & m_feedConsumers)) {
+		queue(id);
+	}
+	if (before == 0) {
+		m_size++;
+		return true;
+	}
+	return false;
+}
+
+bool SubscriptionRegistry::release(SymbolId id, int consumer)
+{
+	if (consumer < 0 || consumer >= m_consumerNames.size()) {
+		return false;
+	}
+	const quint32 before = holders(id);
+	const quint32 after = before & ~(1u << consumer);
+	if (after == before) {
+		return false;
+	}
+	m_holders[id] = after;
+
+	if ((before & m_feedConsumers) && !(after & m_feedConsumers)) {
+		queue(id);
+	}
+	if (after == 0) {
+		m_size--;
+		return true;
+	}
+	return false;
+}
+
+bool SubscriptionRegistry::isHeldBy(SymbolId id, int consumer) const
+{
+	return consumer >= 0 && consumer < MaxConsumers && (holders(id) & (1u << consumer));
+}
+
+int SubscriptionRegistry::refCount(SymbolId id) const
+{
+	quint32 mask = holders(id);
+	int count = 0;
+	while (mask) {
+		mask &= mask - 1;
+		count++;
+	}
+	return count;
+}
+
+QVector<SymbolId> SubscriptionRegistry::symbols() const
+{
+	QVector<SymbolId> ids;
+	ids.reserve(m_size);
+	for (int i = 0; i < m_holders.size(); ++i) {
+		if (m_holders[i]) {
+			ids.append(static_cast<SymbolId>(i));
+		}
+	}
+	return ids;
+}
+
+QStringList SubscriptionRegistry::holderNames(SymbolId id) const
+{
+	QStringList names;
+	const quint32 mask = holders(id);
+	for (int consumer = 0; consumer < m_consumerNames.size(); ++consumer) {
+		if (mask & (1u << consumer)) {
+			names.append(m_consumerNames[consumer]);
+		}
+	}
+	return names;
+}
+
+void SubscriptionRegistry::takeChanges(QVector<SymbolId>& subscribe, QVector<SymbolId>& unsubscribe)
+{
+	for (SymbolId id : m_changed) {
+		m_queued[id] = false;
+		const bool wanted = (m_holders[id] & m_feedConsumers) != 0;
+		if (wanted != m_sent[id]) {
+			(wanted ? subscribe : unsubscribe).append(id);
+			m_sent[id] = wanted;
+		}
+	}
+	m_changed.clear();
+}
+
+void SubscriptionRegistry::resetFeed()
+{
+	for (int i = 0; i < m_sent.size(); ++i) {
+		m_sent[i] = false;
+		if (m_holders[i] & m_feedConsumers) {
+			queue(static_cast<SymbolId>(i));
+		}
+	}
+}
+
+void SubscriptionRegistry::queue(SymbolId id)
+{
+	if (!m_queued[id]) {
+		m_queued[id] = true;
+		m_changed.append(id);
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include "SymbolTable.h"
+
+// Which consumers hold each symbol, and what the primary feed has been told.
+//
+// Each consumer (a widget, the application's watchlist, symbols a session
+// brought with it) is one bit in a per-symbol mask, so holding a symbol
+// twice is a no-op and releasing it drops only that consumer's reference.
+// A symbol is subscribed while any bit is set. Consumers added with onFeed
+// false keep symbols tracked without putting them on the wire.
+//
+// Wire changes are not sent as they happen. Symbols whose on-feed state
+// flipped are queued, and takeChanges() diffs them against what was last
+// sent, so a subscribe and unsubscribe between two flushes send nothing and
+// a reconnect is one pass over the held symbols.
+//
+// Consumer-thread only.
+class SubscriptionRegistry {
+public:
+	static const int MaxConsumers = 32;
+
+	SubscriptionRegistry();
+
+	// Returns the consumer's ID, or -1 if all MaxConsumers are taken
+	int addConsumer(const QString& name, bool onFeed = true);
+	QString consumerName(int consumer) const;
+	int consumerCount() const { return m_consumerNames.size(); }
+
+	// True when the symbol went from no holders to one
+	bool acquire(SymbolId id, int consumer);
+	// True when the last holder let go
+	bool release(SymbolId id, int consumer);
+
+	bool contains(SymbolId id) const { return holders(id) != 0; }
+	bool isHeldBy(SymbolId id, int consumer) const;
+	int refCount(SymbolId id) const;
+	int size() const { return m_size; }
+	QVector<SymbolId> symbols() const;  // In SymbolId order
+	QStringList holderNames(SymbolId id) const;
+
+	// Net wire changes since the last call; the feed is then assumed to have them
+	void takeChanges(QVector<SymbolId>& subscribe, QVector<SymbolId>& unsubscribe);
+	bool hasChanges() const { return !m_changed.isEmpty(); }
+
+	// The feed forgot everything (a new connection); queue every on-feed symbol again
+	void resetFeed();
+
+private:
+	quint32 holders(SymbolId id) const
+	{
+		return id < static_cast<SymbolId>(m_holders.size()) ? m_holders[id] : 0;
+	}
+	void queue(SymbolId id);
+
+private:
+	QStringList m_consumerNames;
+	quint32 m_feedConsumers;  // Consumers whose symbols go on the wire
+
+	// Indexed by SymbolId
+	QVector<quint32> m_holders;
+	QVector<bool> m_sent;  // Subscribed on the feed as of the last takeChanges()
+	QVector<bool> m_queued;
+
+	QVector<SymbolId> m_changed;
+	int m_size;
+};
@@ -0,0 +1,69 @@
+#include "SymbolTable.h"
+
+SymbolTable& SymbolTable::instance()
+{
+	static SymbolTable table;
+	return table;
+}
+
+SymbolId SymbolTable::intern(const QString& symbol)
+{
+	{
+		QReadLocker locker(&m_lock);
+		auto it = m_ids.constFind(symbol);
+		if (it != m_ids.constEnd()) {
+			return it.value();
+		}
+	}
+
+	QWriteLocker locker(&m_lock);
+	auto it = m_ids.constFind(symbol);
+	if (it != m_ids.constEnd()) {
+		return it.value();
+	}
+
+	SymbolId id = static_cast<SymbolId>(m_symbols.size());
+	QByteArray utf8 = symbol.toUtf8();
+	m_ids.insert(symbol, id);
+	m_utf8Ids.insert(utf8, id);
+	m_symbols.append(symbol);
+	m_utf8Symbols.append(utf8);
+	return id;
+}
+
+SymbolId SymbolTable::find(const QString& symbol) const
+{
+	QReadLocker locker(&m_lock);
+	return m_ids.value(symbol, InvalidSymbolId);
+}
+
+SymbolId SymbolTable::find(const char* utf8, int length) const
+{
+	QReadLocker locker(&m_lock);
+	// fromRawData wraps the caller's bytes without copying them
+	return m_utf8Ids.value(QByteArray::fromRawData(utf8, length), InvalidSymbolId);
+}
+
+QString SymbolTable::symbol(SymbolId id) const
+{
+	QReadLocker locker(&m_lock);
+	if (id >= static_cast<SymbolId>(m_symbols.size())) {
+		return QString();
+	}
+	return m_symbols[id];
+}
+
+QByteArray SymbolTable::symbolUtf8(SymbolId id) const
+{
+	QReadLocker locker(&m_lock);
+	if (id >= static_cast<SymbolId>(m_utf8Symbols.size())) {
+		return QByteArray();
+	}
+	return m_utf8Symbols[id];
+}
+
+int SymbolTable::size() const
+{
+	QReadLocker locker(&m_lock);
+	return static_cast<int>(m_symbols.size());
+}
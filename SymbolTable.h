@@ -0,0 +1,48 @@
+#pragma once
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <QReadWriteLock>
+
+// Dense per-process symbol ID. IDs are assigned once, never reused, and can be
+// used directly as an index into per-symbol arrays.
+typedef quint32 SymbolId;
+const SymbolId InvalidSymbolId = 0xFFFFFFFFu;
+
+class SymbolTable {
+public:
+	static SymbolTable& instance();
+
+	// Returns the existing ID or assigns the next one. Thread-safe.
+	SymbolId intern(const QString& symbol);
+
+	// Lookups never assign; InvalidSymbolId if the ticker was never interned
+	SymbolId find(const QString& symbol) const;
+	SymbolId find(const char* utf8, int length) const;
+
+	QString symbol(SymbolId id) const;
+	QByteArray symbolUtf8(SymbolId id) const;
+	int size() const;
+
+private:
+	SymbolTable() = default;
+	SymbolTable(const SymbolTable&) = delete;
+	SymbolTable& operator=(const SymbolTable&) = delete;
+
+private:
+	mutable QReadWriteLock m_lock;
+	QHash<QString, SymbolId> m_ids;
+	QHash<QByteArray, SymbolId> m_utf8Ids;
+	QVector<QString> m_symbols;
+	QVector<QByteArray> m_utf8Symbols;
+};
+
+// Grows a per-symbol array so that `id` is a valid index
+template<typename T>
+inline void ensureSymbolCapacity(QVector<T>& array, SymbolId id, const T& fill = T())
+{
+	if (id != InvalidSymbolId && static_cast<qsizetype>(id) >= array.size()) {
+		array.resize(static_cast<qsizetype>(id) + 1, fill);
+	}
+}
@@ -0,0 +1,241 @@
+#include "SyntheticMarketGenerator.h"
+#include <QHash>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <cmath>
+
+namespace {
+
+// Trading seconds in a year, for scaling annualised drift and volatility
+const double secondsPerYear = 252.0 * 6.5 * 3600.0;
+
+// Bursts after a jump: this many events at burstVolMultiplier x volatility
+const int burstLength = 200;
+const double burstVolMultiplier = 5.0;
+
+}
+
+SyntheticMarketGenerator::SyntheticMarketGenerator(QObject* parent)
+	: QObject(parent)
+	, m_stopRequested(false)
+	, m_wakePending(false)
+{
+}
+
+SyntheticMarketGenerator::~SyntheticMarketGenerator()
+{
+	stop();
+}
+
+SyntheticSymbolConfig SyntheticMarketGenerator::defaultSymbolConfig(const QString& symbol, PriceModel model)
+{
+	static const QHash<QString, double> startPrices = {
+		{ "AAPL", 182.50 }, { "MSFT", 384.90 }, { "GOOGL", 149.34 },
+		{ "TSLA", 253.80 }, { "AMZN", 151.94 }, { "NVDA", 722.48 },
+		{ "META", 434.61 }, { "SPY", 469.50 }, { "QQQ", 395.80 }
+	};
+
+	SyntheticSymbolConfig config;
+	config.symbol = symbol;
+	config.model = model;
+	config.startPrice = startPrices.value(symbol, 100.0);
+	config.drift = 0.05;
+	config.volatility = 0.30;
+	config.reversionSpeed = 50.0;
+	config.reversionLevel = config.startPrice;
+	config.jumpIntensity = 20.0;
+	config.jumpSize = 0.02;
+	config.spreadBps = 10.0;
+	config.quoteRatio = 0.5;
+	return config;
+}
+
+QVector<SyntheticSymbolConfig> SyntheticMarketGenerator::makeUniverse(int symbolCount)
+{
+	QVector<SyntheticSymbolConfig> universe;
+	universe.reserve(symbolCount);
+
+	// Deterministic spread of models and prices, independent of the run seed
+	Xoshiro256 rng(0x53594E);
+	for (int i = 0; i < symbolCount; ++i) {
+		SyntheticSymbolConfig config = defaultSymbolConfig(
+			QString("SYN%1").arg(i, 5, 10, QChar('0')),
+			static_cast<PriceModel>(i % 3));
+		config.startPrice = 5.0 + rng.nextDouble() * 495.0;
+		config.reversionLevel = config.startPrice;
+		config.volatility = 0.15 + rng.nextDouble() * 0.60;
+		universe.append(config);
+	}
+	return universe;
+}
+
+void SyntheticMarketGenerator::start(const SyntheticGeneratorConfig& config)
+{
+	stop();
+
+	const int threadCount = qBound(1, config.threads, qMax(1, static_cast<int>(config.symbols.size())));
+	const double dtYears = config.secondsPerEvent / secondsPerYear;
+
+	for (int t = 0; t < threadCount; ++t) {
+		// Seed per partition so the output only depends on seed and thread count
+		m_workers.append(std::make_shared<Worker>(config.seed + 0x9E3779B97F4A7C15ull * (t + 1), 65536));
+		m_workers.back()->eventsPerSecond = config.eventsPerSecond > 0
+			? qMax<qint64>(1, config.eventsPerSecond / threadCount) : 0;
+		m_workers.back()->sourceId = config.sourceId;
+	}
+
+	for (int i = 0; i < config.symbols.size(); ++i) {
+		const SyntheticSymbolConfig& symbol = config.symbols[i];
+
+		SymbolState state;
+		state.id = SymbolTable::instance().intern(symbol.symbol);
+		state.model = symbol.model;
+		state.logPrice = std::log(qMax(0.01, symbol.startPrice));
+		state.driftStep = (symbol.drift - 0.5 * symbol.volatility * symbol.volatility) * dtYears;
+		state.volStep = symbol.volatility * std::sqrt(dtYears);
+		state.reversionStep = qMin(1.0, symbol.reversionSpeed * dtYears);
+		state.logLevel = std::log(qMax(0.01, symbol.reversionLevel));
+		state.jumpProbability = symbol.jumpIntensity * dtYears;
+		state.jumpSize = symbol.jumpSize;
+		state.halfSpread = symbol.spreadBps / 20000.0;
+		state.quoteRatio = symbol.quoteRatio;
+		state.burstRemaining = 0;
+
+		m_workers[i % threadCount]->symbols.append(state);
+	}
+
+	m_stopRequested.store(false, std::memory_order_relaxed);
+	for (const std::shared_ptr<Worker>& worker : m_workers) {
+		Worker* w = worker.get();
+		w->thread = QThread::create([this, w]() { run(w); });
+		w->thread->setObjectName("SyntheticMarket");
+		w->thread->start();
+	}
+}
+
+void SyntheticMarketGenerator::stop()
+{
+	if (m_workers.isEmpty()) {
+		return;
+	}
+
+	m_stopRequested.store(true, std::memory_order_relaxed);
+	for (const std::shared_ptr<Worker>& worker : m_workers) {
+		worker->thread->wait();
+		delete worker->thread;
+	}
+	m_workers.clear();
+}
+
+quint64 SyntheticMarketGenerator::eventsGenerated() const
+{
+	quint64 total = 0;
+	for (const std::shared_ptr<Worker>& worker : m_workers) {
+		total += worker->events.load(std::memory_order_relaxed);
+	}
+	return total;
+}
+
+void SyntheticMarketGenerator::run(Worker* worker)
+{
+	const int symbolCount = static_cast<int>(worker->symbols.size());
+	if (symbolCount == 0) {
+		return;
+	}
+
+	SymbolState* symbols = worker->symbols.data();
+	const int maxBatch = 256;
+	QElapsedTimer clock;
+	clock.start();
+	quint64 produced = 0;
+	FeedTick tick;
+	tick.sourceId = worker->sourceId;
+
+	while (!m_stopRequested.load(std::memory_order_relaxed)) {
+		int batch = maxBatch;
+		if (worker->eventsPerSecond > 0) {
+			// Pace against the wall clock; values never depend on timing
+			const quint64 due = static_cast<quint64>(clock.nsecsElapsed() / 1000) * worker->eventsPerSecond / 1000000;
+			if (due <= produced) {
+				QThread::usleep(500);
+				continue;
+			}
+			batch = static_cast<int>(qMin<quint64>(maxBatch, due - produced));
+		}
+
+		const qint64 exchangeTime = QDateTime::currentMSecsSinceEpoch();
+		tick.receiveTime = MonotonicClock::now();
+		tick.parsedTime = tick.receiveTime;
+		for (int i = 0; i < batch; ++i) {
+			SymbolState& state = symbols[worker->rng.bounded(symbolCount)];
+			step(worker, state, exchangeTime, tick);
+
+			while (!worker->ring.tryPush(tick)) {
+				if (m_stopRequested.load(std::memory_order_relaxed)) {
+					return;
+				}
+				wakeConsumer();
+				QThread::yieldCurrentThread();
+			}
+		}
+
+		produced += batch;
+		worker->events.store(produced, std::memory_order_relaxed);
+		wakeConsumer();
+	}
+}
+
+void SyntheticMarketGenerator::step(Worker* worker, SymbolState& state, qint64 exchangeTime, FeedTick& tick)
+{
+	Xoshiro256& rng = worker->rng;
+	const double z = rng.nextGaussian();
+
+	switch (state.model) {
+	case PriceModel::GeometricBrownian:
+		state.logPrice += state.driftStep + state.volStep * z;
+		break;
+	case PriceModel::MeanReverting:
+		state.logPrice += state.reversionStep * (state.logLevel - state.logPrice) + state.volStep * z;
+		break;
+	case PriceModel::JumpBurst: {
+		double vol = state.volStep;
+		if (state.burstRemaining > 0) {
+			vol *= burstVolMultiplier;
+			state.burstRemaining--;
+		}
+		state.logPrice += state.driftStep + vol * z;
+		if (rng.nextDouble() < state.jumpProbability) {
+			state.logPrice += state.jumpSize * rng.nextGaussian();
+			state.burstRemaining = burstLength;
+		}
+		break;
+	}
+	}
+
+	const double price = std::exp(state.logPrice);
+	tick.symbolId = state.id;
+	tick.exchangeTime = exchangeTime;
+
+	if (rng.nextDouble() < state.quoteRatio) {
+		const double halfSpread = qMax(0.005, price * state.halfSpread);
+		tick.type = FeedTickType::Quote;
+		tick.price = price - halfSpread;
+		tick.volume = 100.0 * (1 + rng.bounded(20));
+		tick.askPrice = price + halfSpread;
+		tick.askVolume = 100.0 * (1 + rng.bounded(20));
+	}
+	else {
+		tick.type = FeedTickType::Trade;
+		tick.price = price;
+		tick.volume = 1 + rng.bounded(1000);
+		tick.askPrice = 0.0;
+		tick.askVolume = 0.0;
+	}
+}
+
+void SyntheticMarketGenerator::wakeConsumer()
+{
+	if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+		emit ticksAvailable();
+	}
+}
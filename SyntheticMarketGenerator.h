@@ -0,0 +1,104 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include "FeedHandler.h"
+#include "Xoshiro256.h"
+
+enum class PriceModel {
+	GeometricBrownian,  // Log-normal random walk with drift
+	MeanReverting,      // Ornstein-Uhlenbeck on log price
+	JumpBurst           // GBM plus Poisson jumps followed by a high-volatility burst
+};
+
+struct SyntheticSymbolConfig {
+	QString symbol;
+	PriceModel model;
+	double startPrice;
+	double drift;             // Annualised
+	double volatility;        // Annualised
+	double reversionSpeed;    // MeanReverting: per year
+	double reversionLevel;    // MeanReverting: price the model pulls towards
+	double jumpIntensity;     // JumpBurst: expected jumps per year
+	double jumpSize;          // JumpBurst: stddev of log jump
+	double spreadBps;         // Quoted spread in basis points
+	double quoteRatio;        // Fraction of events that are quotes
+};
+
+struct SyntheticGeneratorConfig {
+	quint64 seed;
+	FeedSourceId sourceId;
+	int threads;                 // Symbols are partitioned across threads
+	qint64 eventsPerSecond;      // Total target; 0 = as fast as the consumer allows
+	double secondsPerEvent;      // Simulated time one event advances its symbol
+	QVector<SyntheticSymbolConfig> symbols;
+};
+
+// Multi-threaded synthetic trade/quote source for load testing. Each worker
+// owns a disjoint slice of the symbols, its own PRNG and its own SPSC tick
+// ring, so the generated sequence depends only on the seed and thread count.
+// A full ring makes the worker wait rather than drop.
+class SyntheticMarketGenerator : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit SyntheticMarketGenerator(QObject* parent = nullptr);
+	~SyntheticMarketGenerator();
+
+	static SyntheticSymbolConfig defaultSymbolConfig(const QString& symbol, PriceModel model = PriceModel::GeometricBrownian);
+	static QVector<SyntheticSymbolConfig> makeUniverse(int symbolCount);
+
+	void start(const SyntheticGeneratorConfig& config);
+	void stop();
+	bool isRunning() const { return !m_workers.isEmpty(); }
+
+	// Consumer side (GUI thread)
+	int ringCount() const { return static_cast<int>(m_workers.size()); }
+	SpscRing<FeedTick>* ring(int index) const { return &m_workers[index]->ring; }
+	void acknowledgeTicks() { m_wakePending.store(false, std::memory_order_release); }
+
+	quint64 eventsGenerated() const;
+
+signals:
+	void ticksAvailable();
+
+private:
+	struct SymbolState {
+		SymbolId id;
+		PriceModel model;
+		double logPrice;
+		double driftStep;       // Precomputed per-event terms
+		double volStep;
+		double reversionStep;
+		double logLevel;
+		double jumpProbability;
+		double jumpSize;
+		double halfSpread;      // Fraction of price
+		double quoteRatio;
+		int burstRemaining;
+	};
+
+	struct Worker {
+		Worker(quint64 seed, int ringCapacity) : ring(ringCapacity), rng(seed), events(0), thread(nullptr) {}
+		SpscRing<FeedTick> ring;
+		Xoshiro256 rng;
+		FeedSourceId sourceId;
+		QVector<SymbolState> symbols;
+		qint64 eventsPerSecond;
+		std::atomic<quint64> events;
+		QThread* thread;
+	};
+
+	void run(Worker* worker);
+	void step(Worker* worker, SymbolState& state, qint64 exchangeTime, FeedTick& tick);
+	void wakeConsumer();
+
+private:
+	QVector<std::shared_ptr<Worker>> m_workers;
+	std::atomic<bool> m_stopRequested;
+	std::atomic<bool> m_wakePending;
+};
@@ -0,0 +1,403 @@
+#include "TickAnalytics.h"
+#include "TickStoreFormat.h"
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QTimeZone>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TICK_ANALYTICS_SSE2
+#endif
+
+namespace {
+	// One symbol-day reduced to what merging across days needs
+	struct DayPartial {
+		qint64 trades = 0;
+		double volume = 0.0;
+		double notional = 0.0;
+		double open = 0.0;
+		double close = 0.0;
+		double high = 0.0;
+		double low = 0.0;
+		double maxDrawdown = 0.0;
+		QVector<VolumeBucket> buckets;
+		qint64 bytesRead = 0;
+		QString error;
+	};
+
+	// Falls, as fractions of the running peak, over one day in file order
+	double dayDrawdown(const double* prices, int count)
+	{
+		// Only a new peak can end a fall, so compare against the trough since the last one
+		double peak = prices[0];
+		double trough = prices[0];
+		double worst = 0.0;
+		for (int i = 1; i < count; ++i) {
+			const double price = prices[i];
+			if (price > peak) {
+				worst = qMax(worst, (peak - trough) / peak);
+				peak = price;
+				trough = price;
+			}
+			else if (price < trough) {
+				trough = price;
+			}
+		}
+		return qMax(worst, (peak - trough) / peak);
+	}
+
+	void addToBucket(VolumeBucket& bucket, const double* prices, const double* sizes, int count)
+	{
+		double volume;
+		double notional;
+		TickAnalytics::sumVolumeNotional(prices, sizes, count, volume, notional);
+		bucket.volume += volume;
+		bucket.notional += notional;
+		bucket.close = prices[count - 1];
+		bucket.trades += count;
+	}
+
+	void reduceDay(const TickQuery& query, const QString& symbol, const QDate& day, DayPartial& partial)
+	{
+		if (!QFile::exists(TickStoreFormat::dataFileName(query.root, day, symbol))) {
+			return;  // Nothing recorded that day
+		}
+
+		TickStoreReader reader;
+		if (!reader.open(query.root, symbol, day)) {
+			partial.error = reader.errorString();
+			return;
+		}
+
+		TickColumns ticks;
+		reader.read(query.fromNs, query.toNs, ticks);
+		partial.bytesRead = reader.fileSize();
+		const int count = ticks.size();
+		if (count == 0) {
+			return;
+		}
+
+		const qint64* times = ticks.times.constData();
+		const double* prices = ticks.prices.constData();
+		const double* sizes = ticks.sizes.constData();
+
+		partial.trades = count;
+		partial.open = prices[0];
+		partial.close = prices[count - 1];
+		TickAnalytics::minMax(prices, count, partial.low, partial.high);
+		partial.maxDrawdown = dayDrawdown(prices, count);
+
+		// Trades arrive nearly in time order, so buckets are found as runs and
+		// each run is summed by the kernel. A late trade can reopen an earlier bucket.
+		const qint64 width = query.bucketNs;
+		int runStart = 0;
+		while (runStart < count) {
+			const qint64 start = times[runStart] - times[runStart] % width;
+			const qint64 end = start + width;
+			int runEnd = runStart + 1;
+			while (runEnd < count && times[runEnd] >= start && times[runEnd] < end) {
+				runEnd++;
+			}
+
+			QVector<VolumeBucket>& buckets = partial.buckets;
+			if (buckets.isEmpty() || buckets.last().startTime < start) {
+				buckets.append(VolumeBucket{ start, 0.0, 0.0, 0.0, 0 });
+				addToBucket(buckets.last(), prices + runStart, sizes + runStart, runEnd - runStart);
+			}
+			else if (buckets.last().startTime == start) {
+				addToBucket(buckets.last(), prices + runStart, sizes + runStart, runEnd - runStart);
+			}
+			else {
+				auto it = std::lower_bound(buckets.begin(), buckets.end(), start,
+					[](const VolumeBucket& bucket, qint64 time) { return bucket.startTime < time; });
+				if (it == buckets.end() || it->startTime != start) {
+					it = buckets.insert(it, VolumeBucket{ start, 0.0, 0.0, 0.0, 0 });
+				}
+				// Late trades do not move a close that later trades already set
+				const double close = it->close;
+				addToBucket(*it, prices + runStart, sizes + runStart, runEnd - runStart);
+				if (close != 0.0) {
+					it->close = close;
+				}
+			}
+			runStart = runEnd;
+		}
+
+		for (const VolumeBucket& bucket : partial.buckets) {
+			partial.volume += bucket.volume;
+			partial.notional += bucket.notional;
+		}
+	}
+
+	void mergeDay(TickQueryResult& result, DayPartial& day)
+	{
+		if (!day.error.isEmpty()) {
+			result.errors.append(day.error);
+		}
+		result.bytesRead += day.bytesRead;
+		if (day.trades == 0) {
+			return;
+		}
+
+		if (result.trades == 0) {
+			result.open = day.open;
+			result.high = day.high;
+			result.low = day.low;
+			result.maxDrawdown = day.maxDrawdown;
+		}
+		else {
+			// A fall can start at an earlier day's peak and bottom out today
+			result.maxDrawdown = qMax(result.maxDrawdown, qMax(day.maxDrawdown, (result.high - day.low) / result.high));
+			result.high = qMax(result.high, day.high);
+			result.low = qMin(result.low, day.low);
+		}
+		result.close = day.close;
+		result.trades += day.trades;
+		result.volume += day.volume;
+		result.notional += day.notional;
+		result.days++;
+
+		// Buckets wider than a day's remainder straddle midnight
+		int from = 0;
+		if (!result.buckets.isEmpty() && result.buckets.last().startTime == day.buckets.first().startTime) {
+			VolumeBucket& shared = result.buckets.last();
+			const VolumeBucket& next = day.buckets.first();
+			shared.volume += next.volume;
+			shared.notional += next.notional;
+			shared.close = next.close;
+			shared.trades += next.trades;
+			from = 1;
+		}
+		result.buckets.reserve(result.buckets.size() + day.buckets.size() - from);
+		for (int i = from; i < day.buckets.size(); ++i) {
+			result.buckets.append(day.buckets[i]);
+		}
+		day.buckets.clear();
+	}
+
+	double realizedVolatility(const QVector<VolumeBucket>& buckets)
+	{
+		double sum = 0.0;
+		for (int i = 1; i < buckets.size(); ++i) {
+			if (buckets[i - 1].close > 0.0 && buckets[i].close > 0.0) {
+				const double r = std::log(buckets[i].close / buckets[i - 1].close);
+				sum += r * r;
+			}
+		}
+		return std::sqrt(sum);
+	}
+
+	QString formatTime(qint64 ns, const char* format)
+	{
+		return QDateTime::fromMSecsSinceEpoch(ns / 1000000, QTimeZone::UTC).toString(format);
+	}
+}
+
+qint64 TickQueryReport::totalTrades() const
+{
+	qint64 total = 0;
+	for (const TickQueryResult& result : results) {
+		total += result.trades;
+	}
+	return total;
+}
+
+qint64 TickQueryReport::totalBytes() const
+{
+	qint64 total = 0;
+	for (const TickQueryResult& result : results) {
+		total += result.bytesRead;
+	}
+	return total;
+}
+
+TickQueryReport TickAnalytics::run(const TickQuery& query)
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	TickQueryReport report;
+	if (query.symbols.isEmpty() || query.fromNs > query.toNs || query.bucketNs <= 0) {
+		return report;
+	}
+
+	const QDate firstDay = TickStoreFormat::dayOf(query.fromNs);
+	const int days = static_cast<int>(firstDay.daysTo(TickStoreFormat::dayOf(query.toNs))) + 1;
+	const int symbols = static_cast<int>(query.symbols.size());
+
+	// One task per symbol-day; each writes only its own slot
+	QVector<DayPartial> partials(symbols * days);
+	{
+		QThreadPool pool;
+		pool.setMaxThreadCount(query.threads > 0 ? query.threads : QThread::idealThreadCount());
+		for (int s = 0; s < symbols; ++s) {
+			for (int d = 0; d < days; ++d) {
+				DayPartial* partial = &partials[s * days + d];
+				const QString symbol = query.symbols[s];
+				const QDate day = firstDay.addDays(d);
+				pool.start([&query, symbol, day, partial]() {
+					reduceDay(query, symbol, day, *partial);
+					});
+			}
+		}
+		pool.waitForDone();
+	}
+	report.tasks = static_cast<int>(partials.size());
+
+	report.results.resize(symbols);
+	for (int s = 0; s < symbols; ++s) {
+		TickQueryResult& result = report.results[s];
+		result.symbol = query.symbols[s];
+		for (int d = 0; d < days; ++d) {
+			mergeDay(result, partials[s * days + d]);
+		}
+		result.realizedVolatility = realizedVolatility(result.buckets);
+	}
+
+	report.elapsedNs = timer.nsecsElapsed();
+	return report;
+}
+
+QString TickAnalytics::formatReport(const TickQuery& query, const TickQueryReport& report)
+{
+	QString text;
+	QTextStream out(&text);
+	const double seconds = report.elapsedNs / 1e9;
+	out << QString("[QUERY] %1 symbol(s), %2 to %3 UTC, %4 s buckets: %5 trades, %6 MB in %7 ms (%8 M trades/s, %9 tasks)")
+		.arg(report.results.size())
+		.arg(formatTime(query.fromNs, "yyyy-MM-dd HH:mm"))
+		.arg(formatTime(query.toNs, "yyyy-MM-dd HH:mm"))
+		.arg(query.bucketNs / 1000000000LL)
+		.arg(report.totalTrades())
+		.arg(report.totalBytes() / (1024.0 * 1024.0), 0, 'f', 1)
+		.arg(report.elapsedNs / 1e6, 0, 'f', 1)
+		.arg(seconds > 0.0 ? report.totalTrades() / seconds / 1e6 : 0.0, 0, 'f', 1)
+		.arg(report.tasks);
+
+	for (const TickQueryResult& result : report.results) {
+		out << "\n";
+		if (result.trades == 0) {
+			out << QString("  %1: no trades").arg(result.symbol);
+		}
+		else {
+			const auto busiest = std::max_element(result.buckets.constBegin(), result.buckets.constEnd(),
+				[](const VolumeBucket& a, const VolumeBucket& b) { return a.volume < b.volume; });
+			out << QString("  %1: %2 trades over %3 day(s), VWAP %4, volume %5, open %6 high %7 low %8 close %9")
+				.arg(result.symbol)
+				.arg(result.trades)
+				.arg(result.days)
+				.arg(result.vwap(), 0, 'f', 4)
+				.arg(result.volume, 0, 'f', 0)
+				.arg(result.open, 0, 'f', 2)
+				.arg(result.high, 0, 'f', 2)
+				.arg(result.low, 0, 'f', 2)
+				.arg(result.close, 0, 'f', 2);
+			out << QString("\n    realized vol %1%, max drawdown %2%, %3 buckets, busiest %4 UTC (%5)")
+				.arg(result.realizedVolatility * 100.0, 0, 'f', 2)
+				.arg(result.maxDrawdown * 100.0, 0, 'f', 2)
+				.arg(result.buckets.size())
+				.arg(formatTime(busiest->startTime, "yyyy-MM-dd HH:mm:ss"))
+				.arg(busiest->volume, 0, 'f', 0);
+		}
+		for (const QString& error : result.errors) {
+			out << QString("\n    skipped: %1").arg(error);
+		}
+	}
+	out.flush();
+	return text;
+}
+
+QString TickAnalytics::formatBuckets(const TickQueryReport& report)
+{
+	QString text;
+	QTextStream out(&text);
+	out << "symbol,start,volume,vwap,close,trades\n";
+	for (const TickQueryResult& result : report.results) {
+		for (const VolumeBucket& bucket : result.buckets) {
+			out << result.symbol << ','
+				<< formatTime(bucket.startTime, "yyyy-MM-ddTHH:mm:ssZ") << ','
+				<< QString::number(bucket.volume, 'f', 0) << ','
+				<< QString::number(bucket.volume > 0.0 ? bucket.notional / bucket.volume : 0.0, 'f', 4) << ','
+				<< QString::number(bucket.close, 'f', 4) << ','
+				<< bucket.trades << '\n';
+		}
+	}
+	out.flush();
+	return text;
+}
+
+void TickAnalytics::sumVolumeNotional(const double* prices, const double* sizes, int count, double& volume, double& notional)
+{
+	int i = 0;
+	double sumVolume = 0.0;
+	double sumNotional = 0.0;
+#ifdef TICK_ANALYTICS_SSE2
+	// Two accumulators per sum hide the add latency
+	__m128d volume0 = _mm_setzero_pd();
+	__m128d volume1 = _mm_setzero_pd();
+	__m128d notional0 = _mm_setzero_pd();
+	__m128d notional1 = _mm_setzero_pd();
+	for (; i + 4 <= count; i += 4) {
+		const __m128d size0 = _mm_loadu_pd(sizes + i);
+		const __m128d size1 = _mm_loadu_pd(sizes + i + 2);
+		volume0 = _mm_add_pd(volume0, size0);
+		volume1 = _mm_add_pd(volume1, size1);
+		notional0 = _mm_add_pd(notional0, _mm_mul_pd(_mm_loadu_pd(prices + i), size0));
+		notional1 = _mm_add_pd(notional1, _mm_mul_pd(_mm_loadu_pd(prices + i + 2), size1));
+	}
+	const __m128d volumes = _mm_add_pd(volume0, volume1);
+	const __m128d notionals = _mm_add_pd(notional0, notional1);
+	sumVolume = _mm_cvtsd_f64(_mm_add_sd(volumes, _mm_unpackhi_pd(volumes, volumes)));
+	sumNotional = _mm_cvtsd_f64(_mm_add_sd(notionals, _mm_unpackhi_pd(notionals, notionals)));
+#endif
+	for (; i < count; ++i) {
+		sumVolume += sizes[i];
+		sumNotional += prices[i] * sizes[i];
+	}
+	volume = sumVolume;
+	notional = sumNotional;
+}
+
+void TickAnalytics::minMax(const double* values, int count, double& low, double& high)
+{
+	if (count <= 0) {
+		low = 0.0;
+		high = 0.0;
+		return;
+	}
+
+	int i = 0;
+	double lo = std::numeric_limits<double>::infinity();
+	double hi = -std::numeric_limits<double>::infinity();
+#ifdef TICK_ANALYTICS_SSE2
+	__m128d low0 = _mm_set1_pd(lo);
+	__m128d low1 = low0;
+	__m128d high0 = _mm_set1_pd(hi);
+	__m128d high1 = high0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128d a = _mm_loadu_pd(values + i);
+		const __m128d b = _mm_loadu_pd(values + i + 2);
+		low0 = _mm_min_pd(low0, a);
+		low1 = _mm_min_pd(low1, b);
+		high0 = _mm_max_pd(high0, a);
+		high1 = _mm_max_pd(high1, b);
+	}
+	const __m128d lows = _mm_min_pd(low0, low1);
+	const __m128d highs = _mm_max_pd(high0, high1);
+	lo = _mm_cvtsd_f64(_mm_min_sd(lows, _mm_unpackhi_pd(lows, lows)));
+	hi = _mm_cvtsd_f64(_mm_max_sd(highs, _mm_unpackhi_pd(highs, highs)));
+#endif
+	for (; i < count; ++i) {
+		lo = qMin(lo, values[i]);
+		hi = qMax(hi, values[i]);
+	}
+	low = lo;
+	high = hi;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QDate>
+
+// Aggregate queries over the tick history written by TickStore. Each
+// symbol-day is decoded and reduced on its own pool thread with SIMD
+// kernels, then the days are merged in order per symbol.
+struct TickQuery {
+	QString root;           // TickStore directory
+	QStringList symbols;
+	qint64 fromNs = 0;      // Inclusive, ns since epoch
+	qint64 toNs = 0;        // Inclusive
+	qint64 bucketNs = 300LL * 1000000000LL;  // Volume buckets and volatility sampling
+	int threads = 0;        // 0 = one per core
+};
+
+struct VolumeBucket {
+	qint64 startTime;  // ns since epoch, a multiple of the bucket width
+	double volume;
+	double notional;
+	double close;      // Last trade in the bucket
+	int trades;
+};
+
+struct TickQueryResult {
+	QString symbol;
+	qint64 trades = 0;
+	double volume = 0.0;
+	double notional = 0.0;
+	double open = 0.0;
+	double high = 0.0;
+	double low = 0.0;
+	double close = 0.0;
+	double maxDrawdown = 0.0;         // Largest peak-to-trough fall, as a fraction of the peak
+	double realizedVolatility = 0.0;  // sqrt of summed squared log returns between bucket closes, not annualized
+	QVector<VolumeBucket> buckets;    // Non-empty buckets only, in time order
+	int days = 0;                     // Days with data
+	qint64 bytesRead = 0;
+	QStringList errors;               // Unreadable files; their days are skipped
+
+	double vwap() const { return volume > 0.0 ? notional / volume : 0.0; }
+};
+
+struct TickQueryReport {
+	QVector<TickQueryResult> results;  // One per query symbol, in query order
+	qint64 elapsedNs = 0;
+	int tasks = 0;
+
+	qint64 totalTrades() const;
+	qint64 totalBytes() const;
+};
+
+class TickAnalytics {
+public:
+	// Blocks until every symbol-day is done
+	static TickQueryReport run(const TickQuery& query);
+
+	// Human-readable summary for the System Log, or the query tool's output
+	static QString formatReport(const TickQuery& query, const TickQueryReport& report);
+
+	// One CSV row per bucket per symbol: symbol,start,volume,vwap,close,trades
+	static QString formatBuckets(const TickQueryReport& report);
+
+	// Kernels, exposed for benchmarking
+	static void sumVolumeNotional(const double* prices, const double* sizes, int count, double& volume, double& notional);
+	static void minMax(const double* values, int count, double& low, double& high);
+};
@@ -0,0 +1,85 @@
+#include "TickFile.h"
+#include <QtEndian>
+#include <cstring>
+
+void TickFile::writeFileHeader(char* dst, qint64 createdNs)
+{
+	std::memset(dst, 0, FileHeaderSize);
+	qToLittleEndian<quint32>(Magic, dst);
+	qToLittleEndian<quint16>(Version, dst + 4);
+	qToLittleEndian<qint64>(createdNs, dst + 8);
+}
+
+void TickFile::writeRecordHeader(char* dst, qint64 receiveTimeNs, quint32 length, quint8 kind)
+{
+	std::memset(dst, 0, RecordHeaderSize);
+	qToLittleEndian<qint64>(receiveTimeNs, dst);
+	qToLittleEndian<quint32>(length, dst + 8);
+	dst[12] = static_cast<char>(kind);
+}
+
+TickFileReader::TickFileReader()
+	: m_data(nullptr)
+	, m_pos(nullptr)
+	, m_end(nullptr)
+	, m_createdTime(0)
+	, m_valid(false)
+{
+}
+
+TickFileReader::TickFileReader(const char* data, qint64 size)
+	: m_data(data)
+	, m_pos(data)
+	, m_end(data + size)
+	, m_createdTime(0)
+	, m_valid(false)
+{
+	if (size < TickFile::FileHeaderSize ||
+		qFromLittleEndian<quint32>(data) != TickFile::Magic ||
+		qFromLittleEndian<quint16>(data + 4) != TickFile::Version) {
+		return;
+	}
+
+	m_createdTime = qFromLittleEndian<qint64>(data + 8);
+	m_pos = data + TickFile::FileHeaderSize;
+	m_valid = true;
+}
+
+bool TickFileReader::next(TickFileRecord& record)
+{
+	if (!m_valid || m_end - m_pos < TickFile::RecordHeaderSize) {
+		return false;
+	}
+
+	const qint64 receiveTime = qFromLittleEndian<qint64>(m_pos);
+	const quint32 length = qFromLittleEndian<quint32>(m_pos + 8);
+	if (receiveTime == 0 && length == 0) {
+		return false;  // Zeroed, preallocated tail
+	}
+	if (length > static_cast<quint64>(m_end - m_pos - TickFile::RecordHeaderSize)) {
+		return false;
+	}
+
+	record.receiveTime = receiveTime;
+	record.kind = static_cast<TickFilePayload>(static_cast<quint8>(m_pos[12]));
+	record.payload = m_pos + TickFile::RecordHeaderSize;
+	record.length = static_cast<int>(length);
+
+	m_pos += TickFile::RecordHeaderSize + length;
+	return true;
+}
+
+void TickFileReader::rewind()
+{
+	if (m_valid) {
+		m_pos = m_data + TickFile::FileHeaderSize;
+	}
+}
+
+double TickFileReader::progress() const
+{
+	if (!m_valid || m_end == m_data) {
+		return 0.0;
+	}
+	return static_cast<double>(m_pos - m_data) / static_cast<double>(m_end - m_data);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <QtGlobal>
+#include <QByteArray>
+
+// On-disk format shared by recorded feed files (replay input and journal
+// segments). Little-endian throughout.
+//
+// File header (16 bytes)
+//   0  u32  magic "LTTF"
+//   4  u16  version
+//   6  u16  reserved
+//   8  i64  creation time, ns since epoch
+//
+// Each record is a 16-byte header followed by the raw frame payload
+//   0  i64  receive time, ns since epoch
+//   8  u32  payload length
+//   12 u8   payload kind (TickFilePayload)
+//   13 u8[3] reserved
+// An all-zero record header ends the file, so a preallocated file can be
+// read while its tail is still unused.
+namespace TickFile {
+	const quint32 Magic = 0x4654544Cu;  // "LTTF" as little-endian bytes
+	const quint16 Version = 1;
+	const int FileHeaderSize = 16;
+	const int RecordHeaderSize = 16;
+
+	void writeFileHeader(char* dst, qint64 createdNs);
+	void writeRecordHeader(char* dst, qint64 receiveTimeNs, quint32 length, quint8 kind);
+}
+
+enum class TickFilePayload : quint8 {
+	Text = 0,    // Finnhub JSON frame
+	Binary = 1   // BinaryFeedProtocol batch
+};
+
+// Frame view into a mapped file; only valid while the mapping is alive
+struct TickFileRecord {
+	qint64 receiveTime;
+	TickFilePayload kind;
+	const char* payload;
+	int length;
+};
+
+// Walks the records of a mapped tick file in place
+class TickFileReader {
+public:
+	TickFileReader();
+	TickFileReader(const char* data, qint64 size);
+
+	bool isValid() const { return m_valid; }
+	qint64 createdTime() const { return m_createdTime; }
+
+	// Returns false at the end of the file or on a truncated record
+	bool next(TickFileRecord& record);
+	void rewind();
+
+	// Fraction of the file consumed so far, 0..1
+	double progress() const;
+
+private:
+	const char* m_data;
+	const char* m_pos;
+	const char* m_end;
+	qint64 m_createdTime;
+	bool m_valid;
+};
@@ -0,0 +1,304 @@
+#include "TickStore.h"
+#include "MonotonicClock.h"
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <cstring>
+
+TickStore::TickStore(const QString& directory, QObject* parent)
+	: QObject(parent)
+	, m_directory(directory)
+	, m_flushSeconds(10)
+	, m_writer(nullptr)
+	, m_stopping(false)
+	, m_ticksWritten(0)
+	, m_ticksDropped(0)
+	, m_bytesWritten(0)
+{
+	setRingSize(256 * 1024);
+}
+
+TickStore::~TickStore()
+{
+	stop();
+}
+
+void TickStore::setRingSize(int ticks)
+{
+	if (m_writer) {
+		return;
+	}
+	m_ring.reset(new SpscRing<StoredTick>(ticks));
+}
+
+bool TickStore::start()
+{
+	if (m_writer) {
+		return true;
+	}
+
+	if (!QDir().mkpath(m_directory)) {
+		emit logMessage(QString("[TICKSTORE] Cannot create %1").arg(m_directory));
+		return false;
+	}
+
+	m_stopping.store(false, std::memory_order_relaxed);
+	m_writer = QThread::create([this]() { writerLoop(); });
+	m_writer->setObjectName("TickStore");
+	m_writer->start(QThread::LowPriority);
+
+	emit logMessage(QString("[TICKSTORE] Recording trades to %1").arg(m_directory));
+	return true;
+}
+
+void TickStore::stop()
+{
+	if (!m_writer) {
+		return;
+	}
+
+	m_stopping.store(true, std::memory_order_release);
+	m_writer->wait();
+	delete m_writer;
+	m_writer = nullptr;
+
+	emit logMessage(QString("[TICKSTORE] Stopped: %1 trades in %2 MB (%3x), %4 dropped")
+		.arg(ticksWritten())
+		.arg(bytesWritten() / (1024.0 * 1024.0), 0, 'f', 1)
+		.arg(compressionRatio(), 0, 'f', 1)
+		.arg(ticksDropped()));
+}
+
+bool TickStore::append(SymbolId id, qint64 timestampNs, double price, double size)
+{
+	StoredTick tick;
+	tick.symbolId = id;
+	tick.time = timestampNs;
+	tick.price = price;
+	tick.size = size;
+	if (!m_ring->tryPush(tick)) {
+		// Writer is behind (slow disk) - losing history beats stalling the feed
+		m_ticksDropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	return true;
+}
+
+double TickStore::compressionRatio() const
+{
+	const quint64 bytes = bytesWritten();
+	return bytes > 0 ? ticksWritten() * 24.0 / bytes : 0.0;
+}
+
+void TickStore::writerLoop()
+{
+	QElapsedTimer sinceFlush;
+	sinceFlush.start();
+
+	StoredTick tick;
+	for (;;) {
+		int popped = 0;
+		while (m_ring->tryPop(tick)) {
+			store(tick);
+			popped++;
+		}
+
+		if (sinceFlush.elapsed() >= m_flushSeconds * 1000LL) {
+			flushAll(false);
+			sinceFlush.restart();
+		}
+
+		if (popped == 0) {
+			// The feed stops appending before stop() is called, so empty means done
+			if (m_stopping.load(std::memory_order_acquire)) {
+				break;
+			}
+			QThread::msleep(5);
+		}
+	}
+
+	flushAll(true);
+	m_pending.clear();
+}
+
+void TickStore::store(const StoredTick& tick)
+{
+	std::shared_ptr<PendingBlock>& slot = m_pending[tick.symbolId];
+	if (!slot) {
+		slot = std::make_shared<PendingBlock>();
+		slot->symbol = SymbolTable::instance().symbol(tick.symbolId);
+	}
+
+	// One file per UTC day; a trade from another day closes the current block
+	PendingBlock& pending = *slot;
+	const QDate day = TickStoreFormat::dayOf(tick.time);
+	if (pending.ticks.size() > 0 && day != pending.day) {
+		flushBlock(pending);
+	}
+	pending.day = day;
+	if (pending.ticks.size() == 0) {
+		adoptTail(pending);
+	}
+
+	pending.ticks.times.append(tick.time);
+	pending.ticks.prices.append(tick.price);
+	pending.ticks.sizes.append(tick.size);
+	if (pending.ticks.size() == TickStoreFormat::BlockTicks) {
+		flushBlock(pending);
+	}
+}
+
+void TickStore::flushAll(bool seal)
+{
+	for (auto it = m_pending.begin(); it != m_pending.end(); ++it) {
+		PendingBlock& pending = *it.value();
+		if (seal && pending.ticks.size() > 0) {
+			flushBlock(pending);
+		}
+		else if (pending.ticks.size() > pending.persisted) {
+			writeTail(pending);
+		}
+	}
+}
+
+bool TickStore::openData(QFile& data, const PendingBlock& pending, qint64& written)
+{
+	// Opened per write rather than held, so thousands of symbols do not exhaust file handles
+	QDir().mkpath(TickStoreFormat::dayDirectory(m_directory, pending.day));
+	data.setFileName(TickStoreFormat::dataFileName(m_directory, pending.day, pending.symbol));
+	if (!data.open(QIODevice::ReadWrite)) {
+		emit logMessage(QString("[TICKSTORE] Cannot open %1: %2").arg(data.fileName(), data.errorString()));
+		return false;
+	}
+
+	if (data.size() < TickStoreFormat::FileHeaderSize) {
+		char header[TickStoreFormat::FileHeaderSize];
+		TickStoreFormat::writeFileHeader(header, pending.day, MonotonicClock::toWallNanos(MonotonicClock::now()));
+		data.resize(0);
+		data.write(header, sizeof(header));
+		written += TickStoreFormat::FileHeaderSize;
+	}
+	return true;
+}
+
+void TickStore::adoptTail(PendingBlock& pending)
+{
+	// A tail left by a run that stopped without sealing it is the start of this block
+	QFile tail(TickStoreFormat::tailFileName(m_directory, pending.day, pending.symbol));
+	if (pending.symbol.isEmpty() || !tail.exists() || !tail.open(QIODevice::ReadOnly)) {
+		return;
+	}
+	const QByteArray contents = tail.readAll();
+	tail.close();
+
+	const QFileInfo data(TickStoreFormat::dataFileName(m_directory, pending.day, pending.symbol));
+	if (contents.size() > TickStoreFormat::TailHeaderSize
+		&& qFromLittleEndian<qint64>(contents.constData()) == data.size()
+		&& TickStoreFormat::decodeBlock(contents.constData() + TickStoreFormat::TailHeaderSize,
+			contents.size() - TickStoreFormat::TailHeaderSize,
+			pending.ticks.times, pending.ticks.prices, pending.ticks.sizes)) {
+		pending.persisted = pending.ticks.size();
+		pending.tailBytes = contents.size();
+		return;
+	}
+
+	// Already sealed into the data file, or unreadable
+	pending.ticks.clear();
+	tail.remove();
+}
+
+void TickStore::writeTail(PendingBlock& pending)
+{
+	const int count = pending.ticks.size();
+	if (pending.symbol.isEmpty()) {
+		pending.ticks.clear();
+		return;
+	}
+
+	// The data file must exist for readers to find the tail
+	qint64 written = 0;
+	QFile data;
+	if (!openData(data, pending, written)) {
+		return;  // Still buffered; tried again at the next flush
+	}
+	const qint64 base = data.size();
+	data.close();
+
+	// Rewritten whole and swapped in atomically, so a reader never sees half of one
+	m_encoded.resize(TickStoreFormat::TailHeaderSize);
+	qToLittleEndian<qint64>(base, m_encoded.data());
+	TickStoreFormat::encodeBlock(pending.ticks.times.constData(), pending.ticks.prices.constData(),
+		pending.ticks.sizes.constData(), count, m_encoded);
+
+	QSaveFile tail(TickStoreFormat::tailFileName(m_directory, pending.day, pending.symbol));
+	if (!tail.open(QIODevice::WriteOnly) || tail.write(m_encoded) != m_encoded.size() || !tail.commit()) {
+		emit logMessage(QString("[TICKSTORE] Write to %1 failed: %2").arg(tail.fileName(), tail.errorString()));
+		return;
+	}
+
+	m_ticksWritten.fetch_add(count - pending.persisted, std::memory_order_relaxed);
+	m_bytesWritten.fetch_add(written + m_encoded.size() - pending.tailBytes, std::memory_order_relaxed);
+	pending.persisted = count;
+	pending.tailBytes = m_encoded.size();
+}
+
+void TickStore::flushBlock(PendingBlock& pending)
+{
+	const int count = pending.ticks.size();
+	if (count == 0 || pending.symbol.isEmpty()) {
+		pending.ticks.clear();
+		return;
+	}
+
+	qint64 written = 0;
+	QFile data;
+	if (!openData(data, pending, written)) {
+		m_ticksDropped.fetch_add(count - pending.persisted, std::memory_order_relaxed);
+		pending.ticks.clear();
+		pending.persisted = 0;  // Those are still in the tail, adopted again with the next trade
+		pending.tailBytes = 0;
+		return;
+	}
+	const qint64 offset = data.size();
+
+	m_encoded.clear();
+	TickStoreFormat::encodeBlock(pending.ticks.times.constData(), pending.ticks.prices.constData(),
+		pending.ticks.sizes.constData(), count, m_encoded);
+	pending.ticks.clear();
+	data.seek(offset);
+	if (data.write(m_encoded) != m_encoded.size()) {
+		emit logMessage(QString("[TICKSTORE] Write to %1 failed: %2").arg(data.fileName(), data.errorString()));
+		data.resize(offset);  // Leave no partial block behind
+		m_ticksDropped.fetch_add(count - pending.persisted, std::memory_order_relaxed);
+		pending.persisted = 0;
+		pending.tailBytes = 0;
+		return;
+	}
+	data.close();
+	written += m_encoded.size();
+
+	// Index entry only after the block is down, so an entry never points past the data
+	char entry[TickStoreFormat::IndexEntrySize] = {};
+	std::memcpy(entry, m_encoded.constData() + 8, 16);  // min and max time, as in the block header
+	qToLittleEndian<qint64>(offset, entry + 16);
+	qToLittleEndian<quint32>(static_cast<quint32>(count), entry + 24);
+
+	QFile index(TickStoreFormat::indexFileName(m_directory, pending.day, pending.symbol));
+	if (index.open(QIODevice::WriteOnly | QIODevice::Append)) {
+		index.write(entry, sizeof(entry));
+		written += sizeof(entry);
+	}
+
+	// The block now holds what the tail did; its base no longer matches either way
+	if (pending.tailBytes > 0) {
+		QFile::remove(TickStoreFormat::tailFileName(m_directory, pending.day, pending.symbol));
+	}
+
+	m_ticksWritten.fetch_add(count - pending.persisted, std::memory_order_relaxed);
+	m_bytesWritten.fetch_add(written - pending.tailBytes, std::memory_order_relaxed);
+	pending.persisted = 0;
+	pending.tailBytes = 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <QObject>
+#include <QThread>
+#include <QString>
+#include <QHash>
+#include <QFile>
+#include <atomic>
+#include <memory>
+#include "SpscRing.h"
+#include "SymbolTable.h"
+#include "TickStoreFormat.h"
+
+// Persists trades to the columnar tick history (see TickStoreFormat.h).
+// The feed's consumer thread hands each trade over through a lock-free
+// ring and never waits; a background writer buffers them per symbol and
+// appends a compressed block once a symbol has BlockTicks trades. So that
+// readers are never far behind, the flush interval rewrites each symbol's
+// partial block to its tail file rather than appending a short block - a
+// quiet symbol would otherwise pay a block header and index entry for a
+// handful of trades every interval.
+class TickStore : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit TickStore(const QString& directory, QObject* parent = nullptr);
+	~TickStore();
+
+	// Configuration - set before start()
+	void setFlushInterval(int seconds) { m_flushSeconds = seconds; }  // Default 10 s
+	void setRingSize(int ticks);                                      // Default 256K trades
+
+	QString directory() const { return m_directory; }
+
+	bool start();
+	void stop();  // Writes everything buffered, then returns
+	bool isRunning() const { return m_writer != nullptr; }
+
+	// Producer side - one thread only. Returns false (and counts a drop)
+	// when the writer has fallen behind.
+	bool append(SymbolId id, qint64 timestampNs, double price, double size);
+
+	// Thread-safe statistics
+	quint64 ticksWritten() const { return m_ticksWritten.load(std::memory_order_relaxed); }
+	quint64 ticksDropped() const { return m_ticksDropped.load(std::memory_order_relaxed); }
+	quint64 bytesWritten() const { return m_bytesWritten.load(std::memory_order_relaxed); }
+	double compressionRatio() const;  // Against 24 bytes per raw trade
+
+signals:
+	void logMessage(const QString& message);
+
+private:
+	struct StoredTick {
+		SymbolId symbolId;
+		qint64 time;
+		double price;
+		double size;
+	};
+
+	// Writer thread state for one symbol: the block being filled
+	struct PendingBlock {
+		QString symbol;
+		QDate day;
+		TickColumns ticks;
+		int persisted = 0;     // Leading ticks already in the tail file
+		qint64 tailBytes = 0;  // Size of the tail file, 0 if there is none
+	};
+
+	void writerLoop();
+	void store(const StoredTick& tick);
+	bool openData(QFile& data, const PendingBlock& pending, qint64& written);
+	void adoptTail(PendingBlock& pending);
+	void writeTail(PendingBlock& pending);
+	void flushBlock(PendingBlock& pending);
+	void flushAll(bool seal);
+
+private:
+	QString m_directory;
+	int m_flushSeconds;
+	std::unique_ptr<SpscRing<StoredTick>> m_ring;
+
+	QThread* m_writer;
+	std::atomic<bool> m_stopping;
+
+	// Writer thread only
+	QHash<SymbolId, std::shared_ptr<PendingBlock>> m_pending;
+	QByteArray m_encoded;
+
+	std::atomic<quint64> m_ticksWritten;
+	std::atomic<quint64> m_ticksDropped;
+	std::atomic<quint64> m_bytesWritten;
+};
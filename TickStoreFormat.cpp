@@ -0,0 +1,866 @@
+#include "TickStoreFormat.h"
+#include <QDir>
+#include <QDateTime>
+#include <QTimeZone>
+#include <QtEndian>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+namespace {
+	const qint64 Pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+	inline quint64 zigzag(qint64 value)
+	{
+		return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+	}
+
+	inline qint64 unzigzag(quint64 value)
+	{
+		return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+	}
+
+	inline qint64 floorDiv(qint64 value, qint64 divisor)
+	{
+		const qint64 quotient = value / divisor;
+		return quotient * divisor > value ? quotient - 1 : quotient;
+	}
+
+	inline quint64 doubleBits(double value)
+	{
+		quint64 bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	inline double bitsDouble(quint64 bits)
+	{
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	// MSB-first bit stream appended to a byte array
+	class BitWriter {
+	public:
+		explicit BitWriter(QByteArray& out) : m_out(out), m_acc(0), m_bits(0) {}
+
+		void write(quint64 value, int bits)
+		{
+			if (bits < 64) {
+				value &= (quint64(1) << bits) - 1;
+			}
+			while (bits > 32) {
+				bits -= 32;
+				writeSmall(static_cast<quint32>(value >> bits), 32);
+			}
+			writeSmall(static_cast<quint32>(value & ((quint64(1) << bits) - 1)), bits);
+		}
+
+		// value >= 1; costs 2 * floor(log2(value)) + 1 bits
+		void writeGamma(quint64 value)
+		{
+			const int width = 64 - static_cast<int>(qCountLeadingZeroBits(value));
+			for (int zeros = width - 1; zeros > 0; zeros -= qMin(zeros, 32)) {
+				writeSmall(0, qMin(zeros, 32));
+			}
+			write(value, width);
+		}
+
+		// Order-k Exp-Golomb: gamma of the high bits, then the low k bits
+		// verbatim. Order 0 is gamma of value + 1.
+		void writeExpGolomb(quint64 value, int k)
+		{
+			writeGamma((value >> k) + 1);
+			write(value, k);
+		}
+
+		void flush()
+		{
+			if (m_bits > 0) {
+				m_out.append(static_cast<char>((m_acc << (8 - m_bits)) & 0xFF));
+				m_acc = 0;
+				m_bits = 0;
+			}
+		}
+
+	private:
+		void writeSmall(quint32 value, int bits)
+		{
+			if (bits == 0) {
+				return;
+			}
+			m_acc = (m_acc << bits) | value;
+			m_bits += bits;
+			while (m_bits >= 8) {
+				m_bits -= 8;
+				m_out.append(static_cast<char>((m_acc >> m_bits) & 0xFF));
+			}
+		}
+
+		QByteArray& m_out;
+		quint64 m_acc;
+		int m_bits;
+	};
+
+	class BitReader {
+	public:
+		BitReader(const uchar* data, qint64 size)
+			: m_pos(data), m_end(data + size), m_buffer(0), m_count(0), m_overrun(false) {}
+
+		bool overrun() const { return m_overrun; }
+
+		quint64 read(int bits)
+		{
+			if (bits > 32) {
+				const quint64 high = readSmall(bits - 32);
+				return (high << 32) | readSmall(32);
+			}
+			return readSmall(bits);
+		}
+
+		quint64 readExpGolomb(int k)
+		{
+			const quint64 high = readGamma() - 1;
+			return (high << k) | read(k);
+		}
+
+		quint64 readGamma()
+		{
+			// Common case: the whole code is already in the buffer
+			refill();
+			if (m_buffer != 0) {
+				const int length = 2 * static_cast<int>(qCountLeadingZeroBits(m_buffer)) + 1;
+				if (length <= m_count) {
+					const quint64 value = m_buffer >> (64 - length);
+					m_buffer = length == 64 ? 0 : m_buffer << length;
+					m_count -= length;
+					return value;
+				}
+			}
+
+			int zeros = 0;
+			for (;;) {
+				refill();
+				if (m_count == 0) {
+					m_overrun = true;
+					return 1;
+				}
+				const int leading = m_buffer == 0 ? 64 : static_cast<int>(qCountLeadingZeroBits(m_buffer));
+				if (leading < m_count) {
+					zeros += leading;
+					m_buffer <<= leading;
+					m_count -= leading;
+					break;
+				}
+				zeros += m_count;
+				m_buffer = 0;
+				m_count = 0;
+			}
+			if (zeros > 63) {
+				m_overrun = true;
+				return 1;
+			}
+			return read(zeros + 1);
+		}
+
+	private:
+		void refill()
+		{
+			if (m_count > 56) {
+				return;
+			}
+			if (m_end - m_pos >= 8) {
+				// Whole word at once; the bits past the last whole byte are re-read next time
+				m_buffer |= qFromBigEndian<quint64>(m_pos) >> m_count;
+				const int bytes = (63 - m_count) >> 3;
+				m_pos += bytes;
+				m_count += bytes * 8;
+				return;
+			}
+			while (m_count <= 56 && m_pos < m_end) {
+				m_buffer |= static_cast<quint64>(*m_pos++) << (56 - m_count);
+				m_count += 8;
+			}
+		}
+
+		quint64 readSmall(int bits)
+		{
+			if (bits == 0) {
+				return 0;
+			}
+			refill();
+			if (m_count < bits) {
+				m_overrun = true;
+				return 0;
+			}
+			const quint64 value = m_buffer >> (64 - bits);
+			m_buffer = bits == 64 ? 0 : m_buffer << bits;
+			m_count -= bits;
+			return value;
+		}
+
+		const uchar* m_pos;
+		const uchar* m_end;
+		quint64 m_buffer;  // Left-aligned
+		int m_count;
+		bool m_overrun;
+	};
+
+	inline int expGolombBits(quint64 value, int k)
+	{
+		return 2 * (63 - static_cast<int>(qCountLeadingZeroBits((value >> k) + 1))) + 1 + k;
+	}
+
+	// Exp-Golomb order with the fewest bits for these values
+	int bestOrder(const quint64* values, int count)
+	{
+		qint64 cost[TickStoreFormat::MaxCodeOrder + 1] = {};
+		for (int i = 0; i < count; ++i) {
+			for (int k = 0; k <= TickStoreFormat::MaxCodeOrder; ++k) {
+				cost[k] += expGolombBits(values[i], k);
+			}
+		}
+		return static_cast<int>(std::min_element(cost, cost + TickStoreFormat::MaxCodeOrder + 1) - cost);
+	}
+
+	// Smallest decimal scale at which every value is an exact integer, or XorScale
+	quint8 decimalScale(const double* values, int count, bool allowNegative)
+	{
+		for (int scale = 0; scale <= TickStoreFormat::MaxDecimalScale; ++scale) {
+			const double factor = static_cast<double>(Pow10[scale]);
+			bool exact = true;
+			for (int i = 0; i < count && exact; ++i) {
+				const double scaled = values[i] * factor;
+				exact = std::fabs(scaled) < 9007199254740992.0
+					&& (allowNegative || scaled >= 0.0)
+					&& static_cast<double>(std::llround(scaled)) / factor == values[i];
+			}
+			if (exact) {
+				return static_cast<quint8>(scale);
+			}
+		}
+		return TickStoreFormat::XorScale;
+	}
+
+	void encodeXor(const double* values, int count, BitWriter& writer)
+	{
+		quint64 previous = doubleBits(values[0]);
+		writer.write(previous, 64);
+		int previousLeading = -1;
+		int previousTrailing = 0;
+
+		for (int i = 1; i < count; ++i) {
+			const quint64 bits = doubleBits(values[i]);
+			const quint64 x = bits ^ previous;
+			previous = bits;
+			if (x == 0) {
+				writer.write(0, 1);
+				continue;
+			}
+
+			const int leading = qMin(31, static_cast<int>(qCountLeadingZeroBits(x)));
+			const int trailing = static_cast<int>(qCountTrailingZeroBits(x));
+			if (previousLeading >= 0 && leading >= previousLeading && trailing >= previousTrailing) {
+				// Fits the previous window
+				writer.write(2, 2);
+				writer.write(x >> previousTrailing, 64 - previousLeading - previousTrailing);
+				continue;
+			}
+
+			const int length = 64 - leading - trailing;
+			writer.write(3, 2);
+			writer.write(static_cast<quint64>(leading), 5);
+			writer.write(static_cast<quint64>(length - 1), 6);
+			writer.write(x >> trailing, length);
+			previousLeading = leading;
+			previousTrailing = trailing;
+		}
+	}
+
+	void decodeXor(BitReader& reader, int count, double* out)
+	{
+		quint64 previous = reader.read(64);
+		out[0] = bitsDouble(previous);
+		int previousLeading = 0;
+		int previousTrailing = 0;
+
+		for (int i = 1; i < count; ++i) {
+			if (reader.read(1) == 1) {
+				if (reader.read(1) == 1) {
+					previousLeading = static_cast<int>(reader.read(5));
+					const int length = static_cast<int>(reader.read(6)) + 1;
+					previousTrailing = qMax(0, 64 - previousLeading - length);
+				}
+				const int length = 64 - previousLeading - previousTrailing;
+				previous ^= reader.read(length) << previousTrailing;
+			}
+			out[i] = bitsDouble(previous);
+		}
+	}
+}
+
+QString TickStoreFormat::dayDirectory(const QString& root, const QDate& day)
+{
+	return QDir(root).filePath(day.toString("yyyyMMdd"));
+}
+
+QString TickStoreFormat::dataFileName(const QString& root, const QDate& day, const QString& symbol)
+{
+	return QDir(dayDirectory(root, day)).filePath(symbol + ".lts");
+}
+
+QString TickStoreFormat::indexFileName(const QString& root, const QDate& day, const QString& symbol)
+{
+	return QDir(dayDirectory(root, day)).filePath(symbol + ".ltx");
+}
+
+QString TickStoreFormat::tailFileName(const QString& root, const QDate& day, const QString& symbol)
+{
+	return QDir(dayDirectory(root, day)).filePath(symbol + ".ltt");
+}
+
+QDate TickStoreFormat::dayOf(qint64 timestampNs)
+{
+	return QDateTime::fromMSecsSinceEpoch(timestampNs / 1000000, QTimeZone::UTC).date();
+}
+
+void TickStoreFormat::writeFileHeader(char* dst, const QDate& day, qint64 createdNs)
+{
+	std::memset(dst, 0, FileHeaderSize);
+	qToLittleEndian<quint32>(DataMagic, dst);
+	qToLittleEndian<quint16>(Version, dst + 4);
+	qToLittleEndian<qint32>(day.year() * 10000 + day.month() * 100 + day.day(), dst + 8);
+	qToLittleEndian<qint64>(createdNs, dst + 16);
+}
+
+void TickStoreFormat::encodeBlock(const qint64* times, const double* prices, const double* sizes, int count, QByteArray& out)
+{
+	if (count <= 0) {
+		return;
+	}
+
+	const int headerOffset = static_cast<int>(out.size());
+	out.append(BlockHeaderSize, '\0');
+
+	// Coarsest unit that divides every timestamp - feeds stamp ms or us
+	int timeUnit = 6;
+	qint64 minTime = times[0];
+	qint64 maxTime = times[0];
+	for (int i = 0; i < count; ++i) {
+		while (timeUnit > 0 && times[i] % Pow10[timeUnit] != 0) {
+			timeUnit -= 3;
+		}
+		minTime = qMin(minTime, times[i]);
+		maxTime = qMax(maxTime, times[i]);
+	}
+
+	// Each gamma-coded stream gets its own Exp-Golomb order, picked to fit the
+	// block: millisecond gaps on a busy symbol, or odd-lot sizes, are a few
+	// bits wide even when they repeat
+	QVector<quint64> codes(count);
+	int timeOrder = 0;
+	int start = static_cast<int>(out.size());
+	{
+		BitWriter writer(out);
+		const qint64 unit = Pow10[timeUnit];
+		qint64 previous = times[0] / unit;
+		for (int i = 1; i < count; ++i) {
+			const qint64 value = times[i] / unit;
+			codes[i] = zigzag(value - previous);
+			previous = value;
+		}
+		timeOrder = bestOrder(codes.constData() + 1, count - 1);
+		writer.write(static_cast<quint64>(times[0] / unit), 64);
+		for (int i = 1; i < count; ++i) {
+			writer.writeExpGolomb(codes[i], timeOrder);
+		}
+		writer.flush();
+	}
+	const quint32 timeBytes = static_cast<quint32>(out.size() - start);
+
+	start = static_cast<int>(out.size());
+	const quint8 priceScale = decimalScale(prices, count, true);
+	int priceOrder = 0;
+	int priceDigits = 0;
+	{
+		BitWriter writer(out);
+		if (priceScale == XorScale) {
+			encodeXor(prices, count, writer);
+		}
+		else {
+			// Ticks move a few cents at a time, so deltas stay tiny. A few
+			// sub-penny prints would otherwise scale every delta by 100: when
+			// most prices need fewer digits, the extra ones are split off and
+			// sent only where they are not zero.
+			const double factor = static_cast<double>(Pow10[priceScale]);
+			QVector<qint64> scaled(count);
+			for (int i = 0; i < count; ++i) {
+				scaled[i] = std::llround(prices[i] * factor);
+			}
+			while (priceDigits < priceScale) {
+				const qint64 step = Pow10[priceDigits + 1];
+				int exact = 0;
+				for (int i = 0; i < count; ++i) {
+					exact += scaled[i] % step == 0 ? 1 : 0;
+				}
+				if (exact * 10 < count * 9) {
+					break;
+				}
+				priceDigits++;
+			}
+			const qint64 step = Pow10[priceDigits];
+
+			qint64 previous = floorDiv(scaled[0], step);
+			for (int i = 1; i < count; ++i) {
+				const qint64 value = floorDiv(scaled[i], step);
+				codes[i] = zigzag(value - previous);
+				previous = value;
+			}
+			priceOrder = bestOrder(codes.constData() + 1, count - 1);
+			writer.write(static_cast<quint64>(scaled[0]), 64);
+			for (int i = 1; i < count; ++i) {
+				writer.writeExpGolomb(codes[i], priceOrder);
+				if (step > 1) {
+					const qint64 remainder = scaled[i] - floorDiv(scaled[i], step) * step;
+					writer.write(remainder != 0 ? 1 : 0, 1);
+					if (remainder != 0) {
+						writer.writeGamma(static_cast<quint64>(remainder));
+					}
+				}
+			}
+		}
+		writer.flush();
+	}
+	const quint32 priceBytes = static_cast<quint32>(out.size() - start);
+
+	start = static_cast<int>(out.size());
+	const quint8 sizeScale = decimalScale(sizes, count, false);
+	int lotExponent = 0;
+	int sizeOrder = 0;
+	int lotOrder = 0;
+	{
+		BitWriter writer(out);
+		if (sizeScale == XorScale) {
+			encodeXor(sizes, count, writer);
+		}
+		else {
+			// Sizes do not trend, so the values themselves are smaller than deltas.
+			// Equities trade mostly in round lots; when enough sizes are whole lots
+			// a flag bit lets them be coded as a lot count.
+			const double factor = static_cast<double>(Pow10[sizeScale]);
+			QVector<quint64> lots(count);
+			int multiples[3] = { count, 0, 0 };
+			for (int i = 0; i < count; ++i) {
+				codes[i] = static_cast<quint64>(std::llround(sizes[i] * factor));
+				multiples[1] += codes[i] % 10 == 0 ? 1 : 0;
+				multiples[2] += codes[i] % 100 == 0 ? 1 : 0;
+			}
+			lotExponent = multiples[2] * 10 >= count * 3 ? 2 : multiples[1] * 10 >= count * 3 ? 1 : 0;
+
+			// Odd sizes and lot counts are coded with separate orders
+			const quint64 lot = static_cast<quint64>(Pow10[lotExponent]);
+			int odd = 0;
+			int whole = 0;
+			for (int i = 0; i < count; ++i) {
+				if (lot > 1 && codes[i] % lot == 0) {
+					lots[whole++] = codes[i] / lot;
+				}
+				else {
+					lots[count - 1 - odd++] = codes[i];
+				}
+			}
+			lotOrder = bestOrder(lots.constData(), whole);
+			sizeOrder = bestOrder(lots.constData() + count - odd, odd);
+
+			for (int i = 0; i < count; ++i) {
+				const quint64 value = codes[i];
+				if (lot == 1) {
+					writer.writeExpGolomb(value, sizeOrder);
+				}
+				else if (value % lot == 0) {
+					writer.write(1, 1);
+					writer.writeExpGolomb(value / lot, lotOrder);
+				}
+				else {
+					writer.write(0, 1);
+					writer.writeExpGolomb(value, sizeOrder);
+				}
+			}
+		}
+		writer.flush();
+	}
+	const quint32 sizeBytes = static_cast<quint32>(out.size() - start);
+
+	char* header = out.data() + headerOffset;
+	qToLittleEndian<quint32>(static_cast<quint32>(count), header);
+	header[4] = static_cast<char>(priceScale);
+	header[5] = static_cast<char>(sizeScale);
+	header[6] = static_cast<char>(timeUnit);
+	header[7] = static_cast<char>(lotExponent);
+	qToLittleEndian<qint64>(minTime, header + 8);
+	qToLittleEndian<qint64>(maxTime, header + 16);
+	qToLittleEndian<quint32>(timeBytes, header + 24);
+	qToLittleEndian<quint32>(priceBytes, header + 28);
+	qToLittleEndian<quint32>(sizeBytes, header + 32);
+	header[36] = static_cast<char>(timeOrder | (priceOrder << 4));
+	header[37] = static_cast<char>(sizeOrder | (lotOrder << 4));
+	header[38] = static_cast<char>(priceDigits);
+}
+
+bool TickStoreFormat::decodeBlock(const char* block, qint64 available, QVector<qint64>& times, QVector<double>& prices, QVector<double>& sizes)
+{
+	if (available < BlockHeaderSize) {
+		return false;
+	}
+
+	const int count = static_cast<int>(qFromLittleEndian<quint32>(block));
+	const quint8 priceScale = static_cast<quint8>(block[4]);
+	const quint8 sizeScale = static_cast<quint8>(block[5]);
+	const int timeUnit = static_cast<quint8>(block[6]);
+	const int lotExponent = static_cast<quint8>(block[7]);
+	const qint64 timeBytes = qFromLittleEndian<quint32>(block + 24);
+	const qint64 priceBytes = qFromLittleEndian<quint32>(block + 28);
+	const qint64 sizeBytes = qFromLittleEndian<quint32>(block + 32);
+	const int timeOrder = static_cast<quint8>(block[36]) & 0x0F;
+	const int priceOrder = static_cast<quint8>(block[36]) >> 4;
+	const int sizeOrder = static_cast<quint8>(block[37]) & 0x0F;
+	const int lotOrder = static_cast<quint8>(block[37]) >> 4;
+	const int priceExtraDigits = static_cast<quint8>(block[38]);
+	if (count <= 0 || count > BlockTicks || timeUnit > 6 || timeUnit % 3 != 0 || lotExponent > 2
+		|| (priceScale > MaxDecimalScale && priceScale != XorScale)
+		|| (sizeScale > MaxDecimalScale && sizeScale != XorScale)
+		|| (priceExtraDigits > 0 && (priceScale == XorScale || priceExtraDigits > priceScale))
+		|| BlockHeaderSize + timeBytes + priceBytes + sizeBytes > available) {
+		return false;
+	}
+
+	// Callers decode many blocks into the same columns; grow geometrically
+	const qsizetype base = times.size();
+	if (times.capacity() < base + count) {
+		const qsizetype capacity = qMax(base + count, times.capacity() * 2);
+		times.reserve(capacity);
+		prices.reserve(capacity);
+		sizes.reserve(capacity);
+	}
+	times.resize(base + count);
+	prices.resize(base + count);
+	sizes.resize(base + count);
+
+	// Scale 0 skips the division; dividing by the exact power of ten
+	// (rather than multiplying by its inverse) gives back the stored double
+	bool valid;
+	const uchar* column = reinterpret_cast<const uchar*>(block + BlockHeaderSize);
+	{
+		qint64* out = times.data() + base;
+		BitReader reader(column, timeBytes);
+		const qint64 unit = Pow10[timeUnit];
+		qint64 value = static_cast<qint64>(reader.read(64));
+		out[0] = value * unit;
+		for (int i = 1; i < count; ++i) {
+			value += unzigzag(reader.readExpGolomb(timeOrder));
+			out[i] = value * unit;
+		}
+		valid = !reader.overrun();
+	}
+	column += timeBytes;
+
+	if (valid) {
+		double* out = prices.data() + base;
+		BitReader reader(column, priceBytes);
+		if (priceScale == XorScale) {
+			decodeXor(reader, count, out);
+		}
+		else {
+			const qint64 first = static_cast<qint64>(reader.read(64));
+			out[0] = static_cast<double>(first);
+			if (priceExtraDigits == 0) {
+				qint64 value = first;
+				for (int i = 1; i < count; ++i) {
+					value += unzigzag(reader.readExpGolomb(priceOrder));
+					out[i] = static_cast<double>(value);
+				}
+			}
+			else {
+				const qint64 step = Pow10[priceExtraDigits];
+				qint64 value = floorDiv(first, step);
+				for (int i = 1; i < count; ++i) {
+					value += unzigzag(reader.readExpGolomb(priceOrder));
+					const qint64 remainder = reader.read(1) == 1 ? static_cast<qint64>(reader.readGamma()) : 0;
+					out[i] = static_cast<double>(value * step + remainder);
+				}
+			}
+			if (priceScale > 0) {
+				const double factor = static_cast<double>(Pow10[priceScale]);
+				for (int i = 0; i < count; ++i) {
+					out[i] /= factor;
+				}
+			}
+		}
+		valid = !reader.overrun();
+	}
+	column += priceBytes;
+
+	if (valid) {
+		double* out = sizes.data() + base;
+		BitReader reader(column, sizeBytes);
+		if (sizeScale == XorScale) {
+			decodeXor(reader, count, out);
+		}
+		else {
+			const qint64 lot = Pow10[lotExponent];
+			for (int i = 0; i < count; ++i) {
+				qint64 value;
+				if (lot != 1 && reader.read(1) == 1) {
+					value = static_cast<qint64>(reader.readExpGolomb(lotOrder)) * lot;
+				}
+				else {
+					value = static_cast<qint64>(reader.readExpGolomb(sizeOrder));
+				}
+				out[i] = static_cast<double>(value);
+			}
+			if (sizeScale > 0) {
+				const double factor = static_cast<double>(Pow10[sizeScale]);
+				for (int i = 0; i < count; ++i) {
+					out[i] /= factor;
+				}
+			}
+		}
+		valid = !reader.overrun();
+	}
+
+	if (!valid) {
+		times.resize(base);
+		prices.resize(base);
+		sizes.resize(base);
+	}
+	return valid;
+}
+
+TickStoreReader::TickStoreReader()
+	: m_data(nullptr)
+	, m_dataSize(0)
+	, m_tickCount(0)
+{
+}
+
+TickStoreReader::~TickStoreReader()
+{
+	close();
+}
+
+bool TickStoreReader::open(const QString& root, const QString& symbol, const QDate& day)
+{
+	close();
+
+	m_dataFile.setFileName(TickStoreFormat::dataFileName(root, day, symbol));
+	if (!m_dataFile.open(QIODevice::ReadOnly)) {
+		m_error = QString("Cannot open %1: %2").arg(m_dataFile.fileName(), m_dataFile.errorString());
+		return false;
+	}
+
+	m_dataSize = m_dataFile.size();
+	uchar* map = m_dataSize >= TickStoreFormat::FileHeaderSize ? m_dataFile.map(0, m_dataSize) : nullptr;
+	if (!map || qFromLittleEndian<quint32>(map) != TickStoreFormat::DataMagic
+		|| qFromLittleEndian<quint16>(map + 4) != TickStoreFormat::Version) {
+		m_error = QString("%1 is not a tick store file").arg(m_dataFile.fileName());
+		if (map) {
+			m_dataFile.unmap(map);
+		}
+		m_dataFile.close();
+		return false;
+	}
+	m_data = reinterpret_cast<const char*>(map);
+
+	// The index is small; read it whole rather than map it
+	qint64 recoverFrom = TickStoreFormat::FileHeaderSize;
+	m_indexFile.setFileName(TickStoreFormat::indexFileName(root, day, symbol));
+	if (m_indexFile.open(QIODevice::ReadOnly)) {
+		const QByteArray index = m_indexFile.readAll();
+		m_indexFile.close();
+
+		const char* entry = index.constData();
+		const int entries = static_cast<int>(index.size() / TickStoreFormat::IndexEntrySize);
+		m_blocks.reserve(entries);
+		for (int i = 0; i < entries; ++i, entry += TickStoreFormat::IndexEntrySize) {
+			BlockRef block;
+			block.minTime = qFromLittleEndian<qint64>(entry);
+			block.maxTime = qFromLittleEndian<qint64>(entry + 8);
+			block.offset = qFromLittleEndian<qint64>(entry + 16);
+			block.count = qFromLittleEndian<quint32>(entry + 24);
+			if (block.offset != recoverFrom || block.offset + TickStoreFormat::BlockHeaderSize > m_dataSize) {
+				break;  // Out of step with the data file; rebuild the rest from it
+			}
+			const char* header = m_data + block.offset;
+			const qint64 length = TickStoreFormat::BlockHeaderSize
+				+ qFromLittleEndian<quint32>(header + 24)
+				+ qFromLittleEndian<quint32>(header + 28)
+				+ qFromLittleEndian<quint32>(header + 32);
+			if (block.offset + length > m_dataSize) {
+				break;
+			}
+			m_blocks.append(block);
+			m_tickCount += block.count;
+			recoverFrom = block.offset + length;
+		}
+	}
+	recoverBlocks(recoverFrom);
+	readTail(TickStoreFormat::tailFileName(root, day, symbol));
+
+	const int count = static_cast<int>(m_blocks.size());
+	m_prefixMax.resize(count);
+	m_suffixMin.resize(count);
+	qint64 runningMax = std::numeric_limits<qint64>::min();
+	for (int i = 0; i < count; ++i) {
+		runningMax = qMax(runningMax, m_blocks[i].maxTime);
+		m_prefixMax[i] = runningMax;
+	}
+	qint64 runningMin = std::numeric_limits<qint64>::max();
+	for (int i = count - 1; i >= 0; --i) {
+		runningMin = qMin(runningMin, m_blocks[i].minTime);
+		m_suffixMin[i] = runningMin;
+	}
+	return true;
+}
+
+void TickStoreReader::close()
+{
+	if (m_data) {
+		m_dataFile.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+		m_data = nullptr;
+	}
+	m_dataFile.close();
+	m_dataSize = 0;
+	m_tickCount = 0;
+	m_blocks.clear();
+	m_tail.clear();
+	m_prefixMax.clear();
+	m_suffixMin.clear();
+}
+
+void TickStoreReader::recoverBlocks(qint64 from)
+{
+	// Walk block headers the index does not cover, stopping at a partial write
+	qint64 offset = from;
+	while (offset + TickStoreFormat::BlockHeaderSize <= m_dataSize) {
+		const char* header = m_data + offset;
+		const quint32 count = qFromLittleEndian<quint32>(header);
+		const qint64 length = TickStoreFormat::BlockHeaderSize
+			+ qFromLittleEndian<quint32>(header + 24)
+			+ qFromLittleEndian<quint32>(header + 28)
+			+ qFromLittleEndian<quint32>(header + 32);
+		if (count == 0 || count > static_cast<quint32>(TickStoreFormat::BlockTicks) || offset + length > m_dataSize) {
+			break;
+		}
+
+		BlockRef block;
+		block.minTime = qFromLittleEndian<qint64>(header + 8);
+		block.maxTime = qFromLittleEndian<qint64>(header + 16);
+		block.offset = offset;
+		block.count = count;
+		m_blocks.append(block);
+		m_tickCount += count;
+		offset += length;
+	}
+}
+
+void TickStoreReader::readTail(const QString& fileName)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return;
+	}
+	const QByteArray contents = file.readAll();
+	if (contents.size() < TickStoreFormat::TailHeaderSize + TickStoreFormat::BlockHeaderSize
+		|| qFromLittleEndian<qint64>(contents.constData()) != m_dataSize) {
+		return;  // Appended to the data file since, or not yet complete
+	}
+
+	const char* header = contents.constData() + TickStoreFormat::TailHeaderSize;
+	const quint32 count = qFromLittleEndian<quint32>(header);
+	const qint64 length = TickStoreFormat::BlockHeaderSize
+		+ qFromLittleEndian<quint32>(header + 24)
+		+ qFromLittleEndian<quint32>(header + 28)
+		+ qFromLittleEndian<quint32>(header + 32);
+	if (count == 0 || count > static_cast<quint32>(TickStoreFormat::BlockTicks)
+		|| TickStoreFormat::TailHeaderSize + length > contents.size()) {
+		return;
+	}
+
+	m_tail = contents.mid(TickStoreFormat::TailHeaderSize, length);
+	BlockRef block;
+	block.minTime = qFromLittleEndian<qint64>(header + 8);
+	block.maxTime = qFromLittleEndian<qint64>(header + 16);
+	block.offset = -1;
+	block.count = count;
+	m_blocks.append(block);
+	m_tickCount += count;
+}
+
+qint64 TickStoreReader::minTime() const
+{
+	return m_suffixMin.isEmpty() ? 0 : m_suffixMin.first();
+}
+
+qint64 TickStoreReader::maxTime() const
+{
+	return m_prefixMax.isEmpty() ? 0 : m_prefixMax.last();
+}
+
+int TickStoreReader::read(qint64 fromNs, qint64 toNs, TickColumns& out) const
+{
+	if (!m_data || fromNs > toNs) {
+		return 0;
+	}
+
+	// Every block before the first whose running max reaches fromNs ends before the range
+	const int first = static_cast<int>(std::lower_bound(m_prefixMax.constBegin(), m_prefixMax.constEnd(), fromNs)
+		- m_prefixMax.constBegin());
+
+	// Size the output once from the index instead of growing it block by block
+	qint64 expected = 0;
+	for (int i = first; i < m_blocks.size() && m_suffixMin[i] <= toNs; ++i) {
+		if (m_blocks[i].maxTime >= fromNs && m_blocks[i].minTime <= toNs) {
+			expected += m_blocks[i].count;
+		}
+	}
+	out.times.reserve(out.size() + expected);
+	out.prices.reserve(out.size() + expected);
+	out.sizes.reserve(out.size() + expected);
+
+	int added = 0;
+	TickColumns block;
+	for (int i = first; i < m_blocks.size() && m_suffixMin[i] <= toNs; ++i) {
+		const BlockRef& ref = m_blocks[i];
+		if (ref.maxTime < fromNs || ref.minTime > toNs) {
+			continue;
+		}
+
+		const char* data = ref.offset < 0 ? m_tail.constData() : m_data + ref.offset;
+		const qint64 available = ref.offset < 0 ? m_tail.size() : m_dataSize - ref.offset;
+		if (ref.minTime >= fromNs && ref.maxTime <= toNs) {
+			// Wholly inside - decode straight into the output
+			const int before = out.size();
+			if (TickStoreFormat::decodeBlock(data, available, out.times, out.prices, out.sizes)) {
+				added += out.size() - before;
+			}
+			continue;
+		}
+
+		block.clear();
+		if (!TickStoreFormat::decodeBlock(data, available, block.times, block.prices, block.sizes)) {
+			continue;
+		}
+		for (int j = 0; j < block.size(); ++j) {
+			if (block.times[j] >= fromNs && block.times[j] <= toNs) {
+				out.times.append(block.times[j]);
+				out.prices.append(block.prices[j]);
+				out.sizes.append(block.sizes[j]);
+				added++;
+			}
+		}
+	}
+	return added;
+}
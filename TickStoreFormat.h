@@ -0,0 +1,151 @@
+#pragma once
+#include <QtGlobal>
+#include <QVector>
+#include <QFile>
+#include <QString>
+#include <QDate>
+
+// On-disk format of the tick history store: one data file and one index
+// file per symbol per UTC day, <root>/<yyyyMMdd>/<SYMBOL>.lts and .ltx,
+// and while the writer is filling a block, a tail file .ltt.
+// Little-endian throughout.
+//
+// Data file header (32 bytes)
+//   0  u32  magic "LTSD"
+//   4  u16  version
+//   6  u16  reserved
+//   8  i32  day, yyyyMMdd
+//   12 u32  reserved
+//   16 i64  creation time, ns since epoch
+//   24 u64  reserved
+//
+// The header is followed by blocks of up to BlockTicks trades. Each block
+// is a 40-byte header and three column streams, each padded to a byte:
+//   0  u32  tick count
+//   4  u8   price scale: prices are integers / 10^scale, or XorScale
+//   5  u8   size scale, likewise
+//   6  u8   time unit: timestamps are multiples of 10^unit ns
+//   7  u8   size lot: 10^lot, see below
+//   8  i64  min timestamp, ns since epoch
+//   16 i64  max timestamp
+//   24 u32  time column bytes
+//   28 u32  price column bytes
+//   32 u32  size column bytes
+//   36 u8   time code order | price code order << 4
+//   37 u8   odd size code order | lot count code order << 4
+//   38 u8   price extra digits, see below
+//   39 u8   reserved
+//
+// Timestamps and scaled prices are stored as zigzag deltas from the
+// previous tick and scaled sizes as plain values, each Exp-Golomb coded with
+// the order in the block header; order 0 is Elias-gamma of value + 1, so a
+// repeated price or same-unit timestamp costs one bit. With a size lot
+// above 1 each size carries a flag bit and whole lots are coded as a lot
+// count. With price extra digits e above 0, the deltas are of the price
+// floored to a multiple of 10^e and each price is followed by a flag bit
+// and, when set, the gamma-coded remainder. Doubles that are not short
+// decimals, and negative sizes, fall back to Gorilla-style XOR against the
+// previous value. Blocks written before the orders existed have zeros there
+// and decode unchanged.
+//
+// Index file: one 32-byte entry per block, appended after the block
+//   0  i64  min timestamp
+//   8  i64  max timestamp
+//   16 i64  block offset in the data file
+//   24 u32  tick count
+//   28 u32  reserved
+// The index may lag the data file after a crash; readers recover the
+// missing entries from the block headers.
+//
+// Tail file: the block being filled, replaced whole at each flush
+//   0  i64  data file size it follows
+//   8       one block, as in the data file
+// Its ticks are not in the data file until the block is appended there,
+// after which the tail is removed. A tail whose size field does not match
+// the data file has already been appended and is ignored.
+namespace TickStoreFormat {
+	const quint32 DataMagic = 0x4453544Cu;  // "LTSD" as little-endian bytes
+	const quint16 Version = 1;
+	const int FileHeaderSize = 32;
+	const int BlockHeaderSize = 40;
+	const int IndexEntrySize = 32;
+	const int TailHeaderSize = 8;
+	const int BlockTicks = 4096;
+	const quint8 XorScale = 0xFF;
+	const int MaxDecimalScale = 6;
+	const int MaxCodeOrder = 15;
+
+	QString dayDirectory(const QString& root, const QDate& day);
+	QString dataFileName(const QString& root, const QDate& day, const QString& symbol);
+	QString indexFileName(const QString& root, const QDate& day, const QString& symbol);
+	QString tailFileName(const QString& root, const QDate& day, const QString& symbol);
+	QDate dayOf(qint64 timestampNs);  // UTC
+
+	void writeFileHeader(char* dst, const QDate& day, qint64 createdNs);
+
+	// Encodes count ticks as one block - header, then columns - into out
+	void encodeBlock(const qint64* times, const double* prices, const double* sizes, int count, QByteArray& out);
+
+	// Appends the block's ticks; false if it is malformed
+	bool decodeBlock(const char* block, qint64 available, QVector<qint64>& times, QVector<double>& prices, QVector<double>& sizes);
+}
+
+// A time range of one symbol's trades, column by column
+struct TickColumns {
+	QVector<qint64> times;   // ns since epoch
+	QVector<double> prices;
+	QVector<double> sizes;
+
+	int size() const { return static_cast<int>(times.size()); }
+	void clear() { times.clear(); prices.clear(); sizes.clear(); }
+};
+
+// Reads one symbol-day. The data file is memory-mapped and the index and
+// tail read at open(); trades the writer stores afterwards are not seen
+// until the next open().
+class TickStoreReader {
+public:
+	TickStoreReader();
+	~TickStoreReader();
+
+	bool open(const QString& root, const QString& symbol, const QDate& day);
+	void close();
+	bool isOpen() const { return m_data != nullptr; }
+	QString errorString() const { return m_error; }
+
+	int blockCount() const { return static_cast<int>(m_blocks.size()); }
+	qint64 tickCount() const { return m_tickCount; }
+	qint64 fileSize() const { return m_dataSize; }
+	qint64 minTime() const;
+	qint64 maxTime() const;
+
+	// Appends trades with fromNs <= time <= toNs, in file order; returns how many
+	int read(qint64 fromNs, qint64 toNs, TickColumns& out) const;
+
+private:
+	struct BlockRef {
+		qint64 minTime;
+		qint64 maxTime;
+		qint64 offset;  // -1 for the tail
+		quint32 count;
+	};
+
+	void recoverBlocks(qint64 from);
+	void readTail(const QString& fileName);
+
+private:
+	QFile m_dataFile;
+	QFile m_indexFile;
+	const char* m_data;
+	qint64 m_dataSize;
+	qint64 m_tickCount;
+	QVector<BlockRef> m_blocks;
+	QByteArray m_tail;  // Its block, when it follows the mapped data
+
+	// Blocks are in append order, and late trades make their ranges overlap,
+	// so the search runs on the running max and the scan stops on the
+	// remaining min
+	QVector<qint64> m_prefixMax;
+	QVector<qint64> m_suffixMin;
+	QString m_error;
+};
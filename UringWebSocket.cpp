@@ -0,0 +1,658 @@
+#include "UringWebSocket.h"
+
+#ifdef Q_OS_LINUX
+#include <QCryptographicHash>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+namespace {
+
+const unsigned RingEntries = 64;
+const int MaxCompletions = 2 * RingEntries;  // The kernel's default CQ size
+
+enum Opcode {
+	ContinuationFrame = 0x0,
+	TextFrame = 0x1,
+	BinaryFrame = 0x2,
+	CloseFrame = 0x8,
+	PingFrame = 0x9,
+	PongFrame = 0xA
+};
+
+struct Completion {
+	quint64 userData;
+	int result;
+};
+
+QString systemError(const char* operation, int error)
+{
+	return QString("%1: %2").arg(operation, QString::fromLocal8Bit(std::strerror(error)));
+}
+
+char* mapBuffer(int size)
+{
+	void* buffer = mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return buffer == MAP_FAILED ? nullptr : static_cast<char*>(buffer);
+}
+
+}
+
+UringWebSocket::UringWebSocket(Listener* listener, int receiveBufferSize, int sendBufferSize)
+	: m_listener(listener)
+	, m_eventFd(-1)
+	, m_socket(-1)
+	, m_state(State::Closed)
+	, m_generation(0)
+	, m_inFlight(0)
+	, m_receive(mapBuffer(receiveBufferSize))
+	, m_receiveCapacity(receiveBufferSize)
+	, m_receiveUsed(0)
+	, m_readPending(false)
+	, m_send(mapBuffer(sendBufferSize))
+	, m_sendHalf(sendBufferSize / 2)
+	, m_filling(0)
+	, m_active(-1)
+	, m_written(0)
+	, m_fragmentOpcode(0)
+	, m_framesReceived(0)
+	, m_framesSent(0)
+	, m_maskState(0)
+{
+	std::memset(&m_address, 0, sizeof(m_address));
+	m_fill[0] = m_fill[1] = 0;
+
+	std::random_device seed;
+	while (m_maskState == 0) {
+		m_maskState = seed();
+	}
+}
+
+UringWebSocket::~UringWebSocket()
+{
+	shutdownSocket();
+	m_ring.submit();
+	if (m_eventFd >= 0) {
+		::close(m_eventFd);
+	}
+	// Registered pages stay pinned by the ring until it is destroyed, so unmapping first is safe
+	if (m_receive) {
+		munmap(m_receive, static_cast<size_t>(m_receiveCapacity));
+	}
+	if (m_send) {
+		munmap(m_send, static_cast<size_t>(m_sendHalf) * 2);
+	}
+}
+
+bool UringWebSocket::setupRing()
+{
+	if (m_ring.isValid()) {
+		return true;
+	}
+	if (!m_receive || !m_send) {
+		m_error = "Cannot allocate socket buffers";
+		return false;
+	}
+	if (!m_ring.setup(RingEntries)) {
+		m_error = systemError("io_uring_setup", m_ring.lastError());
+		return false;
+	}
+
+	iovec buffers[2];
+	buffers[0].iov_base = m_receive;
+	buffers[0].iov_len = static_cast<size_t>(m_receiveCapacity);
+	buffers[1].iov_base = m_send;
+	buffers[1].iov_len = static_cast<size_t>(m_sendHalf) * 2;
+	if (!m_ring.registerBuffers(buffers, 2)) {
+		m_error = systemError("io_uring_register(buffers)", m_ring.lastError());
+		return false;
+	}
+
+	m_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (m_eventFd < 0 || !m_ring.registerEventFd(m_eventFd)) {
+		m_error = systemError("io_uring_register(eventfd)", m_eventFd < 0 ? errno : m_ring.lastError());
+		return false;
+	}
+	return true;
+}
+
+bool UringWebSocket::open(const QByteArray& host, quint16 port, const QByteArray& resource)
+{
+	if (m_state != State::Closed) {
+		shutdownSocket();  // Replaces the connection, like QWebSocket::open()
+		m_state = State::Closed;
+	}
+	m_error.clear();
+	if (!setupRing()) {
+		return false;
+	}
+
+	addrinfo hints;
+	std::memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* addresses = nullptr;
+	const int resolved = getaddrinfo(host.constData(), QByteArray::number(port).constData(), &hints, &addresses);
+	if (resolved != 0 || !addresses) {
+		m_error = QString("Cannot resolve %1: %2").arg(QString::fromUtf8(host), QString::fromLocal8Bit(gai_strerror(resolved)));
+		return false;
+	}
+	std::memcpy(&m_address, addresses->ai_addr, addresses->ai_addrlen);
+	const socklen_t addressLength = addresses->ai_addrlen;
+	const int family = addresses->ai_family;
+	freeaddrinfo(addresses);
+
+	m_socket = socket(family, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+	if (m_socket < 0) {
+		m_error = systemError("socket", errno);
+		return false;
+	}
+	const int noDelay = 1;
+	setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+	m_generation++;
+	m_receiveUsed = 0;
+	m_fill[0] = m_fill[1] = 0;
+	m_filling = 0;
+	m_active = -1;
+	m_written = 0;
+	m_overflow.clear();
+	m_fragment.clear();
+
+	// The handshake request is sent once the connect completes
+	QByteArray key(16, Qt::Uninitialized);
+	for (int i = 0; i < key.size(); ++i) {
+		m_maskState ^= m_maskState << 13;
+		m_maskState ^= m_maskState >> 17;
+		m_maskState ^= m_maskState << 5;
+		key[i] = static_cast<char>(m_maskState);
+	}
+	m_handshakeKey = key.toBase64();
+	m_request = "GET " + (resource.isEmpty() ? QByteArray("/") : resource) + " HTTP/1.1\r\n"
+		"Host: " + (port == 80 ? host : host + ':' + QByteArray::number(port)) + "\r\n"
+		"Upgrade: websocket\r\n"
+		"Connection: Upgrade\r\n"
+		"Sec-WebSocket-Key: " + m_handshakeKey + "\r\n"
+		"Sec-WebSocket-Version: 13\r\n\r\n";
+
+	io_uring_sqe* sqe = nextSqe(ConnectOperation);
+	sqe->opcode = IORING_OP_CONNECT;
+	sqe->fd = m_socket;
+	sqe->addr = reinterpret_cast<quint64>(&m_address);
+	sqe->off = addressLength;
+	m_state = State::Connecting;
+	m_ring.submit();
+	return true;
+}
+
+void UringWebSocket::close()
+{
+	switch (m_state) {
+	case State::Closed:
+	case State::Closing:
+		return;
+	case State::Open: {
+		// Status 1000, normal closure; the peer answers and drops the connection
+		const char status[2] = { char(0x03), char(0xE8) };
+		queueFrame(CloseFrame, status, 2);
+		m_state = State::Closing;
+		flush();
+		return;
+	}
+	default:
+		finishClose();
+		return;
+	}
+}
+
+bool UringWebSocket::queueText(const char* data, int length)
+{
+	if (m_state != State::Open) {
+		return false;
+	}
+	m_framesSent++;
+	return queueFrame(TextFrame, data, length);
+}
+
+bool UringWebSocket::queueBinary(const char* data, int length)
+{
+	if (m_state != State::Open) {
+		return false;
+	}
+	m_framesSent++;
+	return queueFrame(BinaryFrame, data, length);
+}
+
+void UringWebSocket::flush()
+{
+	if (m_active < 0) {
+		submitWrite();
+	}
+	m_ring.submit();
+}
+
+int UringWebSocket::processCompletions()
+{
+	quint64 signalled;
+	while (read(m_eventFd, &signalled, sizeof(signalled)) > 0) {
+	}
+
+	// Copied out first: a callback that drops the connection reaps the ring itself.
+	// The CQ holds MaxCompletions, so one pass takes everything posted so far;
+	// anything posted during dispatch signals the event fd again.
+	Completion completions[MaxCompletions];
+	int count = 0;
+	m_ring.reap([&](quint64 userData, int result, quint32) {
+		m_inFlight--;
+		completions[count].userData = userData;
+		completions[count].result = result;
+		count++;
+		});
+	for (int i = 0; i < count; ++i) {
+		if ((completions[i].userData >> 8) != m_generation) {
+			continue;  // From a connection that has since been dropped
+		}
+		switch (completions[i].userData & 0xFF) {
+		case ConnectOperation:
+			onConnectComplete(completions[i].result);
+			break;
+		case ReadOperation:
+			onReadComplete(completions[i].result);
+			break;
+		case WriteOperation:
+			onWriteComplete(completions[i].result);
+			break;
+		}
+	}
+
+	// Everything the callbacks queued - next read, pongs, replies - in one enter
+	if (m_socket >= 0 && m_active < 0) {
+		submitWrite();
+	}
+	m_ring.submit();
+	return count;
+}
+
+io_uring_sqe* UringWebSocket::nextSqe(Operation operation)
+{
+	io_uring_sqe* sqe = m_ring.nextSqe();
+	if (!sqe) {
+		m_ring.submit();
+		sqe = m_ring.nextSqe();
+	}
+	sqe->user_data = (static_cast<quint64>(m_generation) << 8) | operation;
+	m_inFlight++;
+	return sqe;
+}
+
+bool UringWebSocket::queueFrame(int opcode, const char* data, int length)
+{
+	const int headerLength = length < 126 ? 2 : (length <= 0xFFFF ? 4 : 10);
+	uchar* frame = reinterpret_cast<uchar*>(reserveSend(headerLength + 4 + length));
+
+	frame[0] = static_cast<uchar>(0x80 | opcode);
+	if (length < 126) {
+		frame[1] = static_cast<uchar>(0x80 | length);
+	}
+	else if (length <= 0xFFFF) {
+		frame[1] = 0x80 | 126;
+		frame[2] = static_cast<uchar>(length >> 8);
+		frame[3] = static_cast<uchar>(length);
+	}
+	else {
+		frame[1] = 0x80 | 127;
+		const quint64 length64 = static_cast<quint64>(length);
+		for (int i = 0; i < 8; ++i) {
+			frame[2 + i] = static_cast<uchar>(length64 >> (56 - 8 * i));
+		}
+	}
+
+	// Clients must mask every frame
+	m_maskState ^= m_maskState << 13;
+	m_maskState ^= m_maskState >> 17;
+	m_maskState ^= m_maskState << 5;
+	uchar* mask = frame + headerLength;
+	std::memcpy(mask, &m_maskState, 4);
+	uchar* payload = mask + 4;
+	for (int i = 0; i < length; ++i) {
+		payload[i] = static_cast<uchar>(data[i]) ^ mask[i & 3];
+	}
+	return true;
+}
+
+char* UringWebSocket::reserveSend(int length)
+{
+	// Straight into the registered buffer unless earlier bytes are waiting in the overflow
+	if (m_overflow.isEmpty() && m_fill[m_filling] + length <= m_sendHalf) {
+		char* out = m_send + m_filling * m_sendHalf + m_fill[m_filling];
+		m_fill[m_filling] += length;
+		return out;
+	}
+	const qsizetype offset = m_overflow.size();
+	m_overflow.resize(offset + length);
+	return m_overflow.data() + offset;
+}
+
+void UringWebSocket::refillFromOverflow()
+{
+	const int space = m_sendHalf - m_fill[m_filling];
+	const int count = static_cast<int>(qMin<qsizetype>(space, m_overflow.size()));
+	if (count <= 0) {
+		return;
+	}
+	// A frame may straddle two writes; TCP only sees the byte stream
+	std::memcpy(m_send + m_filling * m_sendHalf + m_fill[m_filling], m_overflow.constData(), static_cast<size_t>(count));
+	m_fill[m_filling] += count;
+	m_overflow.remove(0, count);
+}
+
+void UringWebSocket::submitRead()
+{
+	if (m_readPending || m_socket < 0) {
+		return;
+	}
+	const int space = m_receiveCapacity - m_receiveUsed;
+	io_uring_sqe* sqe = nextSqe(ReadOperation);
+	sqe->opcode = IORING_OP_READ_FIXED;
+	sqe->fd = m_socket;
+	sqe->addr = reinterpret_cast<quint64>(m_receive + m_receiveUsed);
+	sqe->len = static_cast<quint32>(space);
+	sqe->buf_index = 0;
+	m_readPending = true;
+}
+
+void UringWebSocket::submitWrite()
+{
+	if (m_socket < 0) {
+		return;
+	}
+	if (m_active < 0) {
+		if (m_fill[m_filling] == 0) {
+			refillFromOverflow();
+		}
+		if (m_fill[m_filling] == 0) {
+			return;
+		}
+		m_active = m_filling;
+		m_filling ^= 1;
+		m_written = 0;
+		refillFromOverflow();
+	}
+
+	io_uring_sqe* sqe = nextSqe(WriteOperation);
+	sqe->opcode = IORING_OP_WRITE_FIXED;
+	sqe->fd = m_socket;
+	sqe->addr = reinterpret_cast<quint64>(m_send + m_active * m_sendHalf + m_written);
+	sqe->len = static_cast<quint32>(m_fill[m_active] - m_written);
+	sqe->buf_index = 1;
+}
+
+void UringWebSocket::onConnectComplete(int result)
+{
+	if (result < 0) {
+		fail(systemError("connect", -result));
+		return;
+	}
+	std::memcpy(reserveSend(static_cast<int>(m_request.size())), m_request.constData(), static_cast<size_t>(m_request.size()));
+	m_state = State::Handshaking;
+	submitRead();
+}
+
+void UringWebSocket::onReadComplete(int result)
+{
+	m_readPending = false;
+	if (result <= 0) {
+		if (m_state == State::Closing && result == 0) {
+			finishClose();
+		}
+		else {
+			fail(result == 0 ? QString("The remote host closed the connection") : systemError("read", -result));
+		}
+		return;
+	}
+
+	const quint32 generation = m_generation;
+	m_receiveUsed += result;
+	if (m_state == State::Handshaking && !parseHandshake()) {
+		return;
+	}
+	if (m_generation != generation) {
+		return;
+	}
+	parseFrames();
+	if (m_generation != generation || m_state == State::Closed) {
+		return;
+	}
+	if (m_receiveUsed == m_receiveCapacity) {
+		fail(QString("Message larger than the %1 byte receive buffer").arg(m_receiveCapacity));
+		return;
+	}
+	submitRead();
+}
+
+void UringWebSocket::onWriteComplete(int result)
+{
+	if (result < 0) {
+		fail(systemError("write", -result));
+		return;
+	}
+	m_written += result;
+	if (m_written < m_fill[m_active]) {
+		submitWrite();  // Short write: the rest of the same half
+		return;
+	}
+	m_fill[m_active] = 0;
+	m_active = -1;
+	submitWrite();
+}
+
+bool UringWebSocket::parseHandshake()
+{
+	const QByteArray received = QByteArray::fromRawData(m_receive, m_receiveUsed);
+	const int end = static_cast<int>(received.indexOf("\r\n\r\n"));
+	if (end < 0) {
+		if (m_receiveUsed == m_receiveCapacity) {
+			fail("Handshake response too large");
+			return false;
+		}
+		submitRead();
+		return false;
+	}
+
+	const QByteArray header = QByteArray(m_receive, end).toLower();
+	if (!header.startsWith("http/1.1 101")) {
+		fail(QString("Handshake rejected: %1").arg(QString::fromLatin1(QByteArray(m_receive, static_cast<int>(header.indexOf("\r\n"))))));
+		return false;
+	}
+	const QByteArray expected = QCryptographicHash::hash(m_handshakeKey + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11",
+		QCryptographicHash::Sha1).toBase64();
+	const int acceptAt = static_cast<int>(header.indexOf("sec-websocket-accept:"));
+	const int acceptEnd = acceptAt < 0 ? -1 : static_cast<int>(header.indexOf("\r\n", acceptAt));
+	const QByteArray accept = acceptAt < 0 ? QByteArray()
+		: QByteArray(m_receive + acceptAt + 21, (acceptEnd < 0 ? end : acceptEnd) - acceptAt - 21).trimmed();
+	if (accept != expected) {
+		fail("Handshake failed: bad Sec-WebSocket-Accept");
+		return false;
+	}
+
+	const int consumed = end + 4;
+	std::memmove(m_receive, m_receive + consumed, static_cast<size_t>(m_receiveUsed - consumed));
+	m_receiveUsed -= consumed;
+	m_state = State::Open;
+	m_listener->onOpen();
+	return true;
+}
+
+void UringWebSocket::parseFrames()
+{
+	const quint32 generation = m_generation;
+	int offset = 0;
+	while (m_state == State::Open || m_state == State::Closing) {
+		const int available = m_receiveUsed - offset;
+		if (available < 2) {
+			break;
+		}
+		uchar* frame = reinterpret_cast<uchar*>(m_receive + offset);
+		const bool fin = (frame[0] & 0x80) != 0;
+		const int opcode = frame[0] & 0x0F;
+		const bool masked = (frame[1] & 0x80) != 0;
+		quint64 length = frame[1] & 0x7F;
+		int headerLength = 2;
+		if (length == 126) {
+			if (available < 4) {
+				break;
+			}
+			length = (static_cast<quint64>(frame[2]) << 8) | frame[3];
+			headerLength = 4;
+		}
+		else if (length == 127) {
+			if (available < 10) {
+				break;
+			}
+			length = 0;
+			for (int i = 0; i < 8; ++i) {
+				length = (length << 8) | frame[2 + i];
+			}
+			headerLength = 10;
+		}
+		if (masked) {
+			// RFC 6455 5.1: a client must close on a masked frame from the server
+			fail("Server sent a masked frame");
+			return;
+		}
+		if (length > static_cast<quint64>(m_receiveCapacity - headerLength)) {
+			fail(QString("Message of %1 bytes is larger than the receive buffer").arg(length));
+			return;
+		}
+		if (static_cast<quint64>(available - headerLength) < length) {
+			break;
+		}
+
+		char* payload = m_receive + offset + headerLength;
+		offset += headerLength + static_cast<int>(length);
+
+		handleFrame(opcode, fin, payload, static_cast<int>(length));
+		if (m_generation != generation) {
+			return;  // The connection was dropped or replaced from a callback
+		}
+	}
+
+	if (offset > 0 && m_state != State::Closed) {
+		std::memmove(m_receive, m_receive + offset, static_cast<size_t>(m_receiveUsed - offset));
+		m_receiveUsed -= offset;
+	}
+}
+
+void UringWebSocket::handleFrame(int opcode, bool fin, const char* payload, int length)
+{
+	bool reassembled = false;
+	switch (opcode) {
+	case CloseFrame:
+		if (m_state == State::Closing) {
+			finishClose();  // The answer to our close
+		}
+		else {
+			queueFrame(CloseFrame, payload, qMin(length, 2));
+			m_state = State::Closing;  // The peer drops the connection once the answer is written
+		}
+		return;
+	case PingFrame:
+		queueFrame(PongFrame, payload, length);
+		return;
+	case PongFrame:
+		return;
+	case TextFrame:
+	case BinaryFrame:
+		if (!fin) {
+			m_fragmentOpcode = opcode;
+			m_fragment = QByteArray(payload, length);
+			return;
+		}
+		break;
+	case ContinuationFrame:
+		m_fragment.append(payload, length);
+		if (!fin) {
+			return;
+		}
+		opcode = m_fragmentOpcode;
+		payload = m_fragment.constData();
+		length = static_cast<int>(m_fragment.size());
+		reassembled = true;
+		break;
+	default:
+		fail(QString("Unknown WebSocket opcode %1").arg(opcode));
+		return;
+	}
+
+	if (m_state == State::Open) {  // Closing: nothing more is delivered
+		m_framesReceived++;
+		if (opcode == TextFrame) {
+			m_listener->onTextFrame(payload, length);
+		}
+		else {
+			m_listener->onBinaryFrame(payload, length);
+		}
+	}
+	if (reassembled) {
+		m_fragment.clear();
+	}
+}
+
+void UringWebSocket::fail(const QString& error)
+{
+	m_error = error;
+	shutdownSocket();
+	m_state = State::Closed;
+	m_listener->onError(error);
+	m_listener->onClosed();
+}
+
+void UringWebSocket::shutdownSocket()
+{
+	if (m_socket < 0) {
+		return;
+	}
+
+	// Wakes a pending read or write; a connect still in progress needs cancelling
+	::shutdown(m_socket, SHUT_RDWR);
+	const quint64 connectTag = (static_cast<quint64>(m_generation) << 8) | ConnectOperation;
+	io_uring_sqe* sqe = m_ring.nextSqe();
+	if (sqe) {
+		sqe->opcode = IORING_OP_ASYNC_CANCEL;
+		sqe->addr = connectTag;
+		sqe->user_data = 0;  // Matches no generation, so it is ignored like any stale completion
+		m_inFlight++;
+	}
+
+	// The buffers are reused by the next connection, so nothing may still be writing to them
+	m_generation++;
+	m_ring.submit();
+	while (m_inFlight > 0) {
+		if (m_ring.submit(1) < 0) {
+			break;
+		}
+		m_ring.reap([this](quint64, int, quint32) {
+			m_inFlight--;
+			});
+	}
+
+	::close(m_socket);
+	m_socket = -1;
+	m_readPending = false;
+	m_active = -1;
+}
+
+void UringWebSocket::finishClose()
+{
+	shutdownSocket();
+	m_state = State::Closed;
+	m_listener->onClosed();
+}
+
+#endif
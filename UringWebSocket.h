@@ -0,0 +1,134 @@
+#pragma once
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+#include <QByteArray>
+#include <QString>
+#include <netinet/in.h>
+#include "IoUring.h"
+
+// WebSocket client (RFC 6455, ws:// only - no TLS) on a TCP socket driven
+// by io_uring.
+//
+// The receive and send buffers are registered with the ring once, so reads
+// and writes are READ_FIXED / WRITE_FIXED with no per-operation page
+// pinning. One read is always outstanding; frames are parsed in place and
+// handed to the listener as pointers into the receive buffer. Outgoing
+// frames are encoded straight into the idle half of the send buffer while
+// the other half is being written, and every SQE produced by one pass -
+// the next read, a write, a pong - goes to the kernel in one io_uring_enter.
+//
+// Nothing blocks except host name resolution in open(). The owner waits on
+// eventFd() and calls processCompletions() when it becomes readable; all
+// listener callbacks run from there, on the owner's thread.
+class UringWebSocket {
+public:
+	enum class State {
+		Closed,
+		Connecting,
+		Handshaking,
+		Open,
+		Closing
+	};
+
+	class Listener {
+	public:
+		virtual ~Listener() = default;
+		virtual void onOpen() = 0;
+		virtual void onClosed() = 0;
+		virtual void onError(const QString& error) = 0;
+		// The data is only valid for the duration of the call
+		virtual void onTextFrame(const char* data, int length) = 0;
+		virtual void onBinaryFrame(const char* data, int length) = 0;
+	};
+
+	explicit UringWebSocket(Listener* listener, int receiveBufferSize = 1 << 20, int sendBufferSize = 1 << 20);
+	~UringWebSocket();
+
+	UringWebSocket(const UringWebSocket&) = delete;
+	UringWebSocket& operator=(const UringWebSocket&) = delete;
+
+	// False (with errorString()) if the ring or socket could not be set up
+	bool open(const QByteArray& host, quint16 port, const QByteArray& resource);
+	void close();  // Sends a close frame, then drops the connection; onClosed() follows
+
+	State state() const { return m_state; }
+	bool isOpen() const { return m_state == State::Open; }
+	QString errorString() const { return m_error; }
+	int eventFd() const { return m_eventFd; }
+
+	// Frames wait in the send buffer until flush(); false if the connection is not open
+	bool queueText(const char* data, int length);
+	bool queueBinary(const char* data, int length);
+	void flush();
+
+	// Reads the event fd, dispatches every completion and submits what they produced
+	int processCompletions();
+
+	quint64 framesReceived() const { return m_framesReceived; }
+	quint64 framesSent() const { return m_framesSent; }
+	quint64 enterCalls() const { return m_ring.enterCalls(); }
+
+private:
+	enum Operation : quint64 {
+		ConnectOperation = 1,
+		ReadOperation = 2,
+		WriteOperation = 3
+	};
+
+	bool setupRing();
+	io_uring_sqe* nextSqe(Operation operation);
+	bool queueFrame(int opcode, const char* data, int length);
+	char* reserveSend(int length);
+	void refillFromOverflow();
+	void submitRead();
+	void submitWrite();
+	void onConnectComplete(int result);
+	void onReadComplete(int result);
+	void onWriteComplete(int result);
+	bool parseHandshake();
+	void parseFrames();
+	void handleFrame(int opcode, bool fin, const char* payload, int length);
+	void fail(const QString& error);
+	void shutdownSocket();
+	void finishClose();
+
+private:
+	Listener* m_listener;
+	IoUring m_ring;
+	int m_eventFd;
+	int m_socket;
+	State m_state;
+	QString m_error;
+	quint32 m_generation;  // In user_data, so completions from an old connection are told apart
+	int m_inFlight;
+
+	sockaddr_storage m_address;  // Read by the kernel when the connect SQE is submitted
+	QByteArray m_request;  // HTTP upgrade, sent once connected
+	QByteArray m_handshakeKey;
+
+	// Registered buffer 0: bytes received and not yet parsed start at m_receive
+	char* m_receive;
+	int m_receiveCapacity;
+	int m_receiveUsed;
+	bool m_readPending;
+
+	// Registered buffer 1, two halves: one being written, the other filling
+	char* m_send;
+	int m_sendHalf;
+	int m_fill[2];
+	int m_filling;       // Half new frames are encoded into
+	int m_active;        // Half being written, -1 when idle
+	int m_written;       // Bytes of the active half already written
+	QByteArray m_overflow;  // Bytes that did not fit in the filling half, in order
+
+	// A fragmented message being reassembled
+	QByteArray m_fragment;
+	int m_fragmentOpcode;
+
+	quint64 m_framesReceived;
+	quint64 m_framesSent;
+	quint32 m_maskState;
+};
+
+#endif
@@ -96,8 +96,8 @@ UserAccount::UserAccount(const QString& username, const QString& fullName, const
 double UserAccount::portfolioValue() const
 {
 	double total = 0.0;
-	for (auto it = m_positions.begin(); it != m_positions.end(); ++it) {
-		total += it.value().marketValue();
+	for (SymbolId id : m_positionIds) {
+		total += m_positions[id].marketValue();
 	}
 	return total;
 }
@@ -152,11 +152,14 @@ QList<Transaction> UserAccount::getRecentTransactions(int count) const
 
 void UserAccount::addPosition(const QString& symbol, double quantity, double price)
 {
-	if (m_positions.contains(symbol)) {
-		m_positions[symbol].addQuantity(quantity, price);
+	SymbolId id = SymbolTable::instance().intern(symbol);
+	if (hasPosition(id)) {
+		m_positions[id].addQuantity(quantity, price);
 	}
 	else {
-		m_positions[symbol] = Position(symbol, quantity, price);
+		ensureSymbolCapacity(m_positions, id);
+		m_positions[id] = Position(symbol, quantity, price);
+		m_positionIds.append(id);
 	}
 
 	// Deduct cash for purchase
@@ -173,9 +176,10 @@ void UserAccount::addPosition(const QString& symbol, double quantity, double pri
 
 void UserAccount::reducePosition(const QString& symbol, double quantity)
 {
-	if (!m_positions.contains(symbol)) return;
+	SymbolId id = SymbolTable::instance().find(symbol);
+	if (!hasPosition(id)) return;
 
-	Position& position = m_positions[symbol];
+	Position& position = m_positions[id];
 	double salePrice = position.currentPrice();
 	double proceeds = quantity * salePrice;
 
@@ -189,7 +193,8 @@ void UserAccount::reducePosition(const QString& symbol, double quantity)
 
 	// Remove position if quantity is zero
 	if (position.quantity() <= 0) {
-		m_positions.remove(symbol);
+		position = Position();
+		m_positionIds.removeOne(id);
 	}
 
 	// Record trade transaction
@@ -204,8 +209,9 @@ void UserAccount::reducePosition(const QString& symbol, double quantity)
 
 Position* UserAccount::getPosition(const QString& symbol)
 {
-	if (m_positions.contains(symbol)) {
-		return &m_positions[symbol];
+	SymbolId id = SymbolTable::instance().find(symbol);
+	if (hasPosition(id)) {
+		return &m_positions[id];
 	}
 	return nullptr;
 }
@@ -213,21 +219,32 @@ Position* UserAccount::getPosition(const QString& symbol)
 QList<Position> UserAccount::getAllPositions() const
 {
 	QList<Position> positions;
-	for (auto it = m_positions.begin(); it != m_positions.end(); ++it) {
-		positions.append(it.value());
+	for (SymbolId id : m_positionIds) {
+		positions.append(m_positions[id]);
 	}
 	return positions;
 }
 
 bool UserAccount::hasPosition(const QString& symbol) const
 {
-	return m_positions.contains(symbol);
+	return hasPosition(SymbolTable::instance().find(symbol));
+}
+
+bool UserAccount::hasPosition(SymbolId id) const
+{
+	return id != InvalidSymbolId && id < static_cast<SymbolId>(m_positions.size()) &&
+		!m_positions[id].symbol().isEmpty();
 }
 
 void UserAccount::updatePositionPrice(const QString& symbol, double currentPrice)
 {
-	if (m_positions.contains(symbol)) {
-		m_positions[symbol].setCurrentPrice(currentPrice);
+	updatePositionPrice(SymbolTable::instance().find(symbol), currentPrice);
+}
+
+void UserAccount::updatePositionPrice(SymbolId id, double currentPrice)
+{
+	if (hasPosition(id)) {
+		m_positions[id].setCurrentPrice(currentPrice);
 	}
 }
 
@@ -256,8 +273,8 @@ double UserAccount::totalWithdrawals() const
 double UserAccount::unrealizedPnL() const
 {
 	double total = 0.0;
-	for (auto it = m_positions.begin(); it != m_positions.end(); ++it) {
-		total += it.value().unrealizedPnL();
+	for (SymbolId id : m_positionIds) {
+		total += m_positions[id].unrealizedPnL();
 	}
 	return total;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <QString>
 #include <QDateTime>
 #include <QMap>
+#include <QVector>
+#include "SymbolTable.h"
 
 enum class TransactionType {
 	Deposit,
@@ -99,12 +101,14 @@ public:
 	// Position management
 	void addPosition(const QString& symbol, double quantity, double price);
 	void reducePosition(const QString& symbol, double quantity);
-	Position* getPosition(const QString& symbol);
+	Position* getPosition(const QString& symbol);  // Valid until the next addPosition()
 	QList<Position> getAllPositions() const;
 	bool hasPosition(const QString& symbol) const;
+	bool hasPosition(SymbolId id) const;
 
 	// Update positions with current market prices
 	void updatePositionPrice(const QString& symbol, double currentPrice);
+	void updatePositionPrice(SymbolId id, double currentPrice);
 
 	// Statistics
 	double totalDeposits() const;
@@ -128,6 +132,7 @@ private:
 	double m_realizedPnL;
 
 	// Positions and transactions
-	QMap<QString, Position> m_positions;
+	QVector<Position> m_positions;      // Indexed by SymbolId; empty symbol = no position
+	QVector<SymbolId> m_positionIds;    // Open positions, in the order they were opened
 	QList<Transaction> m_transactions;
 };
\ No newline at end of file
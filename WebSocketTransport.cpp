@@ -0,0 +1,177 @@
+#include "WebSocketTransport.h"
+#include <QWebSocket>
+#include <QSocketNotifier>
+#include "UringWebSocket.h"
+
+namespace {
+
+class QtWebSocketTransport : public WebSocketTransport
+{
+public:
+	explicit QtWebSocketTransport(QObject* parent)
+		: WebSocketTransport(parent)
+		, m_webSocket(new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this))
+	{
+		connect(m_webSocket, &QWebSocket::connected, this, &WebSocketTransport::connected);
+		connect(m_webSocket, &QWebSocket::disconnected, this, &WebSocketTransport::disconnected);
+		connect(m_webSocket, QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::errorOccurred),
+			this, [this](QAbstractSocket::SocketError) {
+				emit errorOccurred(m_webSocket->errorString());
+			});
+		connect(m_webSocket, &QWebSocket::textMessageReceived, this, &WebSocketTransport::textMessageReceived);
+		connect(m_webSocket, &QWebSocket::binaryMessageReceived, this, &WebSocketTransport::binaryMessageReceived);
+	}
+
+	WebSocketTransportKind kind() const override { return WebSocketTransportKind::Qt; }
+	void open(const QUrl& url) override { m_webSocket->open(url); }
+	void close() override { m_webSocket->close(); }
+	bool isValid() const override { return m_webSocket->isValid(); }
+	void sendTextMessage(const QString& message) override { m_webSocket->sendTextMessage(message); }
+	QString errorString() const override { return m_webSocket->errorString(); }
+
+private:
+	QWebSocket* m_webSocket;
+};
+
+#ifdef Q_OS_LINUX
+// The ring's event fd is watched by the owning thread's event loop, so the
+// session thread needs no extra poller; one notifier wake handles every
+// completion posted since the last one.
+class UringWebSocketTransport : public WebSocketTransport, private UringWebSocket::Listener
+{
+public:
+	explicit UringWebSocketTransport(QObject* parent)
+		: WebSocketTransport(parent)
+		, m_socket(this)
+		, m_notifier(nullptr)
+	{
+	}
+
+	~UringWebSocketTransport() override
+	{
+		delete m_notifier;  // Before the event fd closes with m_socket
+	}
+
+	WebSocketTransportKind kind() const override { return WebSocketTransportKind::IoUring; }
+
+	void open(const QUrl& url) override
+	{
+		if (url.scheme() != "ws") {
+			m_error = QString("Unsupported scheme for the io_uring transport: %1").arg(url.scheme());
+			emit errorOccurred(m_error);
+			return;
+		}
+		QByteArray resource = url.path(QUrl::FullyEncoded).toUtf8();
+		if (resource.isEmpty()) {
+			resource = "/";
+		}
+		if (url.hasQuery()) {
+			resource += '?' + url.query(QUrl::FullyEncoded).toUtf8();
+		}
+		if (!m_socket.open(url.host().toUtf8(), static_cast<quint16>(url.port(80)), resource)) {
+			m_error = m_socket.errorString();
+			emit errorOccurred(m_error);
+			return;
+		}
+		if (!m_notifier) {
+			// Created here rather than in the constructor, on the thread the transport runs on
+			m_notifier = new QSocketNotifier(m_socket.eventFd(), QSocketNotifier::Read);
+			connect(m_notifier, &QSocketNotifier::activated, this, [this]() {
+				m_socket.processCompletions();
+				});
+		}
+	}
+
+	void close() override { m_socket.close(); }
+	bool isValid() const override { return m_socket.isOpen(); }
+
+	void sendTextMessage(const QString& message) override
+	{
+		const QByteArray utf8 = message.toUtf8();
+		if (m_socket.queueText(utf8.constData(), static_cast<int>(utf8.size()))) {
+			m_socket.flush();
+		}
+	}
+
+	void sendTextMessages(const QStringList& messages) override
+	{
+		// Every frame goes into the registered send buffer, then one submission
+		for (const QString& message : messages) {
+			const QByteArray utf8 = message.toUtf8();
+			if (!m_socket.queueText(utf8.constData(), static_cast<int>(utf8.size()))) {
+				return;
+			}
+		}
+		m_socket.flush();
+	}
+
+	QString errorString() const override { return m_error; }
+
+private:
+	void onOpen() override { emit connected(); }
+	void onClosed() override { emit disconnected(); }
+
+	void onError(const QString& error) override
+	{
+		m_error = error;
+		emit errorOccurred(error);
+	}
+
+	void onTextFrame(const char* data, int length) override
+	{
+		emit textFrameReceived(QByteArray::fromRawData(data, length));
+	}
+
+	void onBinaryFrame(const char* data, int length) override
+	{
+		emit binaryMessageReceived(QByteArray::fromRawData(data, length));
+	}
+
+private:
+	UringWebSocket m_socket;
+	QSocketNotifier* m_notifier;
+	QString m_error;
+};
+#endif
+
+}
+
+void WebSocketTransport::sendTextMessages(const QStringList& messages)
+{
+	for (const QString& message : messages) {
+		sendTextMessage(message);
+	}
+}
+
+bool WebSocketTransport::isAvailable(WebSocketTransportKind kind)
+{
+	switch (kind) {
+	case WebSocketTransportKind::Qt:
+		return true;
+	case WebSocketTransportKind::IoUring: {
+#ifdef Q_OS_LINUX
+		static const bool supported = IoUring::isSupported();  // Probed once; seccomp or sysctl may forbid it
+		return supported;
+#else
+		return false;
+#endif
+	}
+	}
+	return false;
+}
+
+QString WebSocketTransport::kindName(WebSocketTransportKind kind)
+{
+	return kind == WebSocketTransportKind::IoUring ? "io_uring" : "Qt";
+}
+
+WebSocketTransport* WebSocketTransport::create(WebSocketTransportKind kind, QObject* parent)
+{
+#ifdef Q_OS_LINUX
+	if (kind == WebSocketTransportKind::IoUring && isAvailable(kind)) {
+		return new UringWebSocketTransport(parent);
+	}
+#endif
+	Q_UNUSED(kind);
+	return new QtWebSocketTransport(parent);
+}
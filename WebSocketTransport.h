@@ -0,0 +1,46 @@
+#pragma once
+#include <QObject>
+#include <QUrl>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+
+enum class WebSocketTransportKind {
+	Qt,       // QWebSocket on the Qt event loop; ws:// and wss://
+	IoUring   // UringWebSocket, Linux only; ws:// only
+};
+
+// Client WebSocket as the feed sessions use it, so the socket underneath can
+// be swapped without touching the decoding. Lives on the thread that owns
+// the session; signals are emitted from that thread.
+class WebSocketTransport : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit WebSocketTransport(QObject* parent = nullptr) : QObject(parent) {}
+
+	virtual WebSocketTransportKind kind() const = 0;
+	virtual void open(const QUrl& url) = 0;
+	virtual void close() = 0;
+	virtual bool isValid() const = 0;  // Connected and able to send
+	virtual void sendTextMessage(const QString& message) = 0;
+	virtual void sendTextMessages(const QStringList& messages);  // Backends that batch override this
+	virtual QString errorString() const = 0;
+
+	static bool isAvailable(WebSocketTransportKind kind);
+	static QString kindName(WebSocketTransportKind kind);
+	// Falls back to the Qt transport when kind is not available here
+	static WebSocketTransport* create(WebSocketTransportKind kind, QObject* parent = nullptr);
+
+signals:
+	void connected();
+	void disconnected();
+	void errorOccurred(const QString& error);
+	void textMessageReceived(const QString& message);
+
+	// Raw frame bytes for backends that do not decode to QString. The data
+	// is only valid during the emission, so connect on the transport's thread.
+	void textFrameReceived(const QByteArray& frame);
+	void binaryMessageReceived(const QByteArray& message);
+};
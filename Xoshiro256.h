@@ -0,0 +1,77 @@
+#pragma once
+#include <QtGlobal>
+#include <cmath>
+
+// xoshiro256++ (Blackman & Vigna). Small, fast and good enough for market
+// simulation; one instance per thread, never shared.
+class Xoshiro256 {
+public:
+	explicit Xoshiro256(quint64 seed)
+		: m_hasSpareGaussian(false)
+		, m_spareGaussian(0.0)
+	{
+		// Expand the seed with splitmix64 so nearby seeds give unrelated streams
+		for (int i = 0; i < 4; ++i) {
+			seed += 0x9E3779B97F4A7C15ull;
+			quint64 z = seed;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			m_state[i] = z ^ (z >> 31);
+		}
+	}
+
+	quint64 next()
+	{
+		const quint64 result = rotl(m_state[0] + m_state[3], 23) + m_state[0];
+		const quint64 t = m_state[1] << 17;
+
+		m_state[2] ^= m_state[0];
+		m_state[3] ^= m_state[1];
+		m_state[1] ^= m_state[2];
+		m_state[0] ^= m_state[3];
+		m_state[2] ^= t;
+		m_state[3] = rotl(m_state[3], 45);
+
+		return result;
+	}
+
+	// Uniform in [0, 1)
+	double nextDouble()
+	{
+		return (next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	// Uniform in [0, bound) - multiply-shift, no division
+	quint32 bounded(quint32 bound)
+	{
+		return static_cast<quint32>(((next() >> 32) * bound) >> 32);
+	}
+
+	// Standard normal via the Marsaglia polar method; every other call is free
+	double nextGaussian()
+	{
+		if (m_hasSpareGaussian) {
+			m_hasSpareGaussian = false;
+			return m_spareGaussian;
+		}
+
+		double u, v, s;
+		do {
+			u = nextDouble() * 2.0 - 1.0;
+			v = nextDouble() * 2.0 - 1.0;
+			s = u * u + v * v;
+		} while (s >= 1.0 || s == 0.0);
+
+		const double scale = std::sqrt(-2.0 * std::log(s) / s);
+		m_spareGaussian = v * scale;
+		m_hasSpareGaussian = true;
+		return u * scale;
+	}
+
+private:
+	static quint64 rotl(quint64 x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	quint64 m_state[4];
+	bool m_hasSpareGaussian;
+	double m_spareGaussian;
+};
@@ -1,10 +1,69 @@
 #include <QtWidgets/QApplication>
 #include <QStyleFactory>
 #include <QDir>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QTimeZone>
+#include <QTextStream>
 #include "MainWindow.h"
+#include "TickAnalytics.h"
+
+// Headless tick history query, e.g.
+//   LightningTrade --query D:/ticks --symbols AAPL,MSFT --from 2025-01-01 --to 2025-12-31 > report.txt
+// The report goes to stdout; on Windows redirect it, as a GUI build has no console.
+static int runHistoryQuery(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Lightning Trade");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Aggregate queries over recorded tick history");
+    parser.addHelpOption();
+    parser.addOption({ "query", "Tick history directory.", "directory" });
+    parser.addOption({ "symbols", "Comma-separated symbols.", "list" });
+    parser.addOption({ "from", "First UTC day, yyyy-MM-dd (default: a year before --to).", "date" });
+    parser.addOption({ "to", "Last UTC day, yyyy-MM-dd (default: today).", "date" });
+    parser.addOption({ "bucket", "Volume bucket width in seconds (default 300).", "seconds", "300" });
+    parser.addOption({ "threads", "Worker threads (default: one per core).", "count", "0" });
+    parser.addOption({ "buckets", "Also print every bucket as CSV." });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    const QDate to = parser.isSet("to") ? QDate::fromString(parser.value("to"), Qt::ISODate)
+        : QDateTime::currentDateTimeUtc().date();
+    const QDate from = parser.isSet("from") ? QDate::fromString(parser.value("from"), Qt::ISODate) : to.addYears(-1);
+    const QStringList symbols = parser.value("symbols").toUpper().split(',', Qt::SkipEmptyParts);
+    if (symbols.isEmpty() || !from.isValid() || !to.isValid() || from > to) {
+        err << "Expected --symbols and a valid --from/--to range\n";
+        return 2;
+    }
+
+    TickQuery query;
+    query.root = parser.value("query");
+    query.symbols = symbols;
+    query.fromNs = QDateTime(from, QTime(0, 0), QTimeZone::UTC).toMSecsSinceEpoch() * 1000000;
+    query.toNs = QDateTime(to.addDays(1), QTime(0, 0), QTimeZone::UTC).toMSecsSinceEpoch() * 1000000 - 1;
+    query.bucketNs = qMax(1LL, parser.value("bucket").toLongLong()) * 1000000000LL;
+    query.threads = parser.value("threads").toInt();
+
+    const TickQueryReport report = TickAnalytics::run(query);
+    out << TickAnalytics::formatReport(query, report) << "\n";
+    if (parser.isSet("buckets")) {
+        out << TickAnalytics::formatBuckets(report);
+    }
+    return report.totalTrades() > 0 ? 0 : 1;
+}
 
 int main(int argc, char* argv[])
 {
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--query") == 0) {
+            return runHistoryQuery(argc, argv);
+        }
+    }
+
     QApplication app(argc, argv);
 
     // Set application properties